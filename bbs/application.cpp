@@ -55,6 +55,7 @@
 #include "common/workspace.h"
 #include "core/command_line.h"
 #include "core/eventbus.h"
+#include "core/net.h"
 #include "core/os.h"
 #include "core/strings-ng.h"
 #include "core/strings.h"
@@ -81,6 +82,7 @@
 #include "sdk/files/files.h"
 #include "sdk/menus/menu_set.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_header_cache.h"
 #include "sdk/net/networks.h"
 #include <algorithm>
 #include <chrono>
@@ -154,7 +156,8 @@ Application::Application(LocalIO* localIO)
       context_(std::make_unique<ApplicationContext>(this)),
       pipe_eval_(std::make_unique<PipeEval>(*context_)),
       bbs_macro_context_(std::make_unique<BbsMacroContext>(context_.get(), *pipe_eval_)),
-      batch_(std::make_unique<Batch>()) {
+      batch_(std::make_unique<Batch>()),
+      msg_header_cache_(std::make_unique<msgapi::MessageHeaderCache>()) {
   VLOG(4) << "Application::Application()";
   ::bout.SetLocalIO(localIO);
   bout.set_context_provider([this]() -> Context& { return *this->context_; });
@@ -1001,10 +1004,29 @@ int Application::Run(int argc, char* argv[]) {
     // HACK for now, pass arg into InitializeBBS
     user_already_on_ = true;
   }
-  CreateComm(hSockOrComm, parent_pid, type);
+  // wwivd may start us ahead of time as a warm worker, in which case it hands us
+  // the caller's socket over this channel once we are fully initialized.
+  const auto handoff = environment_variable("WWIV_HANDOFF");
+  const auto warm_worker = !handoff.empty() && type == CommunicationType::TELNET;
+  CreateComm(hSockOrComm, parent_pid, warm_worker ? CommunicationType::NONE : type);
   if (!InitializeBBS(!user_already_on_ && sysop_cmd.empty() && fsed.empty() && run_basic.empty())) {
     return exitLevelNotOK;
   }
+  if (warm_worker) {
+    // Don't let doors think they are warm workers too.
+    set_environment_variable("WWIV_HANDOFF", "");
+    const auto channel = to_number<SOCKET>(handoff);
+    SOCKET sock = INVALID_SOCKET;
+    std::string handoff_data;
+    const auto received = ReceiveSocketHandle(channel, sock, handoff_data);
+    closesocket(channel);
+    if (!received) {
+      // wwivd recycled us before a caller arrived.
+      VLOG(1) << "Warm worker exiting without a connection.";
+      return oklevel_;
+    }
+    CreateComm(sock, parent_pid, type);
+  }
   bout.localIO()->UpdateNativeTitleBar(config()->system_name(), sess().instance_number());
 
   auto remote_opened = true;
@@ -1239,6 +1261,8 @@ void Application::set_current_file_area(std::unique_ptr<wwiv::sdk::files::FileAr
 
 Batch& Application::batch() { return *batch_; }
 
+msgapi::MessageHeaderCache& Application::msg_header_cache() { return *msg_header_cache_; }
+
 static usersubrec empty_user_sub{"", -1};
 
 const usersubrec& Application::current_user_sub() const {
@@ -88,6 +88,7 @@ struct directory_t;
 
 namespace msgapi {
 class MessageApi;
+class MessageHeaderCache;
 class WWIVMessageApi;
 } // namespace msgapi
 
@@ -235,6 +236,8 @@ public:
   [[nodiscard]] wwiv::sdk::net::Network& mutable_current_net();
 
   [[nodiscard]] bool IsUseInternalZmodem() const { return internal_zmodem_; }
+  /** Whether the internal ZMODEM may send subpackets larger than 1K (ZMODEM-8K). */
+  [[nodiscard]] bool IsUseZmodem8K() const { return zmodem_8k_; }
   [[nodiscard]] bool IsUseInternalFsed() const; 
 
   [[nodiscard]] int GetNumMessagesInCurrentMessageArea() const { return num_msgs_current_sub_; }
@@ -281,6 +284,8 @@ public:
   [[nodiscard]] wwiv::sdk::msgapi::MessageApi* msgapi(int type) const;
   [[nodiscard]] wwiv::sdk::msgapi::MessageApi* msgapi() const;
   [[nodiscard]] wwiv::sdk::msgapi::WWIVMessageApi* msgapi_email() const;
+  /** Headers of the messages in recently listed subs. */
+  [[nodiscard]] wwiv::sdk::msgapi::MessageHeaderCache& msg_header_cache();
 
   [[nodiscard]] wwiv::sdk::files::FileApi* fileapi() const;
   [[nodiscard]] wwiv::sdk::files::FileArea* current_file_area() const;
@@ -343,6 +348,7 @@ public:
 
   bool newscan_at_login_{false};
   bool internal_zmodem_{true};
+  bool zmodem_8k_{false};
   bool internal_fsed_{true};
   bool exec_log_syncfoss_{true};
   int num_msgs_read_cur_logon_{0};
@@ -479,6 +485,7 @@ private:
   std::unique_ptr<wwiv::common::PipeEval> pipe_eval_;
   std::unique_ptr<BbsMacroContext> bbs_macro_context_;
   std::unique_ptr<Batch> batch_;
+  std::unique_ptr<wwiv::sdk::msgapi::MessageHeaderCache> msg_header_cache_;
 };
 
 #endif
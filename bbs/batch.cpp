@@ -19,6 +19,7 @@
 // ReSharper disable CppClangTidyHicppMultiwayPathsCovered
 #include "bbs/batch.h"
 
+#include "bbs/batch_prep.h"
 #include "bbs/bbs.h"
 #include "bbs/dsz.h"
 #include "bbs/execexternal.h"
@@ -56,10 +57,13 @@
 #include <algorithm>
 #include <chrono>
 #include <iterator>
+#include <map>
 #include <string>
+#include <thread>
 #include <utility>
 
 using namespace std::chrono;
+using namespace wwiv::bbs;
 using namespace wwiv::common;
 using namespace wwiv::core;
 using namespace wwiv::local::io;
@@ -270,6 +274,59 @@ static void ProcessDSZLogFile(const std::string& path) {
   });
 }
 
+// The results of prepare_downloads, keyed by the path of each file in its area.
+using prepared_downloads_t = std::map<std::string, batch_prep_result_t>;
+
+static StagedFileCache staged_file_cache() {
+  return StagedFileCache(FilePath(a()->config()->datadir(), "staged"),
+                         StagedFileCache::DEFAULT_MAX_SIZE);
+}
+
+/**
+ * Checks all of the files in the download queue and stages the ones from
+ * CD-ROM areas up front, instead of one at a time as each is sent.
+ */
+static prepared_downloads_t prepare_downloads(StagedFileCache& cache) {
+  std::vector<batch_prep_request_t> requests;
+  for (const auto& b : a()->batch().entry) {
+    if (!b.sending()) {
+      continue;
+    }
+    const auto& dir = a()->dirs()[b.dir()];
+    requests.push_back({FilePath(dir.path, files::FileName(b.aligned_filename())),
+                        (dir.mask & mask_cdrom) != 0});
+  }
+  // This is mostly waiting on the disk, so a few threads are plenty.
+  const auto jobs = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4);
+  auto results = prepare_batch(requests, &cache, jobs);
+
+  prepared_downloads_t prepared;
+  for (std::size_t i = 0; i < requests.size(); i++) {
+    prepared.emplace(requests[i].path.string(), std::move(results[i]));
+  }
+  return prepared;
+}
+
+/** Returns the file to send for f from dir_num. */
+static std::filesystem::path send_path(const prepared_downloads_t& prepared, int dir_num,
+                                       const files::FileName& f) {
+  const auto& dir = a()->dirs()[dir_num];
+  auto path = FilePath(dir.path, f);
+  if (const auto it = prepared.find(path.string());
+      it != prepared.end() && !it->second.send_path.empty()) {
+    return it->second.send_path;
+  }
+  if (dir.mask & mask_cdrom) {
+    // It wasn't staged, so copy it to the temp directory like before.
+    auto temp_path = FilePath(a()->sess().dirs().temp_directory(), f);
+    if (!File::Exists(temp_path)) {
+      File::Copy(path, temp_path);
+    }
+    return temp_path;
+  }
+  return path;
+}
+
 static int hangup_color(int left) {
   if (left < 3) {
     return 6;
@@ -331,6 +388,9 @@ void zmbatchdl(bool bHangupAfterDl) {
   bout << message;
   bout.nl(2);
 
+  auto cache = staged_file_cache();
+  auto in_use = cache.lock_in_use();
+  const auto prepared = prepare_downloads(cache);
   bool bRatioBad = false;
   bool ok = true;
   // TODO(rushfan): Rewrite this to use iterators;
@@ -357,15 +417,8 @@ void zmbatchdl(bool bHangupAfterDl) {
                                     ctim(a()->batch().dl_time_in_secs()), "\r\n"));
         auto* area = a()->current_file_area();
         auto f = area->ReadFile(record_number);
-        auto send_filename = FilePath(a()->dirs()[dir_num].path, f);
-        if (a()->dirs()[dir_num].mask & mask_cdrom) {
-          auto orig_filename = FilePath(a()->dirs()[dir_num].path, f);
-          // update the send filename and copy it from the CD-ROM
-          send_filename = FilePath(a()->sess().dirs().temp_directory(), f);
-          if (!File::Exists(send_filename)) {
-            File::Copy(orig_filename, send_filename);
-          }
-        }
+        const auto send_filename =
+            send_path(prepared, dir_num, files::FileName(f.aligned_filename()));
         write_inst(INST_LOC_DOWNLOAD, a()->current_user_dir().subnum, INST_FLAGS_NONE);
         const auto send_fn = send_filename.string();
         double percent;
@@ -379,6 +432,8 @@ void zmbatchdl(bool bHangupAfterDl) {
     }
   }
   while (ok && !a()->sess().hangup() && size_int(a()->batch().entry) > cur && !bRatioBad);
+  in_use.reset();
+  cache.trim();
 
   if (bRatioBad) {
     bout << "\r\nYour ratio is too low to continue the transfer.\r\n\n\n";
@@ -462,6 +517,9 @@ void ymbatchdl(bool bHangupAfterDl) {
   bout << message;
   bout.nl(2);
 
+  auto cache = staged_file_cache();
+  auto in_use = cache.lock_in_use();
+  const auto prepared = prepare_downloads(cache);
   bool bRatioBad = false;
   bool ok = true;
   //TODO(rushfan): rewrite to use iterators.
@@ -488,14 +546,8 @@ void ymbatchdl(bool bHangupAfterDl) {
                                     ctim(a()->batch().dl_time_in_secs()), "\r\n"));
         auto* area = a()->current_file_area();
         auto f = area->ReadFile(record_number);
-        auto send_filename = FilePath(a()->dirs()[dir_num].path, f);
-        if (a()->dirs()[dir_num].mask & mask_cdrom) {
-          auto orig_filename = FilePath(a()->dirs()[dir_num].path, f);
-          send_filename = FilePath(a()->sess().dirs().temp_directory(), f);
-          if (!File::Exists(send_filename)) {
-            File::Copy(orig_filename, send_filename);
-          }
-        }
+        const auto send_filename =
+            send_path(prepared, dir_num, files::FileName(f.aligned_filename()));
         write_inst(INST_LOC_DOWNLOAD, a()->current_user_dir().subnum, INST_FLAGS_NONE);
         double percent;
         xymodem_send(send_filename.string(), &ok, &percent, true, true, true);
@@ -507,6 +559,8 @@ void ymbatchdl(bool bHangupAfterDl) {
       a()->batch().delbatch(cur);
     }
   } while (ok && !a()->sess().hangup() && size_int(a()->batch().entry) > cur && !bRatioBad);
+  in_use.reset();
+  cache.trim();
 
   if (ok && !a()->sess().hangup()) {
     end_ymodem_batch();
@@ -546,12 +600,13 @@ static std::string make_ul_batch_list() {
   return list_filename.string();
 }
 
-static std::filesystem::path make_dl_batch_list() {
+static std::filesystem::path make_dl_batch_list(StagedFileCache& cache) {
   const auto fn = fmt::sprintf("%s.%3.3u", FILESDL_NOEXT, a()->sess().instance_number());
   auto list_filename = FilePath(a()->bbspath(), fn);
 
   File::Remove(list_filename, true);
 
+  const auto prepared = prepare_downloads(cache);
   TextFile tf(list_filename, "wt");
 
   int32_t at = 0;
@@ -560,18 +615,13 @@ static std::filesystem::path make_dl_batch_list() {
     if (!b.sending()) {
       continue;
     }
-    std::string filename_to_send;
-    if (a()->dirs()[b.dir()].mask & mask_cdrom) {
-      const auto fileToSend =
-          FilePath(a()->sess().dirs().temp_directory(), files::FileName(b.aligned_filename()));
-      if (!File::Exists(fileToSend)) {
-        auto sourceFile = FilePath(a()->dirs()[b.dir()].path, files::FileName(b.aligned_filename()));
-        File::Copy(sourceFile, fileToSend);
-      }
-      filename_to_send = fileToSend.string();
-    } else {
-      filename_to_send = FilePath(a()->dirs()[b.dir()].path, files::FileName(b.aligned_filename())).string();
+    const files::FileName fn_to_send(b.aligned_filename());
+    if (const auto it = prepared.find(FilePath(a()->dirs()[b.dir()].path, fn_to_send).string());
+        it != prepared.end() && !it->second.exists) {
+      bout << "Cannot download " << b.aligned_filename() << ": File not found" << wwiv::endl;
+      continue;
     }
+    const auto filename_to_send = send_path(prepared, b.dir(), fn_to_send).string();
     bool ok = true;
     if (nsl() < b.time(a()->modem_speed_) + at) {
       ok = false;
@@ -649,8 +699,12 @@ void dszbatchdl(bool bHangupAfterDl, const std::string& command_line, const std:
   bout.nl(2);
 
   write_inst(INST_LOC_DOWNLOAD, a()->current_user_dir().subnum, INST_FLAGS_NONE);
-  const auto list_filename = make_dl_batch_list();
+  auto cache = staged_file_cache();
+  auto in_use = cache.lock_in_use();
+  const auto list_filename = make_dl_batch_list(cache);
   run_cmd(command_line, list_filename.string(), "", download_log_entry, bHangupAfterDl);
+  in_use.reset();
+  cache.trim();
 }
 
 static void dszbatchul(bool bHangupAfterDl, char* command_line, const std::string& description) {
@@ -0,0 +1,221 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "bbs/batch_prep.h"
+
+#include "core/log.h"
+#include "core/os.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/file.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace wwiv::core;
+
+namespace wwiv::bbs {
+
+StagedFileCache::StagedFileCache(std::filesystem::path dir, int64_t max_size)
+    : dir_(std::move(dir)), max_size_(max_size) {}
+
+std::string StagedFileCache::key(const std::filesystem::path& source, uintmax_t size,
+                                 std::filesystem::file_time_type time) {
+  // 64 bit FNV-1a
+  uint64_t h = 0xcbf29ce484222325ULL;
+  const auto add = [&h](const void* p, std::size_t len) {
+    const auto* b = static_cast<const uint8_t*>(p);
+    for (std::size_t i = 0; i < len; i++) {
+      h = (h ^ b[i]) * 0x100000001b3ULL;
+    }
+  };
+  const auto name = source.generic_string();
+  add(name.data(), name.size());
+  const auto s = static_cast<uint64_t>(size);
+  add(&s, sizeof(s));
+  const auto t = static_cast<int64_t>(time.time_since_epoch().count());
+  add(&t, sizeof(t));
+  return fmt::format("{:016x}", h);
+}
+
+std::optional<std::filesystem::path> StagedFileCache::get(const std::filesystem::path& source) {
+  std::error_code ec;
+  const auto size = fs::file_size(source, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto time = fs::last_write_time(source, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto entry_dir = dir_ / key(source, size, time);
+  auto dest = entry_dir / source.filename();
+  if (fs::file_size(dest, ec) == size && !ec) {
+    // Mark it as recently used for trim().
+    fs::last_write_time(entry_dir, fs::file_time_type::clock::now(), ec);
+    VLOG(1) << "Using staged copy of: " << source.string();
+    return dest;
+  }
+
+  fs::create_directories(entry_dir, ec);
+  // Copy under a name no one else is using and then rename it into place,
+  // so that another node never sees a partial copy.
+  static std::atomic<int> counter{0};
+  const auto tmp = entry_dir / fmt::format("{}.{}.{}.tmp", source.filename().string(),
+                                           os::get_pid(), counter++);
+  if (!fs::copy_file(source, tmp, fs::copy_options::overwrite_existing, ec) || ec) {
+    LOG(WARNING) << "Unable to stage: " << source.string() << "; " << ec.message();
+    fs::remove(tmp, ec);
+    return std::nullopt;
+  }
+  fs::rename(tmp, dest, ec);
+  if (ec) {
+    LOG(WARNING) << "Unable to stage: " << source.string() << "; " << ec.message();
+    fs::remove(tmp, ec);
+    return std::nullopt;
+  }
+  VLOG(1) << "Staged: " << source.string() << " as " << dest.string();
+  return dest;
+}
+
+std::filesystem::path StagedFileCache::lock_path() const { return dir_ / "staged.lck"; }
+
+// The share mode that lets every node hold the lock at once.  On Windows
+// that is sharing with everyone, which keeps trim()'s shareDenyReadWrite
+// open from succeeding.  Elsewhere File::Open only takes a shared flock for
+// shareDenyRead.
+static int in_use_share_mode() {
+#ifdef _WIN32
+  return File::shareDenyNone;
+#else
+  return File::shareDenyRead;
+#endif
+}
+
+std::unique_ptr<File> StagedFileCache::lock_in_use() {
+  std::error_code ec;
+  fs::create_directories(dir_, ec);
+  auto f = std::make_unique<File>(lock_path());
+  // This only waits for a trim() that is already running.
+  if (!f->Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite,
+               in_use_share_mode())) {
+    LOG(WARNING) << "Unable to lock: " << lock_path().string();
+  }
+  return f;
+}
+
+bool StagedFileCache::trim() {
+  // Skip trimming rather than wait for the nodes using the cache to finish
+  // sending.  The next download will trim it.
+  File lock(lock_path());
+#ifdef _WIN32
+  const auto locked = lock.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite,
+                                File::shareDenyReadWrite);
+#else
+  // Upgrading the shared lock fails at once if anyone else holds it.
+  const auto locked = lock.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite,
+                                in_use_share_mode()) &&
+                      flock(lock.handle(), LOCK_EX | LOCK_NB) == 0;
+#endif
+  if (!locked) {
+    VLOG(1) << "Staged copies are in use, not trimming: " << dir_.string();
+    return false;
+  }
+
+  struct entry_t {
+    fs::path path;
+    fs::file_time_type time;
+    int64_t size{0};
+  };
+  std::vector<entry_t> entries;
+  int64_t total = 0;
+  std::error_code ec;
+  for (const auto& d : fs::directory_iterator(dir_, ec)) {
+    if (!d.is_directory(ec)) {
+      continue;
+    }
+    entry_t e{d.path(), d.last_write_time(ec), 0};
+    auto staging = false;
+    for (const auto& f : fs::directory_iterator(d.path(), ec)) {
+      e.size += static_cast<int64_t>(f.file_size(ec));
+      staging = staging || f.path().extension() == ".tmp";
+    }
+    total += e.size;
+    // get() without the lock may still be copying into it.
+    if (!staging) {
+      entries.emplace_back(std::move(e));
+    }
+  }
+  if (total <= max_size_) {
+    return true;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const entry_t& l, const entry_t& r) { return l.time < r.time; });
+  for (const auto& e : entries) {
+    if (total <= max_size_) {
+      break;
+    }
+    VLOG(1) << "Removing staged copy: " << e.path.string();
+    fs::remove_all(e.path, ec);
+    total -= e.size;
+  }
+  return true;
+}
+
+static batch_prep_result_t prepare_file(const batch_prep_request_t& r, StagedFileCache* cache) {
+  batch_prep_result_t result{};
+  std::error_code ec;
+  const auto size = fs::file_size(r.path, ec);
+  if (ec) {
+    return result;
+  }
+  result.exists = true;
+  result.size = static_cast<int64_t>(size);
+  if (!r.stage) {
+    result.send_path = r.path;
+  } else if (auto staged = cache->get(r.path)) {
+    result.send_path = std::move(staged.value());
+  }
+  return result;
+}
+
+std::vector<batch_prep_result_t>
+prepare_batch(const std::vector<batch_prep_request_t>& requests, StagedFileCache* cache, int jobs) {
+  std::vector<batch_prep_result_t> results(requests.size());
+  std::atomic<std::size_t> next{0};
+  const auto worker = [&] {
+    for (auto i = next++; i < requests.size(); i = next++) {
+      results[i] = prepare_file(requests[i], cache);
+    }
+  };
+  const auto num_threads = std::min<std::size_t>(std::max(1, jobs), requests.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  return results;
+}
+
+} // namespace wwiv::bbs
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_BBS_BATCH_PREP_H
+#define INCLUDED_BBS_BATCH_PREP_H
+
+#include "core/file.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wwiv::bbs {
+
+/** A file in the batch download queue to get ready for sending. */
+struct batch_prep_request_t {
+  // Where the file lives in its file area.
+  std::filesystem::path path;
+  // Send a local copy of the file instead of the original (CD-ROM areas).
+  bool stage{false};
+};
+
+struct batch_prep_result_t {
+  // The file to give to the protocol.  Empty if the file is missing or
+  // could not be staged.
+  std::filesystem::path send_path;
+  bool exists{false};
+  int64_t size{0};
+};
+
+/**
+ * Local copies of files from slow (CD-ROM) file areas, shared by all of
+ * the nodes.
+ *
+ * Each copy lives in a directory named by a hash of the source path, size
+ * and last write time, under its original name so that protocols send it
+ * with the right name.  An unchanged file is only copied once no matter
+ * how many times it is downloaded, and a changed one is never served stale.
+ */
+class StagedFileCache final {
+public:
+  static constexpr int64_t DEFAULT_MAX_SIZE = 1024 * 1024 * 1024;
+
+  StagedFileCache(std::filesystem::path dir, int64_t max_size);
+
+  /**
+   * Returns the cached copy of source, copying it into the cache first if
+   * needed.  Safe to call from multiple threads and processes at once.
+   * Hold lock_in_use() from before calling this until the copy is sent.
+   */
+  [[nodiscard]] std::optional<std::filesystem::path> get(const std::filesystem::path& source);
+
+  /**
+   * Returns a shared lock on the cache.  While any node holds one, trim()
+   * doesn't remove anything, so copies can be staged and sent safely.
+   */
+  [[nodiscard]] std::unique_ptr<core::File> lock_in_use();
+
+  /**
+   * Removes the least recently used copies until the cache fits in
+   * max_size.  Does nothing if any node has the cache locked with
+   * lock_in_use(), including this one, so release it first.  Returns
+   * false if it was skipped because of that.
+   */
+  bool trim();
+
+  /** The name of the cache directory for a file. */
+  [[nodiscard]] static std::string key(const std::filesystem::path& source, uintmax_t size,
+                                       std::filesystem::file_time_type time);
+
+  [[nodiscard]] const std::filesystem::path& dir() const noexcept { return dir_; }
+
+private:
+  [[nodiscard]] std::filesystem::path lock_path() const;
+
+  const std::filesystem::path dir_;
+  const int64_t max_size_;
+};
+
+/**
+ * Checks that each requested file exists and stages the ones that need it,
+ * using up to jobs threads.  The results are in the same order as
+ * requests.  cache may only be null if no request needs staging.
+ */
+[[nodiscard]] std::vector<batch_prep_result_t>
+prepare_batch(const std::vector<batch_prep_request_t>& requests, StagedFileCache* cache, int jobs);
+
+} // namespace wwiv::bbs
+
+#endif
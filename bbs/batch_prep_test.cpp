@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "bbs/batch_prep.h"
+#include "core/test/file_helper.h"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace wwiv::bbs;
+using namespace wwiv::core::test;
+
+namespace fs = std::filesystem;
+
+class BatchPrepTest : public ::testing::Test {
+protected:
+  BatchPrepTest() : cache_(helper_.TempDir() / "staged", StagedFileCache::DEFAULT_MAX_SIZE) {
+    helper_.Mkdir("area");
+  }
+
+  fs::path CreateAreaFile(const std::string& name, const std::string& contents) {
+    return helper_.CreateTempFile("area/" + name, contents);
+  }
+
+  FileHelper helper_;
+  StagedFileCache cache_;
+};
+
+TEST_F(BatchPrepTest, Prepare_Missing) {
+  const auto path = helper_.TempDir() / "area" / "missing.zip";
+  const auto results = prepare_batch({{path, false}, {path, true}}, &cache_, 2);
+  ASSERT_EQ(2u, results.size());
+  for (const auto& r : results) {
+    EXPECT_FALSE(r.exists);
+    EXPECT_TRUE(r.send_path.empty());
+  }
+}
+
+TEST_F(BatchPrepTest, Prepare_NotStaged) {
+  const auto path = CreateAreaFile("a.zip", "hello");
+  const auto results = prepare_batch({{path, false}}, nullptr, 1);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_TRUE(results[0].exists);
+  EXPECT_EQ(5, results[0].size);
+  EXPECT_EQ(path, results[0].send_path);
+}
+
+TEST_F(BatchPrepTest, Prepare_Staged) {
+  const auto path = CreateAreaFile("a.zip", "hello");
+  const auto results = prepare_batch({{path, true}}, &cache_, 1);
+  ASSERT_EQ(1u, results.size());
+  const auto& send_path = results[0].send_path;
+  EXPECT_NE(path, send_path);
+  EXPECT_EQ("a.zip", send_path.filename().string());
+  EXPECT_EQ("hello", helper_.ReadFile(send_path));
+}
+
+TEST_F(BatchPrepTest, Prepare_KeepsOrder) {
+  std::vector<batch_prep_request_t> requests;
+  for (auto i = 0; i < 20; i++) {
+    const auto name = std::to_string(i) + ".zip";
+    if (i % 3) {
+      requests.push_back({CreateAreaFile(name, std::string(i, 'x')), i % 2 == 0});
+    } else {
+      requests.push_back({helper_.TempDir() / "area" / name, false});
+    }
+  }
+  const auto results = prepare_batch(requests, &cache_, 4);
+  ASSERT_EQ(requests.size(), results.size());
+  for (auto i = 0; i < 20; i++) {
+    EXPECT_EQ(i % 3 != 0, results[i].exists) << i;
+    if (results[i].exists) {
+      EXPECT_EQ(i, results[i].size) << i;
+      EXPECT_EQ(requests[i].path.filename(), results[i].send_path.filename()) << i;
+    }
+  }
+}
+
+TEST_F(BatchPrepTest, Get_ReusesCopy) {
+  const auto path = CreateAreaFile("a.zip", "hello");
+  const auto first = cache_.get(path);
+  ASSERT_TRUE(first.has_value());
+  const auto first_time = fs::last_write_time(first.value());
+
+  const auto second = cache_.get(path);
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(first.value(), second.value());
+  EXPECT_EQ(first_time, fs::last_write_time(second.value()));
+}
+
+TEST_F(BatchPrepTest, Get_Changed) {
+  const auto path = CreateAreaFile("a.zip", "hello");
+  const auto first = cache_.get(path);
+  ASSERT_TRUE(first.has_value());
+
+  CreateAreaFile("a.zip", "hello world");
+  const auto second = cache_.get(path);
+  ASSERT_TRUE(second.has_value());
+  EXPECT_NE(first.value(), second.value());
+  EXPECT_EQ("hello world", helper_.ReadFile(second.value()));
+}
+
+TEST_F(BatchPrepTest, Trim) {
+  StagedFileCache cache(helper_.TempDir() / "small", 10);
+  const auto a = cache.get(CreateAreaFile("a.zip", "123456"));
+  ASSERT_TRUE(a.has_value());
+  const auto b = cache.get(CreateAreaFile("b.zip", "123456"));
+  ASSERT_TRUE(b.has_value());
+  // Make sure a is the least recently used.
+  fs::last_write_time(a->parent_path(), fs::last_write_time(b->parent_path()) - std::chrono::hours(1));
+
+  cache.trim();
+  EXPECT_FALSE(fs::exists(a.value()));
+  EXPECT_TRUE(fs::exists(b.value()));
+
+  // Already small enough.
+  cache.trim();
+  EXPECT_TRUE(fs::exists(b.value()));
+}
+
+TEST_F(BatchPrepTest, Trim_InUse) {
+  StagedFileCache cache(helper_.TempDir() / "small", 10);
+  auto in_use = cache.lock_in_use();
+  const auto a = cache.get(CreateAreaFile("a.zip", "123456"));
+  ASSERT_TRUE(a.has_value());
+  const auto b = cache.get(CreateAreaFile("b.zip", "123456"));
+  ASSERT_TRUE(b.has_value());
+
+  // Another node trimming while this one is still sending.
+  StagedFileCache other(helper_.TempDir() / "small", 10);
+  EXPECT_FALSE(other.trim());
+  EXPECT_TRUE(fs::exists(a.value()));
+  EXPECT_TRUE(fs::exists(b.value()));
+
+  in_use.reset();
+  EXPECT_TRUE(other.trim());
+  EXPECT_FALSE(fs::exists(a.value()) && fs::exists(b.value()));
+}
+
+TEST_F(BatchPrepTest, Trim_Staging) {
+  StagedFileCache cache(helper_.TempDir() / "small", 10);
+  const auto a = cache.get(CreateAreaFile("a.zip", "123456"));
+  ASSERT_TRUE(a.has_value());
+  // A copy still being made into a's directory.
+  const auto tmp = a->parent_path() / "b.zip.1.0.tmp";
+  helper_.CreateTempFile(fs::relative(tmp, helper_.TempDir()).string(), "123456");
+
+  EXPECT_TRUE(cache.trim());
+  EXPECT_TRUE(fs::exists(a.value()));
+  EXPECT_TRUE(fs::exists(tmp));
+}
+
+TEST_F(BatchPrepTest, Get_Missing) {
+  EXPECT_FALSE(cache_.get(helper_.TempDir() / "area" / "missing.zip").has_value());
+}
@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "bbs/door_io.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace wwiv::bbs {
+
+static constexpr uint8_t IAC = 255;
+static constexpr uint8_t SB = 250;
+static constexpr uint8_t SE = 240;
+static constexpr uint8_t WILL = 251;
+static constexpr uint8_t DONT = 254;
+static constexpr char CONTROL_C = 3;
+
+void DoorInputFilter::filter(const char* data, std::size_t size, std::string& out) {
+  out.reserve(out.size() + size);
+  const auto* end = data + size;
+  for (const auto* p = data; p != end; ++p) {
+    const auto ch = static_cast<uint8_t>(*p);
+    switch (state_) {
+    case state_t::data: {
+      // Copy everything up to the next byte that needs a look in one go.
+      const auto* q = p;
+      while (q != end && static_cast<uint8_t>(*q) != IAC && *q != CONTROL_C) {
+        ++q;
+      }
+      out.append(p, q - p);
+      if (q == end) {
+        return;
+      }
+      p = q;
+      if (static_cast<uint8_t>(*p) == IAC) {
+        state_ = state_t::iac;
+      }
+    } break;
+    case state_t::iac:
+      if (ch == IAC) {
+        out.push_back(static_cast<char>(IAC));
+        state_ = state_t::data;
+      } else if (ch >= WILL && ch <= DONT) {
+        state_ = state_t::option;
+      } else if (ch == SB) {
+        state_ = state_t::subnegotiation;
+      } else {
+        state_ = state_t::data;
+      }
+      break;
+    case state_t::option:
+      state_ = state_t::data;
+      break;
+    case state_t::subnegotiation:
+      if (ch == IAC) {
+        state_ = state_t::subnegotiation_iac;
+      }
+      break;
+    case state_t::subnegotiation_iac:
+      state_ = ch == SE ? state_t::data : state_t::subnegotiation;
+      break;
+    }
+  }
+}
+
+void append_door_output(const char* data, std::size_t size, std::string& out) {
+  out.reserve(out.size() + size + size / 16);
+  const auto* end = data + size;
+  for (const auto* p = data; p != end;) {
+    const auto* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (nl == nullptr) {
+      out.append(p, end - p);
+      return;
+    }
+    out.append(p, nl - p);
+    out.append("\r\n");
+    p = nl + 1;
+  }
+}
+
+} // namespace wwiv::bbs
@@ -0,0 +1,56 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_BBS_DOOR_IO_H
+#define INCLUDED_BBS_DOOR_IO_H
+
+#include <cstddef>
+#include <string>
+
+namespace wwiv::bbs {
+
+/** Size of the buffers used when moving data between a caller and a door. */
+static constexpr std::size_t DOOR_IO_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Filters what the caller types before it is passed to a door running on a
+ * terminal.  Telnet commands are removed (an escaped IAC is passed on as a
+ * single 0xFF) since sequences like "do suppress GA" (255, 253, 3) were
+ * interpreted as a SIGINT by dosemu, and so is control-c.
+ *
+ * Telnet commands may be split across reads, so one filter must be used for
+ * the whole session.
+ */
+class DoorInputFilter final {
+public:
+  /** Appends the bytes in data that should be sent to the door to out. */
+  void filter(const char* data, std::size_t size, std::string& out);
+
+private:
+  enum class state_t { data, iac, option, subnegotiation, subnegotiation_iac };
+  state_t state_{state_t::data};
+};
+
+/**
+ * Appends data to out, translating every LF into CR/LF for the caller's
+ * terminal.
+ */
+void append_door_output(const char* data, std::size_t size, std::string& out);
+
+} // namespace wwiv::bbs
+
+#endif
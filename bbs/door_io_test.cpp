@@ -0,0 +1,72 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "bbs/door_io.h"
+#include <string>
+
+using namespace wwiv::bbs;
+
+static std::string filter(DoorInputFilter& f, const std::string& s) {
+  std::string out;
+  f.filter(s.data(), s.size(), out);
+  return out;
+}
+
+TEST(DoorIoTest, InputFilter_PassThrough) {
+  DoorInputFilter f;
+  EXPECT_EQ("hello world\r", filter(f, "hello world\r"));
+}
+
+TEST(DoorIoTest, InputFilter_ControlC) {
+  DoorInputFilter f;
+  EXPECT_EQ("ab", filter(f, "a\x03" "b"));
+}
+
+TEST(DoorIoTest, InputFilter_Option) {
+  DoorInputFilter f;
+  // IAC DO SUPPRESS-GO-AHEAD
+  EXPECT_EQ("ab", filter(f, "a\xff\xfd\x03" "b"));
+}
+
+TEST(DoorIoTest, InputFilter_EscapedIac) {
+  DoorInputFilter f;
+  EXPECT_EQ("a\xff" "b", filter(f, "a\xff\xff" "b"));
+}
+
+TEST(DoorIoTest, InputFilter_Subnegotiation) {
+  DoorInputFilter f;
+  // IAC SB NAWS 0 80 0 25 IAC SE
+  EXPECT_EQ("ab", filter(f, std::string("a\xff\xfa\x1f\x00\x50\x00\x19\xff\xf0" "b", 11)));
+}
+
+TEST(DoorIoTest, InputFilter_SplitAcrossReads) {
+  DoorInputFilter f;
+  EXPECT_EQ("a", filter(f, "a\xff"));
+  EXPECT_EQ("", filter(f, "\xfb"));
+  EXPECT_EQ("b", filter(f, "\x01" "b"));
+}
+
+TEST(DoorIoTest, Output) {
+  std::string out;
+  append_door_output("", 0, out);
+  EXPECT_EQ("", out);
+  const std::string s = "one\ntwo\n\nthree";
+  append_door_output(s.data(), s.size(), out);
+  EXPECT_EQ("one\r\ntwo\r\n\r\nthree", out);
+}
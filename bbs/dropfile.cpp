@@ -507,6 +507,8 @@ std::string create_chain_file() {
         u.real_name(), u.callsign(), u.age(),
         u.gender(), u.gold(), u.laston(),
         u.screen_width(), u.screen_lines(), u.sl()));
+    // Doors may append to the instance log, so make sure it's current first.
+    flush_sysoplog();
     const auto temporary_log_filename = GetTemporaryInstanceLogFileName();
     const auto gfilesdir = a()->config()->gfilesdir();
     file.Write(fmt::sprintf("%d\n%d\n%d\n%u\n%8ld.00\n%s\n%s\n%s\n", cs(), so(), okansi(),
@@ -18,6 +18,7 @@
 /**************************************************************************/
 #include "bbs/exec_socket.h"
 
+#include "bbs/door_io.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "core/net.h"
@@ -26,6 +27,7 @@
 #include "fmt/format.h"
 #include <chrono>
 #include <string>
+#include <vector>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -205,16 +207,36 @@ bool ExecSocket::process_still_active(EXEC_SOCKET_HANDLE h) {
 #endif
 }
 
+// Waits up to timeout for sock to have something to read.
+static bool wait_for_input(SOCKET sock, std::chrono::milliseconds timeout) {
+  fd_set rfds;
+  FD_ZERO(&rfds);
+  FD_SET(sock, &rfds);
+  const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+  timeval tv{};
+  tv.tv_sec = static_cast<long>(usec / 1000000);
+  tv.tv_usec = static_cast<long>(usec % 1000000);
+  return select(static_cast<int>(sock) + 1, &rfds, nullptr, nullptr, &tv) > 0;
+}
+
 pump_socket_result_t ExecSocket::pump_socket(EXEC_SOCKET_HANDLE hProcess, SOCKET sock, wwiv::common::RemoteIO& io) {
-  static constexpr int check_process_every = 10;
-  char buf[1024];
-  int count = 0;
+  // The caller's input can only be polled through io, so this is how long
+  // it may wait before being passed on to the door.
+  static constexpr auto input_wait = std::chrono::milliseconds(10);
+  static constexpr auto check_process_every = std::chrono::seconds(1);
+  std::vector<char> buf(DOOR_IO_BUFFER_SIZE);
+  auto last_check = std::chrono::steady_clock::now();
   while (!stop_.load()) {
-    if (auto num_read = recv(sock, buf, sizeof(buf), 0); num_read > 0) {
-      io.write(buf, num_read);
-    } else if (num_read == 0) {
-      VLOG(1) << "Exiting pump_socket: recv.";
-      return pump_socket_result_t::socket_error;
+    // Sleep until the door has something to send instead of a fixed time,
+    // then send everything it has written so far.
+    if (wait_for_input(sock, input_wait)) {
+      const auto num_read = recv(sock, buf.data(), static_cast<int>(buf.size()), 0);
+      if (num_read > 0) {
+        io.write(buf.data(), static_cast<unsigned int>(num_read));
+      } else if (num_read == 0) {
+        VLOG(1) << "Exiting pump_socket: recv.";
+        return pump_socket_result_t::socket_error;
+      }
     }
 
     if (!io.connected()) {
@@ -222,23 +244,24 @@ pump_socket_result_t ExecSocket::pump_socket(EXEC_SOCKET_HANDLE hProcess, SOCKET
       return pump_socket_result_t::socket_error;
     }
 
-    if (io.incoming()) {
-      if (auto num_read = io.read(buf, sizeof(buf)); num_read > 0) {
-        if (send(sock, buf, num_read, 0) == 0) {
-          // TODO(rushfan): handle nonblocking error?
-          VLOG(1) << "Exiting pump_socket; Write to socket failed";
-          return pump_socket_result_t::socket_error;
-        }
+    while (io.incoming()) {
+      const auto num_read = io.read(buf.data(), static_cast<unsigned int>(buf.size()));
+      if (num_read == 0) {
+        break;
+      }
+      if (send(sock, buf.data(), static_cast<int>(num_read), 0) == 0) {
+        // TODO(rushfan): handle nonblocking error?
+        VLOG(1) << "Exiting pump_socket; Write to socket failed";
+        return pump_socket_result_t::socket_error;
       }
     }
 
-    if (++count >= check_process_every) {
-      count = 0;
+    if (const auto now = std::chrono::steady_clock::now(); now - last_check >= check_process_every) {
+      last_check = now;
       if (!process_still_active(hProcess)) {
         return pump_socket_result_t::process_exit;
       }
     }
-    wwiv::os::sleep_for(std::chrono::milliseconds(100));
   }
   return pump_socket_result_t::process_exit;
 }
@@ -17,6 +17,9 @@
 /*                                                                        */
 /**************************************************************************/
 #include "bbs/exec.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 
 #define TTYDEFCHARS
@@ -38,6 +41,7 @@
 #endif
 
 #include "bbs/bbs.h"
+#include "bbs/door_io.h"
 #include "bbs/exec_socket.h"
 #include "bbs/stuffin.h"
 #include "common/context.h"
@@ -45,132 +49,234 @@
 #include "common/remote_io.h"
 #include "core/log.h"
 #include "core/os.h"
+#include "core/scope_exit.h"
 #include "sdk/vardec.h"
 
+#include <algorithm>
+#include <functional>
+#include <string>
 #include <tuple>
+#include <vector>
 
 static const char SHELL[] = "/bin/bash";
 
 using namespace wwiv::bbs;
 
 
-static int ReadWriteNonBinary(int sock, int pty_fd, fd_set& rfd) {
-  if (FD_ISSET(sock, &rfd)) {
-    char input{};
-    if (read(sock, &input, 1) == 0) { 
-      return -1;
-    }
-    if (static_cast<uint8_t>(input) == 0xff) {
-      // IAC, skip over them so we ignore them for now
-      // This was causing the do suppress GA (255, 253, 3)
-      // to get interpreted as a SIGINT by dosemu on startup.
-      LOG(INFO) << "IAC";
-      if (read(sock, &input, 1) == 0) { 
-        return -1;
+// Writes all of data to fd, waiting for it to drain if fd is non-blocking.
+static bool write_fully(int fd, const char* data, std::size_t size) {
+  while (size > 0) {
+    const auto w = write(fd, data, size);
+    if (w < 0) {
+      if (errno == EINTR) {
+        continue;
       }
-      if (read(sock, &input, 1) == 0) { 
-        return -1;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        pollfd pfd{fd, POLLOUT, 0};
+        poll(&pfd, 1, -1);
+        continue;
       }
-      return 0;
+      VLOG(1) << "write failed; fd: " << fd << "; errno: " << errno;
+      return false;
     }
-    if (input == 3) {
-      VLOG(1) << "control-c from user, skipping.";
-      return 0;
-    }
-    VLOG(4) << "Read from Socket: input: " << input << " [" << static_cast<unsigned int>(input)
-	    << "]";
-    write(pty_fd, &input, 1);
-    VLOG(4) << "read from socket, write to term: '" << input << "'";
+    data += w;
+    size -= static_cast<std::size_t>(w);
   }
-  if (FD_ISSET(pty_fd, &rfd)) {
-    char input{};
-    read(pty_fd, &input, 1);
-    if (input == '\n') {
-      VLOG(1) << "Performed LF -> CRLF translation.";
-      write(sock, "\r\n", 2);
-    } else {
-      VLOG(4) << "Read From Terminal: '" << input << "'; [" << static_cast<unsigned>(input) << "]";
-      write(sock, &input, 1);
-    }
+  return true;
+}
+
+// Returns a pidfd for pid, or -1 if the kernel has no pidfd support.
+static int open_pidfd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+  return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+  (void)pid;
+  return -1;
+#endif
+}
+
+// True once pid has exited.  The child is left for wait_for_exit to reap so
+// that its exit status is not lost.
+static bool child_exited(pid_t pid) {
+  siginfo_t info{};
+  if (waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOHANG | WNOWAIT) == -1) {
+    VLOG(2) << "waitid returned -1; errno: " << errno;
+    return errno != EINTR;
   }
-  return 0;
+  return info.si_pid != 0;
 }
 
-static constexpr int READ_SIZE = 1024;
-static int ReadWriteBinary(int sock, int pty_fd, fd_set& rfd) {
-  VLOG(1) << "ReadWriteBinary Loop: << sock: " << sock
-	    << "; pty_fd: " << pty_fd;
-  if (FD_ISSET(sock, &rfd)) {
-    char input[READ_SIZE + 10];
-    const int num_read = read(sock, &input, READ_SIZE);
-    if (num_read > 0) {
-      const auto w = write(pty_fd, &input, num_read);
-      VLOG(1) << "wrote[pty_fd]: " << num_read << ";w:" << w;
+/**
+ * Moves data from one file descriptor to another.  In binary mode on Linux
+ * this uses splice through a pipe so the data never has to be copied into
+ * the BBS, falling back to read and write if either end can not splice.
+ */
+class DoorChannel final {
+public:
+  DoorChannel(int from, int to, bool binary) : from_(from), to_(to), binary_(binary) {
+#ifdef __linux__
+    if (binary_ && pipe2(pipe_, O_CLOEXEC) == 0) {
+      fcntl(pipe_[1], F_SETPIPE_SZ, static_cast<int>(DOOR_IO_BUFFER_SIZE));
     } else {
-      VLOG(1) << "num_read[sock] <= 0; " << num_read;
+      pipe_[0] = pipe_[1] = -1;
     }
+#endif
   }
-  if (FD_ISSET(pty_fd, &rfd)) {
-    char input[READ_SIZE + 10];
-    const int num_read = read(pty_fd, &input, READ_SIZE);
-    if (num_read > 0) {
-      const auto w = write(sock, &input, num_read);
-      VLOG(1) << "wrote[sock]: " << num_read << ";w:" << w;
-    } else {
-      VLOG(1) << "num_read[pty_fd] <= 0; " << num_read;
+  ~DoorChannel() { close_pipe(); }
+  DoorChannel(const DoorChannel&) = delete;
+  DoorChannel& operator=(const DoorChannel&) = delete;
+
+  /**
+   * Moves whatever is available to read.  Returns false once from has
+   * been closed or either end has failed.
+   */
+  bool pump() {
+#ifdef __linux__
+    if (pipe_[0] != -1) {
+      if (const auto r = splice_once(); r >= 0) {
+        return r > 0;
+      }
+      // Splicing isn't supported by one of the ends, so stop trying.
+      VLOG(1) << "splice not supported; errno: " << errno;
+      close_pipe();
+    }
+#endif
+    const auto num_read = read(from_, buf_.data(), buf_.size());
+    if (num_read < 0) {
+      return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    if (num_read == 0) {
+      return false;
     }
+    return write_out(buf_.data(), static_cast<std::size_t>(num_read));
   }
-  return 0;
-}
 
-static void pump_stdio(int sock, int pty_fd, pid_t pid, bool binary) {
-  const auto max_fd = std::max<int>(sock, pty_fd) + 1;
-  for (;;) {
-    fd_set rfd;
-    FD_ZERO(&rfd);
-    if (pty_fd > -1) {
-      FD_SET(pty_fd, &rfd);
+  /** Filter used for data read from the caller in non-binary mode. */
+  std::function<void(const char*, std::size_t, std::string&)> translate;
+
+private:
+  void close_pipe() {
+    for (auto& fd : pipe_) {
+      if (fd != -1) {
+        close(fd);
+        fd = -1;
+      }
     }
-    FD_SET(sock, &rfd);
+  }
 
-    struct timeval tv = {1, 0};
-    auto ret = select(max_fd, &rfd, nullptr, nullptr, &tv);
-    if (ret < 0) {
-      LOG(INFO) << "select returned <0";
-      break;
+  bool write_out(const char* data, std::size_t size) {
+    if (binary_ || !translate) {
+      return write_fully(to_, data, size);
     }
-    // N.B. This has been copied to ExecSocket::process_active
-    int status_code = 0;
-    pid_t wp = waitpid(pid, &status_code, WNOHANG);
-    if (wp == -1 || wp > 0) {
-      // -1 means error and >0 is the pid
-      VLOG(2) << "waitpid returned: " << wp << "; errno: " << errno;
-      if (WIFEXITED(status_code)) {
-        VLOG(1) << "child exited with code: " << WEXITSTATUS(status_code);
-        return;
-      }
-      if (WIFSIGNALED(status_code)) {
-        VLOG(1) << "child caught signal: " << WTERMSIG(status_code);
-      } else {
-        LOG(INFO) << "Raw status_code: " << status_code;
+    out_.clear();
+    translate(data, size, out_);
+    return write_fully(to_, out_.data(), out_.size());
+  }
+
+#ifdef __linux__
+  // Returns the number of bytes moved, 0 at the end of the input or on an
+  // error, and -1 if nothing was moved since splice isn't supported here.
+  ssize_t splice_once() {
+    const auto n = splice(from_, nullptr, pipe_[1], nullptr, DOOR_IO_BUFFER_SIZE,
+                          SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (n < 0) {
+      if (errno == EINVAL) {
+        return -1;
       }
-      LOG(INFO) << "core dump? : " << WCOREDUMP(status_code);
-      return;
+      return (errno == EINTR || errno == EAGAIN) ? 1 : 0;
     }
-
-    if (pty_fd != -1) {
-      // Only do this in STDIO mode.
-      if (binary) {
-        ReadWriteBinary(sock, pty_fd, rfd);
-      } else {
-        if (ReadWriteNonBinary(sock, pty_fd, rfd) == -1) {
-          close(pty_fd);
-          return;
+    for (auto left = n; left > 0;) {
+      const auto w = splice(pipe_[0], nullptr, to_, nullptr, left, SPLICE_F_MOVE);
+      if (w > 0) {
+        left -= w;
+        continue;
+      }
+      if (w < 0 && errno == EINTR) {
+        continue;
+      }
+      if (w < 0 && errno == EINVAL) {
+        // The input is already in the pipe, so copy it out the slow way and
+        // stop splicing from now on.
+        VLOG(1) << "splice not supported for output; errno: " << errno;
+        while (left > 0) {
+          const auto r = read(pipe_[0], buf_.data(), std::min<std::size_t>(left, buf_.size()));
+          if (r <= 0 || !write_fully(to_, buf_.data(), r)) {
+            return 0;
+          }
+          left -= r;
         }
+        close_pipe();
+        return n;
       }
+      return 0;
     }
+    return n;
+  }
+#endif
+
+  const int from_;
+  const int to_;
+  const bool binary_;
+  int pipe_[2]{-1, -1};
+  std::vector<char> buf_ = std::vector<char>(DOOR_IO_BUFFER_SIZE);
+  std::string out_;
+};
+
+static void pump_stdio(int sock, int pty_fd, pid_t pid, bool binary) {
+  if (pty_fd == -1) {
+    return;
   }
+  DoorChannel to_door(sock, pty_fd, binary);
+  DoorChannel from_door(pty_fd, sock, binary);
+  DoorInputFilter input_filter;
+  to_door.translate = [&input_filter](const char* data, std::size_t size, std::string& out) {
+    input_filter.filter(data, size, out);
+  };
+  from_door.translate = append_door_output;
 
+  // The pidfd becomes readable when the door exits.  Without one, wake up
+  // once a second to check on it.
+  const auto pidfd = open_pidfd(pid);
+  wwiv::core::ScopeExit close_pidfd([pidfd] {
+    if (pidfd != -1) {
+      close(pidfd);
+    }
+  });
+  pollfd fds[3]{{sock, POLLIN, 0}, {pty_fd, POLLIN, 0}, {pidfd, POLLIN, 0}};
+  for (;;) {
+    const auto ret = poll(fds, pidfd != -1 ? 3 : 2, pidfd != -1 ? -1 : 1000);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(INFO) << "poll returned <0; errno: " << errno;
+      return;
+    }
+    if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+      if (!from_door.pump()) {
+        // The terminal is closed once the door (and anything it started)
+        // is done with it, so just wait for it to exit.
+        VLOG(1) << "Door closed the terminal.";
+        fds[1].fd = -1;
+      }
+    }
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+      if (!to_door.pump()) {
+        VLOG(1) << "Caller hung up.";
+        close(pty_fd);
+        return;
+      }
+    }
+    if ((pidfd == -1 || fds[2].revents) && child_exited(pid)) {
+      // Pass on anything the door wrote just before exiting.
+      pollfd pfd{pty_fd, POLLIN, 0};
+      while (fds[1].fd != -1 && poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN) &&
+             from_door.pump()) {
+      }
+      VLOG(1) << "Door exited.";
+      return;
+    }
+  }
 }
 
 static int wait_for_exit(pid_t pid) {
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/stl.h"
+#include "fmt/format.h"
+#include "fsed/document.h"
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::fsed;
+using namespace wwiv::stl;
+
+static std::string text(const line_t& l) { return l.to_colored_text(0); }
+
+static std::vector<line_t> numbered_lines(int n) {
+  std::vector<line_t> lines;
+  for (auto i = 0; i < n; i++) {
+    lines.emplace_back(std::to_string(i));
+  }
+  return lines;
+}
+
+TEST(FsedDocumentTest, Empty) {
+  const document_t d;
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(0, d.size());
+  EXPECT_THROW((void)d.at(0), std::out_of_range);
+}
+
+TEST(FsedDocumentTest, PushBack) {
+  document_t d;
+  d.push_back(line_t("a"));
+  d.push_back(line_t("b"));
+  ASSERT_EQ(2, d.size());
+  EXPECT_EQ("a", text(d.at(0)));
+  EXPECT_EQ("b", text(d.at(1)));
+}
+
+TEST(FsedDocumentTest, Insert_SplitsBlocks) {
+  document_t d;
+  const auto n = document_t::MAX_BLOCK_SIZE * 4;
+  // Always insert at the front, so the lines end up in reverse order.
+  for (auto i = 0; i < n; i++) {
+    ASSERT_TRUE(d.insert(0, line_t(std::to_string(i))));
+  }
+  ASSERT_EQ(n, d.size());
+  for (auto i = 0; i < n; i++) {
+    EXPECT_EQ(std::to_string(n - i - 1), text(d.at(i)));
+  }
+  EXPECT_FALSE(d.insert(n + 1, line_t("x")));
+}
+
+TEST(FsedDocumentTest, Assign_Erase) {
+  document_t d;
+  const auto n = document_t::MAX_BLOCK_SIZE * 3 + 7;
+  d.assign(numbered_lines(n));
+  ASSERT_EQ(n, d.size());
+
+  // Remove all of the even numbered lines.
+  for (auto i = 0; i < d.size(); i++) {
+    ASSERT_TRUE(d.erase(i));
+  }
+  ASSERT_EQ(n / 2, d.size());
+  for (auto i = 0; i < d.size(); i++) {
+    EXPECT_EQ(std::to_string(i * 2 + 1), text(d.at(i)));
+  }
+  EXPECT_FALSE(d.erase(d.size()));
+}
+
+TEST(FsedDocumentTest, ForEach) {
+  document_t d;
+  d.assign(numbered_lines(document_t::MAX_BLOCK_SIZE * 2));
+  d.insert(5, line_t("x"));
+
+  std::vector<std::string> all;
+  d.for_each([&](const line_t& l) { all.push_back(text(l)); });
+  ASSERT_EQ(d.size(), ssize(all));
+  EXPECT_EQ("4", all.at(4));
+  EXPECT_EQ("x", all.at(5));
+  EXPECT_EQ("5", all.at(6));
+}
@@ -137,3 +137,69 @@ TEST_F(FsedModelTest, BackSpace_Color) {
   // Now 0 since we went to the end.
   EXPECT_EQ(0, ed.curline().wwiv_color());
 }
+
+TEST_F(FsedModelTest, Undo_Typing) {
+  add("Hello");
+  EXPECT_TRUE(ed.can_undo());
+  ASSERT_TRUE(ed.undo());
+  EXPECT_EQ(0, ed.cx);
+  EXPECT_EQ(0, wwiv::stl::ssize(ed.curline()));
+  EXPECT_FALSE(ed.can_undo());
+
+  ASSERT_TRUE(ed.redo());
+  EXPECT_EQ(5, ed.cx);
+  EXPECT_EQ(std::vector<std::string>{"Hello"}, ed.to_lines());
+}
+
+TEST_F(FsedModelTest, Undo_Enter) {
+  add("Hello World");
+  ed.cx = 5;
+  ed.enter();
+  EXPECT_EQ(2, wwiv::stl::ssize(ed));
+
+  ASSERT_TRUE(ed.undo());
+  EXPECT_EQ(1, wwiv::stl::ssize(ed));
+  EXPECT_EQ(0, ed.curli);
+  EXPECT_EQ(5, ed.cx);
+  EXPECT_EQ(std::vector<std::string>{"Hello World"}, ed.to_lines());
+
+  ASSERT_TRUE(ed.redo());
+  const std::vector<std::string> expected{"Hello", " World"};
+  EXPECT_EQ(expected, ed.to_lines());
+  EXPECT_EQ(1, ed.curli);
+}
+
+TEST_F(FsedModelTest, Undo_DeleteLine) {
+  add("a\nb\nc");
+  ed.cursor_up();
+  ed.delete_line();
+  const std::vector<std::string> deleted{"a", "c"};
+  EXPECT_EQ(deleted, ed.to_lines());
+
+  ASSERT_TRUE(ed.undo());
+  const std::vector<std::string> expected{"a", "b", "c"};
+  EXPECT_EQ(expected, ed.to_lines());
+}
+
+TEST_F(FsedModelTest, Undo_NewEditClearsRedo) {
+  add("a\nb");
+  ASSERT_TRUE(ed.undo());
+  EXPECT_TRUE(ed.can_redo());
+  add("c");
+  EXPECT_FALSE(ed.can_redo());
+}
+
+TEST_F(FsedModelTest, LargeMessage) {
+  wwiv::fsed::FsedModel big(50000);
+  big.set_view(view);
+  for (auto i = 0; i < 20000; i++) {
+    big.emplace_back(wwiv::fsed::line_t(fmt::format("Line-{}", i)));
+  }
+  big.curli = 10000;
+  big.cx = 0;
+  big.enter();
+  EXPECT_EQ(20001, wwiv::stl::ssize(big));
+  EXPECT_EQ(0, wwiv::stl::ssize(big.line(10000)));
+  EXPECT_EQ("Line-10000", big.line(10001).to_colored_text(0));
+  EXPECT_EQ("Line-19999", big.line(20000).to_colored_text(0));
+}
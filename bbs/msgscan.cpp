@@ -61,6 +61,7 @@
 #include "sdk/usermanager.h"
 #include "sdk/msgapi/message.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_header_cache.h"
 
 #include <algorithm>
 #include <memory>
@@ -270,41 +271,40 @@ static FullScreenView CreateFullScreenListTitlesView() {
   return FullScreenView(bout, bin, num_header_lines, screen_width, screen_length);
 }
 
-static std::string CreateLine(std::unique_ptr<Message>&& msg, const int msgnum) {
-  if (!msg) {
+static std::string CreateLine(const std::optional<message_header_summary_t>& header,
+                              const int msgnum) {
+  if (!header) {
     return "";
   }
   std::string tmpbuf;
-  const auto& h = msg->header();
-  if (h.local() && h.from_usernum() == a()->sess().user_num()) {
+  const auto& h = header.value();
+  if (h.local && h.from_usernum == a()->sess().user_num()) {
     tmpbuf = fmt::sprintf("|09[|11%d|09]", msgnum);
-  } else if (!h.local()) {
+  } else if (!h.local) {
     tmpbuf = fmt::sprintf("|09<|11%d|09>", msgnum);
   } else {
     tmpbuf = fmt::sprintf("|09(|11%d|09)", msgnum);
   }
   std::string line = "       ";
-  if (h.storage_type() == 2) {
+  if (h.storage_type == 2) {
     // HACK: Need to make this generic. this before supporting JAM.
-    // N.B. If for some reason dynamic_cast fails, a std::bad_cast is thrown.
-    const auto& wh = dynamic_cast<const WWIVMessageHeader&>(h);
-    if (wh.last_read() > a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()]) {
+    if (h.last_read > a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()]) {
       line[0] = '*';
     }
   }
-  if (h.pending_network() || h.unvalidated()) {
+  if (h.pending_network || h.unvalidated) {
     line[0] = '+';
   }
   const auto tmpbuf_size = size_without_colors(tmpbuf);
   line.resize(std::max<int>(0, 9 - tmpbuf_size));
   line += tmpbuf;
   line += "|11 ";
-  if ((h.unvalidated() || h.deleted()) && !lcs()) {
+  if ((h.unvalidated || h.deleted) && !lcs()) {
     line += "<<< NOT VALIDATED YET >>>";
   } else {
-    // Need the StringTrim on post title since some FSEDs
-    // added \r in the title string, also gets rid of extra spaces
-    line += trim_to_size_ignore_colors(StringTrim(h.title()), 60);
+    // The cached title has already been trimmed, since some FSEDs
+    // added \r in the title string.
+    line += trim_to_size_ignore_colors(h.title, 60);
   }
 
   if (a()->user()->screen_width() >= 80) {
@@ -317,19 +317,26 @@ static std::string CreateLine(std::unique_ptr<Message>&& msg, const int msgnum)
     } else {
       line += "| ";
     }
-    if ((h.anony() & 0x0f) && ((a()->config()->sl(a()->sess().effective_sl()).ability & ability_read_post_anony) == 0)) {
+    if ((h.anony & 0x0f) && ((a()->config()->sl(a()->sess().effective_sl()).ability & ability_read_post_anony) == 0)) {
       line += ">UNKNOWN<";
     } else {
-      line += trim_to_size_ignore_colors(h.from(), 25);
+      line += trim_to_size_ignore_colors(h.from, 25);
     }
   }
   return line;
 }
 
+static AreaHeaderCache& current_sub_header_cache(MessageArea& area) {
+  const auto status = a()->status_manager()->get_status();
+  return a()->msg_header_cache().area(a()->current_sub().filename, area.number_of_messages(),
+                                      status->qscanptr());
+}
+
 static std::vector<std::string> CreateMessageTitleVector(MessageArea* area, int start, int num) {
+  auto& headers = current_sub_header_cache(*area);
   std::vector<std::string> lines;
   for (auto i = start; i < start + num; i++) {
-    if (auto line = CreateLine(area->ReadMessage(i), i); !line.empty()) {
+    if (auto line = CreateLine(headers.get(*area, i), i); !line.empty()) {
       lines.push_back(line);
     }
   }
@@ -584,10 +591,11 @@ static void HandleListTitles(int& msgnum, MsgScanOption& scan_option_type) {
        << std::string(a()->user()->screen_width() - 3, static_cast<unsigned char>(205))
        << static_cast<unsigned char>(181) << "\r\n";
   const auto num_title_lines = std::max<int>(a()->sess().num_screen_lines() - 6, 1);
+  auto& headers = current_sub_header_cache(*area);
   auto i = 0;
   while (!abort && ++i <= num_title_lines) {
     ++msgnum;
-    const auto line = CreateLine(area->ReadMessage(msgnum), msgnum);
+    const auto line = CreateLine(headers.get(*area, msgnum), msgnum);
     bout.bpla(line, &abort);
     if (msgnum >= num_msgs_in_area) {
       abort = true;
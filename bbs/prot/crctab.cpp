@@ -2,6 +2,10 @@
  *  Crc calculation stuff
  */
 
+#include "bbs/prot/crctab.h"
+
+#include <cstring>
+
 /* crctab calculated by Mark G. Mendel, Network Systems Corporation */
 unsigned short crctab[256] = {
     0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7, 0x8108, 0x9129, 0xa14a, 0xb16b,
@@ -118,6 +122,55 @@ unsigned long cr3tab[] =
      0xcdd70693, 0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
      0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
 
-#define UPDC32(b, c) (cr3tab[((int)c ^ b) & 0xff] ^ ((c >> 8) & 0x00FFFFFF))
+/* Tables for computing the 32 bit crc eight bytes at a time ("slicing
+ * by 8").  Table 0 is cr3tab, and table n is the crc of a byte followed
+ * by n zero bytes.
+ */
+struct crc32_slice_tables {
+  uint32_t t[8][256];
+
+  crc32_slice_tables() {
+    for (int i = 0; i < 256; i++) {
+      t[0][i] = static_cast<uint32_t>(cr3tab[i]);
+    }
+    for (int i = 0; i < 256; i++) {
+      for (int n = 1; n < 8; n++) {
+        t[n][i] = (t[n - 1][i] >> 8) ^ t[0][t[n - 1][i] & 0xff];
+      }
+    }
+  }
+};
+
+static const crc32_slice_tables& slice_tables() {
+  static const crc32_slice_tables tables;
+  return tables;
+}
+
+uint32_t updcrc32_buf(const unsigned char* buf, size_t len, uint32_t crc) {
+  const auto& t = slice_tables().t;
+  while (len >= 8) {
+    // Assemble little endian words by hand so this works the same on
+    // any byte order.
+    const uint32_t lo = crc ^ (static_cast<uint32_t>(buf[0]) | static_cast<uint32_t>(buf[1]) << 8 |
+                               static_cast<uint32_t>(buf[2]) << 16 |
+                               static_cast<uint32_t>(buf[3]) << 24);
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+          t[3][buf[4]] ^ t[2][buf[5]] ^ t[1][buf[6]] ^ t[0][buf[7]];
+    buf += 8;
+    len -= 8;
+  }
+  while (len-- > 0) {
+    crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+uint16_t updcrc16_buf(const unsigned char* buf, size_t len, uint16_t crc) {
+  unsigned int c = crc;
+  while (len-- > 0) {
+    c = updcrc(*buf++, c);
+  }
+  return static_cast<uint16_t>(c);
+}
 
 /* End of crctab.c */
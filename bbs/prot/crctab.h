@@ -4,6 +4,9 @@
  *  Crc calculation stuff.  See crctab.c
  */
 
+#include <cstddef>
+#include <cstdint>
+
 extern unsigned short crctab[256];
 
 #define updcrc(cp, crc) (crctab[((crc >> 8) & 255)] ^ (crc << 8) ^ cp)
@@ -11,3 +14,13 @@ extern unsigned short crctab[256];
 extern unsigned long cr3tab[];
 
 #define UPDC32(b, c) (cr3tab[((int)c ^ b) & 0xff] ^ ((c >> 8) & 0x00FFFFFF))
+
+/* Updates crc with len bytes of buf.  Equivalent to calling UPDC32 for
+ * each byte, only faster.
+ */
+uint32_t updcrc32_buf(const unsigned char* buf, size_t len, uint32_t crc);
+
+/* Updates crc with len bytes of buf, the same as calling updcrc for each
+ * byte.
+ */
+uint16_t updcrc16_buf(const unsigned char* buf, size_t len, uint16_t crc);
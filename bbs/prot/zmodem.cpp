@@ -75,6 +75,38 @@ extern int YsendChar(char c, ZModem* info);
 int ZProtocol(ZModem* info);
 int ZDataReceived(ZModem* info, int crcGood);
 
+/* Fast path for the body of a data subpacket.  Copies the run of bytes
+ * at the start of str that need no special handling into the buffer,
+ * updating the crc for all of them at once.  Returns the number of
+ * bytes used, which may be 0.
+ */
+static int DataRun(const u_char* str, int len, ZModem* info) {
+  if (info->escape || info->crcCount != 0 || info->buflen == 0 ||
+      (info->DataType != ZBIN && info->DataType != ZBIN32)) {
+    return 0;
+  }
+  const auto room = info->buflen - info->chrCount;
+  if (len > room) {
+    len = room;
+  }
+  int n = 0;
+  while (n < len && str[n] != ZDLE && str[n] != XON && str[n] != XOFF) {
+    ++n;
+  }
+  if (n == 0) {
+    return 0;
+  }
+  memcpy(info->buffer + info->chrCount, str, n);
+  info->chrCount += n;
+  if (info->DataType == ZBIN) {
+    info->crc = updcrc16_buf(str, n, static_cast<uint16_t>(info->crc));
+  } else {
+    info->crc = updcrc32_buf(str, n, info->crc);
+  }
+  info->canCount = 0;
+  return n;
+}
+
 int ZmodemRcv(u_char* str, int len, ZModem* info) {
   int err;
 
@@ -82,6 +114,13 @@ int ZmodemRcv(u_char* str, int len, ZModem* info) {
   info->rcvlen = len;
 
   while (--info->rcvlen >= 0) {
+    if (info->InputState == ZModem::Indata) {
+      if (const auto n = DataRun(str, info->rcvlen + 1, info); n > 0) {
+        str += n;
+        info->rcvlen -= n - 1;
+        continue;
+      }
+    }
     const auto c = *str++;
 
     if (c == CAN) {
@@ -357,6 +396,12 @@ int DataChar(u_char c, ZModem* info) {
     }
   }
 
+  if (info->crcCount == 0 && info->buflen != 0 && info->chrCount >= info->buflen) {
+    /* subpacket is larger than we can hold, treat it as garbled */
+    zmodemlog("DataChar: subpacket too large [chrCount: {}]\n", info->chrCount);
+    return ZDataReceived(info, 0);
+  }
+
   switch (info->DataType) {
   /* TODO: are hex data packets ever used? */
   case ZBIN:
@@ -60,6 +60,9 @@
   64               /* max "noise" characters before transmission                                   \
                     * pauses */
 #define MaxErrs 20 /* Max receive errors before cancel */
+#define ZMinSubpacket 1024 /* transmit subpackets start at this size */
+#define ZMaxSubpacket 8192 /* largest subpacket sent or received (ZMODEM-8K) */
+#define ZGrowAfter 8       /* double the subpacket size after this many clean ones */
 
 /* always send ZSINIT header, even if not                                                      \
  * needed, this makes protocol more robust */
@@ -165,6 +168,10 @@ struct ZModem {
   int noiseCount;     /* how many noise chars received? */
   int errorFlush;     /* ignore incoming data because of error */
   u_char* buffer;     /* data buffer */
+  int buflen;         /* allocated size of buffer, 0 if unknown */
+  u_char* filebuf;    /* unescaped file data for the next subpacket */
+  int subpacketSize;  /* current transmit subpacket size, <= packetsize */
+  int goodCount;      /* subpackets sent since the last error */
   uint32_t offset;      /* file offset */
   uint32_t lastOffset;  /* last acknowledged offset */
   uint32_t zrposOffset; /* last offset specified w/zrpos */
@@ -0,0 +1,250 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "bbs/prot/crctab.h"
+#include "bbs/prot/zmodem.h"
+#include "core/test/file_helper.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono;
+using namespace wwiv::core::test;
+
+// The callbacks used by the zmodem engine.  The bbs provides these in
+// zmwwiv.cpp, here both ends of the transfer talk over info->ofd and
+// received files are written to receive_dir.
+
+static std::filesystem::path receive_dir;
+
+int ZXmitStr(const u_char* str, int len, ZModem* info) {
+  while (len > 0) {
+    const auto n = ::write(info->ofd, str, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ZmErrSys;
+    }
+    str += n;
+    len -= static_cast<int>(n);
+  }
+  return 0;
+}
+
+void ZIFlush(ZModem*) {}
+void ZOFlush(ZModem*) {}
+int ZAttn(ZModem*) { return 0; }
+void ZFlowControl(int, ZModem*) {}
+void ZStatus(int, int, char*) {}
+void ZIdleStr(u_char*, int, ZModem*) {}
+
+FILE* ZOpenFile(char* name, uint32_t, ZModem*) {
+  return fopen((receive_dir / name).string().c_str(), "wb");
+}
+
+int ZWriteFile(u_char* buffer, int len, FILE* file, ZModem*) {
+  return fwrite(buffer, 1, len, file) == static_cast<size_t>(len) ? 0 : ZmErrSys;
+}
+
+int ZCloseFile(ZModem* info) {
+  fclose(info->file);
+  return 0;
+}
+
+// Feeds input from info->ifd to the engine until it finishes, the same
+// way doIO does in zmwwiv.cpp.
+static int pump(ZModem* info) {
+  std::vector<u_char> buf(ZMaxSubpacket * 2);
+  for (;;) {
+    pollfd p{info->ifd, POLLIN, 0};
+    const auto r = poll(&p, 1, info->timeout > 0 ? info->timeout * 1000 : 0);
+    int done;
+    if (r > 0) {
+      const auto n = ::read(info->ifd, buf.data(), buf.size());
+      if (n <= 0) {
+        return ZmErrSys;
+      }
+      done = ZmodemRcv(buf.data(), static_cast<int>(n), info);
+    } else {
+      done = ZmodemTimeout(info);
+    }
+    if (done) {
+      return done;
+    }
+  }
+}
+
+class ZModemLoopbackTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+    receive_dir = helper_.Dir("received");
+    std::filesystem::create_directories(receive_dir);
+  }
+
+  void TearDown() override {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  // Sends contents from one end of the socket pair to the other, returning
+  // the contents of the file written by the receiver.
+  std::string Transfer(const std::string& contents, int zrinitflags = CANFDX | CANOVIO | CANFC32) {
+    // FileHelper::CreateTempFile stops at the first NUL.
+    const auto path = helper_.CreateTempFilePath("DATA.BIN");
+    auto* f = fopen(path.string().c_str(), "wb");
+    fwrite(contents.data(), 1, contents.size(), f);
+    fclose(f);
+
+    int receive_result = 0;
+    std::thread receiver([&] {
+      ZModem info{};
+      info.ifd = info.ofd = fds_[1];
+      info.zrinitflags = zrinitflags;
+      ZmodemRInit(&info);
+      receive_result = pump(&info);
+    });
+
+    ZModem info{};
+    info.ifd = info.ofd = fds_[0];
+    info.packetsize = ZMaxSubpacket;
+    info.windowsize = 128 * 1024;
+    ZmodemTInit(&info);
+    auto done = pump(&info);
+    EXPECT_EQ(ZmDone, done);
+    const auto fn = path.string();
+    done = ZmodemTFile(fn.c_str(), "DATA.BIN", ZCBIN, 0, 0, 0, 0, 0, &info);
+    if (!done) {
+      done = pump(&info);
+    }
+    EXPECT_EQ(ZmDone, done);
+    done = ZmodemTFinish(&info);
+    if (!done) {
+      done = pump(&info);
+    }
+    EXPECT_EQ(ZmDone, done);
+    receiver.join();
+    EXPECT_EQ(ZmDone, receive_result);
+
+    return helper_.ReadFile(receive_dir / "DATA.BIN");
+  }
+
+  static std::string RandomBytes(int size) {
+    std::mt19937 rng(size);
+    std::string s(size, '\0');
+    for (auto& c : s) {
+      c = static_cast<char>(rng() & 0xff);
+    }
+    return s;
+  }
+
+  FileHelper helper_;
+  int fds_[2]{-1, -1};
+};
+
+TEST(ZModemCrcTest, Crc32_MatchesBytewise) {
+  std::mt19937 rng(1);
+  std::vector<u_char> data(1000);
+  for (auto& c : data) {
+    c = static_cast<u_char>(rng() & 0xff);
+  }
+  for (auto start = 0; start < 8; start++) {
+    for (auto len : {0, 1, 7, 8, 9, 63, 64, 500, 992}) {
+      uint32_t expected = 0xffffffff;
+      for (auto i = 0; i < len; i++) {
+        expected = UPDC32(data[start + i], expected);
+      }
+      EXPECT_EQ(expected, updcrc32_buf(&data[start], len, 0xffffffff))
+          << "start: " << start << "; len: " << len;
+    }
+  }
+}
+
+TEST(ZModemCrcTest, Crc32_Check) {
+  const std::string s = "123456789";
+  EXPECT_EQ(0xcbf43926u,
+            ~updcrc32_buf(reinterpret_cast<const u_char*>(s.data()), s.size(), 0xffffffff));
+}
+
+TEST(ZModemCrcTest, Crc16_MatchesBytewise) {
+  const std::string s = "The quick brown fox jumps over the lazy dog";
+  uint32_t expected = 0;
+  for (const auto c : s) {
+    expected = updcrc(static_cast<u_char>(c), expected);
+  }
+  EXPECT_EQ(expected & 0xffff,
+            updcrc16_buf(reinterpret_cast<const u_char*>(s.data()), s.size(), 0));
+}
+
+TEST_F(ZModemLoopbackTest, SmallFile) {
+  const std::string contents = "Hello World\r\n";
+  EXPECT_EQ(contents, Transfer(contents));
+}
+
+TEST_F(ZModemLoopbackTest, EmptyFile) {
+  EXPECT_EQ("", Transfer(""));
+}
+
+TEST_F(ZModemLoopbackTest, EveryByte) {
+  std::string contents;
+  for (auto i = 0; i < 64; i++) {
+    for (auto c = 0; c < 256; c++) {
+      contents.push_back(static_cast<char>(c));
+    }
+  }
+  EXPECT_EQ(contents, Transfer(contents));
+}
+
+TEST_F(ZModemLoopbackTest, LargeFile) {
+  // Large enough for the subpackets to grow to their largest size.
+  const auto contents = RandomBytes(1024 * 1024 + 17);
+  EXPECT_EQ(contents, Transfer(contents));
+}
+
+TEST_F(ZModemLoopbackTest, EscapeControlCharacters) {
+  const auto contents = RandomBytes(100 * 1024);
+  EXPECT_EQ(contents, Transfer(contents, CANFDX | CANOVIO | CANFC32 | ESCCTL));
+}
+
+TEST_F(ZModemLoopbackTest, Crc16) {
+  const auto contents = RandomBytes(100 * 1024);
+  EXPECT_EQ(contents, Transfer(contents, CANFDX | CANOVIO));
+}
+
+// Measures the throughput of a transfer between the sender and receiver.
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(ZModemLoopbackTest, DISABLED_Benchmark) {
+  static constexpr int SIZE = 64 * 1024 * 1024;
+  const auto contents = RandomBytes(SIZE);
+  const auto start = steady_clock::now();
+  const auto received = Transfer(contents);
+  const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start).count();
+  EXPECT_EQ(contents.size(), received.size());
+  std::cout << "ZModem loopback: " << SIZE / (1024 * 1024) << " MB in " << elapsed << " ms: "
+            << (SIZE / 1024.0) / std::max<int64_t>(1, elapsed) << " MB/s\n";
+}
@@ -60,7 +60,8 @@ int ZmodemRInit(ZModem* info) {
   info->attn = nullptr;
   info->file = nullptr;
 
-  info->buffer = (u_char*)malloc(8192);
+  info->buffer = (u_char*)malloc(ZMaxSubpacket);
+  info->buflen = ZMaxSubpacket;
 
   info->state = RStart;
   info->timeoutCount = 0;
@@ -89,6 +90,7 @@ int YmodemRInit(ZModem* info) {
 
   if (info->buffer == nullptr) {
     info->buffer = (u_char*)malloc(1024);
+    info->buflen = 1024;
   }
 
   info->state = YRStart;
@@ -207,17 +207,28 @@ int ZmodemTInit(ZModem* info) {
 
   if (info->packetsize == 0) {
     info->packetsize = 1024;
+  } else if (info->packetsize > ZMaxSubpacket) {
+    info->packetsize = ZMaxSubpacket;
   }
 
+  /* start with small subpackets and grow them while the line is
+   * clean, see SendMoreFileData.
+   */
+  info->subpacketSize = info->packetsize < ZMinSubpacket ? info->packetsize : ZMinSubpacket;
+  info->goodCount = 0;
+
   /* we won't be receiving much data, pick a reasonable buffer
-   * size (largest packet will do)
+   * size (largest packet will do).  Every byte of a subpacket may
+   * need to be escaped, and the crc follows it.
    */
 
-  auto i = info->packetsize * 2;
+  auto i = info->packetsize * 2 + 32;
   if (i < 1024) {
     i = 1024;
   }
   info->buffer = static_cast<u_char*>(malloc(i));
+  info->buflen = i;
+  info->filebuf = static_cast<u_char*>(malloc(info->packetsize));
 
   ZIFlush(info);
 
@@ -258,6 +269,7 @@ int YmodemTInit(ZModem* info) {
   }
 
   info->buffer = (u_char*)malloc(1024);
+  info->buflen = 1024;
 
   ZIFlush(info);
   ZFlowControl(0, info);
@@ -366,6 +378,11 @@ int ZmodemTFinish(ZModem* info) {
   if (info->buffer != nullptr) {
     free(info->buffer);
     info->buffer = nullptr;
+    info->buflen = 0;
+  }
+  if (info->filebuf != nullptr) {
+    free(info->filebuf);
+    info->filebuf = nullptr;
   }
 #if defined(_DEBUG)
   zmodemlog("ZmodemTFinish[{}]: send ZFIN\n", sname(info));
@@ -592,6 +609,11 @@ int SkipFile(ZModem* info) {
 int GotSendPos(ZModem* info) {
   ZStatus(DataErr, ++info->errCount, nullptr);
   info->waitflag = 1; /* next pkt should wait, to resync */
+  /* the line is noisy, go back to small subpackets */
+  if (info->subpacketSize > ZMinSubpacket) {
+    info->subpacketSize = ZMinSubpacket;
+  }
+  info->goodCount = 0;
 #if defined(_DEBUG)
   zmodemlog("GotSendPos[{}]\n", sname(info), info->offset);
 #endif
@@ -623,6 +645,55 @@ int GotSendWaitAck(ZModem* info) {
   return SendMoreFileData(info);
 }
 
+/* Which bytes must be escaped in file data.  The zmodem protocol
+ * requires that CAN(ZDLE), DLE, XON, XOFF and a CR following '@' be
+ * escaped.  In addition, I escape '^]' to protect telnet, CR and LF to
+ * protect rlogin, and ESC for good measure.  The second table is used
+ * when the receiver asks for all control characters to be escaped.
+ */
+struct escape_tables {
+  bool esc[2][256];
+
+  escape_tables() {
+    for (int c = 0; c < 256; c++) {
+      const int c2 = c & 0177;
+      esc[0][c] = c == ZDLE || c2 == 020 || c2 == 021 || c2 == 023 || c2 == 0177 ||
+                  c2 == '\r' || c2 == '\n' || c2 == 033 || c2 == 035;
+      esc[1][c] = esc[0][c] || c2 < 040;
+    }
+  }
+};
+
+/* utility: ZDLE escape len bytes of data into ptr, returning the new end
+ * of ptr.  Runs of bytes that need no escaping are copied as a block.
+ */
+static u_char* escapeData(u_char* ptr, const u_char* data, int len, int escCtrl) {
+  static const escape_tables tables;
+  const bool* esc = tables.esc[escCtrl ? 1 : 0];
+  const u_char* end = data + len;
+  while (data < end) {
+    const u_char* run = data;
+    while (data < end && !esc[*data]) {
+      ++data;
+    }
+    memcpy(ptr, run, data - run);
+    ptr += data - run;
+    if (data == end) {
+      break;
+    }
+    const u_char c = *data++;
+    *ptr++ = ZDLE;
+    if (c == 0177) {
+      *ptr++ = ZRUB0;
+    } else if (c == 0377) {
+      *ptr++ = ZRUB1;
+    } else {
+      *ptr++ = c ^ 0100;
+    }
+  }
+  return ptr;
+}
+
 /* utility: send a chunk of file data.  Whether this is followed
  * by a ZCRCE, ZCRCG, ZCRCQ or ZCRCW depends on all
  * sorts of protocol flags, plus 'waitflag'.  Exact amount of file
@@ -654,7 +725,7 @@ int SendMoreFileData(ZModem* info) {
 
   /* Find out how many bytes we can transfer in the next packet */
 
-  len = info->packetsize;
+  len = info->subpacketSize;
 
   pending = info->offset - info->lastOffset;
 
@@ -716,57 +787,28 @@ int SendMoreFileData(ZModem* info) {
   }
 
   int crc32 = info->crc32;
-  int c = 0, c2, atSign = 0;
   uint32_t crc;
   u_char* ptr = info->buffer;
 
-  crc = crc32 ? 0xffffffff : 0;
-
-  /* read characters from file and put into buffer until buffer is
-   * full or file is exhausted
+  /* read the whole subpacket from the file, then escape it into the
+   * output buffer.
    */
-
-  while (len > 0 && (c = getc(info->file)) != EOF) {
-    if (!crc32) {
-      crc = updcrc(c, crc);
-    } else {
-      crc = UPDC32(c, crc);
-    }
-
-    /* zmodem protocol requires that CAN(ZDLE), DLE, XON, XOFF and
-     * a CR following '@' be escaped.  In addition, I escape '^]'
-     * to protect telnet, "<CR>~." to protect rlogin, and ESC for good
-     * measure.
-     */
-    c2 = c & 0177;
-    if (c == ZDLE || c2 == 020 || c2 == 021 || c2 == 023 || c2 == 0177 || c2 == '\r' ||
-        c2 == '\n' || c2 == 033 || c2 == 035 || (c2 < 040 && info->escCtrl)) {
-      *ptr++ = ZDLE;
-      if (c == 0177) {
-        *ptr = ZRUB0;
-      } else if (c == 0377) {
-        *ptr = ZRUB1;
-      } else {
-        *ptr = c ^ 0100;
-      }
-      len -= 2;
-    } else {
-      *ptr = c;
-      --len;
-    }
-    ++ptr;
-
-    atSign = c2 == '@';
-    ++info->offset;
+  const auto count = static_cast<int>(fread(info->filebuf, 1, len, info->file));
+  if (!crc32) {
+    crc = updcrc16_buf(info->filebuf, count, 0);
+  } else {
+    crc = updcrc32_buf(info->filebuf, count, 0xffffffff);
   }
+  ptr = escapeData(ptr, info->filebuf, count, info->escCtrl);
+  info->offset += count;
 
   /* if we've reached file end, a ZEOF header will follow.  If
    * there's room in the outgoing buffer for it, end the packet
    * with ZCRCE and append the ZEOF header.  If there isn't room,
    * we'll have to do a ZCRCW
    */
-  if ((info->fileEof = (c == EOF))) {
-    if (qfull || (info->bufsize != 0 && len < 24)) {
+  if ((info->fileEof = (count < len))) {
+    if (qfull || (info->bufsize != 0 && len - count < 24)) {
       type = ZCRCW;
     } else {
       type = ZCRCE;
@@ -797,6 +839,15 @@ int SendMoreFileData(ZModem* info) {
 
   ZStatus(SndByteCount, info->offset, nullptr);
 
+  /* the line is clean, try a bigger subpacket next time */
+  if (++info->goodCount >= ZGrowAfter && info->subpacketSize < info->packetsize) {
+    info->subpacketSize *= 2;
+    if (info->subpacketSize > info->packetsize) {
+      info->subpacketSize = info->packetsize;
+    }
+    info->goodCount = 0;
+  }
+
   if ((err = ZXmitStr(info->buffer, len, info))) {
     return err;
   }
@@ -33,6 +33,7 @@
 #include <chrono>
 #include <cstring>
 #include <filesystem>
+#include <optional>
 
 using std::chrono::milliseconds;
 using namespace wwiv::core;
@@ -94,14 +95,55 @@ static void ProcessLocalKeyDuringZmodem() {
   }
 }
 
+// Largest amount of unacknowledged data the sender will have in flight.
+// The receiver is asked to ZACK every quarter of this.
+static constexpr int ZMODEM_SEND_WINDOW_SIZE = 128 * 1024;
+
+// Only update the byte counts on the local screen this often, drawing
+// them for every subpacket costs more than sending it.
+static constexpr auto ZMODEM_STATUS_INTERVAL = milliseconds(250);
+
+/**
+ * Limits how often ZStatus draws the byte counts of one transfer.  Each
+ * transfer has its own, so the first counts of a transfer are never
+ * skipped because of when the last transfer drew its counts.
+ */
+class ByteCountTimer final {
+public:
+  ByteCountTimer() : previous_(current_) { current_ = this; }
+  ~ByteCountTimer() { current_ = previous_; }
+  ByteCountTimer(const ByteCountTimer&) = delete;
+  ByteCountTimer& operator=(const ByteCountTimer&) = delete;
+
+  /** Returns true if the byte count of the current transfer should be drawn now. */
+  static bool should_update() {
+    if (current_ == nullptr) {
+      return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (current_->last_ && now - *current_->last_ < ZMODEM_STATUS_INTERVAL) {
+      return false;
+    }
+    current_->last_ = now;
+    return true;
+  }
+
+private:
+  static inline ByteCountTimer* current_{nullptr};
+  ByteCountTimer* previous_;
+  std::optional<std::chrono::steady_clock::time_point> last_;
+};
+
 bool NewZModemSendFile(const std::filesystem::path& path) {
+  ByteCountTimer timer;
   ZModem info{};
   info.ifd = info.ofd = -1;
   info.zrinitflags = 0;
   info.zsinitflags = 0;
   info.attn = nullptr;
-  info.packetsize = 0;
-  info.windowsize = 0;
+  // Subpackets larger than 1K are ZMODEM-8K, which not every client handles.
+  info.packetsize = a()->IsUseZmodem8K() ? ZMaxSubpacket : ZMinSubpacket;
+  info.windowsize = ZMODEM_SEND_WINDOW_SIZE;
   info.bufsize = 0;
 
   sleep_for(milliseconds(500)); // Kludge -- Byte thinks this may help on his system
@@ -161,6 +203,7 @@ bool NewZModemSendFile(const std::filesystem::path& path) {
 }
 
 bool NewZModemReceiveFile(const std::filesystem::path& path){
+  ByteCountTimer timer;
   ZModem info{};
   info.ifd = info.ofd = -1;
   info.zsinitflags = 0;
@@ -302,6 +345,9 @@ void ZFlowControl(int /* onoff */, ZModem* /* info */) {
 }
 
 void ZStatus(int type, int value, char* msg) {
+  if ((type == RcvByteCount || type == SndByteCount) && !ByteCountTimer::should_update()) {
+    return;
+  }
   switch (type) {
   case RcvByteCount:
     ZModemWindowXferStatus("ZModemWindowXferStatus: {} bytes received", value);
@@ -33,6 +33,7 @@
 #include "bbs/sysoplog.h"
 #include "bbs/utility.h"
 #include "bbs/qwk/qwk_email.h"
+#include "bbs/qwk/qwk_sub_reader.h"
 #include "bbs/qwk/qwk_ui.h"
 #include "bbs/qwk/qwk_util.h"
 #include "common/input.h"
@@ -53,6 +54,9 @@
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
 #include "sdk/ansi/makeansi.h"
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::stl;
@@ -206,14 +210,38 @@ void build_qwk_packet() {
          << '\xC5' << std::string(8, '\xC4') << '\xB4' << wwiv::endl;
   }
 
-  bool msgs_ok = true;
-  for (uint16_t i = 0; i < a()->usub.size() && !a()->sess().hangup() && !qwk_info.abort && msgs_ok; i++) {
-    msgs_ok = max_msgs ? qwk_info.qwk_rec_num <= max_msgs : true;
-    if (a()->sess().qsc_q[a()->usub[i].subnum / 32] & (1L << (a()->usub[i].subnum % 32))) {
-      qwk_gather_sub(i, &qwk_info);
+  // Any message posted after this is left for the next packet.
+  const auto qscanptr = a()->status_manager()->get_status()->qscanptr();
+  std::vector<qwk_sub_request_t> requests;
+  for (auto i = 0; i < size_int(a()->usub); i++) {
+    const auto sn = a()->usub[i].subnum;
+    if (a()->sess().qsc_q[sn / 32] & (1L << (sn % 32))) {
+      qwk_sub_request_t r{};
+      r.usub = i;
+      r.subnum = sn;
+      r.filename = a()->subs().sub(sn).filename;
+      r.qscan_pointer = a()->sess().qsc_p[sn];
+      r.qscan_limit = qscanptr;
+      r.max_msgs = a()->user()->data.qwk_max_msgs_per_sub;
+      r.include_unvalidated = lcs();
+      requests.emplace_back(std::move(r));
     }
   }
 
+  // The subs are read by worker threads while the ones already read are
+  // added to the packet here, since that uses the session state.
+  const auto jobs = QwkSubReader::default_jobs();
+  QwkSubReader reader(a()->config()->datadir(), a()->config()->msgsdir(), std::move(requests),
+                      jobs, jobs * 2);
+  while (!a()->sess().hangup() && !qwk_info.abort &&
+         (!max_msgs || qwk_info.qwk_rec_num <= max_msgs)) {
+    auto sub = reader.next();
+    if (!sub) {
+      break;
+    }
+    qwk_gather_sub(sub.value(), qscanptr, &qwk_info);
+  }
+
   bout << "|#7\xC3" << std::string(4, '\xC4') << '\xC5'
        << std::string(52, '\xC4') << '\xC5'
        << std::string(9, '\xC4') << '\xC5'
@@ -259,77 +287,47 @@ void build_qwk_packet() {
 
 #define qwk_iscan(x) (iscan1(a()->usub[x].subnum))
 
-void qwk_gather_sub(uint16_t bn, qwk_state* qwk_info) {
-
-  const auto sn = a()->usub[bn].subnum;
+void qwk_gather_sub(const qwk_sub_messages_t& sub, uint32_t qscanptr, qwk_state* qwk_info) {
+  const auto bn = sub.request.usub;
+  const auto sn = sub.request.subnum;
 
   if (a()->sess().hangup() || (sn < 0)) {
     return;
   }
 
-  auto qscnptrx = a()->sess().qsc_p[sn];
+  const auto qscnptrx = a()->sess().qsc_p[sn];
   const auto sd = WWIVReadLastRead(sn);
 
   if (!sd || sd > qscnptrx) {
     const auto os = a()->current_user_sub_num();
     a()->set_current_user_sub_num(bn);
-    int i;
 
-    // Get total amount of messages in base
     if (!qwk_iscan(a()->current_user_sub_num())) {
       return;
     }
 
-    qscnptrx = a()->sess().qsc_p[sn];
-
-    // Find out what message number we are on
-    int amount = 0;
-    {
-      // Pre-open the sub to speed up access.
-      open_sub(false);
-      ScopeExit at_exit([]{ close_sub();});
-      const auto total = a()->GetNumMessagesInCurrentMessageArea();
-      for (i = total; i > 1 && get_post(i - 1)->qscan > qscnptrx; i--) {
-        if ((++amount % 1000) == 0) {
-          bout.format("\r|#9Finding Last Read: (|#2{} |#9/ |#1{}|#9)|#0", amount, total);
-        }
-      }
-    }
-    bout.clear_whole_line();      
-
     char thissub[81];
     to_char_array(thissub, a()->current_sub().name);
     thissub[60] = 0;
     const auto subinfo = fmt::sprintf("|#7\xB3|#9%-4d|#7\xB3|#1%-52s|#7\xB3 |#2%-8d|#7\xB3|#3%-8d|#7\xB3",
-                                      bn + 1, thissub, a()->GetNumMessagesInCurrentMessageArea(),
-                                      a()->GetNumMessagesInCurrentMessageArea() - i + 1);
+                                      bn + 1, thissub, sub.total,
+                                      sub.total - sub.first + 1);
     bout.bputs(subinfo);
     bout.nl();
 
     bin.checka(&qwk_info->abort);
 
-    {
-      // Open the sub first, so that we don't open/close it repeatedly
-      // in get_post.
-      open_sub(false);
-      ScopeExit at_exit([]{ close_sub();});
-
-      if (a()->GetNumMessagesInCurrentMessageArea() > 0 &&
-          i <= a()->GetNumMessagesInCurrentMessageArea() && !qwk_info->abort) {
-        if (get_post(i)->qscan > a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()]) {
-          qwk_start_read(i, qwk_info); // read messsage
-        }
-      }
+    if (!sub.messages.empty() && !qwk_info->abort) {
+      qwk_start_read(sub, qwk_info);
     }
 
-    const auto status = a()->status_manager()->get_status();
-    a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()] = status->qscanptr() - 1;
+    a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()] = qscanptr - 1;
     a()->set_current_user_sub_num(os);
   } 
   bout.Color(0);
 }
 
-void qwk_start_read(int msgnum, qwk_state *qwk_info) {
+void qwk_start_read(const qwk_sub_messages_t& sub, qwk_state *qwk_info) {
   a()->sess().clear_irt();
 
   if (a()->sess().GetCurrentReadMessageArea() < 0) {
@@ -342,45 +340,39 @@ void qwk_start_read(int msgnum, qwk_state *qwk_info) {
     set_net_num(0);
   }
 
-  auto amount = 1;
-  auto done = false;
-  const auto total = a()->GetNumMessagesInCurrentMessageArea();
-  do {
-    if (msgnum > 0 && msgnum <= a()->GetNumMessagesInCurrentMessageArea()) {
-      make_pre_qwk(msgnum, qwk_info);
-    }
-    ++msgnum;
-    if (msgnum > total) {
-      done = true;
-    }
-    if (a()->user()->data.qwk_max_msgs_per_sub ? amount >
-        a()->user()->data.qwk_max_msgs_per_sub : 0) {
-      done = true;
+  auto amount = 0;
+  for (const auto& m : sub.messages) {
+    if (a()->sess().hangup() || qwk_info->abort) {
+      break;
     }
-    if (max_msgs ? qwk_info->qwk_rec_num > max_msgs : 0) {
-      done = true;
+    if (max_msgs && qwk_info->qwk_rec_num > max_msgs) {
+      break;
     }
+    make_pre_qwk(m, qwk_info);
     ++amount;
     bin.checka(&qwk_info->abort);
     if ((amount % 100) == 0) {
-      bout.format("\r|#9Packing Message(|#2{} |#9/ |#1{}|#9)|#0", amount, total);
+      bout.format("\r|#9Packing Message(|#2{} |#9/ |#1{}|#9)|#0", amount, sub.total);
     }
-  } while (!done && !a()->sess().hangup() && !qwk_info->abort);
+  }
   bout.clear_whole_line();
 }
 
-void make_pre_qwk(int msgnum, qwk_state *qwk_info) {
-  auto* p = get_post(msgnum);
-  if ((p->status & (status_unvalidated | status_delete)) && !lcs()) {
+void make_pre_qwk(const qwk_sub_message_t& m, qwk_state *qwk_info) {
+  auto p = m.post;
+  if ((p.status & (status_unvalidated | status_delete)) && !lcs()) {
     return;
   }
 
   const auto nn = a()->net_num();
-  if (p->status & status_post_new_net) {
-    set_net_num(p->network.network_msg.net_number);
+  if (p.status & status_post_new_net) {
+    set_net_num(p.network.network_msg.net_number);
   }
 
-  put_in_qwk(p, a()->current_sub().filename.c_str(), msgnum, qwk_info);
+  auto data = m.text ? parse_type2_message(m.text.value(), p.anony & 0x0f, true,
+                                           a()->current_sub().filename, p.ownersys, p.owneruser)
+                     : Type2MessageData{};
+  put_in_qwk(&p, data, m.msgnum, qwk_info);
   if (nn != a()->net_num()) {
     set_net_num(nn);
   }
@@ -388,10 +380,10 @@ void make_pre_qwk(int msgnum, qwk_state *qwk_info) {
   a()->user()->messages_read(a()->user()->messages_read() + 1);
   a()->SetNumMessagesReadThisLogon(a()->GetNumMessagesReadThisLogon() + 1);
 
-  if (p->qscan >
+  if (p.qscan >
       a()->sess()
           .qsc_p[a()->sess().GetCurrentReadMessageArea()]) { // Update qscan pointer right here
-    a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()] = p->qscan; // And here
+    a()->sess().qsc_p[a()->sess().GetCurrentReadMessageArea()] = p.qscan; // And here
   }
 }
 
@@ -499,12 +491,19 @@ void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
       return;
     }
   }
-  memset(&qwk_info->qwk_rec, ' ', sizeof(qwk_info->qwk_rec));
-
   auto m = read_type2_message(&m1->msg, m1->anony & 0x0f, true,
                               fn, m1->ownersys, m1->owneruser);
+  put_in_qwk(m1, m, msgnum, qwk_info);
+}
+
+void put_in_qwk(postrec *m1, Type2MessageData& m, int msgnum, qwk_state *qwk_info) {
+  if (m1->status & (status_unvalidated | status_delete)) {
+    if (!lcs()) {
+      return;
+    }
+  }
+  memset(&qwk_info->qwk_rec, ' ', sizeof(qwk_info->qwk_rec));
 
-  int cur = 0;
   if (m.message_text.empty() && m.title.empty()) {
     // TODO(rushfan): Really read_type2_message should return an std::optional<Type2MessageData>
     bout << "File not found.";
@@ -571,7 +570,21 @@ void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
   }
   qwk_info->qwk_rec.logical_num = qwk_info->qwk_rec_num;
 
-  if (!qwk_info->file->Write(&qwk_info->qwk_rec)) {
+  // Convert the whole message into its blocks first, so that it's
+  // written to MESSAGES.DAT at once.
+  std::vector<qwk_record> blocks(amount_blocks);
+  blocks[0] = qwk_info->qwk_rec;
+  for (auto cur_block = 2; cur_block <= amount_blocks; cur_block++) {
+    auto& b = blocks[cur_block - 1];
+    memset(&b, ' ', sizeof(b));
+    const auto this_pos = (cur_block - 2) * sizeof(b);
+    if (this_pos < len) {
+      const auto size = (this_pos + sizeof(b) > len) ? (len - this_pos - 1) : sizeof(b);
+      memcpy(&b, ss.data() + this_pos, size);
+    }
+  }
+
+  if (!qwk_info->file->Write(blocks.data(), amount_blocks)) {
     qwk_info->abort = true; // Must be out of disk space
     bout.bputs("Write error");
     bout.pausescr();
@@ -603,22 +616,6 @@ void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info) {
   // Setup next NDX position
   qwk_info->qwk_rec_pos += static_cast<uint16_t>(amount_blocks);
 
-  int cur_block = 2;
-  while (cur_block <= amount_blocks && !a()->sess().hangup()) {
-    size_t this_pos;
-    memset(&qwk_info->qwk_rec, ' ', sizeof(qwk_info->qwk_rec));
-    this_pos = (cur_block - 2) * sizeof(qwk_info->qwk_rec);
-
-    if (this_pos < len) {
-      size_t size = (this_pos + sizeof(qwk_info->qwk_rec) > static_cast<size_t>(len)) ? (len - this_pos - 1) : sizeof(qwk_info->qwk_rec);
-      memmove(&qwk_info->qwk_rec, ss.data() + cur + this_pos, size);
-    }
-    // Save this block
-    qwk_info->file->Write(&qwk_info->qwk_rec);
-
-    this_pos += sizeof(qwk_info->qwk_rec);
-    ++cur_block;
-  }
   // Global variable on total amount of records saved
   ++qwk_info->qwk_rec_num;
 }
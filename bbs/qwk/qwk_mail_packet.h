@@ -19,7 +19,9 @@
 #ifndef INCLUDED_BBS_QWK_QWK_MAIL_PACKET_H
 #define INCLUDED_BBS_QWK_QWK_MAIL_PACKET_H
 
+#include "bbs/read_message.h"
 #include "bbs/qwk/qwk_struct.h"
+#include "bbs/qwk/qwk_sub_reader.h"
 #include <cstdint>
 
 
@@ -29,10 +31,11 @@ namespace wwiv::bbs::qwk {
 
 
 void build_qwk_packet();
-void qwk_gather_sub(uint16_t bn, qwk_state *qwk_info);
-void qwk_start_read(int msgnum, qwk_state *qwk_info);
-void make_pre_qwk(int msgnum, qwk_state *qwk_info);
+void qwk_gather_sub(const qwk_sub_messages_t& sub, uint32_t qscanptr, qwk_state *qwk_info);
+void qwk_start_read(const qwk_sub_messages_t& sub, qwk_state *qwk_info);
+void make_pre_qwk(const qwk_sub_message_t& m, qwk_state *qwk_info);
 void put_in_qwk(postrec *m1, const char *fn, int msgnum, qwk_state *qwk_info);
+void put_in_qwk(postrec *m1, Type2MessageData& m, int msgnum, qwk_state *qwk_info);
 void qwk_nscan();
 void finish_qwk(qwk_state *qwk_info);
 
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "bbs/qwk/qwk_sub_reader.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/msgapi/type2_text.h"
+#include <algorithm>
+#include <utility>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+namespace wwiv::bbs::qwk {
+
+qwk_sub_messages_t read_qwk_sub(const std::filesystem::path& datadir,
+                                const std::filesystem::path& msgsdir,
+                                const qwk_sub_request_t& r) {
+  qwk_sub_messages_t result{};
+  result.request = r;
+
+  DataFile<postrec> sub(FilePath(datadir, StrCat(r.filename, ".sub")),
+                        File::modeBinary | File::modeReadOnly);
+  std::vector<postrec> posts;
+  if (!sub || !sub.ReadVector(posts) || posts.empty()) {
+    return result;
+  }
+  // Record 0 holds the number of messages in owneruser, so post i is at index i.
+  const auto total = std::min<int>(posts.front().owneruser, static_cast<int>(posts.size()) - 1);
+  result.total = total;
+  if (total < 1) {
+    return result;
+  }
+  result.last_qscan = posts.at(total).qscan;
+
+  auto first = total;
+  while (first > 1 && posts.at(first - 1).qscan > r.qscan_pointer) {
+    --first;
+  }
+  result.first = first;
+  if (posts.at(first).qscan <= r.qscan_pointer) {
+    // Nothing new.
+    return result;
+  }
+
+  auto last = total;
+  if (r.max_msgs > 0) {
+    last = std::min(total, first + r.max_msgs - 1);
+  }
+  if (r.qscan_limit > 0) {
+    while (last >= first && posts.at(last).qscan >= r.qscan_limit) {
+      --last;
+    }
+  }
+  Type2Text text(FilePath(msgsdir, StrCat(r.filename, ".dat")));
+  result.messages.reserve(last - first + 1);
+  for (auto i = first; i <= last; i++) {
+    qwk_sub_message_t m{};
+    m.msgnum = i;
+    m.post = posts.at(i);
+    const auto hidden = (m.post.status & (status_unvalidated | status_delete)) != 0;
+    if (m.post.msg.storage_type == 2 && (r.include_unvalidated || !hidden)) {
+      m.text = text.readfile(m.post.msg);
+    }
+    result.messages.emplace_back(std::move(m));
+  }
+  return result;
+}
+
+QwkSubReader::QwkSubReader(std::filesystem::path datadir, std::filesystem::path msgsdir,
+                           std::vector<qwk_sub_request_t> requests, int num_jobs, int max_ahead)
+    : datadir_(std::move(datadir)), msgsdir_(std::move(msgsdir)), requests_(std::move(requests)),
+      max_ahead_(std::max(1, max_ahead)), subs_(requests_.size()) {
+  const auto jobs = std::min<std::size_t>(std::max(1, num_jobs), requests_.size());
+  for (std::size_t i = 0; i < jobs; i++) {
+    readers_.emplace_back([this] { read_subs(); });
+  }
+}
+
+QwkSubReader::~QwkSubReader() {
+  {
+    std::lock_guard lock(mu_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : readers_) {
+    t.join();
+  }
+}
+
+int QwkSubReader::default_jobs() {
+  // Reading subs is mostly waiting on the disk, so a few threads are plenty.
+  return std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4);
+}
+
+void QwkSubReader::read_subs() {
+  while (true) {
+    std::size_t i;
+    {
+      std::unique_lock lock(mu_);
+      cv_.wait(lock, [this] {
+        return stopping_ || next_read_ >= requests_.size() ||
+               next_read_ < next_returned_ + max_ahead_;
+      });
+      if (stopping_ || next_read_ >= requests_.size()) {
+        return;
+      }
+      i = next_read_++;
+    }
+    auto s = read_qwk_sub(datadir_, msgsdir_, requests_.at(i));
+    VLOG(2) << "Read " << s.messages.size() << " messages from: " << s.request.filename;
+    std::lock_guard lock(mu_);
+    subs_.at(i) = std::move(s);
+    cv_.notify_all();
+  }
+}
+
+std::optional<qwk_sub_messages_t> QwkSubReader::next() {
+  std::unique_lock lock(mu_);
+  if (next_returned_ >= requests_.size()) {
+    return std::nullopt;
+  }
+  const auto i = next_returned_;
+  cv_.wait(lock, [&] { return subs_.at(i).has_value(); });
+  std::optional<qwk_sub_messages_t> result;
+  result.swap(subs_.at(i));
+  ++next_returned_;
+  cv_.notify_all();
+  return result;
+}
+
+} // namespace wwiv::bbs::qwk
@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_BBS_QWK_QWK_SUB_READER_H
+#define INCLUDED_BBS_QWK_QWK_SUB_READER_H
+
+#include "sdk/vardec.h"
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wwiv::bbs::qwk {
+
+/** A sub to gather into a QWK packet. */
+struct qwk_sub_request_t {
+  // Index into a()->usub.
+  int usub{0};
+  int subnum{0};
+  std::string filename;
+  // Only messages with a qscan pointer after this are read.
+  uint32_t qscan_pointer{0};
+  // Messages with a qscan pointer of this or more were posted after the
+  // packet was started and are left for the next one.  0 for no limit.
+  uint32_t qscan_limit{0};
+  // Maximum number of messages to read, or 0 for no limit.
+  int max_msgs{0};
+  // Also read the text of unvalidated and deleted messages.
+  bool include_unvalidated{false};
+};
+
+struct qwk_sub_message_t {
+  int msgnum{0};
+  postrec post{};
+  // Raw message text, or nullopt if it could not be read (or wasn't
+  // wanted since the message is unvalidated or deleted).
+  std::optional<std::string> text;
+};
+
+struct qwk_sub_messages_t {
+  qwk_sub_request_t request;
+  // Number of messages in the sub.
+  int total{0};
+  // Number of the first message newer than the qscan pointer.
+  int first{0};
+  // qscan pointer of the last message in the sub, 0 if empty.
+  uint32_t last_qscan{0};
+  std::vector<qwk_sub_message_t> messages;
+};
+
+/**
+ * Reads the new messages of sub r from the .sub file in datadir and the
+ * .dat file in msgsdir.  Doesn't use any of the global BBS state, so it
+ * can be called from any thread.
+ */
+[[nodiscard]] qwk_sub_messages_t read_qwk_sub(const std::filesystem::path& datadir,
+                                              const std::filesystem::path& msgsdir,
+                                              const qwk_sub_request_t& r);
+
+/**
+ * Reads the new messages of the subs going into a QWK packet using
+ * num_jobs worker threads, while the caller converts the subs already read
+ * into the packet.  next() returns the subs in the order requested.
+ *
+ * At most max_ahead subs are read but not yet returned by next(), to bound
+ * the memory used.
+ */
+class QwkSubReader final {
+public:
+  QwkSubReader(std::filesystem::path datadir, std::filesystem::path msgsdir,
+               std::vector<qwk_sub_request_t> requests, int num_jobs, int max_ahead);
+  ~QwkSubReader();
+  QwkSubReader(const QwkSubReader&) = delete;
+  QwkSubReader& operator=(const QwkSubReader&) = delete;
+
+  /** Waits for and returns the next sub, or nullopt once all have been returned. */
+  [[nodiscard]] std::optional<qwk_sub_messages_t> next();
+
+  /** Returns a reasonable number of worker threads for this machine. */
+  [[nodiscard]] static int default_jobs();
+
+private:
+  void read_subs();
+
+  const std::filesystem::path datadir_;
+  const std::filesystem::path msgsdir_;
+  const std::vector<qwk_sub_request_t> requests_;
+  const std::size_t max_ahead_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // GUARDED_BY(mu_)
+  std::vector<std::optional<qwk_sub_messages_t>> subs_;
+  // Index of the next sub to read.  GUARDED_BY(mu_)
+  std::size_t next_read_{0};
+  // Index of the next sub to return from next().  GUARDED_BY(mu_)
+  std::size_t next_returned_{0};
+  // GUARDED_BY(mu_)
+  bool stopping_{false};
+
+  std::vector<std::thread> readers_;
+};
+
+} // namespace wwiv::bbs::qwk
+
+#endif
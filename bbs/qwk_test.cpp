@@ -19,13 +19,16 @@
 #include "gtest/gtest.h"
 
 #include "bbs/bbs.h"
+#include "bbs/qwk/qwk_sub_reader.h"
 #include "bbs/qwk/qwk_text.h"
 #include "bbs/bbs_helper.h"
 #include "core/datafile.h"
 #include "core/strings.h"
 #include "sdk/filenames.h"
 #include "sdk/qwk_config.h"
+#include "sdk/msgapi/type2_text.h"
 #include <string>
+#include <vector>
 
 using wwiv::sdk::User;
 using namespace wwiv::common;
@@ -130,4 +133,108 @@ TEST(Qwk1Test, TestGetQwkFromMessage_Malformed_AtEndOfLine) {
                               " Rushfan #1 @561\r\nTitle\r\nDate\r\nThis is the message", QWKFrom);
   const auto opt_to = get_qwk_from_message(message);
   ASSERT_FALSE(opt_to.has_value());
-}
\ No newline at end of file
+}
+class QwkSubReaderTest : public QwkTest {
+protected:
+  // Creates sub "a1" with num messages, with qscan pointers 101, 102...
+  void CreateSub(int num) {
+    const auto dat = FilePath(helper.config().msgsdir(), "a1.dat");
+    File(dat).Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    msgapi::Type2Text text(dat);
+    std::vector<postrec> posts(num + 1);
+    posts[0].owneruser = static_cast<uint16_t>(num);
+    for (auto i = 1; i <= num; i++) {
+      to_char_array(posts[i].title, StrCat("Title ", i));
+      posts[i].qscan = 100 + i;
+      posts[i].msg = text.savefile(StrCat("From\r\nDate\r\nText ", i, "\r\n")).value();
+    }
+    DataFile<postrec> sub(FilePath(helper.config().datadir(), "a1.sub"),
+                          File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    ASSERT_TRUE(sub.WriteVector(posts));
+  }
+
+  [[nodiscard]] qwk_sub_request_t request(uint32_t qscan_pointer, int max_msgs = 0) const {
+    qwk_sub_request_t r{};
+    r.filename = "a1";
+    r.qscan_pointer = qscan_pointer;
+    r.max_msgs = max_msgs;
+    return r;
+  }
+};
+
+TEST_F(QwkSubReaderTest, ReadQwkSub) {
+  CreateSub(5);
+  const auto s = read_qwk_sub(helper.config().datadir(), helper.config().msgsdir(), request(102));
+  EXPECT_EQ(5, s.total);
+  EXPECT_EQ(3, s.first);
+  EXPECT_EQ(105u, s.last_qscan);
+  ASSERT_EQ(3u, s.messages.size());
+  EXPECT_EQ(3, s.messages.front().msgnum);
+  EXPECT_STREQ("Title 3", s.messages.front().post.title);
+  ASSERT_TRUE(s.messages.front().text.has_value());
+  EXPECT_EQ("From\r\nDate\r\nText 3\r\n", s.messages.front().text.value());
+}
+
+TEST_F(QwkSubReaderTest, ReadQwkSub_MaxMsgs) {
+  CreateSub(5);
+  const auto s = read_qwk_sub(helper.config().datadir(), helper.config().msgsdir(), request(0, 2));
+  ASSERT_EQ(2u, s.messages.size());
+  EXPECT_EQ(1, s.messages.front().msgnum);
+  EXPECT_EQ(2, s.messages.back().msgnum);
+}
+
+TEST_F(QwkSubReaderTest, ReadQwkSub_NothingNew) {
+  CreateSub(5);
+  const auto s = read_qwk_sub(helper.config().datadir(), helper.config().msgsdir(), request(105));
+  EXPECT_EQ(5, s.total);
+  EXPECT_TRUE(s.messages.empty());
+}
+
+TEST_F(QwkSubReaderTest, ReadQwkSub_PostedAfterStart) {
+  CreateSub(5);
+  // Posted while the packet is being built, after its qscan pointer was taken.
+  {
+    DataFile<postrec> sub(FilePath(helper.config().datadir(), "a1.sub"),
+                          File::modeBinary | File::modeReadWrite);
+    std::vector<postrec> posts;
+    ASSERT_TRUE(sub.ReadVector(posts));
+    postrec p{};
+    p.qscan = 106;
+    posts.push_back(p);
+    posts[0].owneruser = 6;
+    ASSERT_TRUE(sub.Seek(0));
+    ASSERT_TRUE(sub.WriteVector(posts));
+  }
+  auto r = request(102);
+  r.qscan_limit = 106;
+  const auto s = read_qwk_sub(helper.config().datadir(), helper.config().msgsdir(), r);
+  EXPECT_EQ(6, s.total);
+  ASSERT_EQ(3u, s.messages.size());
+  EXPECT_EQ(105u, s.messages.back().post.qscan);
+}
+
+TEST_F(QwkSubReaderTest, QwkSubReader_InOrder) {
+  CreateSub(5);
+  std::vector<qwk_sub_request_t> requests;
+  for (auto i = 0; i < 10; i++) {
+    auto r = request(100 + i % 5);
+    r.usub = i;
+    requests.push_back(r);
+  }
+  QwkSubReader reader(helper.config().datadir(), helper.config().msgsdir(), requests, 3, 2);
+  for (auto i = 0; i < 10; i++) {
+    const auto s = reader.next();
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(i, s->request.usub);
+    EXPECT_EQ(5u - i % 5, s->messages.size());
+  }
+  EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST_F(QwkSubReaderTest, QwkSubReader_StopEarly) {
+  CreateSub(1);
+  std::vector<qwk_sub_request_t> requests(10, request(0));
+  QwkSubReader reader(helper.config().datadir(), helper.config().msgsdir(), requests, 2, 1);
+  EXPECT_TRUE(reader.next().has_value());
+  // Destroying the reader now must not wait for the rest of the subs.
+}
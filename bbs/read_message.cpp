@@ -50,6 +50,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 using namespace wwiv::common;
 using namespace wwiv::core;
@@ -312,14 +313,20 @@ static void UpdateHeaderInformation(int8_t anon_type, bool readit, const std::st
 Type2MessageData read_type2_message(messagerec* msg, uint8_t an, bool readit, const std::string& file_name,
                                     int from_sys_num, int from_user) {
 
-  Type2MessageData data{};
-  data.email = iequals("email", file_name);
   auto o = readfile(msg, file_name);
   if (!o) {
     return {};
   }
+  return parse_type2_message(std::move(o.value()), an, readit, file_name, from_sys_num, from_user);
+}
+
+Type2MessageData parse_type2_message(std::string text, uint8_t an, bool readit,
+                                     const std::string& file_name, int from_sys_num,
+                                     int from_user) {
+  Type2MessageData data{};
+  data.email = iequals("email", file_name);
   // Make a copy of the raw message text.
-  data.message_text = o.value();
+  data.message_text = std::move(text);
   data.raw_message_text = data.message_text;
 
   // TODO(rushfan): Use get_control_line from networking code here.
@@ -62,6 +62,11 @@ struct Type2MessageData {
 Type2MessageData read_type2_message(messagerec* msg, uint8_t an, bool readit,
                                     const std::string& file_name, int from_sys_num, int from_user);
 
+/** As read_type2_message, for the text of a message already read from file_name. */
+Type2MessageData parse_type2_message(std::string text, uint8_t an, bool readit,
+                                     const std::string& file_name, int from_sys_num,
+                                     int from_user);
+
 
 enum class ReadMessageOption {
   NONE,
@@ -30,6 +30,8 @@
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
+#include "sdk/msgapi/message_header_cache.h"
+#include "sdk/msgapi/thread_index.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
@@ -199,6 +201,7 @@ void write_post(int mn, postrec* pp) {
   }
   fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
+  a()->msg_header_cache().invalidate(a()->current_sub().filename);
 }
 
 void add_post(postrec* pp) {
@@ -242,10 +245,17 @@ void add_post(postrec* pp) {
 
   // we've modified the sub
   a()->subchg = 0;
+  a()->msg_header_cache().invalidate(a()->current_sub().filename);
 
   if (need_close) {
     close_sub();
   }
+
+  // Keep the thread index current, like WWIVMessageArea::AddMessage does.
+  if (const auto text = readfile(&pp->msg, a()->current_sub().filename)) {
+    wwiv::sdk::msgapi::ThreadIndex index(wwiv::sdk::msgapi::ThreadIndex::index_path(subdat_fn));
+    index.Add(pp->qscan, pp->daten, pp->title, text.value());
+  }
 }
 
 static constexpr size_t BUFSIZE = 32000;
@@ -292,6 +302,7 @@ void delete_message(int mn) {
         fileSub->Seek(0L, File::Whence::begin);
         fileSub->Write(&p, sizeof(postrec));
         free(buffer);
+        a()->msg_header_cache().invalidate(a()->current_sub().filename);
       }
     }
   }
@@ -55,6 +55,7 @@
 #include "sdk/filenames.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
+#include "sdk/sysoplog_events.h"
 #include "sdk/user.h"
 #include "sdk/usermanager.h"
 #include "sdk/msgapi/message_utils_wwiv.h"
@@ -1007,6 +1008,10 @@ void beginday(bool displayStatus) {
     bout << "  |#7* |#1Purging inactive users (if enabled)...\r\n";
   }
   auto_purge();
+  if (displayStatus) {
+    bout << "  |#7* |#1Rotating sysop log events...\r\n";
+  }
+  rotate_sysoplog_events(FilePath(a()->config()->gfilesdir(), SYSOPLOG_EVT));
   if (displayStatus) {
     bout << "|#7* |#1Done!\r\n";
   }
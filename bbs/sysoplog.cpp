@@ -26,7 +26,12 @@
 #include "common/context.h"
 #include "fmt/printf.h"
 #include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/sysoplog_events.h"
+#include <chrono>
+#include <filesystem>
 #include <string>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::sdk;
@@ -36,6 +41,102 @@ using namespace wwiv::strings;
 enum class log_cmd_t{ log_string, log_char };
 void AddLineToSysopLogImpl(log_cmd_t cmd, const std::string& text);
 
+// Flush the pending sysop log lines once they are this old or this large.
+static constexpr auto SYSOPLOG_FLUSH_INTERVAL = std::chrono::seconds(30);
+static constexpr std::string::size_type SYSOPLOG_FLUSH_SIZE = 8192;
+
+namespace {
+
+/**
+ * Sysop log lines for this instance, kept in memory until they are flushed
+ * to the instance log (and sysoplog.evt) in a single append.  Most sessions
+ * never touch the instance log at all, since catsl() appends whatever is
+ * still pending straight to the daily log.
+ */
+class SysopLogBuffer final {
+public:
+  ~SysopLogBuffer() {
+    try {
+      flush();
+    } catch (...) {
+      // NOP
+    }
+  }
+
+  void init(const std::filesystem::path& instance_log, const std::filesystem::path& events) {
+    if (instance_log_.empty()) {
+      instance_log_ = instance_log;
+      events_path_ = events;
+    }
+  }
+
+  void add(const std::string& text, sysoplog_event_t event) {
+    if (pending_.empty() && events_.empty()) {
+      first_pending_ = std::chrono::steady_clock::now();
+    }
+    pending_ += text;
+    if (!event.text.empty()) {
+      events_.emplace_back(to_sysoplog_event_line(event));
+    }
+    if (pending_.size() >= SYSOPLOG_FLUSH_SIZE ||
+        std::chrono::steady_clock::now() - first_pending_ >= SYSOPLOG_FLUSH_INTERVAL) {
+      flush();
+    }
+  }
+
+  /** Writes all pending text to the instance log. */
+  void flush() {
+    if (!pending_.empty() && append_atomically(instance_log_, {pending_})) {
+      pending_.clear();
+    }
+    flush_events();
+  }
+
+  /** Appends the instance log and anything pending to the daily log at path. */
+  void merge_into(const std::filesystem::path& path) {
+    std::string text;
+    const auto has_instance_log = File::Exists(instance_log_);
+    if (has_instance_log) {
+      TextFile tmplog(instance_log_, "rt");
+      if (!tmplog) {
+        return;
+      }
+      text = tmplog.ReadFileIntoString();
+    } else if (pending_.empty()) {
+      flush_events();
+      return;
+    }
+    if (append_atomically(path, {text, pending_, "\r\n"})) {
+      pending_.clear();
+      if (has_instance_log) {
+        File::Remove(instance_log_);
+      }
+    }
+    flush_events();
+  }
+
+  std::string::size_type midline{0};
+
+private:
+  void flush_events() {
+    if (!events_.empty() && append_atomically(events_path_, events_)) {
+      events_.clear();
+    }
+  }
+
+  std::filesystem::path instance_log_;
+  std::filesystem::path events_path_;
+  std::string pending_;
+  std::vector<std::string> events_;
+  std::chrono::steady_clock::time_point first_pending_;
+};
+
+SysopLogBuffer& sysoplog_buffer() {
+  static SysopLogBuffer buffer;
+  return buffer;
+}
+
+} // namespace
 
 /*
 * Creates sysop log filename in s, from date string.
@@ -51,54 +152,51 @@ std::string GetTemporaryInstanceLogFileName() {
   return fmt::sprintf("inst-%3.3u.log", a()->sess().instance_number());
 }
 
+/*
+* Writes any buffered sysop log lines to the instance log.
+*/
+void flush_sysoplog() {
+  sysoplog_buffer().flush();
+}
+
 /*
 * Copies temporary/instance sysop log to primary sysop log file.
 */
 void catsl() {
-  const auto templog_fn = FilePath(a()->config()->gfilesdir(), GetTemporaryInstanceLogFileName());
-  if (!File::Exists(templog_fn)) {
+  const auto& gfilesdir = a()->config()->gfilesdir();
+  if (gfilesdir.empty()) {
     return;
   }
-
-  std::string instance_text;
-  {
-    TextFile tmplog(templog_fn, "rt");
-    if (!tmplog) {
-      return;
-    }
-    instance_text = tmplog.ReadFileIntoString();
-  }
-
-  const auto basename = sysoplog_filename(date());
-  TextFile sysoplog_fn(FilePath(a()->config()->gfilesdir(), basename), "at");
-  if (sysoplog_fn) {
-    sysoplog_fn.WriteLine(instance_text);
-    File::Remove(templog_fn);
-  }
+  auto& buffer = sysoplog_buffer();
+  buffer.init(FilePath(gfilesdir, GetTemporaryInstanceLogFileName()),
+              FilePath(gfilesdir, SYSOPLOG_EVT));
+  buffer.merge_into(FilePath(gfilesdir, sysoplog_filename(date())));
 }
 
 /*
 * Writes a line to the sysop log.
 */
 void AddLineToSysopLogImpl(log_cmd_t cmd, const std::string& text) {
-  static std::string::size_type midline = 0;
-  
-  if (a()->config()->gfilesdir().empty()) {
+  const auto& gfilesdir = a()->config()->gfilesdir();
+  if (gfilesdir.empty()) {
     LOG(ERROR) << "gfilesdir empty, can't write to sysop log: " << text;
     return;
   }
-  const static auto s_sysoplog_filename =
-      FilePath(a()->config()->gfilesdir(), GetTemporaryInstanceLogFileName());
+  auto& buffer = sysoplog_buffer();
+  buffer.init(FilePath(gfilesdir, GetTemporaryInstanceLogFileName()),
+              FilePath(gfilesdir, SYSOPLOG_EVT));
+  auto& midline = buffer.midline;
+
+  sysoplog_event_t event{};
+  event.time = DateTime::now().to_time_t();
+  event.node = a()->sess().instance_number();
+  if (a()->sess().IsUserOnline()) {
+    event.user = a()->user()->name();
+  }
+  event.text = StringTrim(text);
 
   switch (cmd) {
   case log_cmd_t::log_string: {  // Write line to sysop log
-    File logFile(s_sysoplog_filename);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     std::string logLine;
     if (midline > 0) {
       logLine = StrCat("\r\n", text);
@@ -107,19 +205,10 @@ void AddLineToSysopLogImpl(log_cmd_t cmd, const std::string& text) {
       logLine = text;
     }
     logLine += "\r\n";
-    logFile.Write(logLine);
-    logFile.Close();
+    buffer.add(logLine, event);
   }
   break;
   case log_cmd_t::log_char: {
-    File logFile(s_sysoplog_filename);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      // sysop log ?
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     std::string logLine;
     if (midline == 0 || (midline + 2 + text.length()) > 78) {
       logLine = (midline) ? "\r\n   " : "  ";
@@ -129,8 +218,7 @@ void AddLineToSysopLogImpl(log_cmd_t cmd, const std::string& text) {
       midline += 2 + text.length();
     }
     logLine += text;
-    logFile.Write(logLine);
-    logFile.Close();
+    buffer.add(logLine, event);
   }
   break;
   }
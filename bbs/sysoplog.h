@@ -24,6 +24,7 @@
 std::string sysoplog_filename(const std::string& date);
 std::string GetTemporaryInstanceLogFileName();
 void catsl();
+void flush_sysoplog();
 void sysopchar(const std::string& text);
 
 class sysoplog {
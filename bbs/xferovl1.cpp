@@ -53,8 +53,10 @@
 #include "local_io/wconstants.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
+#include "sdk/files/arc.h"
 #include "sdk/files/diz.h"
 #include "sdk/files/files.h"
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -200,6 +202,31 @@ static std::optional<std::filesystem::path> PathToTempdDiz(const std::filesystem
   File::Remove(FilePath(a()->sess().dirs().temp_directory(), FILE_ID_DIZ));
   File::Remove(FilePath(a()->sess().dirs().temp_directory(), DESC_SDI));
 
+  // Try to read it out of the archive ourselves before running the archiver.
+  for (const auto& name : {FILE_ID_DIZ, DESC_SDI}) {
+    if (auto text = extract_file(p, name, DizParser::MAX_SIZE)) {
+      auto diz_fn = FilePath(a()->sess().dirs().temp_directory(), name);
+      File f(diz_fn);
+      if (f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                 File::modeTruncate) &&
+          f.Write(text.value()) == static_cast<File::size_type>(text->size())) {
+        VLOG(1) << "Extracted diz: " << diz_fn;
+        return {diz_fn};
+      }
+    }
+  }
+  // A ZIP written as a stream lists as empty, so only trust a listing that
+  // found something.
+  if (const auto files = list_archive(p); files && !files->empty()) {
+    const auto has_diz = std::any_of(files->begin(), files->end(), [](const auto& f) {
+      return iequals(f.filename, FILE_ID_DIZ) || iequals(f.filename, DESC_SDI);
+    });
+    if (!has_diz) {
+      VLOG(1) << "No diz.";
+      return std::nullopt;
+    }
+  }
+
   if (!p.has_extension() || !has_arc_cmd_for_ext(p.extension().string().substr(1))) {
     return std::nullopt;
   }
@@ -280,6 +280,7 @@ void Application::ReadINIFile(IniFile& ini) {
 
   forced_read_subnum_ = ini.value<uint16_t>(INI_STR_FORCE_SCAN_SUBNUM, forced_read_subnum_);
   internal_zmodem_ = ini.value<bool>(INI_STR_INTERNALZMODEM, true);
+  zmodem_8k_ = ini.value<bool>(INI_STR_ZMODEM_8K, false);
   internal_fsed_ = ini.value<bool>(INI_STR_INTERNAL_FSED, true);
   newscan_at_login_ = ini.value<bool>(INI_STR_NEW_SCAN_AT_LOGIN, true);
   exec_log_syncfoss_ = ini.value<bool>(INI_STR_EXEC_LOG_SYNCFOSS, false);
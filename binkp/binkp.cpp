@@ -29,6 +29,7 @@
 #include "core/file.h"
 #include "core/log.h"
 #include "core/os.h"
+#include "core/semaphore_file.h"
 #include "core/socket_exceptions.h"
 #include "core/stl.h"
 #include "core/strings.h"
@@ -40,9 +41,11 @@
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -58,6 +61,12 @@ using namespace wwiv::os;
 
 namespace wwiv::net {
 
+// The largest data frame allowed by the BinkP spec is (1 << 15) - 1 bytes.
+static constexpr int BINKP_MAX_DATA_FRAME_SIZE = 0x7fff;
+
+// How long to wait for M_GET or M_GOT replies while sending before giving up.
+static constexpr auto BINKP_SEND_IDLE_TIMEOUT = seconds(30);
+
 static int System(const std::string& bbsdir, const std::string& cmd) {
   const auto path = FilePath(bbsdir, cmd).string();
 
@@ -106,6 +115,9 @@ bool BinkP::process_opt(const std::string& opt) {
           LOG(INFO) << "       CRAM-MD5 disabled in net.ini; Using plain text passwords.";
         }
       }
+    } else if (s == "NR") {
+      LOG(INFO) << "       Remote requested NR mode.";
+      remote_nr_ = true;
     } else if (s == "CRC") {
       if (config_->crc()) {
         LOG(INFO) << "       Enabling CRC support";
@@ -171,6 +183,9 @@ bool BinkP::process_command(int16_t length, duration<double> d) {
   case BinkpCommands::M_GOT: {
     HandleFileGotRequest(s);
   } break;
+  case BinkpCommands::M_SKIP: {
+    HandleFileSkipRequest(s);
+  } break;
   case BinkpCommands::M_EOB: {
     eob_received_ = true;
   } break;
@@ -196,15 +211,18 @@ bool BinkP::process_data(int16_t length, duration<double> d) {
   if (!conn_->is_open()) {
     return false;
   }
-  const auto s = conn_->receive(length, d);
-  LOG_IF(length != static_cast<int16_t>(s.size()), ERROR)
-      << "RECV:  DATA PACKET; ** unexpected size** len: " << s.size() << "; expected: " << length
+  if (!receive_chunk_) {
+    receive_chunk_ = std::make_unique<char[]>(BINKP_MAX_DATA_FRAME_SIZE);
+  }
+  const auto num_read = conn_->receive(receive_chunk_.get(), length, d);
+  LOG_IF(length != num_read, ERROR)
+      << "RECV:  DATA PACKET; ** unexpected size** len: " << num_read << "; expected: " << length
       << " duration:" << wwiv::core::to_string(d);
   if (!current_receive_file_) {
     LOG(ERROR) << "ERROR: Received M_DATA with no current file.";
     return false;
   }
-  current_receive_file_->WriteChunk(s);
+  current_receive_file_->WriteChunk(receive_chunk_.get(), num_read);
   if (current_receive_file_->length() >= current_receive_file_->expected_length()) {
     LOG(INFO) << "       file finished; bytes_received: " << current_receive_file_->length();
 
@@ -262,6 +280,17 @@ bool BinkP::process_frames(duration<double> d) {
   return process_frames([&]() -> bool { return false; }, d);
 }
 
+bool BinkP::process_frame(duration<double> d) {
+  if (const auto header = conn_->read_uint16(d); header & 0x8000) {
+    return process_command(header & 0x7fff, d);
+  } else {
+    // process data frame.
+    // note: always use a timeout of 10s to process data since dropping bytes
+    // causes real problems.
+    return process_data(header & 0x7fff, seconds(10));
+  }
+}
+
 bool BinkP::process_frames(const std::function<bool()>& predicate, duration<double> d) {
   if (!conn_->is_open()) {
     return false;
@@ -269,19 +298,9 @@ bool BinkP::process_frames(const std::function<bool()>& predicate, duration<doub
   try {
     while (!predicate()) {
       VLOG(3) << "       process_frames(pred)";
-      if (const auto header = conn_->read_uint16(d); header & 0x8000) {
-        if (!process_command(header & 0x7fff, d)) {
-          // false return value means an error occurred.
-          return false;
-        }
-      } else {
-        // process data frame.
-        // note: always use a timeout of 10s to process data since dropping bytes
-        // causes real problems.
-        if (!process_data(header & 0x7fff, seconds(10))) {
-          // false return value mean san error occurred.
-          return false;
-        }
+      if (!process_frame(d)) {
+        // false return value means an error occurred.
+        return false;
       }
     }
   } catch (const timeout_error& e) {
@@ -290,25 +309,31 @@ bool BinkP::process_frames(const std::function<bool()>& predicate, duration<doub
   return true;
 }
 
+bool BinkP::process_pending_frames() {
+  try {
+    while (conn_->is_open() && conn_->wait_for_data(seconds(0))) {
+      // The start of the frame is here, so the rest should follow quickly.
+      if (!process_frame(seconds(3))) {
+        return false;
+      }
+    }
+  } catch (const timeout_error& e) {
+    VLOG(3) << "timeout in process_pending_frames: " << e.what();
+  }
+  return conn_->is_open();
+}
+
 bool BinkP::send_command_packet(uint8_t command_id, const std::string& data) {
   if (!conn_->is_open()) {
     return false;
   }
-  const auto size = 3 + size_int(data); /* header + command + data + null*/
-  const auto packet = std::make_unique<uint8_t[]>(size);
   // Actual packet size parameter does not include the size parameter itself.
   // And for sending a command this will be 2 less than our actual packet size.
   const auto packet_length = static_cast<uint16_t>(data.size() + sizeof(uint8_t)) | 0x8000;
-  const uint8_t b0 = ((packet_length & 0xff00) >> 8) | 0x80;
-  const uint8_t b1 = packet_length & 0x00ff;
-
-  auto* p = packet.get();
-  *p++ = b0;
-  *p++ = b1;
-  *p++ = command_id;
-  memcpy(p, data.data(), data.size());
+  const uint8_t header[3] = {static_cast<uint8_t>(((packet_length & 0xff00) >> 8) | 0x80),
+                             static_cast<uint8_t>(packet_length & 0x00ff), command_id};
 
-  conn_->send(packet.get(), size, seconds(3));
+  conn_->send_with_header(header, sizeof(header), data.data(), size_int(data), seconds(3));
   if (command_id != BinkpCommands::M_PWD) {
     LOG(INFO) << "SEND:  " << BinkpCommands::command_id_to_name(command_id) << ": " << data;
   } else {
@@ -323,21 +348,35 @@ bool BinkP::send_data_packet(const char* data, int packet_length) {
   if (!conn_->is_open()) {
     return false;
   }
-  // for now assume everything fits within a single frame.
-  const std::unique_ptr<char[]> packet(new char[packet_length + 2]);
   packet_length &= 0x7fff;
-  uint8_t b0 = ((packet_length & 0xff00) >> 8);
-  uint8_t b1 = packet_length & 0x00ff;
-  auto* p = packet.get();
-  *p++ = b0;
-  *p++ = b1;
-  memcpy(p, data, packet_length);
-
-  conn_->send(packet.get(), packet_length + 2, seconds(10));
+  const uint8_t header[2] = {static_cast<uint8_t>((packet_length & 0xff00) >> 8),
+                             static_cast<uint8_t>(packet_length & 0x00ff)};
+  conn_->send_with_header(header, sizeof(header), data, packet_length, seconds(10));
   VLOG(3) << "SEND:  data packet: packet_length: " << packet_length;
   return true;
 }
 
+bool BinkP::send_file_data_packet(TransferFile* file, long start, int size) {
+  if (!conn_->is_open()) {
+    return false;
+  }
+  if (const auto fd = file->native_handle(); fd >= 0) {
+    const uint8_t header[2] = {static_cast<uint8_t>((size & 0x7f00) >> 8),
+                               static_cast<uint8_t>(size & 0x00ff)};
+    if (conn_->send_file_with_header(header, sizeof(header), fd, start, size, seconds(10))) {
+      VLOG(3) << "SEND:  data packet (sendfile): packet_length: " << size;
+      return true;
+    }
+  }
+  if (!send_chunk_) {
+    send_chunk_ = std::make_unique<char[]>(BINKP_MAX_DATA_FRAME_SIZE);
+  }
+  if (!file->GetChunk(send_chunk_.get(), start, size)) {
+    return false;
+  }
+  return send_data_packet(send_chunk_.get(), size);
+}
+
 BinkState BinkP::ConnInit() {
   VLOG(1) << "STATE: ConnInit";
   process_frames(seconds(2));
@@ -626,16 +665,16 @@ BinkState BinkP::TransferFiles() {
 
   // Quickly let the inbound event loop percolate.
   process_frames(milliseconds(500));
-  const auto list = file_manager_->CreateTransferFileList(remote_);
+  const auto list = send_transfer_file_list_factory_
+                        ? send_transfer_file_list_factory_(remote_)
+                        : file_manager_->CreateTransferFileList(remote_);
   for (auto* file : list) {
-    SendFilePacket(file);
+    QueueFileToSend(file);
   }
-
-  VLOG(1) << "STATE: After SendFilePacket for all files.";
-  // Quickly let the inbound event loop percolate.
-  for (auto i = 0; i < 5; i++) {
-    process_frames(milliseconds(500));
+  if (!SendQueuedFiles()) {
+    return BinkState::FATAL_ERROR;
   }
+  VLOG(1) << "STATE: After SendQueuedFiles for all files.";
 
   // TODO(rushfan): Should this be in a new state?
   if (files_to_send_.empty()) {
@@ -698,39 +737,99 @@ BinkState BinkP::WaitEob() {
   return BinkState::DONE;
 }
 
-bool BinkP::SendFilePacket(TransferFile* file) {
+void BinkP::QueueFileToSend(TransferFile* file) {
   const auto filename(file->filename());
-  VLOG(1) << "       SendFilePacket: " << filename;
+  VLOG(1) << "       QueueFileToSend: " << filename;
+  if (contains(files_to_send_, filename)) {
+    LOG(WARNING) << "       Skipping duplicate file to send: " << filename;
+    std::unique_ptr<TransferFile> duplicate(file);
+    return;
+  }
   files_to_send_[filename] = std::unique_ptr<TransferFile>(file);
-  send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(0));
-  process_frames(seconds(2));
+  pending_files_.push_back(file);
+}
 
-  // file* may not be viable anymore if it was already send.
-  if (contains(files_to_send_, filename)) {
-    // We have the file still to send.
-    SendFileData(file);
+bool BinkP::SendQueuedFiles() {
+  const auto send_window = std::max(1, config_->send_window());
+  auto last_progress = steady_clock::now();
+  while (conn_->is_open() && !error_received_ && !files_to_send_.empty()) {
+    const auto in_flight = size_int(files_to_send_) - size_int(pending_files_);
+    if (current_send_file_ == nullptr && !pending_files_.empty() && in_flight < send_window) {
+      auto* file = pending_files_.front();
+      pending_files_.pop_front();
+      SendFilePacket(file, remote_nr_ ? -1 : 0);
+    }
+    if (current_send_file_ != nullptr && !waiting_for_get_) {
+      if (!SendNextDataFrame()) {
+        return false;
+      }
+      // Handle any M_GET/M_GOT/M_SKIP that arrived without stalling the pipeline.
+      if (!process_pending_frames()) {
+        return false;
+      }
+      last_progress = steady_clock::now();
+      continue;
+    }
+
+    // Nothing can be sent until the remote answers with M_GET, M_GOT or M_SKIP.
+    const auto num_files = files_to_send_.size();
+    auto predicate = [&]() -> bool {
+      return files_to_send_.size() != num_files ||
+             (current_send_file_ != nullptr && !waiting_for_get_) || error_received_;
+    };
+    process_frames(predicate, seconds(1));
+    if (predicate()) {
+      last_progress = steady_clock::now();
+    } else if (steady_clock::now() - last_progress > BINKP_SEND_IDLE_TIMEOUT) {
+      LOG(WARNING) << "       Timed out waiting for the remote to acknowledge "
+                   << files_to_send_.size() << " files.";
+      break;
+    }
   }
   return true;
 }
 
-bool BinkP::SendFileData(TransferFile* file) {
-  VLOG(1) << "       SendFileData: " << file->filename();
+bool BinkP::SendFilePacket(TransferFile* file, long offset) {
+  VLOG(1) << "       SendFilePacket: " << file->filename() << "; offset: " << offset;
+  current_send_file_ = file;
+  current_send_offset_ = std::max<long>(0, std::min<long>(offset, file->file_size()));
+  waiting_for_get_ = offset < 0;
+  return send_command_packet(BinkpCommands::M_FILE,
+                             file->as_packet_data(static_cast<int>(offset)));
+}
+
+bool BinkP::SendNextDataFrame() {
+  auto* file = current_send_file_;
   const auto file_length = file->file_size();
-  const auto chunk_size = 16384; // This is 1<<14.  The max per spec is (1 << 15) - 1
-  const auto chunk = std::make_unique<char[]>(chunk_size);
-  for (long start = 0; start < file_length; start += chunk_size) {
-    const auto size = std::min<int>(chunk_size, file_length - start);
-    if (!file->GetChunk(chunk.get(), start, size)) {
-      // Bad chunk. Abort
+  const auto size = std::min<int>(BINKP_MAX_DATA_FRAME_SIZE, file_length - current_send_offset_);
+  if (size > 0) {
+    if (!send_file_data_packet(file, current_send_offset_, size)) {
+      LOG(ERROR) << "Unable to read file: " << file->filename()
+                 << " at offset: " << current_send_offset_;
+      send_command_packet(BinkpCommands::M_ERR, StrCat("Unable to read file: ", file->filename()));
+      return false;
     }
-    send_data_packet(chunk.get(), size);
-    // sending multi-chunk files was not reliable.  check after each frame if we have
-    // an inbound command.
-    process_frames(seconds(1));
+    current_send_offset_ += size;
+  }
+  if (current_send_offset_ >= file_length) {
+    VLOG(1) << "       Finished sending: " << file->filename() << "; waiting for M_GOT";
+    current_send_file_ = nullptr;
   }
   return true;
 }
 
+void BinkP::ForgetFileToSend(TransferFile* file) {
+  if (current_send_file_ == file) {
+    current_send_file_ = nullptr;
+    waiting_for_get_ = false;
+  }
+  if (const auto it = std::find(std::begin(pending_files_), std::end(pending_files_), file);
+      it != std::end(pending_files_)) {
+    pending_files_.erase(it);
+  }
+  files_to_send_.erase(file->filename());
+}
+
 bool BinkP::HandlePassword(const std::string& password_line) {
   VLOG(1) << "        HandlePassword: ";
   VLOG(2) << "        password_line: " << password_line;
@@ -770,6 +869,12 @@ bool BinkP::HandleFileRequest(const std::string& request_line) {
                             &crc)) {
     return false;
   }
+  if (starting_offset < 0) {
+    // NR mode; we never have a partial file from an earlier session since the
+    // receive directory is per-session, so ask for the whole file.
+    return send_command_packet(BinkpCommands::M_GET,
+                               fmt::format("{} {} {} 0", filename, expected_length, timestamp));
+  }
   const auto net = remote_.network_name();
   auto* p = new ReceiveFile(received_transfer_file_factory_(net, filename), filename,
                             expected_length, timestamp, crc);
@@ -781,23 +886,29 @@ bool BinkP::HandleFileGetRequest(const std::string& request_line) {
   LOG(INFO) << "       HandleFileGetRequest: request_line: [" << request_line << "]";
   const auto s = SplitString(request_line, " ");
   const auto& filename = s.at(0);
-  //const auto length = to_number<long>(s.at(1));
-  //const auto timestamp = to_number<time_t>(s.at(2));
   long offset = 0;
   if (s.size() >= 4) {
     offset = to_number<long>(s.at(3));
   }
-  if (offset != 0) {
-    LOG(WARNING) << "offset specified in FileGetRequest.  We don't support offset != 0";
-  }
 
   const auto iter = files_to_send_.find(filename);
   if (iter == end(files_to_send_)) {
     LOG(ERROR) << "File not found: " << filename;
     return false;
   }
-  return SendFileData(iter->second.get());
+  auto* file = iter->second.get();
+  if (current_send_file_ != nullptr && current_send_file_ != file) {
+    // Only one file may be sent at a time, so start the interrupted file
+    // again once the requested one has been sent.
+    pending_files_.push_front(current_send_file_);
+  }
+  if (const auto it = std::find(std::begin(pending_files_), std::end(pending_files_), file);
+      it != std::end(pending_files_)) {
+    pending_files_.erase(it);
+  }
+  // Resend from the requested offset, the data frames follow from SendQueuedFiles.
   // File was sent but wait until we receive M_GOT before we remove it from the list.
+  return SendFilePacket(file, std::max<long>(0, offset));
 }
 
 bool BinkP::HandleFileGotRequest(const std::string& request_line) {
@@ -826,13 +937,29 @@ bool BinkP::HandleFileGotRequest(const std::string& request_line) {
   if (!file->Delete()) {
     LOG(ERROR) << "       *** UNABLE TO DELETE FILE: " << file->filename();
   }
-  files_to_send_.erase(iter);
+  ForgetFileToSend(file);
+  return true;
+}
+
+bool BinkP::HandleFileSkipRequest(const std::string& request_line) {
+  LOG(INFO) << "       HandleFileSkipRequest: request_line: [" << request_line << "]";
+  const auto s = SplitString(request_line, " ");
+  const auto& filename = s.at(0);
+
+  const auto iter = files_to_send_.find(filename);
+  if (iter == end(files_to_send_)) {
+    LOG(ERROR) << "File not found: " << filename;
+    return false;
+  }
+  // The remote will take this file in a later session, so leave it on disk.
+  ForgetFileToSend(iter->second.get());
   return true;
 }
 
 void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
   const auto now = DateTime::now();
-  config_->session_identifier(fmt::format("in-{}", now.to_time_t()));
+  // Include the pid since wwivd may start several sessions in the same second.
+  config_->session_identifier(fmt::format("in-{}-{}", now.to_time_t(), get_pid()));
   LOG(INFO) << "session id:  " << config_->session_identifier();
 
   VLOG(1) << "STATE: Run(): side:" << static_cast<int>(side_);
@@ -921,7 +1048,14 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
     net_log.Log(system_clock::to_time_t(start_time), network_log_side, remote_.wwivnet_node(),
                 bytes_sent_, bytes_received_, log_seconds, remote_.network_name());
 
-    // Update contact.net
+    // Update contact.net, other sessions on this network may be finishing too.
+    std::optional<SemaphoreFile> contact_lock;
+    try {
+      const auto lock_path = FilePath(config_->network_dir(remote_.network_name()), "contact.bsy");
+      contact_lock.emplace(SemaphoreFile::try_acquire(lock_path, seconds(30)));
+    } catch (const semaphore_not_acquired& e) {
+      LOG(WARNING) << "Unable to lock contact.net: " << e.what();
+    }
     Contact c(config_->network(remote_.network_name()), true);
     const auto dt = DateTime::from_time_t(system_clock::to_time_t(start_time));
     if (error_received_) {
@@ -27,10 +27,13 @@
 #include "sdk/net/callout.h"
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace wwiv::net {
   
@@ -77,12 +80,25 @@ public:
 
   void Run(const wwiv::core::CommandLine& cmdline);
 
+  // Creates the files to send to the remote; BinkP takes ownership of them.
+  typedef std::function<std::vector<TransferFile*>(const Remote& remote)>
+      send_transfer_file_list_factory_t;
+  // VisibleForTesting
+  // Sends the files from factory instead of the ones in the network directory.
+  void set_send_transfer_file_list_factory(send_transfer_file_list_factory_t factory) {
+    send_transfer_file_list_factory_ = std::move(factory);
+  }
+
 private:
   // Process frames until we time out waiting for a new frame.
   bool process_frames(std::chrono::duration<double> d);
   // Process frames until predicate is satisfied (returns true) or we time out waiting
   // for a new frame.
   bool process_frames(const std::function<bool()>& predicate, std::chrono::duration<double> d);
+  // Process any frames that have already arrived without waiting for new ones.
+  bool process_pending_frames();
+  // Reads and processes a single frame.
+  bool process_frame(std::chrono::duration<double> d);
  
   bool process_opt(const std::string& opt);
   bool process_command(int16_t length, std::chrono::duration<double> d);
@@ -90,6 +106,9 @@ private:
 
   bool send_command_packet(uint8_t command_id, const std::string& data);
   bool send_data_packet(const char* data, int size);
+  // Sends size bytes of file starting at start as a data frame, using
+  // sendfile when the connection and file support it.
+  bool send_file_data_packet(TransferFile* file, long start, int size);
 
   void process_network_files(const wwiv::core::CommandLine& cmdline) const;
 
@@ -108,10 +127,20 @@ private:
   BinkState WaitEob();
   BinkState Unknown();
   BinkState FatalError();
-  bool SendFilePacket(TransferFile* file);
-  bool SendFileData(TransferFile* file);
+  // Adds file to the end of the send queue.  BinkP takes ownership of file.
+  void QueueFileToSend(TransferFile* file);
+  // Sends all queued files, keeping up to send_window files awaiting M_GOT.
+  bool SendQueuedFiles();
+  // Sends M_FILE for file starting at offset (-1 for NR mode) and makes it
+  // the current file being sent.
+  bool SendFilePacket(TransferFile* file, long offset);
+  // Sends the next data frame of the current file being sent.
+  bool SendNextDataFrame();
+  // Stops sending the current file and removes it from the send queue.
+  void ForgetFileToSend(TransferFile* file);
   bool HandleFileGetRequest(const std::string& request_line);
   bool HandleFileGotRequest(const std::string& request_line);
+  bool HandleFileSkipRequest(const std::string& request_line);
   bool HandlePassword(const std::string& password_line);
   bool HandleFileRequest(const std::string& request_line);
 
@@ -121,12 +150,28 @@ private:
   wwiv::core::Connection* conn_ = nullptr;
   bool ok_received_ = false;
   bool eob_received_ = false;
+  // All files to send that have not yet been acknowledged by M_GOT or M_SKIP.
   std::map<std::string, std::unique_ptr<TransferFile>> files_to_send_;
+  // Files in files_to_send_ that we have not yet sent an M_FILE for, in order.
+  std::deque<TransferFile*> pending_files_;
+  // File whose data frames we are currently sending, or nullptr.
+  TransferFile* current_send_file_ = nullptr;
+  // Offset of the next data frame to send from current_send_file_.
+  long current_send_offset_ = 0;
+  // True if we sent M_FILE with offset -1 and are waiting on the M_GET.
+  bool waiting_for_get_ = false;
+  // True if the remote asked for NR mode (OPT NR).
+  bool remote_nr_ = false;
+  // Reusable buffer for outbound data frames.
+  std::unique_ptr<char[]> send_chunk_;
+  // Reusable buffer for inbound data frames.
+  std::unique_ptr<char[]> receive_chunk_;
   BinkSide side_;
   const std::string expected_remote_node_;
   std::string remote_password_;
   bool error_received_ = false;
   received_transfer_file_factory_t received_transfer_file_factory_;
+  send_transfer_file_list_factory_t send_transfer_file_list_factory_;
   std::unique_ptr<ReceiveFile> current_receive_file_;
   unsigned int bytes_received_ = 0;
   unsigned int bytes_sent_ = 0;
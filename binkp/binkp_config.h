@@ -68,6 +68,9 @@ public:
   [[nodiscard]] int verbose() const { return verbose_; }
   void set_network_version(int network_version) { network_version_ = network_version; }
   [[nodiscard]] int network_version() const { return network_version_; }
+  /** Number of files that may be sent before waiting for the remote's M_GOT. */
+  void set_send_window(int send_window) { send_window_ = send_window; }
+  [[nodiscard]] int send_window() const { return send_window_; }
   [[nodiscard]] bool crc() const { return crc_; }
   [[nodiscard]] bool cram_md5() const { return cram_md5_; }
   [[nodiscard]] const sdk::Config& config() const { return config_; }
@@ -94,6 +97,7 @@ private:
   bool skip_net_{false};
   int verbose_{0};
   int network_version_{38};
+  int send_window_{8};
   bool crc_{true};
   bool cram_md5_{true};
   std::string session_identifier_;
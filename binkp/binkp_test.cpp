@@ -26,8 +26,15 @@
 #include "sdk/net/callout.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 using wwiv::sdk::Callout;
 using namespace wwiv::core;
@@ -70,6 +77,146 @@ protected:
     thread_.join();
   }
 
+  /**
+   * Starts an answering session that sends files to node 2, with the test
+   * playing the originating side.  Files are name and contents pairs.
+   */
+  void StartSession(const std::vector<std::pair<std::string, std::string>>& files,
+                    int send_window, bool nr) {
+    CHECK(files_.Mkdir("network"));
+    CHECK(files_.Mkdir("gfiles"));
+    const auto network_dir = files_.DirName("network");
+    wwiv::sdk::config_t wwiv_config_{};
+    wwiv::sdk::Config config(File::current_directory(), wwiv_config_);
+    config.gfilesdir(files_.DirName("gfiles"));
+    Network net(network_type_t::wwivnet, "WWIVnet");
+    net.dir = network_dir;
+    binkp_config_ = std::make_unique<BinkConfig>(ORIGINATING_ADDRESS, config, network_dir);
+    binkp_config_->callouts()["wwivnet"] = std::make_unique<Callout>(net, 0);
+    binkp_config_->address_pw_map.try_emplace(FidoAddress("20000:20000/2@wwivnet"), "-");
+    binkp_config_->set_skip_net(true);
+    binkp_config_->set_send_window(send_window);
+    BinkP::received_transfer_file_factory_t null_factory = [](const std::string&,
+                                                              const std::string& filename) {
+      return new InMemoryTransferFile(filename, "");
+    };
+    binkp_.reset(new BinkP(&conn_, binkp_config_.get(), BinkSide::ANSWERING, ANSWERING_ADDRESS,
+                           null_factory));
+    binkp_->set_send_transfer_file_list_factory([this, files](const Remote&) {
+      std::vector<TransferFile*> result;
+      for (const auto& [name, contents] : files) {
+        result.push_back(new RecordingTransferFile(name, contents, deleted_));
+      }
+      return result;
+    });
+
+    if (nr) {
+      conn_.ReplyCommand(BinkpCommands::M_NUL, "OPT NR");
+    }
+    conn_.ReplyCommand(BinkpCommands::M_ADR, "20000:20000/2@wwivnet");
+    conn_.ReplyCommand(BinkpCommands::M_PWD, "-");
+    thread_ = std::thread([&]() {
+      CommandLine cmdline({"networkb_tests.exe"}, "");
+      binkp_->Run(cmdline);
+    });
+  }
+
+  /**
+   * Collects the packets sent by BinkP until done returns true for the
+   * packets so far, failing after 10 seconds.
+   */
+  bool ReadUntil(const std::function<bool(const FakeBinkpPacket&)>& done) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < end) {
+      if (!conn_.has_sent_packets()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      const auto p = conn_.GetNextPacket();
+      sent_.push_back(p);
+      if (done(p)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Reads until BinkP sends command_id with text starting with prefix. */
+  bool ReadUntilCommand(uint8_t command_id, const std::string& prefix = "") {
+    return ReadUntil([&](const FakeBinkpPacket& p) {
+      return p.is_command() && p.command() == command_id && starts_with(text(p), prefix);
+    });
+  }
+
+  /** Gives BinkP time to send anything else it's going to. */
+  void ReadPending() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    while (conn_.has_sent_packets()) {
+      sent_.push_back(conn_.GetNextPacket());
+    }
+  }
+
+  static std::string text(const FakeBinkpPacket& p) {
+    return p.is_command() ? p.data().substr(1) : p.data();
+  }
+
+  [[nodiscard]] std::vector<std::string> commands(uint8_t command_id) const {
+    std::vector<std::string> result;
+    for (const auto& p : sent_) {
+      if (p.is_command() && p.command() == command_id) {
+        result.push_back(text(p));
+      }
+    }
+    return result;
+  }
+
+  /** All of the data frames sent, joined together. */
+  [[nodiscard]] std::string data() const {
+    std::string result;
+    for (const auto& p : sent_) {
+      if (!p.is_command()) {
+        result += p.data();
+      }
+    }
+    return result;
+  }
+
+  /** Ends the session once all files are done. */
+  void FinishSession() {
+    EXPECT_TRUE(ReadUntilCommand(BinkpCommands::M_EOB));
+    conn_.ReplyCommand(BinkpCommands::M_EOB, "");
+    Stop();
+  }
+
+  [[nodiscard]] bool deleted(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(deleted_->mu);
+    return deleted_->names.count(name) > 0;
+  }
+
+  struct deleted_files_t {
+    mutable std::mutex mu;
+    std::set<std::string> names;
+  };
+
+  /** Records the names of the files deleted after M_GOT. */
+  class RecordingTransferFile final : public InMemoryTransferFile {
+  public:
+    RecordingTransferFile(const std::string& filename, const std::string& contents,
+                          std::shared_ptr<deleted_files_t> deleted)
+        : InMemoryTransferFile(filename, contents, 0), deleted_(std::move(deleted)) {}
+    bool Delete() override {
+      std::lock_guard<std::mutex> lock(deleted_->mu);
+      deleted_->names.insert(filename());
+      return true;
+    }
+
+  private:
+    std::shared_ptr<deleted_files_t> deleted_;
+  };
+
+  std::shared_ptr<deleted_files_t> deleted_ = std::make_shared<deleted_files_t>();
+  std::vector<FakeBinkpPacket> sent_;
+
   std::unique_ptr<BinkP> binkp_;
   std::unique_ptr<BinkConfig> binkp_config_;
   FakeConnection conn_;
@@ -87,6 +234,59 @@ TEST_F(BinkTest, ErrorAbortsSession) {
   }
 }
 
+TEST_F(BinkTest, SendWindow) {
+  StartSession({{"a.net", "aaaaa"}, {"b.net", "bbbbb"}, {"c.net", "ccccc"}}, 2, false);
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "b.net"));
+  ASSERT_TRUE(ReadUntil([](const FakeBinkpPacket& p) { return !p.is_command(); }));
+  ReadPending();
+  // Both files are streamed without waiting, but the third has to wait for
+  // one of them to be acknowledged.
+  EXPECT_EQ(2u, commands(BinkpCommands::M_FILE).size());
+  EXPECT_EQ("aaaaabbbbb", data());
+
+  conn_.ReplyCommand(BinkpCommands::M_GOT, "a.net 5 0");
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "c.net 5 0 0"));
+  conn_.ReplyCommand(BinkpCommands::M_GOT, "b.net 5 0");
+  conn_.ReplyCommand(BinkpCommands::M_GOT, "c.net 5 0");
+  FinishSession();
+
+  EXPECT_EQ("aaaaabbbbbccccc", data());
+  EXPECT_TRUE(deleted("a.net"));
+  EXPECT_TRUE(deleted("b.net"));
+  EXPECT_TRUE(deleted("c.net"));
+}
+
+TEST_F(BinkTest, GetResumesFromOffset) {
+  StartSession({{"a.net", "0123456789"}}, 8, true);
+  // In NR mode the file is offered with an offset of -1 and nothing is sent
+  // until the remote says where to start.
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "a.net 10 0 -1"));
+  ReadPending();
+  EXPECT_TRUE(data().empty());
+
+  conn_.ReplyCommand(BinkpCommands::M_GET, "a.net 10 0 4");
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "a.net 10 0 4"));
+  ASSERT_TRUE(ReadUntil([](const FakeBinkpPacket& p) { return !p.is_command(); }));
+  EXPECT_EQ("456789", data());
+
+  conn_.ReplyCommand(BinkpCommands::M_GOT, "a.net 10 0");
+  FinishSession();
+  EXPECT_TRUE(deleted("a.net"));
+}
+
+TEST_F(BinkTest, SkipKeepsFile) {
+  StartSession({{"a.net", "aaaaa"}, {"b.net", "bbbbb"}}, 1, false);
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "a.net"));
+  conn_.ReplyCommand(BinkpCommands::M_SKIP, "a.net 5 0");
+  ASSERT_TRUE(ReadUntilCommand(BinkpCommands::M_FILE, "b.net"));
+  conn_.ReplyCommand(BinkpCommands::M_GOT, "b.net 5 0");
+  FinishSession();
+
+  // The skipped file is left for a later session.
+  EXPECT_FALSE(deleted("a.net"));
+  EXPECT_TRUE(deleted("b.net"));
+}
+
 static int node_number_from_address_list(const std::string& addresses,
                                          const std::string& network_name) {
   const auto a = ftn_address_from_address_list(addresses, network_name);
@@ -190,3 +390,16 @@ TEST(FtnFromAddressListSet, WithoutDomainInADR_NotFound) {
   const auto known = ftn_addresses_from_address_list(address, addresses);
   EXPECT_THAT(known, testing::IsEmpty());
 }
+
+TEST(ParseFileRequestLineTest, NrModeOffset) {
+  std::string filename;
+  long length = 0;
+  time_t timestamp = 0;
+  long offset = 0;
+  uint32_t crc = 0;
+  ASSERT_TRUE(ParseFileRequestLine("s1.net 1234 5678 -1", &filename, &length, &timestamp, &offset, &crc));
+  EXPECT_EQ("s1.net", filename);
+  EXPECT_EQ(1234, length);
+  EXPECT_EQ(5678, timestamp);
+  EXPECT_EQ(-1, offset);
+}
@@ -36,17 +36,14 @@ using namespace wwiv::strings;
 using namespace wwiv::net;
 
 FakeBinkpPacket::FakeBinkpPacket(const void* data, int size) {
-  auto p = static_cast<const char*>(data);
-  header_ = *p++ << 8;
+  auto p = static_cast<const uint8_t*>(data);
+  header_ = static_cast<uint16_t>(*p++ << 8);
   header_ = header_ | *p++;
-  is_command_ = (header_ | 0x8000) != 0;
+  is_command_ = (header_ & 0x8000) != 0;
   header_ &= 0x7fff;
-
-  if (is_command_) {
-    command_ = *p;
-  }
+  command_ = is_command_ ? *p : 0;
   // size doesn't include the uint16_t header.
-  data_ = std::string(p, size - 2);  
+  data_ = std::string(reinterpret_cast<const char*>(p), size - 2);
 }
 
 FakeBinkpPacket::~FakeBinkpPacket() = default;
@@ -101,7 +98,20 @@ uint8_t FakeConnection::read_uint8(std::chrono::duration<double> d) {
   if (!front.is_command()) {
     throw std::logic_error("called read_uint8 on a data packet");
   }
-  return front.command();
+  const auto command = front.command();
+  if (front.data().size() <= 1) {
+    // No data follows the command id, so receive won't be called for it.
+    receive_queue_.pop();
+  }
+  return command;
+}
+
+bool FakeConnection::wait_for_data(std::chrono::duration<double> d) {
+  auto predicate = [&]() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return !receive_queue_.empty();
+  };
+  return wait_for(predicate, d);
 }
 
 int FakeConnection::receive(void* data, int size, duration<double> d) {
@@ -122,7 +132,8 @@ std::string FakeConnection::receive(int, duration<double> d) {
   std::lock_guard<std::mutex> lock(mu_);
   wwiv::core::ScopeExit on_exit([=] { receive_queue_.pop(); });
   const FakeBinkpPacket& front = receive_queue_.front();
-  return front.data();
+  // The command id was already read by read_uint8.
+  return front.is_command() ? front.data().substr(1) : front.data();
 }
 
 int FakeConnection::send(const void* data, int size, std::chrono::duration<double>) {
@@ -19,6 +19,7 @@
 #define INCLUDED_BINKP_TEST_FAKE_CONNECTION_H
 
 #include "core/connection.h"
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
@@ -59,6 +60,7 @@ public:
 
   uint16_t read_uint16(std::chrono::duration<double> d) override;
   uint8_t read_uint8(std::chrono::duration<double> d) override;
+  bool wait_for_data(std::chrono::duration<double> d) override;
   bool is_open() const override;
   bool close() override;
 
@@ -72,7 +74,7 @@ public:
   std::queue<FakeBinkpPacket> send_queue_;
 private:
   mutable std::mutex mu_;
-  bool open_{};
+  std::atomic<bool> open_{true};
 };
 
 #endif
\ No newline at end of file
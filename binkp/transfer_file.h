@@ -40,6 +40,9 @@ public:
   virtual bool GetChunk(char* chunk, int start, int size) = 0;
   virtual bool WriteChunk(const char* chunk, int size) = 0;
   virtual bool Close() = 0;
+  // Returns an open file descriptor that may be read from directly (i.e. with
+  // sendfile) to send this file, or -1 if the contents must use GetChunk.
+  [[nodiscard]] virtual int native_handle() { return -1; }
 
  protected:
   [[nodiscard]] std::string as_packet_data(int size, int offset) const;
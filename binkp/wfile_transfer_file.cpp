@@ -93,6 +93,15 @@ bool WFileTransferFile::GetChunk(char* chunk, int start, int size) {
   return file_->Read(chunk, size) == size;
 }
 
+int WFileTransferFile::native_handle() {
+  if (!file_->IsOpen()) {
+    if (!file_->Open(File::modeBinary | File::modeReadOnly)) {
+      return -1;
+    }
+  }
+  return file_->handle();
+}
+
 bool WFileTransferFile::WriteChunk(const char* chunk, int size) {
   VLOG(3) << "WFileTransferFile::WriteChunk";
   if (!file_->IsOpen()) {
@@ -38,6 +38,7 @@ public:
   bool GetChunk(char* chunk, int start, int size) override final;
   bool WriteChunk(const char* chunk, int size) override final;
   bool Close() override final;
+  [[nodiscard]] int native_handle() override final;
   void set_flo_file(std::unique_ptr<wwiv::sdk::fido::FloFile>&& f) { flo_file_ = std::move(f); }
 
  private:
@@ -162,11 +162,7 @@ unsigned char RemoteSocketIO::getW() {
     return 0;
   }
   char ch = 0;
-  std::lock_guard<std::mutex> lock(mu_);
-  if (!queue_.empty()) {
-    ch = queue_.front();
-    queue_.pop();
-  }
+  input_.get(ch);
   return static_cast<unsigned char>(ch);
 }
 
@@ -187,10 +183,7 @@ void RemoteSocketIO::purgeIn() {
     return;
   }
 
-  std::lock_guard<std::mutex> lock(mu_);
-  while (!queue_.empty()) {
-    queue_.pop();
-  }
+  input_.clear();
 }
 
 unsigned int RemoteSocketIO::read(char* buffer, unsigned int count) {
@@ -199,17 +192,10 @@ unsigned int RemoteSocketIO::read(char* buffer, unsigned int count) {
     return 0;
   }
 
-  unsigned int num_read = 0;
-  auto* temp = buffer;
-
-  std::lock_guard<std::mutex> lock(mu_);
-  while (!queue_.empty() && num_read <= count) {
-    const auto ch = queue_.front();
-    queue_.pop();
-    *temp++ = ch;
-    num_read++;
+  const auto num_read = static_cast<unsigned int>(input_.read(buffer, count));
+  if (num_read < count) {
+    buffer[num_read] = '\0';
   }
-  *temp = '\0';
   return num_read;
 }
 
@@ -265,8 +251,7 @@ bool RemoteSocketIO::incoming() {
     return false;
   }
 
-  std::lock_guard<std::mutex> lock(mu_);
-  return !queue_.empty();
+  return !input_.empty();
 }
 
 void RemoteSocketIO::StopThreads() {
@@ -474,50 +459,119 @@ void RemoteSocketIO::HandleTelnetIAC(unsigned char nCmd, unsigned char nParam) {
   }
 }
 
-void RemoteSocketIO::AddStringToInputBuffer(int start, int end, const char* buffer) {
-  // Add the data to the input buffer
-  for (auto num_sleeps = 0; num_sleeps < 10 && queue_.size() > 32678; ++num_sleeps) {
-    sleep_for(milliseconds(100));
-  }
-
-  std::lock_guard<std::mutex> lock(mu_);
-
-  if (binary_mode()) {
-    for (auto i = start; i < end; i++) {
-      const uint8_t c = buffer[i];
-      if (skip_next_ && c == 0xff) {
-        skip_next_ = false;
-        continue;
-      }
-      if (c == 0xff) {
-        // TODO(rushfan): If this causes problems, we can add a setting for this
-        VLOG(2) << "Got an escaped 255 possibly";
-        skip_next_ = true;
-      } else {
-        skip_next_ = false;
-      }
-      queue_.push(c);
+// Returns the first NUL or IAC in [p, end), or end if there are none.
+// Ordinary input is scanned a word at a time so that it can be copied
+// in bulk.
+static const char* find_nul_or_iac(const char* p, const char* end) {
+  static constexpr uint64_t ones = 0x0101010101010101ULL;
+  static constexpr uint64_t highs = 0x8080808080808080ULL;
+  while (end - p >= 8) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    // A byte of v is zero (NUL) or a byte of ~v is zero (IAC).
+    const auto inv = ~v;
+    if ((((v - ones) & ~v) | ((inv - ones) & v)) & highs) {
+      break;
     }
-    return;
+    p += 8;
   }
-  for (auto i = start; i < end; i++) {
-    if (static_cast<unsigned char>(buffer[i]) == 255) {
-      if ((i + 1) < end && static_cast<unsigned char>(buffer[i + 1]) == 255) {
-        queue_.push(buffer[i + 1]);
-        i++;
-      } else if ((i + 2) < end) {
-        HandleTelnetIAC(buffer[i + 1], buffer[i + 2]);
-        i += 2;
-      } else {
-        // ::OutputDebugString("WHAT THE HECK?!?!?!? 255 w/o any options or anything\r\n");
+  while (p != end && *p != '\0' && *p != CHAR_TELNET_OPTION_IAC) {
+    ++p;
+  }
+  return p;
+}
+
+void RemoteSocketIO::ParseTelnet(const char* p, const char* end) {
+  for (; p != end; ++p) {
+    const auto ch = static_cast<unsigned char>(*p);
+    switch (telnet_state_) {
+    case telnet_state_t::data: {
+      const auto* q = find_nul_or_iac(p, end);
+      parsed_.append(p, q - p);
+      if (q == end) {
+        return;
       }
-    } else if (buffer[i] != '\0') {
       // RF20020906: I think the nulls in the input buffer were being bad...
       // This fixed the problem with CRT to a linux machine and then telnet from
       // that linux box to the bbs... Hopefully this will fix the Win9x built-in
       // telnet client as well as TetraTERM.
-      queue_.push(buffer[i]);
+      if (*q == CHAR_TELNET_OPTION_IAC) {
+        telnet_state_ = telnet_state_t::iac;
+      }
+      p = q;
+    } break;
+    case telnet_state_t::iac:
+      if (ch == TELNET_OPTION_IAC) {
+        parsed_.push_back(CHAR_TELNET_OPTION_IAC);
+        telnet_state_ = telnet_state_t::data;
+      } else if (ch == TELNET_SB) {
+        telnet_state_ = telnet_state_t::subnegotiation;
+      } else if (ch >= TELNET_OPTION_WILL && ch <= TELNET_OPTION_DONT) {
+        telnet_command_ = ch;
+        telnet_state_ = telnet_state_t::option;
+      } else {
+        HandleTelnetIAC(ch, 0);
+        telnet_state_ = telnet_state_t::data;
+      }
+      break;
+    case telnet_state_t::option:
+      HandleTelnetIAC(telnet_command_, ch);
+      telnet_state_ = telnet_state_t::data;
+      break;
+    case telnet_state_t::subnegotiation:
+      if (ch == TELNET_OPTION_IAC) {
+        telnet_state_ = telnet_state_t::subnegotiation_iac;
+      }
+      break;
+    case telnet_state_t::subnegotiation_iac:
+      telnet_state_ =
+          ch == TELNET_SE ? telnet_state_t::data : telnet_state_t::subnegotiation;
+      break;
+    }
+  }
+}
+
+void RemoteSocketIO::ParseBinary(const char* p, const char* end) {
+  while (p != end) {
+    if (skip_next_ && *p == CHAR_TELNET_OPTION_IAC) {
+      skip_next_ = false;
+      ++p;
+      continue;
+    }
+    const auto* q = static_cast<const char*>(memchr(p, CHAR_TELNET_OPTION_IAC, end - p));
+    if (q == nullptr) {
+      parsed_.append(p, end - p);
+      skip_next_ = false;
+      return;
+    }
+    // TODO(rushfan): If this causes problems, we can add a setting for this
+    VLOG(2) << "Got an escaped 255 possibly";
+    parsed_.append(p, q - p + 1);
+    skip_next_ = true;
+    p = q + 1;
+  }
+}
+
+void RemoteSocketIO::AddStringToInputBuffer(int start, int end, const char* buffer) {
+  parsed_.clear();
+  if (binary_mode()) {
+    ParseBinary(buffer + start, buffer + end);
+  } else {
+    ParseTelnet(buffer + start, buffer + end);
+  }
+
+  // Add the data to the input buffer, waiting for the session to make room
+  // if it has fallen behind.
+  const auto* p = parsed_.data();
+  auto left = parsed_.size();
+  while (left > 0) {
+    const auto n = input_.write(p, left);
+    p += n;
+    left -= n;
+    if (left == 0 || stop_.load()) {
+      break;
     }
+    sleep_for(milliseconds(10));
   }
 }
 
@@ -22,10 +22,11 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include "core/net.h" // INVALID_SOCKET
 #include "common/remote_io.h"
+#include "core/spsc_ring_buffer.h"
 #include <atomic>
 #include <cstdint>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
 
 #if defined( _WIN32 )
@@ -62,6 +63,9 @@ class RemoteSocketIO final : public RemoteIO {
   static const uint8_t TELNET_OPTION_TERMINAL_SPEED = 32;
   static const uint8_t TELNET_OPTION_LINEMODE = 34;
 
+  // Size of the buffer between the socket reader thread and the session.
+  static constexpr std::size_t INPUT_BUFFER_SIZE = 64 * 1024;
+
   static bool Initialize();
 
   RemoteSocketIO(unsigned int socket_handle, bool telnet);
@@ -84,7 +88,7 @@ class RemoteSocketIO final : public RemoteIO {
 
   // VisibleForTesting
   void AddStringToInputBuffer(int start, int end, const char* buffer);
-  std::queue<char>& queue() { return queue_; }
+  core::SpscRingBuffer& input_buffer() { return input_; }
 
   void set_binary_mode(bool b) override;
   std::optional<ScreenPos> screen_position() override;
@@ -92,16 +96,27 @@ class RemoteSocketIO final : public RemoteIO {
 private:
   void HandleTelnetIAC(unsigned char nCmd, unsigned char nParam);
   void InboundTelnetProc();
+  // Appends the data from the caller in [p, end) to parsed_, handling any
+  // telnet commands along the way.
+  void ParseTelnet(const char* p, const char* end);
+  void ParseBinary(const char* p, const char* end);
+
+  enum class telnet_state_t { data, iac, option, subnegotiation, subnegotiation_iac };
 
-  std::queue<char> queue_;
-  mutable std::mutex mu_;
+  // Written by the reader thread and read by the session.
+  core::SpscRingBuffer input_{INPUT_BUFFER_SIZE};
   mutable std::mutex threads_started_mu_;
   SOCKET socket_{INVALID_SOCKET};
   std::thread read_thread_;
   std::atomic<bool> stop_;
   bool threads_started_{false};
   bool telnet_{true};
+  // Only used by the reader thread, since telnet commands may be split
+  // across reads from the socket.
+  telnet_state_t telnet_state_{telnet_state_t::data};
+  unsigned char telnet_command_{0};
   bool skip_next_{false};
+  std::string parsed_;
 };
 
 
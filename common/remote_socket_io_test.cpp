@@ -21,48 +21,61 @@
 #include "gtest/gtest.h"
 #include "common/remote_socket_io.h"
 
+#include <chrono>
+#include <iostream>
 #include <string>
 
+using namespace std::chrono;
 using namespace wwiv::common;
+using namespace wwiv::core;
 using namespace testing;
 
-std::string DumpQueue(std::queue<char>& q) {
+std::string DumpQueue(SpscRingBuffer& q) {
   std::ostringstream ss;
-  while (!q.empty()) {
-    uint8_t c = q.front();
-    ss << fmt::format("[{:x}]", c);
-    q.pop();
+  char ch;
+  while (q.get(ch)) {
+    ss << fmt::format("[{:x}]", static_cast<uint8_t>(ch));
   }
   return ss.str();
 }
 
+static std::string ReadAll(RemoteSocketIO& io) {
+  std::string s;
+  char buf[256];
+  while (io.incoming()) {
+    const auto num_read = io.read(buf, sizeof(buf));
+    s.append(buf, num_read);
+  }
+  return s;
+}
+
 
 TEST(RemoteSocketIOTest, OneFF) {
   RemoteSocketIO io(1, true);
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 4, "\x1\xff\x0\x2");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
 }
 
 TEST(RemoteSocketIOTest, OneFFAtEnd) {
   RemoteSocketIO io(1, true);
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 4, "\x1\x0\x2\xff");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
 }
 
 TEST(RemoteSocketIOTest, OneFFAtEndAndOnePast) {
   RemoteSocketIO io(1, true);
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 4, "\x1\x0\x2\xff\xff\xff");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
 }
 
 TEST(RemoteSocketIOTest, TwoFF) {
   RemoteSocketIO io(1, true);
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 5, "\x1\xff\xff\x0\x2");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
 }
 
 TEST(RemoteSocketIOTest, SplitTwoFF) {
@@ -70,14 +83,92 @@ TEST(RemoteSocketIOTest, SplitTwoFF) {
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 2, "\x1\xff");
   io.AddStringToInputBuffer(0, 3,"\xff\x0\x2");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
 }
 
 TEST(RemoteSocketIOTest, TwoFFAtEnd) {
   RemoteSocketIO io(1, true);
   io.set_binary_mode(true);
   io.AddStringToInputBuffer(0, 5, "\x1\x0\x2\xff\xff");
-  EXPECT_EQ(io.queue().size(), 4u) << DumpQueue(io.queue());
+  EXPECT_EQ(io.input_buffer().size(), 4u) << DumpQueue(io.input_buffer());
+}
+
+TEST(RemoteSocketIOTest, Telnet_Plain) {
+  RemoteSocketIO io(1, true);
+  const std::string s = "Hello World\r\nThis is a longer line of text.";
+  io.AddStringToInputBuffer(0, static_cast<int>(s.size()), s.c_str());
+  EXPECT_EQ(s, ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Telnet_DropsNul) {
+  RemoteSocketIO io(1, true);
+  io.AddStringToInputBuffer(0, 5, "ab\r\0c");
+  EXPECT_EQ("ab\rc", ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Telnet_EscapedFF) {
+  RemoteSocketIO io(1, true);
+  io.AddStringToInputBuffer(0, 4, "a\xff\xff" "b");
+  EXPECT_EQ("a\xff" "b", ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Telnet_Option) {
+  RemoteSocketIO io(1, true);
+  // IAC WONT ECHO
+  io.AddStringToInputBuffer(0, 5, "a\xff\xfc\x01" "b");
+  EXPECT_EQ("ab", ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Telnet_SplitOption) {
+  RemoteSocketIO io(1, true);
+  io.AddStringToInputBuffer(0, 2, "a\xff");
+  io.AddStringToInputBuffer(0, 1, "\xfc");
+  io.AddStringToInputBuffer(0, 2, "\x01" "b");
+  EXPECT_EQ("ab", ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Telnet_Subnegotiation) {
+  RemoteSocketIO io(1, true);
+  // IAC SB TERMINAL-TYPE IS "ANSI" IAC SE, with an escaped IAC inside.
+  static constexpr char s[] = "a\xff\xfa\x18\x00" "AN\xff\xffSI\xff\xf0" "b";
+  io.AddStringToInputBuffer(0, sizeof(s) - 1, s);
+  EXPECT_EQ("ab", ReadAll(io));
+}
+
+TEST(RemoteSocketIOTest, Read_DoesNotOverflow) {
+  RemoteSocketIO io(1, true);
+  io.AddStringToInputBuffer(0, 6, "abcdef");
+  char buf[5] = {'x', 'x', 'x', 'x', 'Z'};
+  EXPECT_EQ(4u, io.read(buf, 4));
+  EXPECT_EQ("abcd", std::string(buf, 4));
+  EXPECT_EQ('Z', buf[4]);
+}
+
+// Measures the throughput of the input path from the socket reader to the
+// session.  Run with --gtest_also_run_disabled_tests.
+TEST(RemoteSocketIOTest, DISABLED_Benchmark_Input) {
+  RemoteSocketIO io(1, true);
+  std::string chunk;
+  while (chunk.size() < 4096) {
+    chunk.append("The quick brown fox jumps over the lazy dog.\r\n");
+  }
+  chunk.resize(4096);
+  static constexpr int NUM_CHUNKS = 64 * 1024;
+
+  std::vector<char> buf(chunk.size());
+  auto total = 0u;
+  const auto start = steady_clock::now();
+  for (auto i = 0; i < NUM_CHUNKS; i++) {
+    io.AddStringToInputBuffer(0, static_cast<int>(chunk.size()), chunk.data());
+    while (io.incoming()) {
+      total += io.read(buf.data(), static_cast<unsigned int>(buf.size()));
+    }
+  }
+  const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start).count();
+  EXPECT_EQ(chunk.size() * NUM_CHUNKS, total);
+  std::cout << fmt::format("Input: {} MB in {} ms: {:.1f} MB/s\n", total / (1024 * 1024),
+                           elapsed / 1000,
+                           static_cast<double>(total) / std::max<int64_t>(1, elapsed));
 }
 
 //TEST(RemoteSocketIOTest, DSR_Smoke) {
@@ -21,6 +21,8 @@
 // ReSharper disable CppUnusedIncludeDirective
 #include "core/stl.h"
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <cereal/access.hpp>
 #include <cereal/cereal.hpp>
@@ -33,12 +35,32 @@
 
 namespace cereal {
 
+template <typename Archive, typename = void> struct has_set_next_name : std::false_type {};
+
+template <typename Archive>
+struct has_set_next_name<Archive,
+                         std::void_t<decltype(std::declval<Archive&>().setNextName(nullptr))>>
+    : std::true_type {};
+
+/**
+ * Called from a catch block when a field could not be serialized.  Archives
+ * with named fields (JSON) skip the missing field, binary archives can't
+ * skip anything so the exception is rethrown.
+ */
+template <typename Archive> void skip_missing_field(Archive& ar) {
+  if constexpr (has_set_next_name<Archive>::value) {
+    ar.setNextName(nullptr);
+  } else {
+    throw;
+  }
+}
+
 #define SERIALIZE(n, field)                                                                        \
   do {                                                                                             \
     try {                                                                                          \
       ar(cereal::make_nvp(#field, (n).field));                                                     \
     } catch (const cereal::Exception&) {                                                           \
-      ar.setNextName(nullptr);                                                                     \
+      cereal::skip_missing_field(ar);                                                              \
     }                                                                                              \
   } while (false)
 
@@ -47,7 +69,7 @@ namespace cereal {
     try {                                                                                          \
       ar(cereal::make_nvp(name, field));                                                     \
     } catch (const cereal::Exception&) {                                                           \
-      ar.setNextName(nullptr);                                                                     \
+      cereal::skip_missing_field(ar);                                                              \
     }                                                                                              \
   } while (false)
 
@@ -374,6 +374,10 @@ bool CommandLine::AddStandardArgs() {
 
   add_argument(
       BooleanCommandLineArgument{"log_startup", "Should the start/stop/args be logged.", false});
+  add_argument({"log_rotate_size", "Rotate log files once larger than this many KB (0 = never).",
+                "0", "WWIV_LOG_ROTATE_SIZE"});
+  add_argument({"log_rotate_days", "Rotate log files once this many days old (0 = never).", "0",
+                "WWIV_LOG_ROTATE_DAYS"});
 
   // Ignore these. used by logger
   add_argument({"v", "verbose log", "0"});
@@ -17,10 +17,27 @@
 /**************************************************************************/
 #include "core/connection.h"
 
+#include <cstring>
+#include <memory>
+
 namespace wwiv::core {
 
 Connection::Connection() noexcept = default;
 
 Connection::~Connection() = default;
 
+int Connection::send_with_header(const void* header, int header_size, const void* data, int size,
+                                 std::chrono::duration<double> d) {
+  const auto total = header_size + size;
+  const auto packet = std::make_unique<char[]>(total);
+  memcpy(packet.get(), header, header_size);
+  memcpy(packet.get() + header_size, data, size);
+  return send(packet.get(), total, d);
+}
+
+bool Connection::send_file_with_header(const void*, int, int, int64_t, int,
+                                       std::chrono::duration<double>) {
+  return false;
+}
+
 } // namespace wwiv
@@ -33,9 +33,29 @@ public:
   virtual std::string receive(int size, std::chrono::duration<double> d) = 0;
   virtual int send(const void* data, int size, std::chrono::duration<double> d) = 0;
   virtual int send(const std::string& s, std::chrono::duration<double> d) = 0;
+  /**
+   * Sends header immediately followed by data, as if they were one buffer.
+   * The default implementation copies both into a single buffer; subclasses
+   * may override to avoid the copy.
+   */
+  virtual int send_with_header(const void* header, int header_size, const void* data, int size,
+                               std::chrono::duration<double> d);
+  /**
+   * Sends header followed by size bytes read from the open file descriptor fd
+   * starting at offset, without copying the file contents through user space.
+   * Returns false without sending anything if this is not supported, in which
+   * case the caller should read the file and use send_with_header.
+   */
+  virtual bool send_file_with_header(const void* header, int header_size, int fd, int64_t offset,
+                                     int size, std::chrono::duration<double> d);
 
   virtual uint16_t read_uint16(std::chrono::duration<double> d) = 0;
   virtual uint8_t read_uint8(std::chrono::duration<double> d) = 0;
+  /**
+   * Waits up to d for inbound data to be available. Returns true if a read
+   * would not block.  A zero duration just polls.
+   */
+  [[nodiscard]] virtual bool wait_for_data(std::chrono::duration<double> d) = 0;
   [[nodiscard]] virtual bool is_open() const = 0;
   virtual bool close() = 0;
 };
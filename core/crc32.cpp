@@ -122,7 +122,7 @@ uint32_t crc32file(const std::filesystem::path& path) {
   return ~crc;
 }
 
-uint32_t crc32string(const std::string& contents) {
+uint32_t crc32string(std::string_view contents) {
   uint32_t crc = 0xFFFFFFFF;
   for (const auto& c : contents) {
     crc = UPDC32(c, crc);
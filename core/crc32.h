@@ -20,11 +20,12 @@
 
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace wwiv::core {
 
 [[nodiscard]] uint32_t crc32file(const std::filesystem::path& path);
-[[nodiscard]] uint32_t crc32string(const std::string& contents);
+[[nodiscard]] uint32_t crc32string(std::string_view contents);
 
 }
 
@@ -19,12 +19,17 @@
 #include "core/http_server.h"
 
 #include "core/datetime.h"
+#include "core/log.h"
+#include "core/socket_exceptions.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
 #include "fmt/format.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 
+using namespace wwiv::stl;
 using namespace wwiv::strings;
 
 namespace wwiv::core {
@@ -53,6 +58,111 @@ std::map<int, std::string> CreateHttpStatusMap() {
   return m;
 }
 
+static std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+static bool equals_ignore_case(std::string_view a, std::string_view b) {
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return to_lower_case_char(x) == to_lower_case_char(y);
+         });
+}
+
+std::optional<std::string> HttpRequest::header(std::string_view name) const {
+  for (const auto& h : headers) {
+    const std::string_view v(h);
+    const auto colon = v.find(':');
+    if (colon != std::string_view::npos && equals_ignore_case(trim(v.substr(0, colon)), name)) {
+      return std::string(trim(v.substr(colon + 1)));
+    }
+  }
+  return std::nullopt;
+}
+
+bool HttpRequest::keep_alive() const {
+  auto close = false;
+  auto keep_alive = false;
+  if (const auto c = header("Connection")) {
+    for (const auto& token : SplitString(c.value(), ",")) {
+      close |= equals_ignore_case(trim(token), "close");
+      keep_alive |= equals_ignore_case(trim(token), "keep-alive");
+    }
+  }
+  if (version == "HTTP/1.0") {
+    return keep_alive && !close;
+  }
+  return !close;
+}
+
+HttpParseResult ParseHttpRequest(std::string_view data, HttpRequest& request, std::size_t& size) {
+  std::vector<std::string_view> lines;
+  std::string_view::size_type pos = 0;
+  while (true) {
+    const auto nl = data.find('\n', pos);
+    if (nl == std::string_view::npos) {
+      return HttpParseResult::INCOMPLETE;
+    }
+    auto line = data.substr(pos, nl - pos);
+    pos = nl + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      lines.push_back(line);
+    } else if (!lines.empty()) {
+      break;
+    }
+    // Blank lines before the request line are ignored (RFC 7230 3.5).
+  }
+
+  const auto& request_line = lines.front();
+  const auto sp1 = request_line.find(' ');
+  const auto sp2 = request_line.rfind(' ');
+  if (sp1 == std::string_view::npos || sp1 == sp2) {
+    return HttpParseResult::BAD_REQUEST;
+  }
+  HttpRequest r{};
+  r.method = std::string(request_line.substr(0, sp1));
+  r.path = std::string(trim(request_line.substr(sp1 + 1, sp2 - sp1 - 1)));
+  r.version = std::string(request_line.substr(sp2 + 1));
+  if (r.method.empty() || r.path.empty() || !starts_with(r.version, "HTTP/1.")) {
+    return HttpParseResult::BAD_REQUEST;
+  }
+  for (auto it = std::next(lines.begin()); it != lines.end(); ++it) {
+    if (it->find(':') == std::string_view::npos) {
+      return HttpParseResult::BAD_REQUEST;
+    }
+    r.headers.emplace_back(*it);
+  }
+
+  // Only GET and HEAD are served, so bodies are only read to find where
+  // the next request starts.
+  if (r.header("Transfer-Encoding")) {
+    return HttpParseResult::BAD_REQUEST;
+  }
+  std::size_t content_length = 0;
+  if (const auto cl = r.header("Content-Length")) {
+    if (cl->empty() || cl->find_first_not_of("0123456789") != std::string::npos ||
+        cl->size() > 9) {
+      return HttpParseResult::BAD_REQUEST;
+    }
+    content_length = to_number<std::size_t>(cl.value());
+  }
+  if (data.size() - pos < content_length) {
+    return HttpParseResult::INCOMPLETE;
+  }
+  r.body = std::string(data.substr(pos, content_length));
+  size = pos + content_length;
+  request = std::move(r);
+  return HttpParseResult::COMPLETE;
+}
+
 HttpServer::HttpServer(std::unique_ptr<SocketConnection> conn)
   : conn_(std::move(conn)) {
 }
@@ -73,60 +183,181 @@ static std::string current_time_as_string() {
   return dt.to_string();
 };
 
+// How long to wait for a client to accept the data sent to it.
+static constexpr auto SEND_TIMEOUT = std::chrono::seconds(10);
+
+class RawResponseWriter final : public HttpResponseWriter {
+public:
+  explicit RawResponseWriter(SocketConnection& conn) : conn_(conn) {}
+  bool write(std::string_view data) override {
+    return conn_.send(data.data(), size_int(data), SEND_TIMEOUT) == size_int(data);
+  }
+
+private:
+  SocketConnection& conn_;
+};
+
+class ChunkedResponseWriter final : public HttpResponseWriter {
+public:
+  explicit ChunkedResponseWriter(SocketConnection& conn) : conn_(conn) {}
+  bool write(std::string_view data) override {
+    if (data.empty()) {
+      // An empty chunk would end the body.
+      return conn_.is_open();
+    }
+    auto chunk = fmt::format("{:x}\r\n", data.size());
+    chunk.append(data).append("\r\n");
+    return conn_.send(chunk, SEND_TIMEOUT) == size_int(chunk);
+  }
+
+private:
+  SocketConnection& conn_;
+};
+
 void HttpServer::SendResponse(const HttpResponse& r) {
+  HttpRequest req{};
+  req.method = "GET";
+  req.version = "HTTP/1.1";
+  Respond(req, r, false);
+  Flush();
+}
+
+bool HttpServer::Respond(const HttpRequest& req, const HttpResponse& r, bool keep_alive) {
   static const auto statuses = CreateHttpStatusMap();
-  const auto d = std::chrono::seconds(1);
-  conn_->send_line(StrCat("HTTP/1.1 ", r.status, " ", statuses.at(r.status)), d);
-  conn_->send_line(StrCat("Date: ", current_time_as_string()), d);
-  conn_->send_line(fmt::format("Server: wwivd/{}", full_version()), d);
-  if (!r.text.empty()) {
-    const auto content_length = r.text.size();
-    conn_->send_line(StrCat("Content-Length: ", content_length), d);
-    conn_->send("\r\n", d);
-    conn_->send(r.text, d);
-  } else {
-    conn_->send_line("Connection: close", d);
-    conn_->send("\r\n", d);
+  const auto head = req.method == "HEAD";
+  const auto chunked = r.stream && req.version != "HTTP/1.0";
+  // Without chunking, the end of a streamed body is the end of the connection.
+  keep_alive &= !r.stream || chunked || head;
+
+  const auto it = statuses.find(r.status);
+  out_.append(StrCat("HTTP/1.1 ", r.status, " ", it != statuses.end() ? it->second : "", "\r\n"));
+  out_.append(StrCat("Date: ", current_time_as_string(), "\r\n"));
+  out_.append(fmt::format("Server: wwivd/{}\r\n", full_version()));
+  for (const auto& [name, value] : r.headers) {
+    out_.append(StrCat(name, ": ", value, "\r\n"));
+  }
+  if (!keep_alive) {
+    out_.append("Connection: close\r\n");
+  } else if (req.version == "HTTP/1.0") {
+    out_.append("Connection: keep-alive\r\n");
   }
+  const auto has_body = r.status >= 200 && r.status != 204 && r.status != 304;
+  if (chunked) {
+    out_.append("Transfer-Encoding: chunked\r\n");
+  } else if (has_body && !r.stream) {
+    out_.append(StrCat("Content-Length: ", r.text.size(), "\r\n"));
+  }
+  out_.append("\r\n");
+
+  if (head || !has_body) {
+    return keep_alive;
+  }
+  if (!r.stream) {
+    out_.append(r.text);
+    return keep_alive;
+  }
+  if (!Flush()) {
+    return false;
+  }
+  if (chunked) {
+    ChunkedResponseWriter writer(*conn_);
+    r.stream(writer);
+    static const std::string last_chunk = "0\r\n\r\n";
+    return conn_->send(last_chunk, SEND_TIMEOUT) == size_int(last_chunk) && keep_alive;
+  }
+  RawResponseWriter writer(*conn_);
+  r.stream(writer);
+  return false;
 }
 
-static std::vector<std::string> read_lines(SocketConnection* conn) {
-  std::vector<std::string> lines;
-  while (true) {
-    auto s = conn->read_line(1024, std::chrono::milliseconds(10));
-    if (!s.empty()) {
-      lines.push_back(s);
-    } else {
-      break;
-    }
+bool HttpServer::Flush() {
+  if (out_.empty()) {
+    return true;
   }
-  return lines;
+  const auto sent = conn_->send(out_, SEND_TIMEOUT);
+  const auto ok = sent == size_int(out_);
+  out_.clear();
+  return ok;
 }
 
-bool HttpServer::Run() {
-  const auto inital_requestline = conn_->read_line(1024, std::chrono::milliseconds(10));
-  if (inital_requestline.empty()) {
+bool HttpServer::Receive(std::chrono::duration<double> d) {
+  if (!conn_->wait_for_data(d)) {
     return false;
   }
-  auto cmd_parts = SplitString(inital_requestline, " ");
-  if (cmd_parts.size() < 3) {
+  // Take everything that has arrived in one go rather than a byte at a time.
+  char buf[8192];
+  const auto num_read = conn_->receive_upto(buf, sizeof(buf), std::chrono::milliseconds(0));
+  if (num_read <= 0) {
+    // Readable with nothing to read means the client has closed.
     return false;
   }
-  const auto& path = cmd_parts.at(1);
-  const auto headers = read_lines(conn_.get());
-  if (const auto & cmd = cmd_parts.at(0); cmd == "GET") {
-    for (const auto& e : get_) {
-      if (starts_with(path, e.first)) {
-        const auto r = e.second->Handle(HttpMethod::GET, path, headers);
-        SendResponse(r);
-        return true;
+  in_.append(buf, num_read);
+  return true;
+}
+
+HttpResponse HttpServer::Dispatch(const HttpRequest& req) {
+  if (req.method != "GET" && req.method != "HEAD") {
+    return HttpResponse(405);
+  }
+  // Roots are sorted, so the last match is the longest one.
+  HttpHandler* handler = nullptr;
+  for (const auto& [root, h] : get_) {
+    if (starts_with(req.path, root)) {
+      handler = h;
+    }
+  }
+  if (handler == nullptr) {
+    return HttpResponse(404);
+  }
+  const auto method = req.method == "HEAD" ? HttpMethod::HEAD : HttpMethod::GET;
+  return handler->Handle(method, req.path, req.headers);
+}
+
+bool HttpServer::Run() {
+  auto num_requests = 0;
+  // When the first byte of the request being received arrived.
+  auto request_start = std::chrono::steady_clock::now();
+  try {
+    while (conn_->is_open()) {
+      HttpRequest req{};
+      std::size_t size = 0;
+      auto result = ParseHttpRequest(in_, req, size);
+      if (result == HttpParseResult::INCOMPLETE && in_.size() <= MAX_REQUEST_SIZE) {
+        // Answer everything pipelined so far before waiting for more.
+        if (!Flush()) {
+          break;
+        }
+        if (in_.empty()) {
+          if (!Receive(KEEPALIVE_TIMEOUT)) {
+            break;
+          }
+          request_start = std::chrono::steady_clock::now();
+          continue;
+        }
+        const auto left = request_start + request_timeout_ - std::chrono::steady_clock::now();
+        if (left <= std::chrono::steady_clock::duration::zero() || !Receive(left)) {
+          break;
+        }
+        continue;
+      }
+      if (result != HttpParseResult::COMPLETE) {
+        SendResponse(HttpResponse(400));
+        break;
+      }
+      in_.erase(0, size);
+      // Any pipelined request after this one has already started arriving.
+      request_start = std::chrono::steady_clock::now();
+      ++num_requests;
+      const auto keep_alive = req.keep_alive() && num_requests < MAX_REQUESTS;
+      if (!Respond(req, Dispatch(req), keep_alive)) {
+        break;
       }
     }
-    SendResponse(HttpResponse(404));
-    return true;
+    Flush();
+  } catch (const socket_error& e) {
+    VLOG(1) << "HttpServer::Run: " << e.what();
   }
-  SendResponse(HttpResponse(405));
-  return false;
+  return num_requests > 0;
 }
 
 
@@ -21,9 +21,14 @@
 
 #include "core/net.h"
 #include "core/socket_connection.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -45,6 +50,43 @@ enum class HttpMethod {
   CONNECT
 };
 
+/**
+ * A request read from the client. headers holds the raw header lines
+ * ("Name: value") without the line endings.
+ */
+struct HttpRequest {
+  std::string method;
+  std::string path;
+  std::string version;
+  std::vector<std::string> headers;
+  std::string body;
+
+  /** Returns the value of the first header named name (ignoring case), if any. */
+  [[nodiscard]] std::optional<std::string> header(std::string_view name) const;
+  /**
+   * True if the client wants the connection kept open after this request:
+   * the default for HTTP/1.1, and only when asked for with HTTP/1.0.
+   */
+  [[nodiscard]] bool keep_alive() const;
+};
+
+enum class HttpParseResult { COMPLETE, INCOMPLETE, BAD_REQUEST };
+
+/**
+ * Parses the request at the start of data into request.  When COMPLETE,
+ * size is set to the number of bytes of data used by the request so that
+ * any pipelined requests after it can be parsed next.
+ */
+HttpParseResult ParseHttpRequest(std::string_view data, HttpRequest& request, std::size_t& size);
+
+/** Writes the body of a streamed response. */
+class HttpResponseWriter {
+public:
+  virtual ~HttpResponseWriter() = default;
+  /** Sends data as the next part of the body, returns false once the client has gone. */
+  virtual bool write(std::string_view data) = 0;
+};
+
 /**
  * Encapsulates an HTTP Response to send to a client.
  */
@@ -65,6 +107,13 @@ public:
   int status;
   std::map<std::string, std::string> headers;
   std::string text;
+  /**
+   * When set, this is called after the headers have been sent instead of
+   * sending text, and writes the body until it returns (i.e. server-sent
+   * events). HTTP/1.1 clients get the body chunked, so the connection may be
+   * reused afterwards.
+   */
+  std::function<void(HttpResponseWriter&)> stream;
 };
 
 class HttpHandler {
@@ -75,25 +124,64 @@ public:
 };
 
 /**
- * Simple HTTP 1.1 Server that can handle GET requests. 
+ * Simple HTTP 1.1 Server that can handle GET and HEAD requests.
+ *
+ * Connections are kept open for as many requests as the client wants to
+ * send, and pipelined requests are answered in order with their responses
+ * sent together.
  */
 class HttpServer final {
 public:
+  /** Longest request (headers and body) that will be accepted. */
+  static constexpr std::size_t MAX_REQUEST_SIZE = 16 * 1024;
+  /** Requests served before the connection is closed. */
+  static constexpr int MAX_REQUESTS = 1000;
+  /** How long an idle connection is kept open waiting for the next request. */
+  static constexpr auto KEEPALIVE_TIMEOUT = std::chrono::seconds(5);
+  /**
+   * How long a request may take to arrive, counted from its first byte, so
+   * that a client trickling in a byte at a time can't hold the connection.
+   */
+  static constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(10);
+
   explicit HttpServer(std::unique_ptr<SocketConnection> conn);
   ~HttpServer();
-  /** Adds a handler (handler) for method method and URL path root {root). */
+  /**
+   * Adds a handler (handler) for method method and URL path root {root). The
+   * longest root matching the start of the request path wins. GET handlers
+   * also answer HEAD requests.
+   */
   bool add(HttpMethod method, const std::string& root, HttpHandler* handler);
   /** Sends an HTTP Response and then terminates the connection. */
   void SendResponse(const HttpResponse& r);
-  /** Runs the Http Server. It must already have all of the handlers needed added to it. */
+  /**
+   * Runs the Http Server until the client closes the connection, asks for it
+   * to be closed or is idle too long. It must already have all of the
+   * handlers needed added to it. Returns true if any requests were handled.
+   */
   bool Run();
 
+  // VisibleForTesting
+  void set_request_timeout(std::chrono::milliseconds d) { request_timeout_ = d; }
+
 private:
+  [[nodiscard]] HttpResponse Dispatch(const HttpRequest& req);
+  /** Adds r to the responses waiting to be sent, streaming it if needed. */
+  bool Respond(const HttpRequest& req, const HttpResponse& r, bool keep_alive);
+  /** Sends all of the responses waiting to be sent. */
+  bool Flush();
+  /** Waits up to d for more of the request, appending it to in_. */
+  bool Receive(std::chrono::duration<double> d);
+
   std::unique_ptr<SocketConnection> conn_;
   std::map<std::string, HttpHandler*> get_;
+  // Received data not yet parsed into requests.
+  std::string in_;
+  // Responses not yet sent, so that pipelined requests share one send.
+  std::string out_;
+  std::chrono::milliseconds request_timeout_{REQUEST_TIMEOUT};
 };
 
-
 }
 
 #endif
@@ -0,0 +1,278 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/http_server.h"
+
+#include "core/strings.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+TEST(ParseHttpRequestTest, Get) {
+  const std::string data = "GET /status HTTP/1.1\r\nHost: localhost\r\nAccept: */*\r\n\r\n";
+  HttpRequest r{};
+  std::size_t size = 0;
+  ASSERT_EQ(HttpParseResult::COMPLETE, ParseHttpRequest(data, r, size));
+  EXPECT_EQ(data.size(), size);
+  EXPECT_EQ("GET", r.method);
+  EXPECT_EQ("/status", r.path);
+  EXPECT_EQ("HTTP/1.1", r.version);
+  EXPECT_EQ(2u, r.headers.size());
+  EXPECT_EQ("localhost", r.header("host").value_or(""));
+  EXPECT_FALSE(r.header("Connection"));
+  EXPECT_TRUE(r.body.empty());
+}
+
+TEST(ParseHttpRequestTest, Incomplete) {
+  HttpRequest r{};
+  std::size_t size = 0;
+  EXPECT_EQ(HttpParseResult::INCOMPLETE, ParseHttpRequest("", r, size));
+  EXPECT_EQ(HttpParseResult::INCOMPLETE, ParseHttpRequest("GET / HTTP/1.1\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::INCOMPLETE,
+            ParseHttpRequest("GET / HTTP/1.1\r\nHost: x\r\n\r", r, size));
+  EXPECT_EQ(HttpParseResult::INCOMPLETE,
+            ParseHttpRequest("POST / HTTP/1.1\r\nContent-Length: 4\r\n\r\nab", r, size));
+}
+
+TEST(ParseHttpRequestTest, Pipelined) {
+  const std::string first = "GET /a HTTP/1.1\r\n\r\n";
+  const std::string second = "POST /b HTTP/1.1\r\nContent-Length: 3\r\n\r\nxyz";
+  const std::string third = "\r\nGET /c HTTP/1.1\n\n";
+  std::string data = first + second + third;
+
+  HttpRequest r{};
+  std::size_t size = 0;
+  ASSERT_EQ(HttpParseResult::COMPLETE, ParseHttpRequest(data, r, size));
+  EXPECT_EQ("/a", r.path);
+  EXPECT_EQ(first.size(), size);
+  data.erase(0, size);
+
+  ASSERT_EQ(HttpParseResult::COMPLETE, ParseHttpRequest(data, r, size));
+  EXPECT_EQ("POST", r.method);
+  EXPECT_EQ("/b", r.path);
+  EXPECT_EQ("xyz", r.body);
+  EXPECT_EQ(second.size(), size);
+  data.erase(0, size);
+
+  ASSERT_EQ(HttpParseResult::COMPLETE, ParseHttpRequest(data, r, size));
+  EXPECT_EQ("/c", r.path);
+  EXPECT_EQ(third.size(), size);
+}
+
+TEST(ParseHttpRequestTest, BadRequest) {
+  HttpRequest r{};
+  std::size_t size = 0;
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST, ParseHttpRequest("GET\r\n\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST, ParseHttpRequest("GET /\r\n\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST, ParseHttpRequest("GET / SPDY/3\r\n\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST,
+            ParseHttpRequest("GET / HTTP/1.1\r\nnocolon\r\n\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST,
+            ParseHttpRequest("GET / HTTP/1.1\r\nContent-Length: -1\r\n\r\n", r, size));
+  EXPECT_EQ(HttpParseResult::BAD_REQUEST,
+            ParseHttpRequest("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", r, size));
+}
+
+TEST(HttpRequestTest, KeepAlive) {
+  HttpRequest r{};
+  r.version = "HTTP/1.1";
+  EXPECT_TRUE(r.keep_alive());
+  r.headers = {"Connection: Close"};
+  EXPECT_FALSE(r.keep_alive());
+
+  r.version = "HTTP/1.0";
+  r.headers.clear();
+  EXPECT_FALSE(r.keep_alive());
+  r.headers = {"connection: TE, keep-alive"};
+  EXPECT_TRUE(r.keep_alive());
+}
+
+#ifndef _WIN32
+
+class TextHandler : public HttpHandler {
+public:
+  HttpResponse Handle(HttpMethod, const std::string& path, std::vector<std::string>) override {
+    HttpResponse r(200, StrCat("path=", path));
+    r.headers.emplace("Content-Type", "text/plain");
+    return r;
+  }
+};
+
+class StreamHandler : public HttpHandler {
+public:
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string>) override {
+    HttpResponse r(200);
+    r.stream = [](HttpResponseWriter& w) {
+      w.write("a");
+      w.write("");
+      w.write("bc");
+    };
+    return r;
+  }
+};
+
+class HttpServerTest : public ::testing::Test {
+protected:
+  /**
+   * Sends request to a server and closes the sending side, returning
+   * everything the server sends back before it closes the connection.
+   */
+  std::string Serve(const std::string& request) {
+    int sv[2];
+    EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    EXPECT_EQ(static_cast<ssize_t>(request.size()), write(sv[1], request.data(), request.size()));
+    shutdown(sv[1], SHUT_WR);
+    {
+      HttpServer h(std::make_unique<SocketConnection>(sv[0]));
+      h.add(HttpMethod::GET, "/status", &text_);
+      h.add(HttpMethod::GET, "/status/events", &stream_);
+      h.Run();
+    }
+    std::string response;
+    char buf[4096];
+    for (auto n = read(sv[1], buf, sizeof(buf)); n > 0; n = read(sv[1], buf, sizeof(buf))) {
+      response.append(buf, n);
+    }
+    close(sv[1]);
+    return response;
+  }
+
+  static int count(const std::string& s, const std::string& what) {
+    auto n = 0;
+    for (auto pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) {
+      ++n;
+    }
+    return n;
+  }
+
+  TextHandler text_;
+  StreamHandler stream_;
+};
+
+TEST_F(HttpServerTest, Pipelined) {
+  const auto r = Serve("GET /status/1 HTTP/1.1\r\n\r\nGET /nope HTTP/1.1\r\n\r\n"
+                       "GET /status/2 HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(2, count(r, "HTTP/1.1 200 OK"));
+  EXPECT_EQ(1, count(r, "HTTP/1.1 404 Not Found"));
+  EXPECT_EQ(0, count(r, "Connection: close"));
+  const auto first = r.find("path=/status/1");
+  const auto missing = r.find("404");
+  const auto second = r.find("path=/status/2");
+  ASSERT_NE(std::string::npos, second);
+  EXPECT_LT(first, missing);
+  EXPECT_LT(missing, second);
+  EXPECT_EQ(2, count(r, "Content-Length: 14"));
+  EXPECT_EQ(1, count(r, "Content-Length: 0"));
+  EXPECT_EQ(2, count(r, "Content-Type: text/plain"));
+}
+
+TEST_F(HttpServerTest, ConnectionClose) {
+  const auto r = Serve("GET /status HTTP/1.1\r\nConnection: close\r\n\r\n"
+                       "GET /status HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(1, count(r, "HTTP/1.1 200 OK"));
+  EXPECT_EQ(1, count(r, "Connection: close"));
+}
+
+TEST_F(HttpServerTest, Http10) {
+  const auto r = Serve("GET /status HTTP/1.0\r\n\r\nGET /status HTTP/1.0\r\n\r\n");
+  EXPECT_EQ(1, count(r, "HTTP/1.1 200 OK"));
+  EXPECT_EQ(1, count(r, "Connection: close"));
+}
+
+TEST_F(HttpServerTest, Http10_KeepAlive) {
+  const auto r = Serve("GET /status HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"
+                       "GET /status HTTP/1.0\r\n\r\n");
+  EXPECT_EQ(2, count(r, "HTTP/1.1 200 OK"));
+  EXPECT_EQ(1, count(r, "Connection: keep-alive"));
+  EXPECT_EQ(1, count(r, "Connection: close"));
+}
+
+TEST_F(HttpServerTest, Head) {
+  const auto r = Serve("HEAD /status HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(1, count(r, "HTTP/1.1 200 OK"));
+  EXPECT_EQ(1, count(r, "Content-Length: 12"));
+  EXPECT_TRUE(ends_with(r, "\r\n\r\n"));
+}
+
+TEST_F(HttpServerTest, MethodNotAllowed) {
+  const auto r = Serve("DELETE /status HTTP/1.1\r\n\r\nGET /status HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(1, count(r, "HTTP/1.1 405 Method Not Allowed"));
+  EXPECT_EQ(1, count(r, "HTTP/1.1 200 OK"));
+}
+
+TEST_F(HttpServerTest, BadRequest) {
+  const auto r = Serve("GET /status\r\n\r\nGET /status HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(1, count(r, "HTTP/1.1 400 Bad Request"));
+  EXPECT_EQ(0, count(r, "HTTP/1.1 200 OK"));
+}
+
+TEST_F(HttpServerTest, Chunked) {
+  const auto r = Serve("GET /status/events HTTP/1.1\r\n\r\nGET /status HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(1, count(r, "Transfer-Encoding: chunked"));
+  EXPECT_EQ(1, count(r, "\r\n\r\n1\r\na\r\n2\r\nbc\r\n0\r\n\r\nHTTP/1.1 200 OK"));
+  EXPECT_TRUE(ends_with(r, "path=/status"));
+}
+
+TEST_F(HttpServerTest, Stream_Http10) {
+  const auto r = Serve("GET /status/events HTTP/1.0\r\n\r\n");
+  EXPECT_EQ(0, count(r, "Transfer-Encoding"));
+  EXPECT_EQ(1, count(r, "Connection: close"));
+  EXPECT_TRUE(ends_with(r, "\r\n\r\nabc"));
+}
+
+TEST_F(HttpServerTest, RequestTimeout_FromFirstByte) {
+  int sv[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+  // Sends a header line every 50ms, so no single wait for more of the
+  // request ever times out.
+  std::thread client([fd = sv[1]] {
+    const std::string start = "GET /status HTTP/1.1\r\n";
+    if (send(fd, start.data(), start.size(), MSG_NOSIGNAL) < 0) {
+      return;
+    }
+    const std::string header = "X-Slow: 1\r\n";
+    for (auto i = 0; i < 60; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (send(fd, header.data(), header.size(), MSG_NOSIGNAL) < 0) {
+        return;
+      }
+    }
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    HttpServer h(std::make_unique<SocketConnection>(sv[0]));
+    h.add(HttpMethod::GET, "/status", &text_);
+    h.set_request_timeout(std::chrono::milliseconds(300));
+    EXPECT_FALSE(h.Run());
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  client.join();
+  close(sv[1]);
+}
+
+#endif  // _WIN32
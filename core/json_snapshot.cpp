@@ -0,0 +1,209 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/json_snapshot.h"
+
+#include "core/crc32.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/os.h"
+#include "core/strings.h"
+#include "core/version.h"
+#include "fmt/format.h"
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::strings;
+
+namespace wwiv::core {
+
+static constexpr char JSON_SNAPSHOT_MAGIC[8] = {'W', 'W', 'I', 'V', 'S', 'N', 'A', 'P'};
+
+JsonSnapshot::~JsonSnapshot() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), data_size_);
+  }
+#endif
+}
+
+// static
+std::filesystem::path JsonSnapshot::path_for(const std::filesystem::path& json_path) {
+  auto p = json_path;
+  p += ".snap";
+  return p;
+}
+
+// static
+uint32_t JsonSnapshot::type_id(const std::string& key, const std::string& type_name,
+                               int version) {
+  // The layout of the binary data depends on the structures in this build,
+  // so a snapshot written by any other build must not be used.
+  return crc32string(StrCat(key, "|", type_name, "|", version, "|", full_version()));
+}
+
+// static
+std::optional<json_snapshot_stamp_t> JsonSnapshot::stamp(const std::filesystem::path& json_path) {
+  // Use the filesystem's full resolution for the time.
+  std::error_code ec;
+  const auto s = std::filesystem::file_size(json_path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto t = std::filesystem::last_write_time(json_path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return json_snapshot_stamp_t{static_cast<uint64_t>(s),
+                               static_cast<int64_t>(t.time_since_epoch().count())};
+}
+
+// static
+std::unique_ptr<JsonSnapshot> JsonSnapshot::Open(const std::filesystem::path& json_path,
+                                                 uint32_t type_id) {
+  const auto path = path_for(json_path);
+  if (!File::Exists(path)) {
+    return nullptr;
+  }
+  const auto json = stamp(json_path);
+  if (!json) {
+    return nullptr;
+  }
+  std::unique_ptr<JsonSnapshot> snapshot(new JsonSnapshot());
+#ifdef _WIN32
+  {
+    File f(path);
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      return nullptr;
+    }
+    snapshot->buffer_.resize(f.length());
+    if (f.Read(snapshot->buffer_.data(), f.length()) != f.length()) {
+      return nullptr;
+    }
+    snapshot->data_ = snapshot->buffer_.data();
+    snapshot->data_size_ = snapshot->buffer_.size();
+  }
+#else
+  {
+    const auto fd = open(path.string().c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(json_snapshot_header_t))) {
+      close(fd);
+      return nullptr;
+    }
+    auto* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+      return nullptr;
+    }
+    snapshot->data_ = static_cast<const char*>(p);
+    snapshot->data_size_ = static_cast<std::size_t>(st.st_size);
+  }
+#endif
+
+  if (snapshot->data_size_ < sizeof(json_snapshot_header_t)) {
+    return nullptr;
+  }
+  json_snapshot_header_t h{};
+  memcpy(&h, snapshot->data_, sizeof(h));
+  if (memcmp(h.magic, JSON_SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION ||
+      h.type_id != type_id) {
+    VLOG(1) << "Ignoring snapshot with wrong version: " << path;
+    return nullptr;
+  }
+  if (h.json_size != json->size || h.json_time != json->time) {
+    VLOG(1) << "Ignoring stale snapshot: " << path;
+    return nullptr;
+  }
+  if (snapshot->data_size_ != sizeof(h) + h.payload_size) {
+    LOG(WARNING) << "Ignoring snapshot with wrong size: " << path;
+    return nullptr;
+  }
+  snapshot->payload_ = std::string_view(snapshot->data_ + sizeof(h), h.payload_size);
+  if (crc32string(snapshot->payload_) != h.payload_crc32) {
+    LOG(WARNING) << "Ignoring snapshot with bad checksum: " << path;
+    return nullptr;
+  }
+  return snapshot;
+}
+
+// static
+bool JsonSnapshot::Write(const std::filesystem::path& json_path, uint32_t type_id,
+                         const json_snapshot_stamp_t& stamp, const std::string& payload) {
+  json_snapshot_header_t h{};
+  memcpy(h.magic, JSON_SNAPSHOT_MAGIC, sizeof(h.magic));
+  h.version = VERSION;
+  h.type_id = type_id;
+  h.json_size = stamp.size;
+  h.json_time = stamp.time;
+  h.payload_size = static_cast<uint32_t>(payload.size());
+  h.payload_crc32 = crc32string(payload);
+
+  // Write to a temporary file and rename it so that nobody else ever maps a
+  // partially written snapshot.
+  const auto path = path_for(json_path);
+  auto tmp_path = path;
+  tmp_path += fmt::format(".{}", os::get_pid());
+  {
+    File f(tmp_path);
+    if (!f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                File::modeTruncate)) {
+      VLOG(1) << "Unable to create snapshot: " << tmp_path;
+      return false;
+    }
+    if (f.Write(&h, sizeof(h)) != sizeof(h) ||
+        f.Write(payload) != static_cast<File::size_type>(payload.size())) {
+      LOG(WARNING) << "Short write on snapshot: " << tmp_path;
+      f.Close();
+      File::Remove(tmp_path);
+      return false;
+    }
+  }
+  if (const auto current = JsonSnapshot::stamp(json_path);
+      !current || current->size != stamp.size || current->time != stamp.time) {
+    VLOG(1) << "Not writing snapshot, the JSON changed while reading it: " << json_path;
+    File::Remove(tmp_path);
+    return false;
+  }
+  if (!File::Move(tmp_path, path)) {
+    File::Remove(tmp_path);
+    return false;
+  }
+  VLOG(2) << "Wrote snapshot: " << path;
+  return true;
+}
+
+// static
+void JsonSnapshot::Remove(const std::filesystem::path& json_path) {
+  if (const auto path = path_for(json_path); File::Exists(path)) {
+    File::Remove(path);
+  }
+}
+
+} // namespace wwiv::core
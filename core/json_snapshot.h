@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_JSON_SNAPSHOT_H
+#define INCLUDED_CORE_JSON_SNAPSHOT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wwiv::core {
+
+#ifndef __MSDOS__
+#pragma pack(push, 1)
+#endif // __MSDOS__
+
+/**
+ * Header of a binary snapshot of a parsed JSON file.  The payload follows
+ * the header.  The size and last write time of the JSON file are recorded
+ * so that a snapshot of an older version of the JSON file is never used.
+ */
+struct json_snapshot_header_t {
+  char magic[8];
+  uint32_t version;
+  // Identifies the type and version of the data and the build that wrote it.
+  uint32_t type_id;
+  uint64_t json_size;
+  int64_t json_time;
+  uint32_t payload_size;
+  uint32_t payload_crc32;
+};
+
+#ifndef __MSDOS__
+#pragma pack(pop)
+#endif // __MSDOS__
+
+static_assert(sizeof(json_snapshot_header_t) == 40, "json_snapshot_header_t != 40 bytes");
+
+/** Size and last write time of a JSON file, used to tell if a snapshot of it is current. */
+struct json_snapshot_stamp_t {
+  uint64_t size{0};
+  int64_t time{0};
+};
+
+/**
+ * A binary snapshot of a JSON file, written next to it with a ".snap"
+ * extension.  Tools that only read their configuration load the snapshot
+ * (which is memory mapped where possible) instead of parsing the JSON.
+ */
+class JsonSnapshot final {
+public:
+  static constexpr uint32_t VERSION = 1;
+
+  ~JsonSnapshot();
+  JsonSnapshot(const JsonSnapshot&) = delete;
+  JsonSnapshot& operator=(const JsonSnapshot&) = delete;
+
+  /** Path of the snapshot for the JSON file at json_path. */
+  static std::filesystem::path path_for(const std::filesystem::path& json_path);
+
+  /** Returns the type id for data saved under key with version by this build. */
+  static uint32_t type_id(const std::string& key, const std::string& type_name, int version);
+
+  /**
+   * Opens the snapshot of json_path, returning nullptr if it does not exist,
+   * is corrupt, was written for a different type_id or is older than the
+   * current contents of json_path.
+   */
+  static std::unique_ptr<JsonSnapshot> Open(const std::filesystem::path& json_path,
+                                            uint32_t type_id);
+
+  /**
+   * Returns the current stamp of json_path.  Take this before reading the
+   * JSON file, so a snapshot made from what was read is never stamped with
+   * a later version of the file.
+   */
+  static std::optional<json_snapshot_stamp_t> stamp(const std::filesystem::path& json_path);
+
+  /**
+   * Writes payload as the snapshot of json_path, stamped with stamp.  Nothing
+   * is written if json_path no longer has that stamp, since the payload was
+   * made from an older version of it.
+   */
+  static bool Write(const std::filesystem::path& json_path, uint32_t type_id,
+                    const json_snapshot_stamp_t& stamp, const std::string& payload);
+
+  /** Removes the snapshot of json_path, if any. */
+  static void Remove(const std::filesystem::path& json_path);
+
+  [[nodiscard]] std::string_view payload() const noexcept { return payload_; }
+
+private:
+  JsonSnapshot() = default;
+
+  // Start of the mapped (or read) snapshot file.
+  const char* data_{nullptr};
+  std::size_t data_size_{0};
+#ifdef _WIN32
+  // Windows reads the snapshot into memory instead of mapping it.
+  std::vector<char> buffer_;
+#endif
+  std::string_view payload_;
+};
+
+/** A read only streambuf over a snapshot payload, so it can be read without a copy. */
+class snapshot_streambuf final : public std::streambuf {
+public:
+  explicit snapshot_streambuf(std::string_view v) {
+    auto* p = const_cast<char*>(v.data());
+    setg(p, p, p + v.size());
+  }
+};
+
+} // namespace wwiv::core
+
+#endif
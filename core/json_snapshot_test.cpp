@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/file.h"
+#include "core/json_snapshot.h"
+#include "core/test/file_helper.h"
+#include "core/textfile.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+
+class JsonSnapshotTest : public testing::Test {
+protected:
+  void SetUp() override {
+    json_path_ = helper_.CreateTempFile("subs.json", R"({"version": 1})");
+    type_id_ = JsonSnapshot::type_id("subs", "vector", 1);
+  }
+
+  bool Write(const std::string& payload) {
+    const auto stamp = JsonSnapshot::stamp(json_path_);
+    return stamp && JsonSnapshot::Write(json_path_, type_id_, stamp.value(), payload);
+  }
+
+  FileHelper helper_;
+  std::filesystem::path json_path_;
+  uint32_t type_id_{0};
+};
+
+TEST_F(JsonSnapshotTest, WriteAndOpen) {
+  ASSERT_TRUE(Write("payload"));
+  ASSERT_TRUE(File::Exists(JsonSnapshot::path_for(json_path_)));
+
+  const auto s = JsonSnapshot::Open(json_path_, type_id_);
+  ASSERT_TRUE(s);
+  EXPECT_EQ("payload", s->payload());
+}
+
+TEST_F(JsonSnapshotTest, Open_Missing) {
+  EXPECT_FALSE(JsonSnapshot::Open(json_path_, type_id_));
+}
+
+TEST_F(JsonSnapshotTest, Open_WrongType) {
+  ASSERT_TRUE(Write("payload"));
+  EXPECT_FALSE(JsonSnapshot::Open(json_path_, JsonSnapshot::type_id("subs", "vector", 2)));
+}
+
+TEST_F(JsonSnapshotTest, Open_Stale) {
+  ASSERT_TRUE(Write("payload"));
+  {
+    TextFile f(json_path_, "w");
+    f.Write(R"({"version": 1, "subs": []})");
+  }
+  EXPECT_FALSE(JsonSnapshot::Open(json_path_, type_id_));
+}
+
+TEST_F(JsonSnapshotTest, Write_JsonChanged) {
+  const auto stamp = JsonSnapshot::stamp(json_path_);
+  ASSERT_TRUE(stamp);
+  {
+    TextFile f(json_path_, "w");
+    f.Write(R"({"version": 1, "subs": []})");
+  }
+  // The payload was made from what the JSON file was before it changed.
+  EXPECT_FALSE(JsonSnapshot::Write(json_path_, type_id_, stamp.value(), "payload"));
+  EXPECT_FALSE(File::Exists(JsonSnapshot::path_for(json_path_)));
+}
+
+TEST_F(JsonSnapshotTest, Open_Corrupt) {
+  ASSERT_TRUE(Write("payload"));
+  {
+    File f(JsonSnapshot::path_for(json_path_));
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite));
+    f.Seek(sizeof(json_snapshot_header_t), File::Whence::begin);
+    f.Write("X", 1);
+  }
+  EXPECT_FALSE(JsonSnapshot::Open(json_path_, type_id_));
+}
+
+TEST_F(JsonSnapshotTest, Remove) {
+  ASSERT_TRUE(Write("payload"));
+  JsonSnapshot::Remove(json_path_);
+  EXPECT_FALSE(File::Exists(JsonSnapshot::path_for(json_path_)));
+}
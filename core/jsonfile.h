@@ -20,13 +20,16 @@
 #define INCLUDED_CORE_JSONFILE_H
 
 #include "core/cereal_utils.h"
+#include "core/json_snapshot.h"
 #include "core/log.h"
 #include "core/textfile.h"
 #include "fmt/format.h"
 #include <filesystem>
 #include <optional>
+#include <istream>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 #include <utility>
 
 // ReSharper disable once CppUnusedIncludeDirective
@@ -34,6 +37,8 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include <cereal/cereal.hpp>
 // ReSharper disable once CppUnusedIncludeDirective
+#include <cereal/archives/binary.hpp>
+// ReSharper disable once CppUnusedIncludeDirective
 #include <cereal/archives/json.hpp>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <cereal/types/map.hpp>
@@ -71,20 +76,38 @@ public:
 
   ~JsonFile() = default;
 
+  /**
+   * When enabled, Load reads the binary snapshot of this file when it is
+   * current and only parses the JSON (and rewrites the snapshot) when it is
+   * not.  Save always rewrites the snapshot.
+   */
+  void set_use_snapshot(bool use_snapshot) noexcept { use_snapshot_ = use_snapshot; }
+
   bool Load() {
     try {
       if (!File::Exists(file_name_)) {
         VLOG(3) << "JSON File does not exist: " << file_name_.string();
         return false;
       }
+      if (use_snapshot_ && LoadSnapshot()) {
+        return true;
+      }
+      // Stamp the snapshot with what the file was before reading it, so a
+      // change made while reading leaves the snapshot stale.
+      const auto stamp = JsonSnapshot::stamp(file_name_);
       if (const auto o = read_json_file(file_name_)) {
-        std::stringstream ss(o.value());
-        cereal::JSONInputArchive ar(ss);
-        SERIALIZE_NVP("version", loaded_version_);
-        if (version_ > 0 && loaded_version_ < version_) {
-          throw json_version_error(file_name_.string(), version_, loaded_version_);
+        {
+          std::stringstream ss(o.value());
+          cereal::JSONInputArchive ar(ss);
+          SERIALIZE_NVP("version", loaded_version_);
+          if (version_ > 0 && loaded_version_ < version_) {
+            throw json_version_error(file_name_.string(), version_, loaded_version_);
+          }
+          ar(cereal::make_nvp(key_, t_));
+        }
+        if (use_snapshot_ && stamp) {
+          SaveSnapshot(loaded_version_, stamp.value());
         }
-        ar(cereal::make_nvp(key_, t_));
         return true;
       }
       return false;
@@ -107,22 +130,69 @@ public:
       return false;
     }
 
-    TextFile file(file_name_, "w");
-    if (!file.IsOpen()) {
-      return false;
+    {
+      TextFile file(file_name_, "w");
+      if (!file.IsOpen()) {
+        return false;
+      }
+      if (!file.Write(ss.str())) {
+        return false;
+      }
     }
-
-    return file.Write(ss.str());
+    if (const auto stamp = JsonSnapshot::stamp(file_name_); use_snapshot_ && stamp) {
+      SaveSnapshot(version_, stamp.value());
+    } else {
+      // Never leave a snapshot of the old contents around.
+      JsonSnapshot::Remove(file_name_);
+    }
+    return true;
   }
 
   [[nodiscard]] int loaded_version() const noexcept { return loaded_version_; }
 
 private:
+  [[nodiscard]] uint32_t snapshot_type_id() const {
+    return JsonSnapshot::type_id(key_, typeid(T).name(), version_);
+  }
+
+  bool LoadSnapshot() {
+    const auto snapshot = JsonSnapshot::Open(file_name_, snapshot_type_id());
+    if (!snapshot) {
+      return false;
+    }
+    try {
+      snapshot_streambuf buf(snapshot->payload());
+      std::istream is(&buf);
+      cereal::BinaryInputArchive ar(is);
+      ar(loaded_version_);
+      ar(t_);
+      VLOG(3) << "Loaded snapshot of: " << file_name_.string();
+      return true;
+    } catch (const cereal::Exception& e) {
+      LOG(WARNING) << "Unable to read snapshot of: " << file_name_.string() << "; " << e.what();
+      return false;
+    }
+  }
+
+  void SaveSnapshot(int version, const json_snapshot_stamp_t& stamp) {
+    std::ostringstream ss;
+    try {
+      cereal::BinaryOutputArchive ar(ss);
+      ar(version);
+      ar(t_);
+    } catch (const cereal::Exception& e) {
+      LOG(WARNING) << "Unable to create snapshot of: " << file_name_.string() << "; " << e.what();
+      return;
+    }
+    JsonSnapshot::Write(file_name_, snapshot_type_id(), stamp, ss.str());
+  }
+
   const std::filesystem::path file_name_;
   const std::string key_;
   T& t_;
   int version_;
   int loaded_version_{0};
+  bool use_snapshot_{false};
 };
 
 // C++17 Deduction Guide for JsonFile
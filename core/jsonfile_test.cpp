@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/file.h"
+#include "core/json_snapshot.h"
+#include "core/jsonfile.h"
+#include "core/test/file_helper.h"
+#include "core/textfile.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+
+struct jsonfile_test_t {
+  int num{0};
+  std::string name;
+  std::vector<std::string> items;
+};
+
+namespace cereal {
+template <class Archive> void serialize(Archive& ar, jsonfile_test_t& t) {
+  SERIALIZE(t, num);
+  SERIALIZE(t, name);
+  SERIALIZE(t, items);
+}
+} // namespace cereal
+
+class JsonFileTest : public testing::Test {
+protected:
+  void SetUp() override {
+    path_ = helper_.CreateTempFilePath("test.json");
+    saved_.num = 42;
+    saved_.name = "Rushfan";
+    saved_.items = {"one", "two"};
+  }
+
+  FileHelper helper_;
+  std::filesystem::path path_;
+  jsonfile_test_t saved_;
+};
+
+TEST_F(JsonFileTest, Snapshot_RoundTrip) {
+  {
+    JsonFile f(path_, "test", saved_, 2);
+    f.set_use_snapshot(true);
+    ASSERT_TRUE(f.Save());
+  }
+  ASSERT_TRUE(File::Exists(JsonSnapshot::path_for(path_)));
+
+  jsonfile_test_t loaded{};
+  JsonFile f(path_, "test", loaded, 2);
+  f.set_use_snapshot(true);
+  ASSERT_TRUE(f.Load());
+  EXPECT_EQ(2, f.loaded_version());
+  EXPECT_EQ(42, loaded.num);
+  EXPECT_EQ("Rushfan", loaded.name);
+  EXPECT_EQ(saved_.items, loaded.items);
+}
+
+TEST_F(JsonFileTest, Snapshot_StaleIsReplaced) {
+  {
+    JsonFile f(path_, "test", saved_, 2);
+    f.set_use_snapshot(true);
+    ASSERT_TRUE(f.Save());
+  }
+  {
+    TextFile tf(path_, "w");
+    tf.Write(R"({"version": 2, "test": {"num": 7, "name": "Edited", "items": ["three"]}})");
+  }
+
+  jsonfile_test_t loaded{};
+  {
+    JsonFile f(path_, "test", loaded, 2);
+    f.set_use_snapshot(true);
+    ASSERT_TRUE(f.Load());
+  }
+  EXPECT_EQ(7, loaded.num);
+  EXPECT_EQ("Edited", loaded.name);
+  EXPECT_EQ(std::vector<std::string>{"three"}, loaded.items);
+
+  // Load wrote a snapshot of the edited file.
+  const auto snapshot = JsonSnapshot::Open(
+      path_, JsonSnapshot::type_id("test", typeid(jsonfile_test_t).name(), 2));
+  ASSERT_TRUE(snapshot);
+  jsonfile_test_t from_snapshot{};
+  int version{0};
+  {
+    snapshot_streambuf buf(snapshot->payload());
+    std::istream is(&buf);
+    cereal::BinaryInputArchive ar(is);
+    ar(version);
+    ar(from_snapshot);
+  }
+  EXPECT_EQ(2, version);
+  EXPECT_EQ(7, from_snapshot.num);
+  EXPECT_EQ("Edited", from_snapshot.name);
+  EXPECT_EQ(std::vector<std::string>{"three"}, from_snapshot.items);
+}
+
+TEST_F(JsonFileTest, Save_WithoutSnapshotRemovesIt) {
+  {
+    JsonFile f(path_, "test", saved_, 2);
+    f.set_use_snapshot(true);
+    ASSERT_TRUE(f.Save());
+  }
+  ASSERT_TRUE(File::Exists(JsonSnapshot::path_for(path_)));
+
+  JsonFile f(path_, "test", saved_, 2);
+  ASSERT_TRUE(f.Save());
+  EXPECT_FALSE(File::Exists(JsonSnapshot::path_for(path_)));
+}
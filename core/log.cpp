@@ -26,7 +26,9 @@
 #include "fmt/core.h"
 #include "fmt/printf.h"
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <filesystem>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -34,6 +36,10 @@
 #include <unordered_map>
 #include <utility>
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
 using namespace wwiv::core;
 using namespace wwiv::strings;
 
@@ -52,30 +58,190 @@ class ConsoleAppender : public Appender {
   }
 };
 
-class LogFileAppender : public Appender {
-public:
-  explicit LogFileAppender(std::string fn)
-    : filename_(std::move(fn)) {
+// How long the background thread waits before writing queued messages.
+static constexpr auto LOG_FLUSH_INTERVAL = std::chrono::milliseconds(250);
+// Write sooner than LOG_FLUSH_INTERVAL once this many messages are queued.
+static constexpr std::size_t LOG_FLUSH_MESSAGES = 512;
+
+LogFileAppender::LogFileAppender(std::string filename, uintmax_t rotate_size, int rotate_days)
+    : filename_(std::move(filename)), rotate_size_(rotate_size), rotate_days_(rotate_days),
+      pid_(os::get_pid()) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+LogFileAppender::~LogFileAppender() {
+  if (os::get_pid() != pid_) {
+    // The thread only exists in the parent process.
+    thread_.detach();
+    return;
   }
+  {
+    std::lock_guard lock(mu_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  std::lock_guard lock(file_mu_);
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+}
 
-  bool append(const std::string& message) override {
-    // Not super performant, but we'll start here and see how far this
-    // gets us.
-    if (message.empty()) {
-      return true;
-    }
+bool LogFileAppender::append(const std::string& message) {
+  if (message.empty()) {
+    return true;
+  }
+  if (os::get_pid() != pid_) {
+    // We're in a forked child, where the background thread doesn't exist and
+    // the parent may have been holding any of our locks, so write directly.
     TextFile out(filename_, "a");
-    if (!out.IsOpen()) {
+    return out.IsOpen() && out.WriteLine(message) > 0;
+  }
+  std::size_t size;
+  {
+    std::lock_guard lock(mu_);
+    queue_.push_back(message);
+    size = queue_.size();
+  }
+  if (size >= LOG_FLUSH_MESSAGES) {
+    cv_.notify_one();
+  }
+  return true;
+}
+
+void LogFileAppender::flush() {
+  if (os::get_pid() != pid_) {
+    return;
+  }
+  std::unique_lock lock(mu_);
+  if (queue_.empty() && written_ == taken_) {
+    return;
+  }
+  // Everything queued now will be written once the next batch taken is.
+  const auto target = taken_ + (queue_.empty() ? 0 : 1);
+  flush_requested_ = true;
+  cv_.notify_one();
+  flushed_cv_.wait(lock, [&] { return written_ >= target || stopping_; });
+}
+
+void LogFileAppender::Run() {
+  std::vector<std::string> batch;
+  while (true) {
+    bool stopping;
+    {
+      std::unique_lock lock(mu_);
+      cv_.wait_for(lock, LOG_FLUSH_INTERVAL, [this] {
+        return stopping_ || flush_requested_ || queue_.size() >= LOG_FLUSH_MESSAGES;
+      });
+      stopping = stopping_;
+      flush_requested_ = false;
+      batch.swap(queue_);
+      if (!batch.empty()) {
+        ++taken_;
+      }
+    }
+    if (!batch.empty()) {
+      {
+        std::lock_guard lock(file_mu_);
+        Write(batch);
+      }
+      batch.clear();
+      {
+        std::lock_guard lock(mu_);
+        ++written_;
+      }
+    }
+    flushed_cv_.notify_all();
+    if (stopping) {
+      std::lock_guard lock(mu_);
+      if (queue_.empty()) {
+        return;
+      }
+    }
+  }
+}
+
+bool LogFileAppender::Write(const std::vector<std::string>& messages) {
+  RotateIfNeeded();
+  if (file_ && !IsOpenFileCurrent()) {
+    // Another process rotated the log, so start writing to the new one.
+    fclose(file_);
+    file_ = nullptr;
+  }
+  if (!file_) {
+    file_ = fopen(filename_.c_str(), "a");
+    if (!file_) {
       // We don't want to crash if we can't log, but what
       // should we do instead?
       return false;
     }
-    return out.WriteLine(message) > 0;
   }
+  for (const auto& m : messages) {
+    fwrite(m.data(), 1, m.size(), file_);
+    fputc('\n', file_);
+  }
+  // Other processes append to the same file, so don't leave a partial
+  // batch sitting in our buffer.
+  return fflush(file_) == 0;
+}
 
-private:
-  const std::string filename_;
-};
+bool LogFileAppender::IsOpenFileCurrent() const {
+#ifdef _WIN32
+  // Windows won't rename a file while we have it open, so the open file is
+  // always the current one.
+  return true;
+#else
+  struct stat open_stat{};
+  struct stat path_stat{};
+  if (fstat(fileno(file_), &open_stat) != 0 || stat(filename_.c_str(), &path_stat) != 0) {
+    return false;
+  }
+  return open_stat.st_dev == path_stat.st_dev && open_stat.st_ino == path_stat.st_ino;
+#endif
+}
+
+void LogFileAppender::RotateIfNeeded() {
+  if (rotate_size_ == 0 && rotate_days_ == 0) {
+    return;
+  }
+  std::error_code ec;
+  const std::filesystem::path path{filename_};
+  auto rotate = false;
+  if (rotate_size_ > 0) {
+    if (const auto size = std::filesystem::file_size(path, ec); !ec && size >= rotate_size_) {
+      rotate = true;
+    }
+  }
+  if (!rotate && rotate_days_ > 0) {
+    // The previous log was last written when it was rotated, so use that as
+    // the age of the current one.
+    auto backup = path;
+    backup += ".1";
+    const auto last = std::filesystem::last_write_time(File::Exists(backup) ? backup : path, ec);
+    if (!ec && std::filesystem::file_time_type::clock::now() - last >=
+                   std::chrono::hours(24) * rotate_days_) {
+      rotate = File::Exists(path);
+    }
+  }
+  if (!rotate) {
+    return;
+  }
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  for (auto i = ROTATE_BACKUPS - 1; i >= 1; i--) {
+    auto from = path;
+    from += StrCat(".", i);
+    auto to = path;
+    to += StrCat(".", i + 1);
+    std::filesystem::rename(from, to, ec);
+  }
+  auto to = path;
+  to += ".1";
+  std::filesystem::rename(path, to, ec);
+}
 
 static std::string FormatLogLevel(LoggerLevel l, int v) noexcept {
   try {
@@ -130,6 +296,9 @@ Logger::~Logger() noexcept {
       a->append(msg);
     }
     if (level_ == LoggerLevel::fatal) {
+      for (const auto& a : appenders) {
+        a->flush();
+      }
       abort();
     }
   } catch (...) {
@@ -142,9 +311,6 @@ void Logger::set_cmdline_verbosity(int cmdline_verbosity) {
   config_.cmdline_verbosity = cmdline_verbosity;
 }
 
-// static
-bool Logger::vlog_is_on(int level) { return level <= config_.cmdline_verbosity; }
-
 // static
 void Logger::StartupLog(int argc, char* argv[]) {
   const auto dt = DateTime::now();
@@ -187,6 +353,12 @@ void Logger::Init(int argc, char** argv, LoggerConfig& c) {
 
   // Set --v from commandline
   config_.cmdline_verbosity = cmdline.iarg("v");
+  if (const auto kb = cmdline.iarg("log_rotate_size"); kb > 0) {
+    config_.log_rotate_size = static_cast<uintmax_t>(kb) * 1024;
+  }
+  if (const auto days = cmdline.iarg("log_rotate_days"); days > 0) {
+    config_.log_rotate_days = days;
+  }
 
   std::string filename(argv[0]);
   if (ends_with(filename, ".exe") || ends_with(filename, ".EXE")) {
@@ -200,7 +372,8 @@ void Logger::Init(int argc, char** argv, LoggerConfig& c) {
 
   // Setup the default appenders.
   console_appender.reset(new ConsoleAppender{});
-  logfile_appender.reset(new LogFileAppender{config_.log_filename});
+  logfile_appender.reset(new LogFileAppender{config_.log_filename, config_.log_rotate_size,
+                                             config_.log_rotate_days});
 
   if (config_.register_console_destinations) {
     config_.add_appender(LoggerLevel::error, console_appender);
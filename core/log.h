@@ -21,12 +21,17 @@
 
 #include "core/os.h"
 
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 typedef std::basic_ostream<char>&(ENDL_TYPE)(std::basic_ostream<char>&);
 
@@ -48,7 +53,12 @@ typedef std::basic_ostream<char>&(ENDL_TYPE)(std::basic_ostream<char>&);
 #define LOG_WARNING wwiv::core::Logger(wwiv::core::LoggerLevel::warning, 0)
 #define LOG_ERROR wwiv::core::Logger(wwiv::core::LoggerLevel::error, 0)
 #define LOG_FATAL wwiv::core::Logger(wwiv::core::LoggerLevel::fatal, 0)
-#define LOG_VERBOSE(verbosity) wwiv::core::Logger(wwiv::core::LoggerLevel::verbose, verbosity)
+// Checks the verbosity before creating the Logger, so that nothing in a
+// disabled VLOG statement is formatted or even evaluated.
+#define LOG_VERBOSE(verbosity)                                                                     \
+  !wwiv::core::Logger::vlog_is_on(verbosity)                                                       \
+      ? (void)0                                                                                    \
+      : wwiv::core::LoggerVoidify() & wwiv::core::Logger(wwiv::core::LoggerLevel::verbose, verbosity)
 #define LOG_FATAL wwiv::core::Logger(wwiv::core::LoggerLevel::fatal, 0)
 
 #define CHECK(x) if (!(x)) wwiv::core::Logger(wwiv::core::LoggerLevel::fatal, 0) \
@@ -101,6 +111,67 @@ public:
 
   Appender() = default;
   virtual bool append(const std::string& message) = 0;
+  /** Writes out anything buffered by append. */
+  virtual void flush() {}
+};
+
+/**
+ * Appends log messages to a file.
+ *
+ * Messages are queued by append and written by a background thread through a
+ * file handle that is kept open, so logging never waits on opening or writing
+ * the file.  The file is rotated to filename.1 (through filename.N) once it
+ * grows past rotate_size bytes or rotate_days days have passed since the last
+ * rotation.  Zero disables either limit.
+ *
+ * A forked child process can't use the parent's thread, so it writes each
+ * message directly.
+ */
+class LogFileAppender final : public Appender {
+public:
+  static constexpr int ROTATE_BACKUPS = 5;
+
+  explicit LogFileAppender(std::string filename, uintmax_t rotate_size = 0, int rotate_days = 0);
+  ~LogFileAppender() override;
+
+  bool append(const std::string& message) override;
+  void flush() override;
+
+private:
+  void Run();
+  /** Writes messages to the log file.  Must hold file_mu_. */
+  bool Write(const std::vector<std::string>& messages);
+  /** Rotates the log file if it's too large or old.  Must hold file_mu_. */
+  void RotateIfNeeded();
+  /**
+   * Returns true if file_ is still the file at filename_, and not one that
+   * was renamed by another process rotating the log.  Must hold file_mu_.
+   */
+  [[nodiscard]] bool IsOpenFileCurrent() const;
+
+  const std::string filename_;
+  const uintmax_t rotate_size_;
+  const int rotate_days_;
+  const int pid_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::condition_variable flushed_cv_;
+  // GUARDED_BY(mu_)
+  std::vector<std::string> queue_;
+  // Number of batches taken off queue_ and written. GUARDED_BY(mu_)
+  uint64_t written_{0};
+  // Number of batches taken off queue_. GUARDED_BY(mu_)
+  uint64_t taken_{0};
+  // GUARDED_BY(mu_)
+  bool flush_requested_{false};
+  // GUARDED_BY(mu_)
+  bool stopping_{false};
+  std::thread thread_;
+
+  std::mutex file_mu_;
+  // GUARDED_BY(file_mu_)
+  FILE* file_{nullptr};
 };
 
 typedef std::unordered_map<LoggerLevel, std::unordered_set<std::shared_ptr<Appender>>>
@@ -121,6 +192,10 @@ public:
   bool log_startup{false};
   std::string exit_filename;
   std::string log_filename;
+  // Rotate the log file once larger than this many bytes, 0 for never.
+  uintmax_t log_rotate_size{0};
+  // Rotate the log file once this many days old, 0 for never.
+  int log_rotate_days{0};
   int cmdline_verbosity{0};
   bool register_file_destinations{true};
   bool register_console_destinations{true};
@@ -129,6 +204,15 @@ public:
   timestamp_fn timestamp_fn_;
 };
 
+class Logger;
+
+/** Used by VLOG to turn a Logger stream expression into void. */
+class LoggerVoidify {
+public:
+  LoggerVoidify() noexcept = default;
+  void operator&(const Logger&) const noexcept {}
+};
+
 class NullLogger {
 public:
   NullLogger() noexcept = default;
@@ -172,7 +256,7 @@ public:
   /** Initializes the WWIV Loggers.  Must be invoked once per binary. */
   static void Init(int argc, char** argv, LoggerConfig& config);
   static void ExitLogger();
-  static bool vlog_is_on(int level);
+  static bool vlog_is_on(int level) noexcept { return level <= config_.cmdline_verbosity; }
   static LoggerConfig& config() noexcept { return config_; }
   static void set_cmdline_verbosity(int cmdline_verbosity);
 
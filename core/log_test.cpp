@@ -17,8 +17,10 @@
 /*                                                                        */
 /**************************************************************************/
 #include "gtest/gtest.h"
+#include "core/file.h"
 #include "core/log.h"
 #include "core/stl.h"
+#include "core/test/file_helper.h"
 #include <string>
 #include <vector>
 
@@ -63,3 +65,58 @@ TEST_F(LogTest, Smoke) {
   EXPECT_EQ("2018-01-01 21:12:00,530 INFO  Hello World!", info->log_lines.front());
   EXPECT_TRUE(warning->log_lines.empty());
 }
+
+static int side_effects = 0;
+static int side_effect() { return ++side_effects; }
+
+TEST_F(LogTest, VLog_DisabledIsNotEvaluated) {
+  Logger::set_cmdline_verbosity(1);
+  side_effects = 0;
+  VLOG(2) << "Not logged: " << side_effect();
+  EXPECT_EQ(0, side_effects);
+  VLOG(1) << "Logged: " << side_effect();
+  EXPECT_EQ(1, side_effects);
+  Logger::set_cmdline_verbosity(0);
+}
+
+TEST_F(LogTest, FileAppender) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFilePath("test.log");
+  LogFileAppender appender(path.string());
+  appender.append("one");
+  appender.append("two");
+  appender.flush();
+  EXPECT_EQ("one\ntwo\n", helper.ReadFile(path));
+}
+
+TEST_F(LogTest, FileAppender_RotateSize) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFilePath("test.log");
+  LogFileAppender appender(path.string(), 4);
+  appender.append("one");
+  appender.flush();
+  appender.append("two");
+  appender.flush();
+  appender.append("three");
+  appender.flush();
+  EXPECT_EQ("three\n", helper.ReadFile(path));
+  EXPECT_EQ("two\n", helper.ReadFile(FilePath(helper.TempDir(), "test.log.1")));
+  EXPECT_EQ("one\n", helper.ReadFile(FilePath(helper.TempDir(), "test.log.2")));
+}
+
+TEST_F(LogTest, FileAppender_RotatedByAnotherProcess) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFilePath("test.log");
+  // Two appenders on the same file stand in for two processes.
+  LogFileAppender rotating(path.string(), 4);
+  LogFileAppender other(path.string());
+  other.append("one");
+  other.flush();
+  rotating.append("two");
+  rotating.flush();
+  // other still has the file that is now test.log.1 open.
+  other.append("three");
+  other.flush();
+  EXPECT_EQ("two\nthree\n", helper.ReadFile(path));
+  EXPECT_EQ("one\n", helper.ReadFile(FilePath(helper.TempDir(), "test.log.1")));
+}
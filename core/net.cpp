@@ -48,7 +48,10 @@
 
 #else
 
+#include <cerrno>
+#include <cstring>
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #endif // _WIN32
@@ -208,6 +211,90 @@ bool SetBlockingMode(SOCKET sock) {
 #endif // _WIN32
 }
 
+#if defined(_WIN32) || defined(__OS2__)
+
+bool SendSocketHandle(SOCKET, SOCKET, const std::string&) {
+  LOG(ERROR) << "SendSocketHandle is not supported on this platform.";
+  return false;
+}
+
+bool ReceiveSocketHandle(SOCKET, SOCKET&, std::string&) {
+  LOG(ERROR) << "ReceiveSocketHandle is not supported on this platform.";
+  return false;
+}
+
+#else
+
+// Maximum size of the message sent along with a socket handle.
+static constexpr int MAX_HANDLE_DATA = 1024;
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_HANDLE_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_HANDLE_FLAGS = 0;
+#endif
+
+bool SendSocketHandle(SOCKET channel, SOCKET sock, const std::string& data) {
+  // At least one byte of real data has to be sent along with the handle.
+  std::string payload = data.empty() ? std::string(1, '\0') : data;
+  if (payload.size() > MAX_HANDLE_DATA) {
+    payload.resize(MAX_HANDLE_DATA);
+  }
+  iovec iov{payload.data(), payload.size()};
+  char control[CMSG_SPACE(sizeof(int))]{};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  auto* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &sock, sizeof(int));
+
+  for (;;) {
+    if (const auto sent = sendmsg(channel, &msg, SEND_HANDLE_FLAGS); sent >= 0) {
+      return true;
+    }
+    if (errno != EINTR) {
+      LOG(ERROR) << "Unable to send socket handle; errno: " << errno;
+      return false;
+    }
+  }
+}
+
+bool ReceiveSocketHandle(SOCKET channel, SOCKET& sock, std::string& data) {
+  char buf[MAX_HANDLE_DATA];
+  iovec iov{buf, sizeof(buf)};
+  char control[CMSG_SPACE(sizeof(int))]{};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received;
+  do {
+    received = recvmsg(channel, &msg, 0);
+  } while (received < 0 && errno == EINTR);
+  if (received <= 0) {
+    // The other side closed the channel without sending us a socket.
+    return false;
+  }
+  for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      std::memcpy(&sock, CMSG_DATA(cmsg), sizeof(int));
+      data.assign(buf, static_cast<std::string::size_type>(received));
+      return true;
+    }
+  }
+  LOG(ERROR) << "Received data without a socket handle.";
+  return false;
+}
+
+#endif
+
 SocketSet::SocketSet()
   : SocketSet(2) {
 };
@@ -78,6 +78,18 @@ int get_dns_cc(const std::string& address, const std::string& rbl_address);
 /** Sets the socket to blocking mode. */
 bool SetBlockingMode(SOCKET sock);
 
+/**
+ * Passes sock (and a short message in data) to the process at the other end
+ * of the UNIX domain socket channel. Only supported on POSIX systems.
+ */
+bool SendSocketHandle(SOCKET channel, SOCKET sock, const std::string& data);
+
+/**
+ * Waits for a socket to be passed over the UNIX domain socket channel by
+ * SendSocketHandle. Returns false if the channel is closed first.
+ */
+bool ReceiveSocketHandle(SOCKET channel, SOCKET& sock, std::string& data);
+
 /** 
  * Once a socket is accepted from the remote system.  Return
  * the socket and also the port that it was accepted from.
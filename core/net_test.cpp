@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/net.h"
+
+#include "gtest/gtest.h"
+#include <string>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace wwiv::core;
+
+class SocketHandleTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, channel_));
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, conn_));
+  }
+
+  void TearDown() override {
+    for (const auto fd : {channel_[0], channel_[1], conn_[0], conn_[1]}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  // Both ends of the channel the handle is passed over.
+  int channel_[2]{-1, -1};
+  // Both ends of the connection being passed.
+  int conn_[2]{-1, -1};
+};
+
+TEST_F(SocketHandleTest, SendAndReceive) {
+  ASSERT_TRUE(SendSocketHandle(channel_[0], conn_[0], "T"));
+
+  SOCKET sock = INVALID_SOCKET;
+  std::string data;
+  ASSERT_TRUE(ReceiveSocketHandle(channel_[1], sock, data));
+  EXPECT_EQ("T", data);
+  ASSERT_NE(INVALID_SOCKET, sock);
+  EXPECT_NE(conn_[0], sock);
+
+  // The received socket is another handle to the same connection, so it
+  // stays connected once the sender closes its copy.
+  close(conn_[0]);
+  conn_[0] = -1;
+  ASSERT_EQ(5, write(sock, "hello", 5));
+  char buf[10]{};
+  ASSERT_EQ(5, read(conn_[1], buf, sizeof(buf)));
+  EXPECT_EQ("hello", std::string(buf, 5));
+
+  // Closing the only remaining copy hangs up the connection.
+  close(sock);
+  EXPECT_EQ(0, read(conn_[1], buf, sizeof(buf)));
+}
+
+TEST_F(SocketHandleTest, EmptyData) {
+  ASSERT_TRUE(SendSocketHandle(channel_[0], conn_[0], ""));
+
+  SOCKET sock = INVALID_SOCKET;
+  std::string data;
+  ASSERT_TRUE(ReceiveSocketHandle(channel_[1], sock, data));
+  // A single byte has to be sent along with the handle.
+  EXPECT_EQ(std::string(1, '\0'), data);
+  close(sock);
+}
+
+TEST_F(SocketHandleTest, ChannelClosed) {
+  close(channel_[0]);
+  channel_[0] = -1;
+
+  SOCKET sock = INVALID_SOCKET;
+  std::string data;
+  EXPECT_FALSE(ReceiveSocketHandle(channel_[1], sock, data));
+  EXPECT_EQ(INVALID_SOCKET, sock);
+}
+
+TEST_F(SocketHandleTest, DataWithoutHandle) {
+  ASSERT_EQ(1, write(channel_[0], "T", 1));
+
+  SOCKET sock = INVALID_SOCKET;
+  std::string data;
+  EXPECT_FALSE(ReceiveSocketHandle(channel_[1], sock, data));
+  EXPECT_EQ(INVALID_SOCKET, sock);
+}
+
+#endif
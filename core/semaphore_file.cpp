@@ -91,10 +91,14 @@ SemaphoreFile::SemaphoreFile(std::filesystem::path path, int fd)
   : path_(std::move(path)), fd_(fd) {
 }
 
+SemaphoreFile::SemaphoreFile(SemaphoreFile&& other) noexcept
+  : path_(other.path_), fd_(std::exchange(other.fd_, -1)) {
+}
+
 SemaphoreFile::~SemaphoreFile() {
   VLOG(1) << "~SemaphoreFile(): " << path_ << "; fd: " << fd_;
   if (fd_ < 0) {
-    LOG(ERROR) << "Skipping closing since file already closed: " << path_;
+    // Moved from, the semaphore belongs to someone else now.
     return;
   }
   if (close(fd_) == -1) {
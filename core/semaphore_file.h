@@ -73,7 +73,8 @@ public:
   [[nodiscard]] const std::filesystem::path& path() const { return path_; }
   [[nodiscard]] int fd() const { return fd_; }
 
-  SemaphoreFile(SemaphoreFile&&) = default;
+  /** Takes over the semaphore from other, which no longer owns it. */
+  SemaphoreFile(SemaphoreFile&& other) noexcept;
   SemaphoreFile(const SemaphoreFile&) = delete;
   SemaphoreFile& operator=(const SemaphoreFile&) = delete;
 
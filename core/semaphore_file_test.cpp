@@ -23,6 +23,7 @@
 #include "core/test/file_helper.h"
 #include "gtest/gtest.h"
 #include <chrono>
+#include <optional>
 #include <string>
 
 using namespace wwiv::core;
@@ -65,3 +66,19 @@ TEST(SemaphoreFileTest, Smoke) {
 
   EXPECT_TRUE(File::Exists(fn)) << fn;
 }
+
+TEST(SemaphoreFileTest, Move) {
+  const wwiv::core::test::FileHelper file;
+  const auto path = FilePath(file.TempDir(), "x.sem");
+  {
+    std::optional<SemaphoreFile> lock;
+    lock.emplace(SemaphoreFile::try_acquire(path, std::chrono::milliseconds(100)));
+    // The moved from temporary is gone, but the semaphore must still be held.
+    EXPECT_TRUE(File::Exists(path));
+    EXPECT_GE(lock->fd(), 0);
+    EXPECT_THROW(
+        (void)SemaphoreFile::try_acquire(path, std::chrono::milliseconds(10)),
+        semaphore_not_acquired);
+  }
+  EXPECT_FALSE(File::Exists(path));
+}
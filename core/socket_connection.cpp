@@ -17,9 +17,11 @@
 /**************************************************************************/
 #include "core/socket_connection.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
 #include <cstring>
+#include <memory>
 #include <thread>
 #ifdef _WIN32
 #include <WS2tcpip.h>
@@ -32,9 +34,14 @@
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif // __linux__
 #endif // _WIN32
 
 #ifdef __OS2__
@@ -52,11 +59,11 @@
 
 using std::chrono::duration;
 using std::chrono::duration_cast;
+using std::chrono::microseconds;
 using std::chrono::milliseconds;
 using std::chrono::seconds;
 using std::chrono::system_clock;
 using std::chrono::time_point;
-using wwiv::os::sleep_for;
 using namespace wwiv::strings;
 
 namespace wwiv::core {
@@ -100,6 +107,22 @@ bool WouldSocketBlock() {
 #endif // _WIN32
 }
 
+// Waits up to d for the socket to become readable (or writable if for_write
+// is true). Returns true if the socket is ready.
+bool WaitForSocket(SOCKET sock, bool for_write, duration<double> d) {
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(sock, &fds);
+  const auto us = std::max<int64_t>(0, duration_cast<microseconds>(d).count());
+  timeval tv{};
+  tv.tv_sec = static_cast<long>(us / 1000000);
+  tv.tv_usec = static_cast<long>(us % 1000000);
+  const auto nfds = static_cast<int>(sock + 1);
+  const auto result = for_write ? select(nfds, nullptr, &fds, nullptr, &tv)
+                                : select(nfds, &fds, nullptr, nullptr, &tv);
+  return result > 0;
+}
+
 std::string GetLastErrorText() {
 #if defined ( _WIN32 )
   char* error_text{nullptr};
@@ -147,6 +170,14 @@ SocketConnection::SocketConnection(SOCKET sock, ExitMode exit_mode)
     sock_ = INVALID_SOCKET;
     throw socket_error("SocketConnection: Unable to set nodelay mode on the socket.");
   }
+#ifdef __linux__
+  sendfile_fn_ = [](SOCKET s, int fd, int64_t* offset, int count) -> int64_t {
+    auto pos = static_cast<off_t>(*offset);
+    const auto sent = ::sendfile(s, fd, &pos, count);
+    *offset = pos;
+    return sent;
+  };
+#endif
 }
 
 std::unique_ptr<SocketConnection> Connect(const std::string& host, int port) {
@@ -237,7 +268,8 @@ static int read_TYPE(const SOCKET sock, TYPE* data, const duration<double> d, bo
       const auto saved_errno = errno;
       const auto saved_errno_text = GetLastErrorText();
       if (WouldSocketBlock()) {
-        sleep_for(SLEEP_MS);
+        // Wake up as soon as data arrives rather than always sleeping.
+        WaitForSocket(sock, false, SLEEP_MS);
         continue;
       }
       if (saved_errno != ECONNRESET) {
@@ -314,18 +346,144 @@ std::string SocketConnection::read_line(int max_size, duration<double> d) {
 #define MSG_NOSIGNAL 0
 #endif  // MSG_NOSIGNAL 
 
-int SocketConnection::send(const void* data, int size, duration<double>) {
-  const auto sent = ::send(sock_, static_cast<const char*>(data), size, MSG_NOSIGNAL);
-  if (open_ && sent != size) {
-    if (sent == -1) {
-      throw socket_closed_error(
-          StrCat("Socket Closed; errno: ", strerror(errno)));
+#ifndef MSG_MORE
+#define MSG_MORE 0
+#endif  // MSG_MORE
+
+// Waits up to end for the socket to be writable after a send returned
+// EWOULDBLOCK, throws timeout_error once end has passed.
+template <typename TP> static void WaitToSend(SOCKET sock, const TP& end) {
+  if (system_clock::now() > end) {
+    throw timeout_error("timeout error writing to socket.");
+  }
+  WaitForSocket(sock, true, SLEEP_MS);
+}
+
+int SocketConnection::send(const void* data, int size, duration<double> d) {
+  return send_bytes(data, size, MSG_NOSIGNAL, d);
+}
+
+int SocketConnection::send_bytes(const void* data, int size, int flags, duration<double> d) {
+  // The socket is nonblocking, so a full send buffer shows up as EWOULDBLOCK
+  // or a short write. Wait for it to drain (up to d) rather than dropping bytes.
+  const auto end = system_clock::now() + d;
+  const auto* p = static_cast<const char*>(data);
+  auto remaining = size;
+  while (remaining > 0) {
+    const auto sent = ::send(sock_, p, remaining, flags);
+    if (sent == SOCKET_ERROR) {
+      if (WouldSocketBlock()) {
+        WaitToSend(sock_, end);
+        continue;
+      }
+      if (open_) {
+        throw socket_closed_error(StrCat("Socket Closed; errno: ", strerror(errno)));
+      }
+      return size;
     }
-    LOG(ERROR) << "ERROR: send != packet size.  size: " << size << "; sent: " << sent;
+    p += sent;
+    remaining -= static_cast<int>(sent);
   }
   return size;
 }
 
+int SocketConnection::send_with_header(const void* header, int header_size, const void* data,
+                                       int size, duration<double> d) {
+#ifdef _WIN32
+  return Connection::send_with_header(header, header_size, data, size, d);
+#else
+  const auto end = system_clock::now() + d;
+  iovec iov[2]{};
+  iov[0].iov_base = const_cast<void*>(header);
+  iov[0].iov_len = header_size;
+  iov[1].iov_base = const_cast<void*>(data);
+  iov[1].iov_len = size;
+  msghdr msg{};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+  while (msg.msg_iovlen > 0) {
+    const auto sent = ::sendmsg(sock_, &msg, MSG_NOSIGNAL);
+    if (sent == SOCKET_ERROR) {
+      if (WouldSocketBlock()) {
+        WaitToSend(sock_, end);
+        continue;
+      }
+      if (open_) {
+        throw socket_closed_error(StrCat("Socket Closed; errno: ", strerror(errno)));
+      }
+      return header_size + size;
+    }
+    // Skip past whatever was written, which may end part way into an iovec.
+    auto n = static_cast<size_t>(sent);
+    while (msg.msg_iovlen > 0 && n >= msg.msg_iov->iov_len) {
+      n -= msg.msg_iov->iov_len;
+      ++msg.msg_iov;
+      --msg.msg_iovlen;
+    }
+    if (msg.msg_iovlen > 0) {
+      msg.msg_iov->iov_base = static_cast<char*>(msg.msg_iov->iov_base) + n;
+      msg.msg_iov->iov_len -= n;
+    }
+  }
+  return header_size + size;
+#endif
+}
+
+bool SocketConnection::send_file_with_header(const void* header, int header_size, int fd,
+                                             int64_t offset, int size, duration<double> d) {
+  if (!sendfile_fn_) {
+    return false;
+  }
+  const auto end = system_clock::now() + d;
+  // MSG_MORE lets the kernel coalesce the header with the file data.
+  send_bytes(header, header_size, MSG_NOSIGNAL | MSG_MORE, d);
+  auto pos = offset;
+  auto remaining = size;
+  while (remaining > 0) {
+    const auto sent = sendfile_fn_(sock_, fd, &pos, remaining);
+    if (sent < 0) {
+      if (WouldSocketBlock()) {
+        WaitToSend(sock_, end);
+        continue;
+      }
+      if (errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP) {
+        // Not every file supports sendfile, send the rest by hand.
+        VLOG(1) << "sendfile unsupported for fd: " << fd << "; " << strerror(errno);
+        send_file_bytes(fd, pos, remaining, end - system_clock::now());
+        return true;
+      }
+      throw socket_error(StrCat("sendfile failed; errno: ", strerror(errno)));
+    }
+    if (sent == 0) {
+      throw socket_error("sendfile: file is shorter than expected.");
+    }
+    remaining -= static_cast<int>(sent);
+  }
+  return true;
+}
+
+void SocketConnection::send_file_bytes(int fd, int64_t offset, int size, duration<double> d) {
+#ifdef _WIN32
+  throw socket_error("send_file_bytes is not supported on this platform.");
+#else
+  const auto end = system_clock::now() + d;
+  constexpr int kChunkSize = 32 * 1024;
+  const auto buf = std::make_unique<char[]>(kChunkSize);
+  while (size > 0) {
+    const auto num_read = ::pread(fd, buf.get(), std::min(size, kChunkSize), offset);
+    if (num_read < 0) {
+      throw socket_error(StrCat("send_file_bytes: read failed; errno: ", strerror(errno)));
+    }
+    if (num_read == 0) {
+      throw socket_error("send_file_bytes: file is shorter than expected.");
+    }
+    send_bytes(buf.get(), static_cast<int>(num_read), MSG_NOSIGNAL, end - system_clock::now());
+    offset += num_read;
+    size -= static_cast<int>(num_read);
+  }
+#endif
+}
+
 int SocketConnection::send(const std::string& s, duration<double> d) {
   return send(s.data(), stl::size_int(s), d);
 }
@@ -354,6 +512,10 @@ uint8_t SocketConnection::read_uint8(duration<double> d) {
   return data;
 }
 
+bool SocketConnection::wait_for_data(duration<double> d) {
+  return open_ && WaitForSocket(sock_, false, d);
+}
+
 bool SocketConnection::close() {
   if (open_) {
     open_ = false;
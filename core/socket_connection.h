@@ -22,6 +22,7 @@
 #include "core/net.h" // SOCKET
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -59,12 +60,31 @@ public:
   std::string read_line(int max_size, std::chrono::duration<double> d);
   int send(const void* data, int size, std::chrono::duration<double> d) override;
   int send(const std::string& s, std::chrono::duration<double> d) override;
+  /** Sends header and data with a single gathering write (writev). */
+  int send_with_header(const void* header, int header_size, const void* data, int size,
+                       std::chrono::duration<double> d) override;
+  /**
+   * Uses sendfile(2) where available to send the file contents. Returns false
+   * without sending anything when sendfile isn't available. Files that
+   * sendfile can't handle are read and sent the ordinary way.
+   */
+  bool send_file_with_header(const void* header, int header_size, int fd, int64_t offset, int size,
+                             std::chrono::duration<double> d) override;
+
+  /**
+   * Sends up to count bytes from fd at *offset to sock, advancing *offset.
+   * Returns the number of bytes sent or -1 with errno set, like sendfile(2).
+   */
+  typedef std::function<int64_t(SOCKET sock, int fd, int64_t* offset, int count)> sendfile_fn_t;
+  // VisibleForTesting
+  void set_sendfile_fn(sendfile_fn_t fn) { sendfile_fn_ = std::move(fn); }
 
   /** Sends a line s and \r\n */
   int send_line(const std::string& s, std::chrono::duration<double> d);
 
   uint16_t read_uint16(std::chrono::duration<double> d) override;
   uint8_t read_uint8(std::chrono::duration<double> d) override;
+  [[nodiscard]] bool wait_for_data(std::chrono::duration<double> d) override;
 
   bool is_open() const override { return open_; }
   bool close() override;
@@ -72,9 +92,17 @@ public:
   SOCKET socket() const { return sock_; }
 
 private:
+  // Sends all size bytes using ::send with flags, waiting up to d for the
+  // socket buffer to drain.
+  int send_bytes(const void* data, int size, int flags, std::chrono::duration<double> d);
+
+  // Sends size bytes of fd starting at offset by reading it into memory.
+  void send_file_bytes(int fd, int64_t offset, int size, std::chrono::duration<double> d);
+
   SOCKET sock_;
   bool open_;
   ExitMode exit_mode_ = ExitMode::LEAVE_SOCKET_OPEN;
+  sendfile_fn_t sendfile_fn_;
 };
 
 
@@ -0,0 +1,190 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/socket_connection.h"
+
+#include "core/socket_exceptions.h"
+#include "core/test/file_helper.h"
+#include "gtest/gtest.h"
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+using namespace wwiv::core;
+
+class SocketConnectionTest : public testing::Test {
+protected:
+  void SetUp() override {
+    int sv[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    conn_ = std::make_unique<SocketConnection>(sv[0]);
+    peer_ = sv[1];
+  }
+
+  void TearDown() override {
+    if (reader_.joinable()) {
+      reader_.join();
+    }
+    conn_.reset();
+    close(peer_);
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  /** Shrinks both socket buffers so large sends only go out a piece at a time. */
+  void UseSmallBuffers() {
+    const int size = 4096;
+    setsockopt(conn_->socket(), SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(peer_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  }
+
+  /** Reads size bytes from the peer on another thread, in small pieces. */
+  void StartReader(std::size_t size) {
+    reader_ = std::thread([this, size] {
+      char buf[1000];
+      while (received_.size() < size) {
+        const auto n = read(peer_, buf, sizeof(buf));
+        if (n <= 0) {
+          return;
+        }
+        received_.append(buf, static_cast<std::size_t>(n));
+      }
+    });
+  }
+
+  std::string Received() {
+    reader_.join();
+    return received_;
+  }
+
+  /** Opens a temporary file containing contents for reading. */
+  int OpenFile(const std::string& contents) {
+    const auto path = files_.CreateTempFile("data.txt", contents);
+    fd_ = open(path.string().c_str(), O_RDONLY);
+    return fd_;
+  }
+
+  static std::string pattern(std::size_t size, int seed) {
+    std::string s(size, '\0');
+    for (std::size_t i = 0; i < size; i++) {
+      s[i] = static_cast<char>('a' + (i * 7 + seed) % 26);
+    }
+    return s;
+  }
+
+  std::unique_ptr<SocketConnection> conn_;
+  int peer_{-1};
+  int fd_{-1};
+  std::thread reader_;
+  std::string received_;
+  wwiv::core::test::FileHelper files_;
+};
+
+TEST_F(SocketConnectionTest, SendWithHeader) {
+  StartReader(5);
+  EXPECT_EQ(5, conn_->send_with_header("he", 2, "llo", 3, seconds(1)));
+  EXPECT_EQ("hello", Received());
+}
+
+TEST_F(SocketConnectionTest, SendWithHeader_PartialWrites) {
+  // Neither iovec fits in the socket buffer, so writes end part way into the
+  // header, on the boundary or part way into the data and have to resume there.
+  UseSmallBuffers();
+  const auto header = pattern(50000, 1);
+  const auto data = pattern(200000, 2);
+  StartReader(header.size() + data.size());
+  EXPECT_EQ(250000, conn_->send_with_header(header.data(), 50000, data.data(), 200000,
+                                            seconds(10)));
+  EXPECT_EQ(header + data, Received());
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader) {
+  const auto fd = OpenFile("0123456789");
+  StartReader(6);
+  EXPECT_TRUE(conn_->send_file_with_header("hd", 2, fd, 3, 4, seconds(1)));
+  EXPECT_EQ("hd3456", Received());
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader_PartialWrites) {
+  UseSmallBuffers();
+  const auto contents = pattern(200000, 3);
+  const auto fd = OpenFile(contents);
+  StartReader(2 + contents.size() - 10);
+  EXPECT_TRUE(conn_->send_file_with_header("hd", 2, fd, 10, 199990, seconds(10)));
+  EXPECT_EQ("hd" + contents.substr(10), Received());
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader_SendfileFails) {
+  // Sends a little with sendfile and then fails like a file that sendfile
+  // doesn't support, the rest has to be read and sent.
+  int calls = 0;
+  conn_->set_sendfile_fn([&calls](SOCKET s, int, int64_t* offset, int count) -> int64_t {
+    if (calls++ > 0) {
+      errno = EINVAL;
+      return -1;
+    }
+    const auto n = std::min(count, 3);
+    ::send(s, "012", n, 0);
+    *offset += n;
+    return n;
+  });
+  UseSmallBuffers();
+  const auto contents = "012" + pattern(100000, 4);
+  const auto fd = OpenFile(contents);
+  StartReader(2 + contents.size());
+  EXPECT_TRUE(conn_->send_file_with_header("hd", 2, fd, 0, 100003, seconds(10)));
+  EXPECT_EQ("hd" + contents, Received());
+  EXPECT_EQ(2, calls);
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader_SendfileError) {
+  conn_->set_sendfile_fn([](SOCKET, int, int64_t*, int) -> int64_t {
+    errno = EIO;
+    return -1;
+  });
+  const auto fd = OpenFile("0123456789");
+  EXPECT_THROW(conn_->send_file_with_header("hd", 2, fd, 0, 10, seconds(1)), socket_error);
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader_ShortFile) {
+  conn_->set_sendfile_fn([](SOCKET, int, int64_t*, int) -> int64_t {
+    errno = ENOSYS;
+    return -1;
+  });
+  const auto fd = OpenFile("0123456789");
+  EXPECT_THROW(conn_->send_file_with_header("hd", 2, fd, 5, 10, seconds(1)), socket_error);
+}
+
+TEST_F(SocketConnectionTest, SendFileWithHeader_Unavailable) {
+  // Without sendfile nothing is sent, the caller sends the data itself.
+  conn_->set_sendfile_fn(nullptr);
+  const auto fd = OpenFile("0123456789");
+  EXPECT_FALSE(conn_->send_file_with_header("hd", 2, fd, 0, 10, seconds(1)));
+  char c;
+  EXPECT_EQ(-1, recv(peer_, &c, 1, MSG_DONTWAIT));
+}
+
+#endif
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_SPSC_RING_BUFFER_H
+#define INCLUDED_CORE_SPSC_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace wwiv::core {
+
+/**
+ * \short
+ * A lock free ring buffer of bytes with a single producer thread and a
+ * single consumer thread.
+ *
+ * write() may only be called from the producer, and read(), get(), and
+ * clear() only from the consumer.  size() and empty() may be called from
+ * either thread.
+ *
+ * Example use:
+ * \code
+ *  SpscRingBuffer rb(4096);
+ *  // producer
+ *  rb.write(data, len);
+ *  // consumer
+ *  char buf[100];
+ *  const auto n = rb.read(buf, sizeof(buf));
+ * \endcode
+ */
+class SpscRingBuffer final {
+public:
+  /** Creates a ring buffer holding at least capacity bytes. */
+  explicit SpscRingBuffer(std::size_t capacity)
+      : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+        data_(std::make_unique<char[]>(capacity_)) {}
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+  [[nodiscard]] std::size_t size() const noexcept {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  /** Appends up to size bytes of data, returning how many fit. */
+  std::size_t write(const char* data, std::size_t size) noexcept {
+    const auto head = head_.load(std::memory_order_relaxed);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    const auto n = std::min(size, capacity_ - (head - tail));
+    copy_in(head, data, n);
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  /** Removes up to size bytes into data, returning how many were read. */
+  std::size_t read(char* data, std::size_t size) noexcept {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto n = std::min(size, head - tail);
+    copy_out(tail, data, n);
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  /** Removes a single byte into ch, returning false if there was none. */
+  bool get(char& ch) noexcept { return read(&ch, 1) == 1; }
+
+  /** Discards everything written so far. */
+  void clear() noexcept {
+    tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  static std::size_t round_up_pow2(std::size_t n) {
+    std::size_t c = 1;
+    while (c < n) {
+      c <<= 1;
+    }
+    return c;
+  }
+
+  void copy_in(std::size_t pos, const char* data, std::size_t n) noexcept {
+    const auto start = pos & mask_;
+    const auto first = std::min(n, capacity_ - start);
+    std::memcpy(data_.get() + start, data, first);
+    std::memcpy(data_.get(), data + first, n - first);
+  }
+
+  void copy_out(std::size_t pos, char* data, std::size_t n) const noexcept {
+    const auto start = pos & mask_;
+    const auto first = std::min(n, capacity_ - start);
+    std::memcpy(data, data_.get() + start, first);
+    std::memcpy(data + first, data_.get(), n - first);
+  }
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<char[]> data_;
+  // Total bytes ever written and read.  Each is only stored to by one side,
+  // and they are kept on separate cache lines so the two sides don't
+  // contend.
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+} // namespace wwiv::core
+
+#endif
@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/spsc_ring_buffer.h"
+#include <string>
+#include <thread>
+
+using namespace wwiv::core;
+
+TEST(SpscRingBufferTest, Capacity) {
+  SpscRingBuffer rb(100);
+  EXPECT_EQ(128u, rb.capacity());
+  EXPECT_TRUE(rb.empty());
+}
+
+TEST(SpscRingBufferTest, WriteRead) {
+  SpscRingBuffer rb(16);
+  EXPECT_EQ(5u, rb.write("hello", 5));
+  EXPECT_EQ(5u, rb.size());
+  char buf[16]{};
+  EXPECT_EQ(5u, rb.read(buf, sizeof(buf)));
+  EXPECT_EQ("hello", std::string(buf, 5));
+  EXPECT_TRUE(rb.empty());
+}
+
+TEST(SpscRingBufferTest, Full) {
+  SpscRingBuffer rb(8);
+  EXPECT_EQ(8u, rb.write("0123456789", 10));
+  EXPECT_EQ(0u, rb.write("x", 1));
+  char ch;
+  ASSERT_TRUE(rb.get(ch));
+  EXPECT_EQ('0', ch);
+  EXPECT_EQ(1u, rb.write("89", 2));
+}
+
+TEST(SpscRingBufferTest, Wrap) {
+  SpscRingBuffer rb(8);
+  char buf[8];
+  rb.write("abcdef", 6);
+  rb.read(buf, 4);
+  EXPECT_EQ(6u, rb.write("ghijkl", 6));
+  EXPECT_EQ(8u, rb.read(buf, sizeof(buf)));
+  EXPECT_EQ("efghijkl", std::string(buf, 8));
+}
+
+TEST(SpscRingBufferTest, Clear) {
+  SpscRingBuffer rb(8);
+  rb.write("abc", 3);
+  rb.clear();
+  EXPECT_TRUE(rb.empty());
+  char ch;
+  EXPECT_FALSE(rb.get(ch));
+}
+
+TEST(SpscRingBufferTest, TwoThreads) {
+  SpscRingBuffer rb(64);
+  static constexpr int SIZE = 256 * 1024;
+  std::thread producer([&] {
+    char buf[37];
+    for (auto i = 0; i < SIZE;) {
+      auto len = 0;
+      for (; len < static_cast<int>(sizeof(buf)) && i + len < SIZE; len++) {
+        buf[len] = static_cast<char>((i + len) & 0xff);
+      }
+      auto written = 0;
+      while (written < len) {
+        if (const auto n = rb.write(buf + written, len - written); n > 0) {
+          written += static_cast<int>(n);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      i += len;
+    }
+  });
+
+  auto bad = 0;
+  char buf[29];
+  for (auto i = 0; i < SIZE;) {
+    const auto n = static_cast<int>(rb.read(buf, sizeof(buf)));
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+    for (auto j = 0; j < n; j++) {
+      if (buf[j] != static_cast<char>((i + j) & 0xff)) {
+        ++bad;
+      }
+    }
+    i += n;
+  }
+  producer.join();
+  EXPECT_EQ(0, bad);
+  EXPECT_TRUE(rb.empty());
+}
@@ -60,6 +60,8 @@ std::map<int, fsed_command_id> CreateDefaultEditModeKeyMap() {
   map.emplace(CP, fsed_command_id::input_wwiv_color);
   map.emplace(CW, fsed_command_id::delete_word_left);
   map.emplace(CX, fsed_command_id::delete_line_left);
+  map.emplace(CZ, fsed_command_id::undo);
+  map.emplace(CY, fsed_command_id::redo);
 
   return map;
 }
@@ -217,6 +219,10 @@ bool FsedCommands::AddAll() {
   add(FsedCommand(
       fsed_command_id::delete_line_left, "delete_line_left",
       [](FsedModel& ed, FsedView&, FsedState&) -> bool { return ed.delete_line_left(); }));
+  add(FsedCommand(fsed_command_id::undo, "undo",
+                  [](FsedModel& ed, FsedView&, FsedState&) -> bool { return ed.undo(); }));
+  add(FsedCommand(fsed_command_id::redo, "redo",
+                  [](FsedModel& ed, FsedView&, FsedState&) -> bool { return ed.redo(); }));
   add(FsedCommand(fsed_command_id::menu, "menu",
                   [&](FsedModel& ed, FsedView& view, FsedState& state) -> bool {
                     show_fsed_menu(ctx_, ed, view, data_, state.done, state.save);
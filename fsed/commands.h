@@ -54,6 +54,8 @@ enum class fsed_command_id {
   toggle_insovr,
   view_redraw,
   input_wwiv_color,
+  undo,
+  redo,
   ignore,
   none,
 };
@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "fsed/document.h"
+
+#include "core/stl.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace wwiv::fsed {
+
+using namespace wwiv::stl;
+
+// New blocks start half full so that lines can be inserted without
+// splitting them right away.
+static constexpr int INITIAL_BLOCK_SIZE = document_t::MAX_BLOCK_SIZE / 2;
+
+line_t& document_t::at(int n) {
+  if (n < 0 || n >= size_) {
+    throw std::out_of_range(fmt::format("Invalid line: {}; size: {}", n, size_));
+  }
+  const auto b = block_of(n);
+  return blocks_[b][n - first_line_[b]];
+}
+
+const line_t& document_t::at(int n) const {
+  if (n < 0 || n >= size_) {
+    throw std::out_of_range(fmt::format("Invalid line: {}; size: {}", n, size_));
+  }
+  const auto b = block_of(n);
+  return blocks_[b][n - first_line_[b]];
+}
+
+bool document_t::insert(int n, line_t l) {
+  if (n < 0 || n > size_) {
+    return false;
+  }
+  if (blocks_.empty()) {
+    blocks_.emplace_back();
+    first_line_.push_back(0);
+  }
+  const auto b = n == size_ ? size_int(blocks_) - 1 : block_of(n);
+  auto& block = blocks_[b];
+  insert_at(block, n - first_line_[b], std::move(l));
+  ++size_;
+  if (size_int(block) > MAX_BLOCK_SIZE) {
+    // Split the block in two.
+    const auto mid = std::next(block.begin(), size_int(block) / 2);
+    std::vector<line_t> tail(std::make_move_iterator(mid), std::make_move_iterator(block.end()));
+    block.erase(mid, block.end());
+    blocks_.insert(std::next(blocks_.begin(), b + 1), std::move(tail));
+    first_line_.insert(std::next(first_line_.begin(), b + 1), 0);
+  }
+  renumber(b);
+  return true;
+}
+
+bool document_t::erase(int n) {
+  if (n < 0 || n >= size_) {
+    return false;
+  }
+  const auto b = block_of(n);
+  erase_at(blocks_[b], n - first_line_[b]);
+  --size_;
+  if (blocks_[b].empty()) {
+    erase_at(blocks_, b);
+    erase_at(first_line_, b);
+  }
+  renumber(b);
+  return true;
+}
+
+void document_t::push_back(line_t l) { insert(size_, std::move(l)); }
+
+void document_t::assign(std::vector<line_t>&& lines) {
+  clear();
+  for (auto it = lines.begin(); it != lines.end();) {
+    const auto end = std::next(it, std::min<std::ptrdiff_t>(INITIAL_BLOCK_SIZE, lines.end() - it));
+    first_line_.push_back(size_);
+    blocks_.emplace_back(std::make_move_iterator(it), std::make_move_iterator(end));
+    size_ += size_int(blocks_.back());
+    it = end;
+  }
+}
+
+void document_t::clear() {
+  blocks_.clear();
+  first_line_.clear();
+  size_ = 0;
+}
+
+int document_t::block_of(int n) const {
+  const auto it = std::upper_bound(first_line_.begin(), first_line_.end(), n);
+  return static_cast<int>(std::distance(first_line_.begin(), it)) - 1;
+}
+
+void document_t::renumber(int b) {
+  for (auto i = std::max(b, 1); i < size_int(blocks_); i++) {
+    first_line_[i] = first_line_[i - 1] + size_int(blocks_[i - 1]);
+  }
+  if (!first_line_.empty()) {
+    first_line_[0] = 0;
+  }
+}
+
+} // namespace wwiv::fsed
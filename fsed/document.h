@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_FSED_DOCUMENT_H
+#define INCLUDED_FSED_DOCUMENT_H
+
+#include "fsed/line.h"
+#include <vector>
+
+namespace wwiv::fsed {
+
+/**
+ * The lines of text being edited.
+ *
+ * Lines are kept in blocks of at most MAX_BLOCK_SIZE lines, so inserting or
+ * removing a line only moves the lines in a single block, and finding a line
+ * is a binary search over the number of the first line of each block. This
+ * keeps editing responsive with messages of tens of thousands of lines.
+ */
+class document_t {
+public:
+  static constexpr int MAX_BLOCK_SIZE = 256;
+
+  [[nodiscard]] int size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+  // Gets the line at a position n or throws std::out_of_range.
+  [[nodiscard]] line_t& at(int n);
+  [[nodiscard]] const line_t& at(int n) const;
+
+  // Inserts l before the line at n, n may be size() to add to the end.
+  bool insert(int n, line_t l);
+  // Removes the line at n.
+  bool erase(int n);
+  void push_back(line_t l);
+  void assign(std::vector<line_t>&& lines);
+  void clear();
+
+  // Calls fn with each line in order.
+  template <typename F> void for_each(F fn) const {
+    for (const auto& b : blocks_) {
+      for (const auto& l : b) {
+        fn(l);
+      }
+    }
+  }
+
+private:
+  // Returns the index of the block containing line n.
+  [[nodiscard]] int block_of(int n) const;
+  // Recomputes first_line_ for blocks from b onwards.
+  void renumber(int b);
+
+  std::vector<std::vector<line_t>> blocks_;
+  // Line number of the first line in each block.
+  std::vector<int> first_line_;
+  int size_{0};
+};
+
+} // namespace wwiv::fsed
+
+#endif
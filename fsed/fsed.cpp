@@ -52,10 +52,13 @@ static std::shared_ptr<FsedView> create_frame(MessageEditorData& data, bool file
   return view;
 }
 
+// Max number of lines when editing a text file.
+static constexpr int MAX_FILE_LINES = 50000;
+
 bool fsed(Context& ctx, const std::filesystem::path& path) {
   MessageEditorData data("<<NO USERNAME>>"); // anonymous username
   data.title = path.string();
-  FsedModel ed(1000);
+  FsedModel ed(MAX_FILE_LINES);
   auto file_lines = read_file(path, ed.maxli());
   if (!file_lines.empty()) {
     ed.set_lines(std::move(file_lines));
@@ -130,6 +130,10 @@ line_t& line_t::operator=(const line_t& o) {
   return *this;
 }
 
+bool line_t::operator==(const line_t& o) const {
+  return wrapped_ == o.wrapped_ && wwiv_color_ == o.wwiv_color_ && cell_ == o.cell_;
+}
+
 void line_t::assign(const std::vector<cell_t>& cells) {
   if (cells.empty()) {
     cell_.clear();
@@ -29,6 +29,7 @@ enum class ins_ovr_mode_t { ins, ovr };
 class cell_t {
 public:
   cell_t(int co, char cc) : wwiv_color(co), ch(cc) {}
+  bool operator==(const cell_t& o) const noexcept { return wwiv_color == o.wwiv_color && ch == o.ch; }
   int wwiv_color{0};
   char ch{0};
 };
@@ -40,6 +41,8 @@ public:
   line_t() : line_t(false, "") {}
   line_t(bool wrapped, std::string text);
   explicit line_t(std::string text) : line_t(false, std::move(text)) {}
+  line_t(const line_t&) = default;
+  line_t(line_t&&) = default;
 
   line_add_result_t add(int x, char c, ins_ovr_mode_t mode);
   line_add_result_t del(int x, ins_ovr_mode_t mode);
@@ -58,6 +61,8 @@ public:
 
   // operators
   line_t& operator=(const line_t& o);
+  line_t& operator=(line_t&& o) = default;
+  bool operator==(const line_t& o) const;
 
   void assign(const std::vector<cell_t>& cells);
   void append(const std::vector<cell_t>& cells);
@@ -21,6 +21,8 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "fmt/format.h"
+#include <algorithm>
+#include <utility>
 
 namespace wwiv::fsed {
 
@@ -46,12 +48,65 @@ static void advance_cy(FsedModel& ed, editor_viewport_t& view, bool invalidate =
 /////////////////////////////////////////////////////////////////////////////
 // EDITOR
 
+/**
+ * Records the edit made during its lifetime in the undo journal.
+ *
+ * Every edit only changes the current line and the lines next to it, and
+ * only inserts or removes lines next to the current one, so the lines
+ * changed are the ones around the current line when the edit started, less
+ * any removed or plus any inserted.
+ */
+class FsedModel::UndoScope {
+public:
+  UndoScope(FsedModel& ed, undo_kind_t kind) : ed_(ed) {
+    if (ed_.undo_depth_++ > 0) {
+      return;
+    }
+    // Make sure the current line exists, so that it is part of the document
+    // both before and after the edit.
+    ed_.curline();
+    const auto size = ed_.lines_.size();
+    const auto first = std::clamp(ed_.curli - 1, 0, size);
+    const auto last = std::clamp(ed_.curli + 2, first, size);
+    auto& e = ed_.pending_undo_;
+    e = undo_entry_t{};
+    e.kind = kind;
+    e.first_line = first;
+    for (auto i = first; i < last; i++) {
+      e.before.push_back(ed_.lines_.at(i));
+    }
+    e.cursor_before = {ed_.curli, ed_.cx};
+    ed_.pending_undo_size_ = size;
+  }
+
+  ~UndoScope() {
+    if (--ed_.undo_depth_ > 0) {
+      return;
+    }
+    auto& e = ed_.pending_undo_;
+    const auto size = ed_.lines_.size();
+    const auto last = std::clamp(
+        e.first_line + size_int(e.before) + size - ed_.pending_undo_size_, e.first_line, size);
+    for (auto i = e.first_line; i < last; i++) {
+      e.after.push_back(ed_.lines_.at(i));
+    }
+    e.cursor_after = {ed_.curli, ed_.cx};
+    ed_.journal_.push(std::move(e));
+  }
+
+  UndoScope(const UndoScope&) = delete;
+  UndoScope& operator=(const UndoScope&) = delete;
+
+private:
+  FsedModel& ed_;
+};
+
 void FsedModel::set_view(const std::shared_ptr<editor_viewport_t>& view) { view_ = view; }
 
 line_t& FsedModel::curline() const {
   // TODO: insert return statement here
-  while (curli >= size_int(lines_)) {
-    lines_.emplace_back();
+  while (curli >= lines_.size()) {
+    lines_.push_back(line_t());
   }
   try {
     return lines_.at(curli);
@@ -73,20 +128,26 @@ line_t& FsedModel::line(int n) const {
 }
 
 bool FsedModel::set_lines(std::vector<line_t>&& n) {
-  lines_ = n;
+  lines_.assign(std::move(n));
+  journal_.clear();
   return true;
 }
 
-void FsedModel::emplace_back(line_t&& n) { lines_.emplace_back(n); }
+void FsedModel::emplace_back(line_t&& n) {
+  lines_.push_back(std::move(n));
+  journal_.clear();
+}
 
 bool FsedModel::insert_line() {
-  if (size_int(lines_) >= maxli()) {
+  if (lines_.size() >= maxli()) {
     return false;
   }
-  return wwiv::stl::insert_at(lines_, curli, line_t());
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
+  return lines_.insert(curli, line_t());
 }
 
 bool FsedModel::insert_lines(std::vector<std::string>& lines) {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   for (const auto& ql : lines) {
     // Insert all quote lines.
     ++curli;
@@ -107,10 +168,12 @@ bool FsedModel::remove_line() {
   if (lines_.empty()) {
     return false;
   }
-  return wwiv::stl::erase_at(lines_, curli);
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
+  return lines_.erase(curli);
 }
 
 editor_add_result_t FsedModel::add(char c) {
+  const UndoScope undo_scope(*this, undo_kind_t::typing);
   auto& line = curline();
   const auto line_result = line.add(cx, c, mode_);
   if (line_result == line_add_result_t::error) {
@@ -187,7 +250,7 @@ bool FsedModel::cursor_up() {
 
 bool FsedModel::cursor_down() {
   const auto previous_line = curli;
-  if (curli < size_int(lines_) - 1) {
+  if (curli < lines_.size() - 1) {
     ++curli;
     const auto right_max = std::min<int>(max_line_len(), size_int(curline()));
     cx = std::min<int>(cx, right_max);
@@ -233,7 +296,7 @@ bool FsedModel::cursor_pgup() {
 bool FsedModel::cursor_pgdown() {
   const auto previous_line = curli;
   const auto dn =
-      std::min<int>(view_->max_view_lines(), std::max<int>(0, size_int(lines_) - curli - 1));
+      std::min<int>(view_->max_view_lines(), std::max<int>(0, lines_.size() - curli - 1));
   if (dn == 0) {
     // nothing to do!
     return true;
@@ -263,6 +326,7 @@ bool FsedModel::cursor_end() {
 }
 
 bool FsedModel::delete_line() {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   if (remove_line()) {
     invalidate_to_eof(curli);
   }
@@ -271,6 +335,7 @@ bool FsedModel::delete_line() {
 }
 
 bool FsedModel::delete_to_eol() {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   if (cx < size_int(curline())) {
     auto& oline = curline();
     oline.assign(oline.substr(0, cx));
@@ -287,6 +352,7 @@ bool FsedModel::delete_to_eol() {
 }
 
 bool FsedModel::delete_line_left() {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   auto& line = curline();
   const auto remainder = line.substr(cx);
   line.assign(remainder);
@@ -297,6 +363,7 @@ bool FsedModel::delete_line_left() {
 }
 
 bool FsedModel::delete_word_left() {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   if (cx <= 0) {
     return true;
   }
@@ -320,6 +387,7 @@ bool FsedModel::delete_word_left() {
 }
 
 bool FsedModel::delete_right() {
+  const UndoScope undo_scope(*this, undo_kind_t::typing);
   // TODO keep mode state;
   del();
   invalidate_to_eol();
@@ -339,6 +407,7 @@ void FsedModel::toggle_ins_ovr_mode() {
 ins_ovr_mode_t FsedModel::mode() const noexcept { return mode_; }
 
 bool FsedModel::del() {
+  const UndoScope undo_scope(*this, undo_kind_t::typing);
   const auto r = curline().del(cx, mode_);
   if (r == line_add_result_t::error) {
     return false;
@@ -350,6 +419,7 @@ bool FsedModel::del() {
 }
 
 bool FsedModel::bs_nowrap() {
+  const UndoScope undo_scope(*this, undo_kind_t::typing);
   const auto r = curline().bs(cx, mode_);
   if (r == line_add_result_t::error) {
     return false;
@@ -361,6 +431,7 @@ bool FsedModel::bs_nowrap() {
 }
 
 bool FsedModel::bs() {
+  const UndoScope undo_scope(*this, undo_kind_t::typing);
   const auto previous_line = curli;
   // TODO keep mode state;
   const auto previous_cx = std::max<int>(cx - 1, 0);
@@ -400,6 +471,7 @@ bool FsedModel::bs() {
 }
 
 bool FsedModel::enter() {
+  const UndoScope undo_scope(*this, undo_kind_t::edit);
   const auto orig_start_line = curli;
   curline().wrapped(false);
   const auto previous_color = curline().wwiv_color();
@@ -450,7 +522,7 @@ void FsedModel::invalidate_to_eol() {
 void FsedModel::invalidate_to_eof() { invalidate_to_eof(curli); }
 
 void FsedModel::invalidate_to_eof(int start_line) {
-  invalidate_range(start_line, size_int(lines_) - 1);
+  invalidate_range(start_line, lines_.size() - 1);
 }
 
 void FsedModel::invalidate_range(int start_line, int end_line) {
@@ -471,7 +543,7 @@ void FsedModel::current_line_dirty(int previous_line) {
 
 std::vector<std::string> FsedModel::to_lines() {
   std::vector<std::string> out;
-  for (const auto& l : lines_) {
+  lines_.for_each([&out](const line_t& l) {
     auto t = l.to_colored_text(0);
     StringTrimCRLF(&t);
     if (l.wrapped()) {
@@ -479,9 +551,59 @@ std::vector<std::string> FsedModel::to_lines() {
       t.push_back('\x1');
     }
     out.emplace_back(t);
-  }
+  });
 
   return out;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// UNDO
+
+void FsedModel::replace_lines(int first, int count, const std::vector<line_t>& lines) {
+  for (auto i = 0; i < count; i++) {
+    lines_.erase(first);
+  }
+  auto n = first;
+  for (const auto& l : lines) {
+    lines_.insert(n++, l);
+  }
+}
+
+void FsedModel::move_cursor(editor_cursor_t c) {
+  curli = std::clamp(c.curli, 0, std::max(0, lines_.size() - 1));
+  cx = c.cx;
+  if (!view_) {
+    return;
+  }
+  const auto max_lines = view_->max_view_lines();
+  if (curli < view_->top_line() || curli > view_->top_line() + max_lines) {
+    view_->set_top_line(std::max(0, curli - max_lines / 2));
+  }
+  cy = curli - view_->top_line();
+  invalidate_to_eof(view_->top_line());
+  current_line_dirty(curli);
+}
+
+bool FsedModel::undo() {
+  const auto o = journal_.undo();
+  if (!o) {
+    return false;
+  }
+  const auto& e = o.value();
+  replace_lines(e.first_line, size_int(e.after), e.before);
+  move_cursor(e.cursor_before);
+  return true;
+}
+
+bool FsedModel::redo() {
+  const auto o = journal_.redo();
+  if (!o) {
+    return false;
+  }
+  const auto& e = o.value();
+  replace_lines(e.first_line, size_int(e.before), e.after);
+  move_cursor(e.cursor_after);
+  return true;
+}
+
 } // namespace wwiv::fsed
@@ -18,7 +18,9 @@
 #ifndef INCLUDED_FSED_MODEL_H
 #define INCLUDED_FSED_MODEL_H
 
+#include "fsed/document.h"
 #include "fsed/line.h"
+#include "fsed/undo.h"
 #include <functional>
 #include <vector>
 #include <string>
@@ -80,7 +82,7 @@ public:
   [[nodiscard]] line_t& line(int n) const;
   bool set_lines(std::vector<line_t>&& n);
   // return the number of lines.
-  [[nodiscard]] std::size_t size() const { return lines_.size(); }
+  [[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(lines_.size()); }
   // Adds a new line to the end of the list of lines.
   void emplace_back(line_t&& n);
   // inserts a new line after curli.
@@ -133,6 +135,16 @@ public:
   bool delete_word_left();
   bool delete_right();
 
+  //
+  // Undo and Redo
+  //
+  // Reverts the most recent edit, returns false if there is nothing to undo.
+  bool undo();
+  // Reapplies the most recently undone edit.
+  bool redo();
+  [[nodiscard]] bool can_undo() const noexcept { return journal_.can_undo(); }
+  [[nodiscard]] bool can_redo() const noexcept { return journal_.can_redo(); }
+
   // Toggles the internal state if the editor is in INSERT or OVERWRITE mode. This
   // matters on add, bs, and del
   void toggle_ins_ovr_mode();
@@ -176,7 +188,7 @@ private:
   int maxli_{255};
   // Lines of text.  mark mutable so we can add the current line
   // into the array and stay logically const.
-  mutable std::vector<line_t> lines_;
+  mutable document_t lines_;
   // Insert or Overwrite mode
   ins_ovr_mode_t mode_{ins_ovr_mode_t::ins};
   // Max number of lines allowed.
@@ -186,6 +198,19 @@ private:
   std::vector<editor_current_line_redraw_fn> line_callbacks_;
   // Viewport for display
   std::shared_ptr<editor_viewport_t> view_;
+
+  // Records the lines changed by an edit into journal_.
+  class UndoScope;
+  // Replaces count lines starting at first with lines.
+  void replace_lines(int first, int count, const std::vector<line_t>& lines);
+  // Moves the cursor to c, scrolling the view if needed.
+  void move_cursor(editor_cursor_t c);
+
+  UndoJournal journal_;
+  // Nesting depth of UndoScopes, only the outermost one records the edit.
+  int undo_depth_{0};
+  undo_entry_t pending_undo_;
+  int pending_undo_size_{0};
 };
 
 }
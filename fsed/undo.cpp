@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "fsed/undo.h"
+
+#include <utility>
+
+namespace wwiv::fsed {
+
+// Removes the lines that were not changed from the start and end of e.
+static void trim_unchanged(undo_entry_t& e) {
+  auto& b = e.before;
+  auto& a = e.after;
+  std::size_t prefix = 0;
+  while (prefix < b.size() && prefix < a.size() && b[prefix] == a[prefix]) {
+    ++prefix;
+  }
+  b.erase(b.begin(), b.begin() + prefix);
+  a.erase(a.begin(), a.begin() + prefix);
+  e.first_line += static_cast<int>(prefix);
+  while (!b.empty() && !a.empty() && b.back() == a.back()) {
+    b.pop_back();
+    a.pop_back();
+  }
+}
+
+static bool can_merge(const undo_entry_t& last, const undo_entry_t& e) {
+  if (last.kind != undo_kind_t::typing || e.kind != undo_kind_t::typing) {
+    return false;
+  }
+  if (last.first_line != e.first_line || last.cursor_after.curli != e.cursor_before.curli ||
+      last.cursor_after.cx != e.cursor_before.cx) {
+    return false;
+  }
+  return last.after.size() == 1 && e.before.size() == 1 && e.after.size() == 1 &&
+         last.after.front() == e.before.front();
+}
+
+void UndoJournal::push(undo_entry_t e) {
+  trim_unchanged(e);
+  if (e.before.empty() && e.after.empty()) {
+    // Nothing changed.
+    return;
+  }
+  redo_.clear();
+  if (!undo_.empty() && can_merge(undo_.back(), e)) {
+    auto& last = undo_.back();
+    last.after = std::move(e.after);
+    last.cursor_after = e.cursor_after;
+    return;
+  }
+  undo_.emplace_back(std::move(e));
+  while (undo_.size() > MAX_ENTRIES) {
+    undo_.pop_front();
+  }
+}
+
+std::optional<undo_entry_t> UndoJournal::undo() {
+  if (undo_.empty()) {
+    return std::nullopt;
+  }
+  auto e = std::move(undo_.back());
+  undo_.pop_back();
+  redo_.push_back(e);
+  return {e};
+}
+
+std::optional<undo_entry_t> UndoJournal::redo() {
+  if (redo_.empty()) {
+    return std::nullopt;
+  }
+  auto e = std::move(redo_.back());
+  redo_.pop_back();
+  undo_.push_back(e);
+  return {e};
+}
+
+void UndoJournal::clear() {
+  undo_.clear();
+  redo_.clear();
+}
+
+} // namespace wwiv::fsed
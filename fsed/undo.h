@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_FSED_UNDO_H
+#define INCLUDED_FSED_UNDO_H
+
+#include "fsed/line.h"
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace wwiv::fsed {
+
+// The position of the cursor in the document.
+struct editor_cursor_t {
+  int curli{0};
+  int cx{0};
+};
+
+enum class undo_kind_t { typing, edit };
+
+/**
+ * A single edit that can be undone: the lines starting at first_line that
+ * were replaced, and the lines that replaced them.
+ */
+struct undo_entry_t {
+  undo_kind_t kind{undo_kind_t::edit};
+  int first_line{0};
+  std::vector<line_t> before;
+  std::vector<line_t> after;
+  editor_cursor_t cursor_before;
+  editor_cursor_t cursor_after;
+};
+
+/**
+ * The undo and redo history of the editor.  Consecutive characters typed
+ * on the same line are kept as a single entry, so that undo removes what
+ * was typed rather than one character at a time.
+ */
+class UndoJournal {
+public:
+  static constexpr int MAX_ENTRIES = 500;
+
+  // Adds e to the history and clears anything that could be redone.
+  void push(undo_entry_t e);
+  // Returns the most recent edit and moves it to the redo list.
+  std::optional<undo_entry_t> undo();
+  // Returns the most recently undone edit and moves it back to the undo list.
+  std::optional<undo_entry_t> redo();
+  void clear();
+
+  [[nodiscard]] bool can_undo() const noexcept { return !undo_.empty(); }
+  [[nodiscard]] bool can_redo() const noexcept { return !redo_.empty(); }
+
+private:
+  std::deque<undo_entry_t> undo_;
+  std::vector<undo_entry_t> redo_;
+};
+
+} // namespace wwiv::fsed
+
+#endif
@@ -48,21 +48,12 @@ using namespace wwiv::strings;
 namespace wwiv::net::network2 {
 
 static bool find_sub(const Subs& subs, int network_number, const std::string& netname, subboard_t& sub) {
-  auto current = 0;
-  for (const auto& x : subs.subs()) {
-    for (const auto& n : x.nets) {
-      if (n.net_num == network_number) {
-        if (iequals(netname, n.stype)) {
-          // Since the subtype matches, we need to find the subboard base filename.
-          // and return that.
-          sub = subs.sub(current);
-          return true;
-        }
-      }
-    }
-    ++current;
+  const auto o = subs.sub_number(network_number, netname);
+  if (!o) {
+    return false;
   }
-  return false;
+  sub = subs.sub(o.value());
+  return true;
 }
 
 // Alpha subtypes are seven characters -- the first must be a letter, but the rest can be any
@@ -38,8 +38,11 @@
 #include "sdk/net/contact.h"
 #include "sdk/net/networks.h"
 #include "sdk/status.h"
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <csignal>
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -61,6 +64,8 @@ static void RegisterNetworkBCommands(CommandLine& cmdline) {
   cmdline.add_argument({"node", "Node number (only used when sending)", "0"});
   cmdline.add_argument({"handle", "Existing socket handle (only used when receiving)", "0"});
   cmdline.add_argument({"port", "Port number to use (receiving only)", "24554"});
+  cmdline.add_argument(
+      {"send_window", "Number of files to send before waiting for the remote to receive them", "8"});
   cmdline.add_argument(BooleanCommandLineArgument(
       "daemon", "Run continually as a daemon until stopped  (only used when receiving)", true));
 }
@@ -166,6 +171,18 @@ static bool Send(const CommandLine& cmdline, BinkConfig& bink_config, const std:
   return true;
 }
 
+// Sessions we originate only lock the node being called, so that wwivd can
+// call several nodes on the same network at once.  Answering sessions keep
+// using the network-wide semaphore.
+static std::filesystem::path semaphore_path(const NetworkCommandLine& net_cmdline) {
+  if (!net_cmdline.cmdline().barg("send")) {
+    return net_cmdline.semaphore_path();
+  }
+  auto node = net_cmdline.cmdline().sarg("node");
+  std::replace_if(std::begin(node), std::end(node), [](char c) { return !isalnum(static_cast<unsigned char>(c)); }, '_');
+  return FilePath(net_cmdline.network().dir, StrCat("networkb-", node, ".bsy"));
+}
+
 static int Main(const NetworkCommandLine& net_cmdline) {
   try {
     [[maybe_unused]] static bool initialized = wwiv::core::InitializeSockets();
@@ -184,6 +201,7 @@ static int Main(const NetworkCommandLine& net_cmdline) {
     bink_config.set_skip_net(skip_net);
     bink_config.set_verbose(net_cmdline.cmdline().verbose());
     bink_config.set_network_version(status->status_net_version());
+    bink_config.set_send_window(net_cmdline.cmdline().iarg("send_window"));
 
     for (const auto& n : bink_config.networks().networks()) {
       auto domain = ToStringLowerCase(n.name);
@@ -231,12 +249,16 @@ static int Main(const NetworkCommandLine& net_cmdline) {
     }
   } catch (const connection_error& e) {
     LOG(ERROR) << "CONNECTION ERROR: [networkb]: " << e.what();
+    return 1;
   } catch (const socket_error& e) {
     LOG(ERROR) << "SOCKET ERROR: [networkb]: " << e.what();
+    return 1;
   } catch (const std::exception& e) {
     LOG(ERROR) << "ERROR: [networkb]: " << e.what();
+    return 1;
   } catch (...) {
     LOG(ERROR) << "ERROR: [networkb]: (Unknown)";
+    return 1;
   }
   return 0;
 }
@@ -260,7 +282,7 @@ int main(int argc, char** argv) {
     return 1;
   }
   try {
-    auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_path(),
+    auto semaphore = SemaphoreFile::try_acquire(semaphore_path(net_cmdline),
                                                 net_cmdline.semaphore_timeout());
     return Main(net_cmdline);
   } catch (const semaphore_not_acquired& e) {
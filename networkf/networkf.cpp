@@ -43,13 +43,18 @@
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
 #include "sdk/net/subscribers.h"
+#include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace wwiv::core;
@@ -100,17 +105,11 @@ void ShowNetworkfHelp(const NetworkCommandLine& cmdline) {
 }
 
 static std::string get_echomail_areaname(const std::string& text) {
-  auto lines = split_message(text);
-  for (const auto& line : lines) {
-    if (starts_with(line, "AREA:")) {
-      return line.substr(5);
-    }
-  }
-  return "";
+  return std::string(find_control_line(text, "AREA"));
 }
 
 NetworkF::NetworkF(const sdk::BbsDirectories& bbsdirs, const networkf_options_t& opts,
-                   const sdk::net::Network net, const sdk::BbsListNet& bbslist, core::Clock& clock)
+                   const sdk::net::Network& net, const sdk::BbsListNet& bbslist, core::Clock& clock)
     : bbslist_(bbslist), clock_(clock), net_(net),
       fido_callout_(bbsdirs.root_directory(), opts.max_backups, net_),
       netdat_(bbsdirs.gfilesdir(), bbsdirs.logdir(), net_, opts.net_cmd, clock_),
@@ -129,12 +128,14 @@ NetworkF::NetworkF(const sdk::BbsDirectories& bbsdirs, const networkf_options_t&
 
 NetworkF::~NetworkF() = default;
 
-bool NetworkF::import_packet_file(const std::filesystem::path& path) {
-  LOG(INFO) << "Importing Packet: " << path.string();
+ftn_packet_t NetworkF::read_packet_file(const std::filesystem::path& path) const {
+  LOG(INFO) << "Reading Packet: " << path.string();
+  ftn_packet_t result;
+  result.path = path;
   auto o = FidoPacket::Open(path);
   if (!o) {
     LOG(INFO) << "Unable to open file: " << path.string();
-    return false;
+    return result;
   }
   auto& packet = o.value();
 
@@ -152,28 +153,51 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
     if (!File::Move(path, bad_messages_paath)) {
       LOG(ERROR) << "Error moving file to BADMSGS; file: " << path.string();
     }
-    return false;
+    return result;
   }
 
   while (true) {
     auto [response, msg] = packet.Read();
     if (response != ReadNetPacketResponse::OK) {
-      return true;
+      break;
+    }
+    ftn_message_t m;
+    m.is_email = (msg.nh.attribute & MSGPRIVATE) != 0;
+    m.from_address = fmt::format("{}", get_address_from_packet(msg, packet.header()));
+    m.to = m.is_email ? msg.vh.to_user_name : get_echomail_areaname(msg.vh.text);
+    if (!m.is_email) {
+      m.msgid = FtnMessageDupe::GetMessageIDFromText(msg.vh.text);
+      FtnMessageDupe::GetMessageCrc32s(msg, m.header_crc32, m.msgid_crc32);
     }
+    m.text = FidoToWWIVText(msg.vh.text);
+    // Only keep the converted text, the original isn't needed anymore.
+    msg.vh.text.clear();
+    msg.vh.text.shrink_to_fit();
+    m.msg = std::move(msg);
+    result.messages.emplace_back(std::move(m));
+  }
+  result.ok = true;
+  return result;
+}
 
-    const auto is_email = (msg.nh.attribute & MSGPRIVATE) != 0;
-    if (!is_email) {
+bool NetworkF::write_packet(const ftn_packet_t& packet) {
+  if (!packet.ok) {
+    return false;
+  }
+  LOG(INFO) << "Importing Packet: " << packet.path.string();
+  for (const auto& m : packet.messages) {
+    const auto& msg = m.msg;
+    if (!m.is_email) {
       // Don't check for dupes in emails since we certainly won't have a MSGID and also
       // likely the header may match for automated responses split over multiple messages (#1395)
-      if (dupe().is_dupe(msg)) {
-        const auto msgid = FtnMessageDupe::GetMessageIDFromText(msg.vh.text);
-        LOG(ERROR) << "Skipping duplicate FTN message: '" << msg.vh.subject << "' msgid: (" << msgid
-                   << ")";
-        LOG(ERROR) << "Text: " << msg.vh.text;
+      if (dupe().is_dupe(m.header_crc32, m.msgid_crc32)) {
+        LOG(ERROR) << "Skipping duplicate FTN message: '" << msg.vh.subject << "' msgid: ("
+                   << m.msgid << ")";
+        LOG(ERROR) << "Text: " << m.text;
         // TODO(rushfan): move this or write out saved copy?
         continue;
       }
-      dupe().add(msg);
+      dupe().add(m.header_crc32, m.msgid_crc32);
     }
 
     net_header_rec nh{};
@@ -181,7 +205,7 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
     nh.fromsys = FTN_FAKE_OUTBOUND_NODE;
     nh.fromuser = 0;
     nh.list_len = 0;
-    if (is_email) {
+    if (m.is_email) {
       nh.main_type = main_type_email_name;
     } else {
       nh.main_type = main_type_new_post;
@@ -192,22 +216,21 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
     nh.tosys = 1; // always 1 in new fido
     nh.touser = 0;
 
-    auto from_address = get_address_from_packet(msg, packet.header());
-
     std::string s1;
     // Email Format: TO_USER<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
     // Non-Email Sub Format: SUBTYPE<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
-    std::string text = (is_email) ? msg.vh.to_user_name : get_echomail_areaname(msg.vh.text);
+    std::string text = m.to;
     // Adding a 0 is adding a NULL character to the string
     text.push_back(0);
     text.append(msg.vh.subject);
     text.push_back(0);
-    text.append(StrCat(msg.vh.from_user_name, "(", from_address, ")\r\n"));
+    text.append(StrCat(msg.vh.from_user_name, "(", m.from_address, ")\r\n"));
+    // fido_to_daten uses localtime, so this stays on the writer thread.
     auto dt = fido_to_daten(msg.vh.date_time);
     text.append(daten_to_wwivnet_time(dt));
     text.append("\r\n");
 
-    if (!is_email) {
+    if (!m.is_email) {
       // Add ^D0FidoAddr for the "To:" name of the post.
       static const char kFidoAddr[] = "\x04"
                                       "0FidoAddr: ";
@@ -215,7 +238,7 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
       // If for some screwy reason we don't have a to name, address it to 'All'.
       text.append(kFidoAddr).append(to_name).append("\r\n");
     }
-    text.append(FidoToWWIVText(msg.vh.text));
+    text.append(m.text);
 
     nh.length = size_uint32(text);
     // Create file, write to local.net_ for network2 to import.
@@ -224,7 +247,7 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
       LOG(ERROR) << "ERROR Writing WWIV packet for message: " << wwiv_packet.nh.main_type << "/"
                  << wwiv_packet.nh.minor_type;
     } else {
-      std::string itype = is_email ? "Email" : "Post";
+      std::string itype = m.is_email ? "Email" : "Post";
       LOG(INFO) << fmt::format("Imported FTN {} '{}' to '{}'", itype, msg.vh.subject, s1);
     }
   }
@@ -232,104 +255,278 @@ bool NetworkF::import_packet_file(const std::filesystem::path& path) {
   return true;
 }
 
-bool NetworkF::import_packets(const std::string& dir, const std::string& mask) {
-  VLOG(1) << "Importing packets from: " << dir << "' mask: '" << mask << "'";
-  FindFiles files(FilePath(dir, mask), FindFiles::FindFilesType::files);
-  if (files.empty()) {
-    LOG(INFO) << "No packets to import in: '" << dir << "' mask: '" << mask << "'";
-  }
-  for (const auto& f : files) {
-    if (import_packet_file(FilePath(dir, f.name))) {
-      LOG(INFO) << "Successfully imported packet: " << FilePath(dir, f.name);
-      if (opts_.skip_delete) {
-        backup_file(FilePath(net_.dir, f.name));
-      }
-      File::Remove(FilePath(dir, f.name));
-    }
-  }
-  return true;
+/**
+ * Returns cmd wrapped so that it runs from dir.  We can't change the current
+ * directory since more than one bundle is unpacked at once.
+ */
+static std::string in_directory(const std::filesystem::path& dir, const std::string& cmd) {
+#ifdef _WIN32
+  return fmt::format("cd /d \"{}\" && {}", dir.string(), cmd);
+#else
+  return fmt::format("cd \"{}\" && {}", dir.string(), cmd);
+#endif
 }
 
-bool NetworkF::import_bundle_file(const std::filesystem::path& path) {
-  VLOG(1) << "import_bundle_file: path: " << path.string();
+ftn_bundle_t NetworkF::unpack_bundle_file(const std::filesystem::path& path,
+                                          const std::filesystem::path& unpack_dir) const {
+  VLOG(1) << "unpack_bundle_file: path: " << path.string();
+  ftn_bundle_t result;
+  result.path = path;
+
+  if (ends_with(ToStringLowerCase(path.filename().string()), ".pkt")) {
+    result.is_packet = true;
+    result.ok = true;
+    result.packets.push_back(path);
+    return result;
+  }
 
   {
     // Check to make sure the file is readable.
     File f(path);
     if (!f.Open(File::modeBinary | File::modeReadOnly)) {
       LOG(INFO) << "Unable to open file: " << path.string();
-      return false;
+      return result;
     }
   }
 
-  const auto saved_dir = File::current_directory();
-  ScopeExit at_exit([=] { File::set_current_directory(saved_dir); });
-  File::set_current_directory(dirs_.temp_inbound_dir());
-
-  // were in the temp dir now.
   const auto arcs = files::read_arcs(datadir_);
   if (arcs.empty()) {
     LOG(ERROR) << "No archivers defined!";
-    return false;
+    return result;
   }
 
   const auto arc = files::find_arcrec(arcs, path, "ZIP");
   if (!arc) {
     LOG(ERROR) << "Unable to find archiver for file: " << path;
-    return false;
+    return result;
+  }
+  if (!File::mkdirs(unpack_dir)) {
+    LOG(ERROR) << "Unable to create directory: " << unpack_dir;
+    return result;
   }
+  result.unpack_dir = unpack_dir;
   // We have no parameter 2 since we're extracting everything.
-  const auto unzip_cmd = arc_stuff_in(arc.value().arce, path.string(), "");
+  const auto unzip_cmd =
+      in_directory(unpack_dir, arc_stuff_in(arc.value().arce, path.string(), ""));
   // Execute the command
   LOG(INFO) << "Command: " << unzip_cmd;
   if (system(unzip_cmd.c_str()) != 0) {
     LOG(ERROR) << "Failed executing: " << unzip_cmd;
+    return result;
+  }
+
+  FindFiles files(FilePath(unpack_dir, "*.pkt"), FindFiles::FindFilesType::files);
+  if (files.empty()) {
+    LOG(INFO) << "No packets to import in: '" << unpack_dir << "'";
+  }
+  for (const auto& f : files) {
+    result.packets.emplace_back(FilePath(unpack_dir, f.name));
+  }
+  result.ok = true;
+  return result;
+}
+
+/** Returns a path in dir for a file named name, adding -N to the name if it is taken. */
+static std::filesystem::path unused_path(const std::string& dir, const std::string& name) {
+  auto path = FilePath(dir, name);
+  const auto stem = path.stem().string();
+  const auto ext = path.extension().string();
+  for (auto i = 1; File::Exists(path); i++) {
+    path = FilePath(dir, fmt::format("{}-{}{}", stem, i, ext));
+  }
+  return path;
+}
+
+bool NetworkF::finish_bundle(const ftn_bundle_t& bundle,
+                             const std::vector<std::filesystem::path>& failed) {
+  if (!bundle.ok || (bundle.is_packet && !failed.empty())) {
     return false;
   }
-  // Need to be back home.
-  File::set_current_directory(saved_dir);
+  if (!bundle.is_packet) {
+    auto all_moved = true;
+    for (const auto& p : failed) {
+      if (!File::Exists(p)) {
+        // Already moved somewhere else, like the bad packets directory.
+        continue;
+      }
+      const auto to = unused_path(dirs_.temp_inbound_dir(), p.filename().string());
+      if (!File::Move(p, to)) {
+        LOG(ERROR) << "Unable to move packet: " << p << " to: " << to;
+        all_moved = false;
+        continue;
+      }
+      LOG(INFO) << "Will retry importing packet: " << to;
+    }
+    if (!all_moved) {
+      LOG(ERROR) << "Keeping bundle: " << bundle.path << " since packets are left in: "
+                 << bundle.unpack_dir;
+      return false;
+    }
+    if (!bundle.unpack_dir.empty()) {
+      // Anything besides packets that came in the bundle is left behind.
+      std::error_code ec;
+      std::filesystem::remove(bundle.unpack_dir, ec);
+    }
+  }
 
-  import_packets(dirs_.temp_inbound_dir(), "*.pkt");
+  LOG(INFO) << "Successfully imported " << (bundle.is_packet ? "packet: " : "bundle: ")
+            << bundle.path;
+  if (opts_.skip_delete) {
+    backup_file(bundle.path);
+  }
+  File::Remove(bundle.path);
   return true;
 }
 
-/**
- * Imports FTN Bundles (files like XXXXXXXXX.SU0)
- *
- * Returns the # of bundles processed.
- */
-int NetworkF::import_bundles(const std::string& dir, const std::string& mask) {
-  auto num_bundles_processed = 0;
+std::vector<std::filesystem::path> NetworkF::find_bundles() const {
+  std::vector<std::filesystem::path> paths;
+  std::set<std::filesystem::path> seen;
+  auto add = [&](const std::string& dir, const std::string& mask) {
+    VLOG(3) << "find_bundles: mask: " << mask;
+    FindFiles files(FilePath(dir, mask), FindFiles::FindFilesType::files);
+    for (const auto& f : files) {
+      if (f.size == 0) {
+        // skip zero byte files.
+        LOG(INFO) << "Skipping zero byte bundle or packet: " << f.name;
+        continue;
+      }
+      if (auto path = FilePath(dir, f.name); seen.insert(path).second) {
+        paths.emplace_back(std::move(path));
+      }
+    }
+  };
 
-  VLOG(3) << "import_bundles: mask: " << mask;
-  FindFiles files(FilePath(dir, mask), FindFiles::FindFilesType::files);
-  for (const auto& f : files) {
-    if (f.size == 0) {
-      // skip zero byte files.
-      LOG(INFO) << "Skipping zero byte bundle or packet: " << f.name;
-      continue;
+  // Packets that failed to import from an earlier run.
+  add(dirs_.temp_inbound_dir(), "*.pkt");
+  const std::vector<std::string> extensions{"su?", "mo?", "tu?", "we?", "th?", "fr?", "sa?", "pkt"};
+  for (const auto& ext : extensions) {
+    add(dirs_.inbound_dir(), StrCat("*.", ext));
+#ifndef _WIN32
+    add(dirs_.inbound_dir(), StrCat("*.", ToStringUpperCase(ext)));
+#endif
+  }
+  return paths;
+}
+
+namespace {
+/** A bundle being handed from a reader thread to the writer. */
+struct bundle_slot_t {
+  std::optional<ftn_bundle_t> bundle;
+  // The next parsed packet of the bundle, waiting for the writer.
+  std::optional<ftn_packet_t> packet;
+};
+} // namespace
+
+int NetworkF::import_bundles(const std::vector<std::filesystem::path>& paths) {
+  if (paths.empty()) {
+    return 0;
+  }
+  const auto num_jobs = std::max<std::size_t>(1, std::min<std::size_t>(opts_.jobs, paths.size()));
+  // Don't let the readers get too far ahead of the writer, since every bundle
+  // they have started is unpacked on disk until it is written.
+  const auto max_ahead = num_jobs * 2;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  // GUARDED_BY(mu)
+  std::vector<bundle_slot_t> slots(paths.size());
+  // GUARDED_BY(mu)
+  std::size_t next = 0;
+  // GUARDED_BY(mu)
+  std::size_t written = 0;
+
+  auto reader = [&] {
+    while (true) {
+      std::size_t i;
+      {
+        std::unique_lock lock(mu);
+        cv.wait(lock, [&] { return next >= paths.size() || next < written + max_ahead; });
+        if (next >= paths.size()) {
+          return;
+        }
+        i = next++;
+      }
+      const auto& path = paths[i];
+      LOG(INFO) << "Attempting to import packet: " << path;
+      ftn_bundle_t b;
+      b.path = path;
+      try {
+        const auto dir = fmt::format("{}-{}", path.filename().string(), i);
+        b = unpack_bundle_file(path, FilePath(dirs_.temp_inbound_dir(), dir));
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Error reading bundle: " << path << "; " << e.what();
+      }
+      {
+        std::lock_guard lock(mu);
+        slots[i].bundle = b;
+        cv.notify_all();
+      }
+      for (const auto& packet_path : b.packets) {
+        ftn_packet_t p;
+        p.path = packet_path;
+        try {
+          p = read_packet_file(packet_path);
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "Error reading packet: " << packet_path << "; " << e.what();
+        }
+        // Only one parsed packet per bundle waits for the writer, so memory
+        // use doesn't grow with the size of the bundle.
+        std::unique_lock lock(mu);
+        cv.wait(lock, [&] { return !slots[i].packet.has_value(); });
+        slots[i].packet = std::move(p);
+        cv.notify_all();
+      }
+    }
+  };
+
+  std::vector<std::thread> readers;
+  for (std::size_t i = 0; i < num_jobs; i++) {
+    readers.emplace_back(reader);
+  }
+
+  auto num_bundles_processed = 0;
+  for (std::size_t i = 0; i < paths.size(); i++) {
+    ftn_bundle_t bundle;
+    {
+      std::unique_lock lock(mu);
+      cv.wait(lock, [&] { return slots[i].bundle.has_value(); });
+      bundle = std::move(slots[i].bundle.value());
     }
-    const auto lname = ToStringLowerCase(f.name);
-    const auto path = FilePath(dir, f.name);
-    LOG(INFO) << "Attempting to import packet: " << path;
-    if (ends_with(lname, ".pkt")) {
-      if (import_packet_file(path)) {
-        LOG(INFO) << "Successfully imported packet: " << path;
-        ++num_bundles_processed;
+    std::vector<std::filesystem::path> failed;
+    for (std::size_t j = 0; j < bundle.packets.size(); j++) {
+      ftn_packet_t p;
+      {
+        std::unique_lock lock(mu);
+        cv.wait(lock, [&] { return slots[i].packet.has_value(); });
+        p = std::move(slots[i].packet.value());
+        slots[i].packet.reset();
+        cv.notify_all();
+      }
+      if (!write_packet(p)) {
+        failed.push_back(p.path);
+        continue;
+      }
+      if (!bundle.is_packet) {
+        LOG(INFO) << "Successfully imported packet: " << p.path;
         if (opts_.skip_delete) {
-          backup_file(path);
+          backup_file(p.path);
         }
-        File::Remove(path);
+        File::Remove(p.path);
       }
-    } else if (import_bundle_file(path)) {
-      LOG(INFO) << "Successfully imported bundle: " << path;
+    }
+    {
+      std::lock_guard lock(mu);
+      ++written;
+      cv.notify_all();
+    }
+    if (finish_bundle(bundle, failed)) {
       ++num_bundles_processed;
-      if (opts_.skip_delete) {
-        backup_file(path);
-      }
-      File::Remove(path);
     }
   }
+
+  for (auto& t : readers) {
+    t.join();
+  }
   return num_bundles_processed;
 }
 
@@ -919,17 +1116,7 @@ sdk::FtnMessageDupe& NetworkF::dupe() {
 }
 
 bool NetworkF::DoImport() {
-  auto num_packets_processed = 0;
-  std::unique_ptr<FtnMessageDupe> dupe;
-  const std::vector<std::string> extensions{"su?", "mo?", "tu?", "we?", "th?", "fr?", "sa?", "pkt"};
-  for (const auto& ext : extensions) {
-    num_packets_processed += import_bundles(dirs_.inbound_dir(), StrCat("*.", ext));
-#ifndef _WIN32
-    num_packets_processed +=
-        import_bundles(dirs_.inbound_dir(), StrCat("*.", ToStringUpperCase(ext)));
-#endif
-  }
-  return num_packets_processed > 0;
+  return import_bundles(find_bundles()) > 0;
 }
 
 bool NetworkF::DoExport() {
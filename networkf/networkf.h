@@ -24,10 +24,14 @@
 #include "sdk/bbslist.h"
 #include "sdk/fido/fido_callout.h"
 #include "sdk/fido/fido_directories.h"
+#include "sdk/fido/fido_packets.h"
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
+#include <cstdint>
+#include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace wwiv::net::networkf {
 
@@ -36,13 +40,48 @@ struct networkf_options_t {
   bool skip_delete{false};
   char net_cmd{'f'};
   std::string system_name;
+  // Number of bundles to unpack and parse at once.
+  int jobs{1};
+};
+
+/** A FTN message read from a packet, waiting to be written as a WWIVnet packet. */
+struct ftn_message_t {
+  // The message header, the text is only kept in text below.
+  sdk::fido::FidoPackedMessage msg;
+  bool is_email{false};
+  // Dupe checking values, only set for posts.
+  std::string msgid;
+  uint32_t header_crc32{0};
+  uint32_t msgid_crc32{0};
+  std::string from_address;
+  // To user for email, echomail area name for posts.
+  std::string to;
+  // Message text converted to WWIV format.
+  std::string text;
+};
+
+/** The messages read from a single FTN packet. */
+struct ftn_packet_t {
+  std::filesystem::path path;
+  bool ok{false};
+  std::vector<ftn_message_t> messages;
+};
+
+/** A FTN bundle (or bare packet) after it has been unpacked. */
+struct ftn_bundle_t {
+  std::filesystem::path path;
+  bool ok{false};
+  bool is_packet{false};
+  // Directory this bundle was unpacked into, empty for bare packets.
+  std::filesystem::path unpack_dir;
+  // Packets to import, these are read one at a time.
+  std::vector<std::filesystem::path> packets;
 };
 
 class NetworkF final {
 public:
-  NetworkF(const sdk::BbsDirectories& bbsdirs,
-           const networkf_options_t& opts, const sdk::net::Network, const sdk::BbsListNet& bbslist,
-           core::Clock& clock);
+  NetworkF(const sdk::BbsDirectories& bbsdirs, const networkf_options_t& opts,
+           const sdk::net::Network& net, const sdk::BbsListNet& bbslist, core::Clock& clock);
   ~NetworkF();
 
   /** Runs networkf import */
@@ -55,14 +94,40 @@ public:
   bool Run(std::vector<std::string> cmds);
 
 private:
-  bool import_packet_file(const std::filesystem::path& path);
+  /**
+   * Reads all messages from the FTN packet at path.  This is safe to call
+   * from multiple threads at once since it does not touch the dupe list
+   * or any WWIVnet packets.
+   */
+  ftn_packet_t read_packet_file(const std::filesystem::path& path) const;
 
-  bool import_packets(const std::string& dir, const std::string& mask);
+  /**
+   * Writes the messages from packet to local.net, skipping dupes. Only
+   * called from the single writer so that dupe checks happen in order.
+   */
+  bool write_packet(const ftn_packet_t& packet);
+
+  /** Unpacks the bundle at path into unpack_dir and lists the packets in it. */
+  ftn_bundle_t unpack_bundle_file(const std::filesystem::path& path,
+                                  const std::filesystem::path& unpack_dir) const;
+
+  /**
+   * Removes bundle once its packets have been written.  Packets in failed
+   * are moved back to the temp inbound directory to be retried next time.
+   */
+  bool finish_bundle(const ftn_bundle_t& bundle, const std::vector<std::filesystem::path>& failed);
 
-  bool import_bundle_file(const std::filesystem::path& path);
+  /** Returns the FTN bundles and packets waiting in the inbound directory. */
+  std::vector<std::filesystem::path> find_bundles() const;
 
-  /** imports FTN bundles, returning the number of packets processed */
-  int import_bundles(const std::string& dir, const std::string& mask);
+  /**
+   * Imports FTN bundles, returning the number of bundles processed.
+   *
+   * Bundles are unpacked and their packets parsed on up to opts_.jobs
+   * threads, and written by a single writer in the same order as paths.
+   * Each thread hands over one parsed packet at a time.
+   */
+  int import_bundles(const std::vector<std::filesystem::path>& paths);
 
   /**
    * Creates a FTN bundle using the appropriate archiver for the route_to system,
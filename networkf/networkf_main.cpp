@@ -44,6 +44,7 @@
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
 #include "sdk/net/subscribers.h"
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -51,6 +52,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef _WIN32
@@ -80,6 +82,8 @@ int main(int argc, char** argv) {
   Logger::Init(argc, argv, config);
 
   CommandLine cmdline(argc, argv, "net");
+  cmdline.add_argument(
+      {"jobs", "Number of bundles to unpack and parse at once (0 for one per CPU)", "0"});
   const NetworkCommandLine net_cmdline(cmdline, 'f');
   try {
     ScopeExit at_exit(Logger::ExitLogger);
@@ -115,6 +119,10 @@ int main(int argc, char** argv) {
 
     networkf_options_t opts{net_cmdline.config().max_backups(), net_cmdline.skip_delete()};
     opts.system_name = net_cmdline.config().system_name();
+    opts.jobs = net_cmdline.cmdline().iarg("jobs");
+    if (opts.jobs <= 0) {
+      opts.jobs = std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
     NetworkF nf(net_cmdline.config(), opts, net, bbslist, clock);
     return nf.Run(net_cmdline.cmdline().remaining()) ? 0 : 2;
   } catch (const semaphore_not_acquired& e) {
@@ -15,23 +15,177 @@
 /*    either  express  or implied.  See  the  License for  the specific   */
 /*    language governing permissions and limitations under the License.   */
 /**************************************************************************/
-#include "gtest/gtest.h"
+#include "networkf/networkf.h"
+
+#include "core/datetime.h"
+#include "core/fake_clock.h"
+#include "core/file.h"
 #include "core/strings.h"
 #include "core/test/file_helper.h"
+#include "core/test/wwivtest.h"
+#include "sdk/bbs_directories.h"
+#include "sdk/bbslist.h"
+#include "sdk/filenames.h"
+#include "sdk/vardec.h"
 #include "sdk/fido/test/ftn_directories_test_helper.h"
+#include "sdk/net/packets.h"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
 
+using namespace wwiv::core;
+using namespace wwiv::net::networkf;
+using namespace wwiv::sdk;
 using namespace wwiv::strings;
 using namespace wwiv::sdk::fido::test;
+using testing::ElementsAre;
 
-class NetworkFTest : public testing::Test {
+#ifndef _WIN32
+
+class TestBbsDirectories final : public BbsDirectories {
 public:
-  NetworkFTest() {}
+  explicit TestBbsDirectories(const std::filesystem::path& root) : root_(root.string()) {}
+  [[nodiscard]] std::string root_directory() const override { return root_; }
+  [[nodiscard]] std::string datadir() const override { return dir("data"); }
+  [[nodiscard]] std::string msgsdir() const override { return dir("msgs"); }
+  [[nodiscard]] std::string gfilesdir() const override { return dir("gfiles"); }
+  [[nodiscard]] std::string menudir() const override { return dir("menus"); }
+  [[nodiscard]] std::string dloadsdir() const override { return dir("dloads"); }
+  [[nodiscard]] std::string scriptdir() const override { return dir("scripts"); }
+  [[nodiscard]] std::string logdir() const override { return dir("logs"); }
+  [[nodiscard]] std::filesystem::path scratch_dir(int) const override { return dir("scratch"); }
+
+private:
+  [[nodiscard]] std::string dir(const std::string& name) const {
+    return FilePath(root_, name).string();
+  }
+  const std::string root_;
+};
+
+class NetworkFTest : public wwiv::core::test::TestDataTest {
+public:
+  NetworkFTest()
+      : dirs_(helper_.TempDir()), net_(CreateTestNetwork(helper_.Dir("network"))),
+        clock_(DateTime::now()) {
+    for (const auto& d : {"data", "gfiles", "logs", "msgs", "src"}) {
+      File::mkdirs(FilePath(helper_.TempDir(), d));
+    }
+    File::mkdirs(in_dir());
+    File::mkdirs(temp_in_dir());
+    // Bundles in the tests are tar files.
+    arcrec arc{};
+    to_char_array(arc.name, "tar");
+    to_char_array(arc.extension, "ZIP");
+    to_char_array(arc.arce, "tar xf %1");
+    File f(FilePath(dirs_.datadir(), ARCHIVER_DAT));
+    CHECK(f.Open(File::modeBinary | File::modeCreateFile | File::modeWriteOnly));
+    f.Write(&arc, sizeof(arc));
+  }
 
 protected:
+  std::filesystem::path in_dir() const { return FilePath(net_.dir, "in"); }
+  std::filesystem::path temp_in_dir() const { return FilePath(net_.dir, "tempin"); }
+
+  /** Writes a copy of a test packet without its packet password to path. */
+  void WritePacket(const std::filesystem::path& path, const std::string& testdata_name) {
+    File in(FilePath(helper_.TestData(), StrCat("fido/", testdata_name)));
+    ASSERT_TRUE(in.Open(File::modeBinary | File::modeReadOnly));
+    std::string data(in.length(), '\0');
+    ASSERT_EQ(in.length(), in.Read(data.data(), in.length()));
+    // Clear the 8 byte password in the type 2+ header.
+    std::fill_n(data.begin() + 26, 8, '\0');
+    File out(path);
+    ASSERT_TRUE(out.Open(File::modeBinary | File::modeCreateFile | File::modeWriteOnly));
+    out.Write(data.data(), data.size());
+  }
+
+  /** Creates a bundle in the inbound directory holding files from dir. */
+  void CreateBundle(const std::string& name, const std::filesystem::path& dir,
+                    const std::vector<std::string>& files) {
+    auto cmd = fmt::format("tar cf \"{}\" -C \"{}\"", FilePath(in_dir(), name).string(),
+                           dir.string());
+    for (const auto& f : files) {
+      cmd += " " + f;
+    }
+    ASSERT_EQ(0, system(cmd.c_str()));
+  }
+
+  bool Import(int jobs) {
+    networkf_options_t opts{};
+    opts.jobs = jobs;
+    const BbsListNet bbslist({});
+    NetworkF networkf(dirs_, opts, net_, bbslist, clock_);
+    return networkf.DoImport();
+  }
+
+  /** Returns the subjects of the messages written to local.net. */
+  std::vector<std::string> Imported() {
+    std::vector<std::string> result;
+    net::NetMailFile file(FilePath(net_.dir, LOCAL_NET), false);
+    for (const auto& p : file) {
+      const auto& text = p.text();
+      const auto start = text.find('\0') + 1;
+      result.emplace_back(text.substr(start, text.find('\0', start) - start));
+    }
+    return result;
+  }
+
   wwiv::core::test::FileHelper helper_;
+  TestBbsDirectories dirs_;
+  net::Network net_;
+  FakeClock clock_;
 };
 
-TEST_F(NetworkFTest, Smoke) { 
-  FAIL() << "Implemente me!";
+TEST_F(NetworkFTest, Import_InOrder) {
+  const auto src = FilePath(helper_.TempDir(), "src");
+  WritePacket(FilePath(src, "a.pkt"), "0e7c5b69.pkt");
+  WritePacket(FilePath(src, "b.pkt"), "0d73f767.pkt");
+  CreateBundle("00000001.mo0", src, {"a.pkt"});
+  CreateBundle("00000002.tu0", src, {"b.pkt"});
+
+  ASSERT_TRUE(Import(2));
+  EXPECT_THAT(Imported(), ElementsAre("test5", "test 6", "test 7", "test 4"));
+  EXPECT_FALSE(File::Exists(FilePath(in_dir(), "00000001.mo0")));
+  EXPECT_FALSE(File::Exists(FilePath(in_dir(), "00000002.tu0")));
+  EXPECT_TRUE(std::filesystem::is_empty(temp_in_dir()));
+}
+
+TEST_F(NetworkFTest, Import_FailedPacketIsRetried) {
+  const auto src = FilePath(helper_.TempDir(), "src");
+  WritePacket(FilePath(src, "a.pkt"), "0e7c5b69.pkt");
+  // Too short to have a packet header.
+  helper_.CreateTempFile("src/c.pkt", "not a pkt");
+  CreateBundle("00000001.mo0", src, {"a.pkt", "c.pkt"});
+
+  ASSERT_TRUE(Import(1));
+  EXPECT_THAT(Imported(), ElementsAre("test5", "test 6", "test 7"));
+  // The bundle is gone, but the packet that failed was kept to try again.
+  EXPECT_FALSE(File::Exists(FilePath(in_dir(), "00000001.mo0")));
+  EXPECT_FALSE(File::Exists(FilePath(temp_in_dir(), "00000001.mo0-0")));
+  ASSERT_TRUE(File::Exists(FilePath(temp_in_dir(), "c.pkt")));
+
+  // Once the packet is readable the next import picks it up.
+  WritePacket(FilePath(temp_in_dir(), "c.pkt"), "0d73f767.pkt");
+  ASSERT_TRUE(Import(1));
+  EXPECT_THAT(Imported(), ElementsAre("test5", "test 6", "test 7", "test 4"));
+  EXPECT_TRUE(std::filesystem::is_empty(temp_in_dir()));
+}
+
+TEST_F(NetworkFTest, Import_FailedPacketNameInUse) {
+  const auto src = FilePath(helper_.TempDir(), "src");
+  helper_.CreateTempFile("src/c.pkt", "not a pkt");
+  CreateBundle("00000001.mo0", src, {"c.pkt"});
+  CreateBundle("00000002.tu0", src, {"c.pkt"});
+
+  Import(1);
+  // Both bundles are gone, and the second failed packet got a new name
+  // rather than replacing the first.
+  EXPECT_FALSE(File::Exists(FilePath(in_dir(), "00000001.mo0")));
+  EXPECT_FALSE(File::Exists(FilePath(in_dir(), "00000002.tu0")));
+  EXPECT_TRUE(File::Exists(FilePath(temp_in_dir(), "c.pkt")));
+  EXPECT_TRUE(File::Exists(FilePath(temp_in_dir(), "c-1.pkt")));
 }
 
+#endif  // _WIN32
@@ -36,10 +36,13 @@
 #include "sdk/files/files.h"
 #include "sdk/files/tic.h"
 #include "sdk/net/packets.h"
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::net;
@@ -56,7 +59,8 @@ static void ShowHelp(const NetworkCommandLine& cmdline) {
   exit(1);
 }
 
-bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_files, bool skip_delete) {
+bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_files,
+                     bool skip_delete, int jobs) {
   if (!net.fido.process_tic) {
     LOG(WARNING) << "TIC processing disabled for network: " << net.name;
     return false;
@@ -69,94 +73,61 @@ bool process_ftn_tic(const Config& config, const Network& net, bool save_tic_fil
   }
   files::FileApi api(config.datadir());
 
+  // Parse and validate every pending TIC up front, then apply them one file
+  // area at a time so that each area is only loaded and saved once.
   FindFiles ff(FilePath(ftn_directories.tic_dir(), "*.tic"), FindFiles::FindFilesType::files);
-  auto first = true;
-  const files::TicParser parser(ftn_directories.tic_dir());
+  std::vector<std::string> tic_filenames;
   for (const auto& f : ff) {
-    auto ot = parser.parse(f.name);
-    if (!ot) {
-      continue;
-    }
-    auto t = ot.value();
-    if (!t.IsValid()) {
-      continue;
-    }
-    auto od = FindFileAreaForTic(dirs, t, net);
-    if (!od) {
-      LOG(ERROR) << "Unable to find AREA_TAG for tic file: TAG: " << t.area << "; file; " << f.name;
-      continue;
-    }
-    auto d = od.value();
+    tic_filenames.push_back(f.name);
+  }
+  const files::TicParser parser(ftn_directories.tic_dir());
+  const auto tics = files::ParseTics(parser, tic_filenames, jobs);
+  const auto areas = files::GroupTicsByArea(tics, dirs, net);
+
+  for (const auto& [dir_num, area_tics] : areas) {
+    const auto& d = dirs.dir(dir_num);
     auto fa = api.CreateOrOpen(d);
     if (!fa) {
       LOG(ERROR) << "Unable to open file area: " << d.filename;
       continue;
     }
-    if (first) {
-      LOG(INFO) << "------------------------------------------------------------------------------";
-      first = false;
-    }
-    files::FileName fn(t.file);
-    auto op = fa->FindFile(fn);
-    files::FileRecord r;
-    r.set_filename(fn);
-    r.set_description(t.desc);
-    r.set_extended_description(!t.ldesc.empty());
-    r.set_numbytes(t.size());
-    r.set_date(t.date());
-    r.set_uploaded_by("WWIV Tic Processor");
-    const auto actual_t = File::last_write_time(FilePath(ftn_directories.tic_dir(), r));
-    r.set_actual_date(DateTime::from_time_t(actual_t));
-    const auto ext_desc = JoinStrings(t.ldesc, "\r\n");
-
-    if (!net.fido.process_tic) {
-      LOG(INFO) << "Skipping processing file. process_tic is not enabled. file: " << t.file;
+    LOG(INFO) << "------------------------------------------------------------------------------";
+    const auto result = files::ImportTics(*fa, area_tics);
+    if (!result) {
+      LOG(ERROR) << "Error saving file area: " << d.filename;
       continue;
     }
+    LOG(INFO) << "Added " << result->added << " and updated " << result->updated
+              << " files in: " << d.filename;
 
-    if (op.has_value()) {
-      LOG(INFO) << "File already exists in file area";
-      LOG(INFO) << "** Updating: "  << r;
-      if (!fa->UpdateFile(r, op.value(), ext_desc)) {
-        LOG(ERROR) << "Failed to update File: " << fn;
-        continue;
-      }
-    } else {
-      LOG(INFO) << "** Adding  :" << r;
-      if (!fa->AddFile(r, ext_desc)) {
-        LOG(ERROR) << "Error adding file: " << r;
-        continue;
-      }
-      if (!fa->Save()) {
-        LOG(ERROR) << "Error saving file area: " << d.filename;
-        continue;
+    for (const auto& pt : area_tics) {
+      const auto& t = pt.tic;
+      const auto r = files::ToFileRecord(t);
+      // Display information about the file;
+      LOG(INFO) << "Area Name  : " << t.area;
+      LOG(INFO) << "Area Desc  : " << t.area_description;
+      LOG(INFO) << "File Name  : " << r;
+      LOG(INFO) << "Description: " << t.desc;
+      LOG(INFO) << "Ext Desc   : ";
+      for (const auto& l : t.ldesc) {
+        LOG(INFO) << "    " << l;
       }
-    }
-    // Display information about the file;
-    LOG(INFO) << "Area Name  : " << t.area;
-    LOG(INFO) << "Area Desc  : " << t.area_description;
-    LOG(INFO) << "File Name  : " << r;
-    LOG(INFO) << "Description: " << t.desc;
-    LOG(INFO) << "Ext Desc   : ";
-    const auto v = SplitString(ext_desc, "\r\n", true);
-    for (const auto& l : v) {
-      LOG(INFO) << "    " << l;
-    }
-    LOG(INFO) << "------------------------------------------------------------------------------";
-    // Use t.file not r here since r will be the unaligned and lower-case filename,
-    // and we have to match the exact case specified. So use t.file.
-    const auto src = FilePath(ftn_directories.tic_dir(), t.file);
-    // f.name is the name of the TIC file
-    const auto tic = FilePath(ftn_directories.tic_dir(), f.name);
-    const auto dest = FilePath(d.path, r);
-    if (save_tic_files) {
-      LOG(INFO) << "Not moving file, just copy, --save_tic_files == true";
-      File::Copy(src, dest);
-    } else {
-      LOG(INFO) << "Moving file to: " << dest.string();
-      File::Move(src, dest);
-      if (!skip_delete) {
-        File::Remove(tic);
+      LOG(INFO) << "------------------------------------------------------------------------------";
+      // Use t.file not r here since r will be the unaligned and lower-case filename,
+      // and we have to match the exact case specified. So use t.file.
+      const auto src = FilePath(ftn_directories.tic_dir(), t.file);
+      // pt.tic_filename is the name of the TIC file
+      const auto tic = FilePath(ftn_directories.tic_dir(), pt.tic_filename);
+      const auto dest = FilePath(d.path, r);
+      if (save_tic_files) {
+        LOG(INFO) << "Not moving file, just copy, --save_tic_files == true";
+        File::Copy(src, dest);
+      } else {
+        LOG(INFO) << "Moving file to: " << dest.string();
+        File::Move(src, dest);
+        if (!skip_delete) {
+          File::Remove(tic);
+        }
       }
     }
   }
@@ -174,7 +145,11 @@ int networkt_main(const NetworkCommandLine& net_cmdline) {
     case network_type_t::ftn: {
       const auto save_tic_files = net_cmdline.cmdline().barg("save_tic_files");
       const auto skip_delete = net_cmdline.skip_delete();
-      if (!process_ftn_tic(net_cmdline.config(), net, save_tic_files, skip_delete)) {
+      auto jobs = net_cmdline.cmdline().iarg("jobs");
+      if (jobs <= 0) {
+        jobs = std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+      }
+      if (!process_ftn_tic(net_cmdline.config(), net, save_tic_files, skip_delete, jobs)) {
         return 1;
       }
     } break;
@@ -208,6 +183,7 @@ int main(int argc, char** argv) {
   cmdline.add_argument({"process_instance", "Also process pending files for BBS instance #", "0"});
   cmdline.add_argument(BooleanCommandLineArgument{
       "save_tic_files", 'S', "Save TIC files, do not delete TIC and archives", false});
+  cmdline.add_argument({"jobs", "Number of files to validate at once (0 for one per CPU)", "0"});
 
   const NetworkCommandLine net_cmdline(cmdline, 't');
   if (!net_cmdline.IsInitialized() || net_cmdline.cmdline().help_requested()) {
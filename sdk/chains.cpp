@@ -101,6 +101,7 @@ bool Chains::Load() {
 bool Chains::LoadFromJSON() {
   chains_.clear();
   JsonFile json(FilePath(datadir_, CHAINS_JSON), "chains", chains_, 1);
+  json.set_use_snapshot(true);
   return json.Load();
 }
 
@@ -170,6 +171,7 @@ bool Chains::Save() {
 
 bool Chains::SaveToJSON() {
   JsonFile json(FilePath(datadir_, CHAINS_JSON), "chains", chains_, 1);
+  json.set_use_snapshot(true);
   return json.Save();
 }
 
@@ -155,6 +155,7 @@ std::optional<conference_file_t> Conferences::Load() const {
   conference_file_t c{};
   const auto path = FilePath(datadir_, "conference.json");
   JsonFile f(path, "conf", c, 1);
+  f.set_use_snapshot(true);
   if (!f.Load()) {
     return std::nullopt;
   }
@@ -173,6 +174,7 @@ bool Conferences::Save() {
   t.dirs = dirs_conf().confs();
   const auto path = FilePath(datadir_, "conference.json");
   JsonFile f(path, "conf", t, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 
 }
@@ -85,6 +85,7 @@ Config& Config::operator=(Config&& o) {
 bool Config::Load() {
   {
     JsonFile f(FilePath(root_directory_, "config.json"), "config", config_, 1);
+    f.set_use_snapshot(true);
     if (!f.Load()) {
       return false;
     }
@@ -96,12 +97,14 @@ bool Config::Load() {
 
   {
     JsonFile f(FilePath(datadir_, "sl.json"), "sl", config_.sl, 1);
+    f.set_use_snapshot(true);
     if (!f.Load()) {
       return false;
     }
   }
   {
     JsonFile f(FilePath(datadir_, "autoval.json"), "autoval", config_.autoval, 1);
+    f.set_use_snapshot(true);
     if (!f.Load()) {
       return false;
     }
@@ -112,6 +115,7 @@ bool Config::Load() {
 
 bool Config::Save() {
   JsonFile f(FilePath(root_directory_, "config.json"), "config", config_, 1);
+  f.set_use_snapshot(true);
   if (readonly_) {
     LOG(ERROR) << "Tried to save a readonly config.json!";
     return false;
@@ -121,8 +125,10 @@ bool Config::Save() {
   }
 
   JsonFile sl_file(FilePath(datadir_, "sl.json"), "sl", config_.sl, 1);
+  sl_file.set_use_snapshot(true);
   sl_file.Save();
   JsonFile av_file(FilePath(datadir_, "autoval.json"), "autoval", config_.autoval, 1);
+  av_file.set_use_snapshot(true);
   av_file.Save();
   return true;
 }
@@ -25,6 +25,7 @@
 #include "sdk/fido/fido_util.h"
 #include "sdk/net/packets.h"
 #include <algorithm>
+#include <cstring>
 #include <optional>
 #include <string>
 
@@ -34,14 +35,6 @@ using namespace wwiv::sdk::net;
 
 namespace wwiv::sdk::fido {
 
-static char ReadCharFromFile(File& f) {
-  char buf[1];
-  if (const auto num_read = f.Read(buf, 1); num_read == 0) {
-    return 0;
-  }
-  return buf[0];
-}
-
 static std::string ReadRestOfFile(File& f, int max_size) {
   auto current = f.current_position();
   const auto size = f.length();
@@ -54,38 +47,6 @@ static std::string ReadRestOfFile(File& f, int max_size) {
   return s;
 }
 
-/**
- * Reads a field of length {len}.  Will trim the field to  remove
- * any trailing nulls.
- */
-static std::string ReadFixedLengthField(File& f, int len) {
-  std::string s;
-  s.resize(len + 1);
-  const auto num_read = f.Read(&s[0], len);
-  s.resize(num_read);
-  while (!s.empty() && s.back() == '\0') {
-    // Remove trailing null characters.
-    s.pop_back();
-  }
-  return s;
-}
-
-/**
- * Reads a null-terminated field of up to length {len} or the first null
- * character.
- */
-static std::string ReadVariableLengthField(File& f, int max_len) {
-  std::string s;
-  for (auto i = 0; i < max_len; i++) {
-    const auto ch = ReadCharFromFile(f);
-    if (ch == 0) {
-      return s;
-    }
-    s.push_back(ch);
-  }
-  return s;
-}
-
 FidoStoredMessage::~FidoStoredMessage()  = default;
 
 bool write_fido_packet_header(File& f, const packet_header_2p_t& header) {
@@ -130,12 +91,76 @@ bool write_stored_message(File& f, FidoStoredMessage& packet) {
   return f.Write(packet.text) == ssize(packet.text);
 }
 
+bool FidoPacketReadBuffer::Fill(File& f) {
+  if (buffer_.empty()) {
+    buffer_.resize(BUFFER_SIZE);
+  }
+  pos_ = 0;
+  end_ = static_cast<int>(f.Read(buffer_.data(), BUFFER_SIZE));
+  return end_ > 0;
+}
+
+int FidoPacketReadBuffer::ReadBytes(File& f, void* buf, int size) {
+  auto* out = static_cast<char*>(buf);
+  auto num_read = 0;
+  while (num_read < size) {
+    if (pos_ >= end_ && !Fill(f)) {
+      break;
+    }
+    const auto n = std::min(size - num_read, end_ - pos_);
+    memcpy(out + num_read, buffer_.data() + pos_, n);
+    pos_ += n;
+    num_read += n;
+  }
+  return num_read;
+}
+
+/**
+ * Reads a field of length {len}.  Will trim the field to  remove
+ * any trailing nulls.
+ */
+std::string FidoPacketReadBuffer::ReadFixedLengthField(File& f, int len) {
+  std::string s;
+  s.resize(len);
+  const auto num_read = ReadBytes(f, &s[0], len);
+  s.resize(num_read);
+  while (!s.empty() && s.back() == '\0') {
+    // Remove trailing null characters.
+    s.pop_back();
+  }
+  return s;
+}
+
+/**
+ * Reads a null-terminated field of up to length {len} or the first null
+ * character.
+ */
+std::string FidoPacketReadBuffer::ReadVariableLengthField(File& f, int max_len) {
+  std::string s;
+  while (ssize(s) < max_len) {
+    if (pos_ >= end_ && !Fill(f)) {
+      break;
+    }
+    const auto* start = buffer_.data() + pos_;
+    const auto n = std::min(max_len - ssize(s), end_ - pos_);
+    if (const auto* nul = static_cast<const char*>(memchr(start, 0, n))) {
+      s.append(start, nul);
+      // Skip the null too.
+      pos_ += static_cast<int>(nul - start) + 1;
+      return s;
+    }
+    s.append(start, n);
+    pos_ += n;
+  }
+  return s;
+}
+
 /**
  * Reads a packed message.
  * See http://ftsc.org/docs/fts-0001.016
  */
-ReadNetPacketResponse read_packed_message(File& f, FidoPackedMessage& packet) {
-  const auto num_read = f.Read(&packet.nh, sizeof(fido_packed_message_t));
+ReadNetPacketResponse FidoPacketReadBuffer::Read(File& f, FidoPackedMessage& packet) {
+  const auto num_read = ReadBytes(f, &packet.nh, sizeof(fido_packed_message_t));
   if (num_read == 0) {
     // at the end of the packet.
     return ReadNetPacketResponse::END_OF_FILE;
@@ -164,6 +189,17 @@ ReadNetPacketResponse read_packed_message(File& f, FidoPackedMessage& packet) {
   return ReadNetPacketResponse::OK;
 }
 
+ReadNetPacketResponse read_packed_message(File& f, FidoPackedMessage& packet) {
+  FidoPacketReadBuffer buffer;
+  const auto response = buffer.Read(f, packet);
+  // Give back what we read past the end of this message so the next read
+  // from f starts at the next message.
+  if (const auto unused = buffer.buffered(); unused > 0) {
+    f.Seek(-unused, File::Whence::current);
+  }
+  return response;
+}
+
 ReadNetPacketResponse read_stored_message(File& f, FidoStoredMessage& packet) {
   if (const auto num_read = f.Read(&packet.nh, sizeof(fido_stored_message_t)); num_read == 0) {
     // at the end of the packet.
@@ -286,8 +322,8 @@ bool FidoPacket::Write(const FidoPackedMessage& packet) {
 
 std::tuple<wwiv::sdk::net::ReadNetPacketResponse, FidoPackedMessage> FidoPacket::Read() {
   FidoPackedMessage msg;
-  auto response = read_packed_message(file_, msg);
-  return std::make_tuple(response, msg);
+  auto response = read_buffer_.Read(file_, msg);
+  return std::make_tuple(response, std::move(msg));
 }
 
 std::string FidoPacket::password() const {
@@ -28,6 +28,7 @@
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace wwiv::sdk::fido {
 
@@ -211,6 +212,10 @@ public:
       : nh(h), vh(std::move(v)) {}
 
   FidoPackedMessage() = default;
+  FidoPackedMessage(const FidoPackedMessage&) = default;
+  FidoPackedMessage(FidoPackedMessage&&) = default;
+  FidoPackedMessage& operator=(const FidoPackedMessage&) = default;
+  FidoPackedMessage& operator=(FidoPackedMessage&&) = default;
   virtual ~FidoPackedMessage() = default;
 
   fido_packed_message_t nh{};
@@ -230,6 +235,33 @@ public:
   std::string text;
 };
 
+/**
+ * Reads packed messages from a .PKT file through a fixed size buffer, so that
+ * the null terminated fields don't need a read per character, and only the
+ * fields of the message being read are allocated no matter how large the
+ * packet is.
+ */
+class FidoPacketReadBuffer {
+public:
+  static constexpr int BUFFER_SIZE = 32 * 1024;
+
+  /** Reads the next packed message from f into packet. */
+  wwiv::sdk::net::ReadNetPacketResponse Read(wwiv::core::File& f, FidoPackedMessage& packet);
+
+  /** The number of bytes read from the file, but not yet used. */
+  [[nodiscard]] int buffered() const noexcept { return end_ - pos_; }
+
+private:
+  bool Fill(wwiv::core::File& f);
+  int ReadBytes(wwiv::core::File& f, void* buf, int size);
+  std::string ReadFixedLengthField(wwiv::core::File& f, int len);
+  std::string ReadVariableLengthField(wwiv::core::File& f, int max_len);
+
+  std::vector<char> buffer_;
+  int pos_{0};
+  int end_{0};
+};
+
 /**
  * Represents a .PKT file in FidoNET.
  */
@@ -245,7 +277,8 @@ public:
   static std::optional<FidoPacket> Open(const std::filesystem::path& path);
 
   FidoPacket(FidoPacket&& o) noexcept
-      : file_(std::move(o.file_)), writable_(o.writable_), header_(o.header_) {}
+      : file_(std::move(o.file_)), writable_(o.writable_), header_(o.header_),
+        read_buffer_(std::move(o.read_buffer_)) {}
 
   bool Write(const FidoPackedMessage& packet);
   [[nodiscard]] std::tuple<wwiv::sdk::net::ReadNetPacketResponse, FidoPackedMessage> Read();
@@ -262,6 +295,7 @@ private:
   wwiv::core::File file_;
   bool writable_{false};
   packet_header_2p_t header_{};
+  FidoPacketReadBuffer read_buffer_;
 };
   
 bool write_fido_packet_header(wwiv::core::File& f, const packet_header_2p_t& header);
@@ -19,7 +19,10 @@
 #include "core/test/file_helper.h"
 #include "core/test/wwivtest.h"
 #include "sdk/fido/fido_packets.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <string>
+#include <vector>
 
 class FidoPacketsTestDataTest : public wwiv::core::test::TestDataTest {};
 
@@ -97,4 +100,22 @@ TEST_F(FidoPacketsTestDataTest, ThreeMessages) {
     auto [result, msg] = packet.Read();
     ASSERT_EQ(ReadNetPacketResponse::END_OF_FILE, result);
   }
-}
\ No newline at end of file
+}
+TEST_F(FidoPacketsTestDataTest, ReadPackedMessage_File) {
+  const auto path = FilePath(FileHelper::TestData(), "fido/0e7c5b69.pkt");
+  File f(path);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  packet_header_2p_t header{};
+  ASSERT_EQ(static_cast<File::size_type>(sizeof(header)), f.Read(&header, sizeof(header)));
+
+  // Each read must leave the file at the start of the next message.
+  std::vector<std::string> subjects;
+  while (true) {
+    FidoPackedMessage msg;
+    if (read_packed_message(f, msg) != ReadNetPacketResponse::OK) {
+      break;
+    }
+    subjects.push_back(msg.vh.subject);
+  }
+  EXPECT_THAT(subjects, testing::ElementsAre("test5", "test 6", "test 7"));
+}
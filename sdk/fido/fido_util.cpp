@@ -29,6 +29,7 @@
 #include "sdk/fido/fido_directories.h"
 #include "sdk/fido/fido_packets.h"
 #include "sdk/fido/flo_file.h"
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -201,6 +202,74 @@ std::vector<std::string> split_message(const std::string& s) {
   return SplitString(temp, "\r");
 }
 
+static std::string_view trim_control_value(std::string_view v) {
+  static constexpr std::string_view kWhitespace = " \t\x8d";
+  const auto start = v.find_first_not_of(kWhitespace);
+  if (start == std::string_view::npos) {
+    return {};
+  }
+  const auto end = v.find_last_not_of(kWhitespace);
+  return v.substr(start, end - start + 1);
+}
+
+static std::optional<ftn_control_line_t> parse_control_line(std::string_view line) {
+  if (line.size() > 1 && line.front() == 0x01) {
+    line.remove_prefix(1);
+    const auto sep = line.find_first_of(": ");
+    ftn_control_line_t cl{true, line.substr(0, sep), {}};
+    if (sep != std::string_view::npos) {
+      cl.value = trim_control_value(line.substr(sep + 1));
+    }
+    return cl;
+  }
+  for (const std::string_view name : {"AREA", "SEEN-BY"}) {
+    if (line.size() > name.size() && line.substr(0, name.size()) == name &&
+        line[name.size()] == ':') {
+      return ftn_control_line_t{false, line.substr(0, name.size()),
+                                trim_control_value(line.substr(name.size() + 1))};
+    }
+  }
+  return std::nullopt;
+}
+
+void for_each_control_line(std::string_view text,
+                           const std::function<bool(const ftn_control_line_t&)>& fn) {
+  while (!text.empty()) {
+    const auto eol = text.find_first_of("\r\n");
+    const auto line = text.substr(0, eol);
+    if (auto cl = parse_control_line(line)) {
+      if (!fn(cl.value())) {
+        return;
+      }
+    }
+    if (eol == std::string_view::npos) {
+      return;
+    }
+    text.remove_prefix(eol + 1);
+  }
+}
+
+static std::string_view find_control_line_of(std::string_view text, bool kludge,
+                                             std::string_view name) {
+  std::string_view result;
+  for_each_control_line(text, [&](const ftn_control_line_t& cl) {
+    if (cl.kludge != kludge || cl.name != name) {
+      return true;
+    }
+    result = cl.value;
+    return false;
+  });
+  return result;
+}
+
+std::string_view find_kludge_line(std::string_view text, std::string_view name) {
+  return find_control_line_of(text, true, name);
+}
+
+std::string_view find_control_line(std::string_view text, std::string_view name) {
+  return find_control_line_of(text, false, name);
+}
+
 /**
  * \brief Type of control line. Control-A Kludge or non-control-a like AREA, or none.
  */
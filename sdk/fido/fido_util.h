@@ -26,7 +26,9 @@
 #include "sdk/fido/fido_callout.h"
 #include <ctime>
 #include <filesystem>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace wwiv::sdk::fido {
@@ -71,6 +73,29 @@ std::optional<FidoAddress> FindRouteToAddress(const FidoAddress& a, const FidoCa
 /** Splits a message to find a specific line. This will strip blank lines. */
 std::vector<std::string> split_message(const std::string& string);
 
+/** A control line from the text of a FTN message, pointing into that text. */
+struct ftn_control_line_t {
+  /** True for ^A kludge lines, false for plain control lines (AREA: and SEEN-BY:) */
+  bool kludge{false};
+  /** Name of the control line, e.g. "MSGID", "PATH", "AREA" or "SEEN-BY" */
+  std::string_view name;
+  /** The rest of the line after the name, without the separator or surrounding whitespace. */
+  std::string_view value;
+};
+
+/**
+ * Calls fn for each control line in the FTN message text, without copying
+ * any of the text, until fn returns false.
+ */
+void for_each_control_line(std::string_view text,
+                           const std::function<bool(const ftn_control_line_t&)>& fn);
+
+/** Returns the value of the first ^A kludge line named name, or an empty string_view. */
+std::string_view find_kludge_line(std::string_view text, std::string_view name);
+
+/** Returns the value of the first plain control line (i.e. AREA) named name. */
+std::string_view find_control_line(std::string_view text, std::string_view name);
+
 /** Converts Ftn style text to WWIV style */
 std::string FidoToWWIVText(const std::string& ft, bool convert_control_codes = true);
 
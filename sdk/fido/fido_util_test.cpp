@@ -23,6 +23,7 @@
 #include "fmt/printf.h"
 #include "sdk/fido/fido_address.h"
 #include "sdk/fido/fido_util.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include <ctime>
 #include <memory>
@@ -439,3 +440,24 @@ SEEN-BY: 1/1 2
   EXPECT_EQ(2, a->node());
 }
 
+
+TEST_F(FidoUtilTest, ForEachControlLine) {
+  const std::string msg = "AREA:WWIV\r\x01MSGID: 1:2/3 abcd\r\x01INTL 1:2/3 1:4/5\r\n"
+                          "Hello\r\nSEEN-BY: 1/1 2\r\x01PATH: 2/3\r";
+  std::vector<std::string> lines;
+  for_each_control_line(msg, [&](const ftn_control_line_t& cl) {
+    lines.push_back(StrCat(cl.kludge ? "^A" : "", cl.name, "=", cl.value));
+    return true;
+  });
+  EXPECT_THAT(lines, testing::ElementsAre("AREA=WWIV", "^AMSGID=1:2/3 abcd", "^AINTL=1:2/3 1:4/5",
+                                          "SEEN-BY=1/1 2", "^APATH=2/3"));
+}
+
+TEST_F(FidoUtilTest, FindKludgeLine) {
+  const std::string msg = "AREA: WWIV \r\x01MSGID: 1:2/3 abcd\r\nHello\r";
+  EXPECT_EQ("1:2/3 abcd", find_kludge_line(msg, "MSGID"));
+  EXPECT_EQ("WWIV", find_control_line(msg, "AREA"));
+  EXPECT_TRUE(find_kludge_line(msg, "AREA").empty());
+  EXPECT_TRUE(find_control_line(msg, "MSGID").empty());
+  EXPECT_TRUE(find_kludge_line(msg, "PATH").empty());
+}
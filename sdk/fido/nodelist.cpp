@@ -23,7 +23,9 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/textfile.h"
+#include "core/log.h"
 #include "fmt/printf.h"
+#include "sdk/fido/nodelist_index.h"
 #include <set>
 #include <string>
 #include <utility>
@@ -164,6 +166,8 @@ Nodelist::Nodelist(const std::filesystem::path& path, std::string domain)
 Nodelist::Nodelist(const std::vector<std::string>& lines, std::string domain) 
   : domain_(std::move(domain)), initialized_(Load(lines)) {}
 
+Nodelist::~Nodelist() = default;
+
 bool Nodelist::HandleLine(const std::string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub) {
   if (line.empty()) return true;
   if (line.front() == ';') {
@@ -215,12 +219,24 @@ bool Nodelist::HandleLine(const std::string& line, uint16_t& zone, uint16_t& reg
 }
 
 bool Nodelist::Load(const std::filesystem::path& path) {
+  const auto index_path = NodelistIndex::index_path(path);
+  if (index_ = NodelistIndex::Open(path, index_path); index_) {
+    VLOG(1) << "Using compiled nodelist index: " << index_path;
+    return true;
+  }
   TextFile f(path, "rt");
   if (!f) {
     return false;
   }
   const auto lines = f.ReadFileIntoVector();
-  return Load(lines);
+  if (!Load(lines)) {
+    return false;
+  }
+  all_entries_loaded_ = true;
+  if (!NodelistIndex::Compile(entries_, path, index_path)) {
+    LOG(WARNING) << "Unable to compile nodelist index: " << index_path;
+  }
+  return true;
 }
 
 bool Nodelist::Load(const std::vector<std::string>& lines) {
@@ -232,10 +248,44 @@ bool Nodelist::Load(const std::vector<std::string>& lines) {
     auto line = StringTrim(raw_line);
     HandleLine(line, zone, region, net, hub);
   }
+  all_entries_loaded_ = true;
   return true;
 }
 
+std::optional<NodelistIndexEntry> Nodelist::find_indexed(const FidoAddress& a) const {
+  if (!index_ || a.point() != 0) {
+    return std::nullopt;
+  }
+  // The same as the lookups with and without the domain below.
+  if (a.has_domain() && !domain_.empty() && a.domain() != domain_) {
+    return std::nullopt;
+  }
+  return index_->find(static_cast<uint16_t>(a.zone()), static_cast<uint16_t>(a.net()),
+                      static_cast<uint16_t>(a.node()));
+}
+
+const NodelistEntry& Nodelist::entry_for(const NodelistIndexEntry& e) const {
+  const FidoAddress a(e.zone(), e.net(), e.node(), 0, domain_);
+  if (auto it = entries_.find(a); it != entries_.end()) {
+    return it->second;
+  }
+  return entries_.emplace(a, e.ToNodelistEntry(domain_)).first->second;
+}
+
+const std::map<FidoAddress, NodelistEntry>& Nodelist::entries() const {
+  if (!all_entries_loaded_ && index_) {
+    for (auto i = 0; i < index_->size(); i++) {
+      entry_for(index_->at(i));
+    }
+    all_entries_loaded_ = true;
+  }
+  return entries_;
+}
+
 const NodelistEntry& Nodelist::entry(const FidoAddress& a) const {
+  if (const auto e = find_indexed(a)) {
+    return entry_for(e.value());
+  }
   if (stl::contains(entries_, a)) {
     return at(entries_, a);
   }
@@ -254,6 +304,9 @@ const NodelistEntry& Nodelist::entry(const FidoAddress& a) const {
 }
 
 bool Nodelist::contains(const FidoAddress& a) const {
+  if (index_) {
+    return find_indexed(a).has_value();
+  }
   if (stl::contains(entries_, a)) {
     return true;
   }
@@ -271,6 +324,13 @@ bool Nodelist::contains(const FidoAddress& a) const {
 
 std::vector<NodelistEntry> Nodelist::entries(uint16_t zone, uint16_t net) const {
   std::vector<NodelistEntry> entries;
+  if (index_) {
+    const auto [lo, hi] = index_->range(zone, net);
+    for (auto i = lo; i < hi; i++) {
+      entries.push_back(entry_for(index_->at(i)));
+    }
+    return entries;
+  }
   for (const auto& e : entries_) {
     if (e.first.zone() == zone && e.first.net() == net) {
       entries.push_back(e.second);
@@ -281,6 +341,13 @@ std::vector<NodelistEntry> Nodelist::entries(uint16_t zone, uint16_t net) const
 
 std::vector<NodelistEntry> Nodelist::entries(uint16_t zone) const {
   std::vector<NodelistEntry> entries;
+  if (index_) {
+    const auto [lo, hi] = index_->range(zone);
+    for (auto i = lo; i < hi; i++) {
+      entries.push_back(entry_for(index_->at(i)));
+    }
+    return entries;
+  }
   for (const auto& e : entries_) {
     if (e.first.zone() == zone) {
       entries.push_back(e.second);
@@ -290,6 +357,9 @@ std::vector<NodelistEntry> Nodelist::entries(uint16_t zone) const {
 }
 
 std::vector<uint16_t> Nodelist::zones() const {
+  if (index_) {
+    return index_->zones();
+  }
   std::set<uint16_t> s;
   for (const auto& e : entries_) {
     s.emplace(e.first.zone());
@@ -302,6 +372,9 @@ std::vector<uint16_t> Nodelist::zones() const {
 }
 
 std::vector<uint16_t> Nodelist::nets(uint16_t zone) const {
+  if (index_) {
+    return index_->nets(zone);
+  }
   std::set<uint16_t> s;
   for (const auto& e : entries_) {
     if (e.first.zone() == zone) {
@@ -316,6 +389,9 @@ std::vector<uint16_t> Nodelist::nets(uint16_t zone) const {
 }
 
 std::vector<uint16_t> Nodelist::nodes(uint16_t zone, uint16_t net) const {
+  if (index_) {
+    return index_->nodes(zone, net);
+  }
   std::vector<uint16_t> nodes;
   for (const auto& e : entries_) {
     if (e.first.zone() == zone && e.first.net() == net) {
@@ -326,6 +402,10 @@ std::vector<uint16_t> Nodelist::nodes(uint16_t zone, uint16_t net) const {
 }
 
 const NodelistEntry* Nodelist::entry(uint16_t zone, uint16_t net, uint16_t node) {
+  if (index_) {
+    const auto e = index_->find(zone, net, node);
+    return e ? &entry_for(e.value()) : nullptr;
+  }
   const FidoAddress a(zone, net, node, 0, "");
   if (!stl::contains(entries_, a)) {
     return nullptr;
@@ -334,6 +414,9 @@ const NodelistEntry* Nodelist::entry(uint16_t zone, uint16_t net, uint16_t node)
 }
 
 bool Nodelist::has_zone(int zone) const noexcept {
+  if (index_) {
+    return index_->has_zone(static_cast<uint16_t>(zone));
+  }
   return std::any_of(std::begin(entries_), std::end(entries_), 
     [zone](const auto& p) { return p.first.zone() == zone; });
 }
@@ -22,6 +22,8 @@
 #include <cstdint>
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -34,6 +36,9 @@
 
 namespace wwiv::sdk::fido {
 
+class NodelistIndex;
+class NodelistIndexEntry;
+
 // The 1st entry of the 8 mandatory ones is the keyword.
 enum class NodelistKeyword {
   zone, region, host, hub, pvt, down, node
@@ -82,6 +87,8 @@ public:
   [[nodiscard]] std::string vmodem_hostname() const { return vmodem_hostname_; }
 
 private:
+  friend class NodelistIndexEntry;
+
   FidoAddress address_;
   NodelistKeyword keyword_ = NodelistKeyword::node;
   uint16_t number_ = 0;
@@ -131,20 +138,25 @@ private:
 
 /**
  * Represents a FidoNet NodeList as defined in FRL-1003.
+ *
+ * When loaded from a file, the nodelist is compiled into a NodelistIndex
+ * next to it the first time, and later loads map that index instead of
+ * parsing the nodelist again.  Entries are only created from the index as
+ * they are used.
  */
 class Nodelist final {
 public:
   /** Parses address.  If it fails, throws bad_fidonet_address. */
   Nodelist(const std::filesystem::path& path, std::string domain);
   Nodelist(const std::vector<std::string>& lines, std::string domain);
-  ~Nodelist() = default;
+  ~Nodelist();
 
   [[nodiscard]] bool initialized() const { return initialized_; }
   explicit operator bool() const { return initialized_; }
 
   [[nodiscard]] const NodelistEntry& entry(const FidoAddress& a) const;
   [[nodiscard]] bool contains(const FidoAddress& a) const;
-  [[nodiscard]] const std::map<FidoAddress, NodelistEntry>& entries() const { return entries_; }
+  [[nodiscard]] const std::map<FidoAddress, NodelistEntry>& entries() const;
   [[nodiscard]] std::vector<NodelistEntry> entries(uint16_t zone, uint16_t net) const;
   [[nodiscard]] std::vector<NodelistEntry> entries(uint16_t zone) const;
   [[nodiscard]] std::vector<uint16_t> zones() const;
@@ -152,6 +164,8 @@ public:
   [[nodiscard]] std::vector<uint16_t> nodes(uint16_t zone, uint16_t net) const;
   [[nodiscard]] const NodelistEntry* entry(uint16_t zone, uint16_t net, uint16_t node);
   [[nodiscard]] bool has_zone(int zone) const noexcept;
+  /** True if this nodelist was loaded from a compiled index. */
+  [[nodiscard]] bool indexed() const noexcept { return index_ != nullptr; }
 
   static std::string FindLatestNodelist(const std::filesystem::path& dir, const std::string& base);
 
@@ -160,7 +174,16 @@ private:
   bool Load(const std::vector<std::string>& lines);
 
   bool HandleLine(const std::string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub );
-  std::map<FidoAddress, NodelistEntry> entries_;
+  /** Finds a in the index, returning nullopt if there is no index or a isn't in it. */
+  [[nodiscard]] std::optional<NodelistIndexEntry> find_indexed(const FidoAddress& a) const;
+  /** Returns the entry for e, creating it from the index if needed. */
+  const NodelistEntry& entry_for(const NodelistIndexEntry& e) const;
+
+  std::unique_ptr<NodelistIndex> index_;
+  // Entries parsed from the nodelist, or when using index_, the ones created
+  // from it so far.
+  mutable std::map<FidoAddress, NodelistEntry> entries_;
+  mutable bool all_entries_loaded_{false};
   std::string domain_;
   bool initialized_{false};
 };
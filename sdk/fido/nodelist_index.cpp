@@ -0,0 +1,333 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/fido/nodelist_index.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/os.h"
+#include "core/strings.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::fido {
+
+static constexpr char NODELIST_INDEX_MAGIC[8] = {'W', 'W', 'I', 'V', 'N', 'L', 'X', '\0'};
+
+NodelistEntry NodelistIndexEntry::ToNodelistEntry(const std::string& domain) const {
+  NodelistEntry e;
+  e.address_ = FidoAddress(zone(), net(), node(), 0, domain);
+  e.keyword_ = keyword();
+  e.number_ = node();
+  e.name_ = name();
+  e.location_ = location();
+  e.sysop_name_ = sysop_name();
+  e.phone_number_ = phone_number();
+  e.baud_rate_ = baud_rate();
+  e.cm_ = has_flag(NODELIST_FLAG_CM);
+  e.icm_ = has_flag(NODELIST_FLAG_ICM);
+  e.mo_ = has_flag(NODELIST_FLAG_MO);
+  e.lo_ = has_flag(NODELIST_FLAG_LO);
+  e.mn_ = has_flag(NODELIST_FLAG_MN);
+  e.bark_file_ = has_flag(NODELIST_FLAG_BARK_FILE);
+  e.bark_update_ = has_flag(NODELIST_FLAG_BARK_UPDATE);
+  e.wazoo_file_ = has_flag(NODELIST_FLAG_WAZOO_FILE);
+  e.wazoo_update_ = has_flag(NODELIST_FLAG_WAZOO_UPDATE);
+  e.hostname_ = hostname();
+  e.binkp_ = has_flag(NODELIST_FLAG_BINKP);
+  e.binkp_port_ = r_->binkp_port;
+  e.binkp_hostname_ = str(NODELIST_BINKP_HOSTNAME);
+  e.telnet_ = has_flag(NODELIST_FLAG_TELNET);
+  e.telnet_port_ = r_->telnet_port;
+  e.telnet_hostname_ = str(NODELIST_TELNET_HOSTNAME);
+  e.vmodem_ = has_flag(NODELIST_FLAG_VMODEM);
+  e.vmodem_port_ = r_->vmodem_port;
+  e.vmodem_hostname_ = str(NODELIST_VMODEM_HOSTNAME);
+  return e;
+}
+
+NodelistIndex::~NodelistIndex() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), data_size_);
+  }
+#endif
+}
+
+// static
+std::filesystem::path NodelistIndex::index_path(const std::filesystem::path& nodelist_path) {
+  // Don't use the nodelist name with a new extension, since FindLatestNodelist
+  // looks at every NODELIST.* file.
+  auto fn = nodelist_path.filename().string();
+  std::replace(std::begin(fn), std::end(fn), '.', '_');
+  return nodelist_path.parent_path() / StrCat(fn, ".nlx");
+}
+
+static uint32_t flags_of(const NodelistEntry& e) {
+  uint32_t f = 0;
+  if (e.cm()) f |= NODELIST_FLAG_CM;
+  if (e.icm()) f |= NODELIST_FLAG_ICM;
+  if (e.mo()) f |= NODELIST_FLAG_MO;
+  if (e.lo()) f |= NODELIST_FLAG_LO;
+  if (e.mn()) f |= NODELIST_FLAG_MN;
+  if (e.bark_file()) f |= NODELIST_FLAG_BARK_FILE;
+  if (e.bark_update()) f |= NODELIST_FLAG_BARK_UPDATE;
+  if (e.wazoo_file()) f |= NODELIST_FLAG_WAZOO_FILE;
+  if (e.wazoo_update()) f |= NODELIST_FLAG_WAZOO_UPDATE;
+  if (e.binkp()) f |= NODELIST_FLAG_BINKP;
+  if (e.telnet()) f |= NODELIST_FLAG_TELNET;
+  if (e.vmodem()) f |= NODELIST_FLAG_VMODEM;
+  return f;
+}
+
+// static
+bool NodelistIndex::Compile(const std::map<FidoAddress, NodelistEntry>& entries,
+                            const std::filesystem::path& nodelist_path,
+                            const std::filesystem::path& index_path) {
+  std::vector<nodelist_index_record_t> records;
+  records.reserve(entries.size());
+  std::string strings;
+  // Hostnames are usually repeated, so only store each string once.
+  std::unordered_map<std::string, uint32_t> offsets;
+  auto add_string = [&](const std::string& s) -> nodelist_index_string_t {
+    auto [it, inserted] = offsets.try_emplace(s, static_cast<uint32_t>(strings.size()));
+    if (inserted) {
+      strings.append(s);
+    }
+    return {it->second, static_cast<uint32_t>(s.size())};
+  };
+
+  for (const auto& [address, e] : entries) {
+    nodelist_index_record_t r{};
+    r.zone = static_cast<uint16_t>(address.zone());
+    r.net = static_cast<uint16_t>(address.net());
+    r.node = static_cast<uint16_t>(address.node());
+    r.keyword = static_cast<uint8_t>(e.keyword());
+    r.baud_rate = e.baud_rate();
+    r.flags = flags_of(e);
+    r.binkp_port = static_cast<uint16_t>(e.binkp_port());
+    r.telnet_port = static_cast<uint16_t>(e.telnet_port());
+    r.vmodem_port = static_cast<uint16_t>(e.vmodem_port());
+    r.strings[NODELIST_NAME] = add_string(e.name());
+    r.strings[NODELIST_LOCATION] = add_string(e.location());
+    r.strings[NODELIST_SYSOP_NAME] = add_string(e.sysop_name());
+    r.strings[NODELIST_PHONE_NUMBER] = add_string(e.phone_number());
+    r.strings[NODELIST_HOSTNAME] = add_string(e.hostname());
+    r.strings[NODELIST_BINKP_HOSTNAME] = add_string(e.binkp_hostname());
+    r.strings[NODELIST_TELNET_HOSTNAME] = add_string(e.telnet_hostname());
+    r.strings[NODELIST_VMODEM_HOSTNAME] = add_string(e.vmodem_hostname());
+    records.push_back(r);
+  }
+  // The map is sorted by FidoAddress which includes the point and domain,
+  // so sort by just what we search on.
+  std::stable_sort(std::begin(records), std::end(records), [](const auto& l, const auto& r) {
+    return std::tie(l.zone, l.net, l.node) < std::tie(r.zone, r.net, r.node);
+  });
+
+  const File nodelist(nodelist_path);
+  nodelist_index_header_t h{};
+  memcpy(h.magic, NODELIST_INDEX_MAGIC, sizeof(h.magic));
+  h.version = VERSION;
+  h.num_records = static_cast<uint32_t>(records.size());
+  h.nodelist_size = static_cast<uint64_t>(nodelist.length());
+  h.nodelist_time = static_cast<int64_t>(nodelist.last_write_time());
+  h.strings_size = static_cast<uint32_t>(strings.size());
+
+  // Write to a temporary file and rename it so that nobody else ever maps a
+  // partially written index.
+  auto tmp_path = index_path;
+  tmp_path += fmt::format(".{}", os::get_pid());
+  {
+    File f(tmp_path);
+    if (!f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                File::modeTruncate)) {
+      LOG(WARNING) << "Unable to create nodelist index: " << tmp_path;
+      return false;
+    }
+    const auto records_size = records.size() * sizeof(nodelist_index_record_t);
+    if (f.Write(&h, sizeof(h)) != sizeof(h) ||
+        f.Write(records.data(), records_size) != static_cast<File::size_type>(records_size) ||
+        f.Write(strings) != static_cast<File::size_type>(strings.size())) {
+      LOG(WARNING) << "Short write on nodelist index: " << tmp_path;
+      f.Close();
+      File::Remove(tmp_path);
+      return false;
+    }
+  }
+  if (!File::Move(tmp_path, index_path)) {
+    File::Remove(tmp_path);
+    return false;
+  }
+  VLOG(1) << "Compiled nodelist index: " << index_path << " with " << records.size() << " nodes";
+  return true;
+}
+
+// static
+std::unique_ptr<NodelistIndex> NodelistIndex::Open(const std::filesystem::path& nodelist_path,
+                                                   const std::filesystem::path& index_path) {
+  if (!File::Exists(index_path) || !File::Exists(nodelist_path)) {
+    return nullptr;
+  }
+  std::unique_ptr<NodelistIndex> index(new NodelistIndex());
+#ifdef _WIN32
+  {
+    File f(index_path);
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      return nullptr;
+    }
+    index->buffer_.resize(f.length());
+    if (f.Read(index->buffer_.data(), f.length()) != f.length()) {
+      return nullptr;
+    }
+    index->data_ = index->buffer_.data();
+    index->data_size_ = index->buffer_.size();
+  }
+#else
+  {
+    const auto fd = open(index_path.string().c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(nodelist_index_header_t))) {
+      close(fd);
+      return nullptr;
+    }
+    auto* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+      return nullptr;
+    }
+    index->data_ = static_cast<const char*>(p);
+    index->data_size_ = static_cast<std::size_t>(st.st_size);
+  }
+#endif
+
+  if (index->data_size_ < sizeof(nodelist_index_header_t)) {
+    return nullptr;
+  }
+  nodelist_index_header_t h{};
+  memcpy(&h, index->data_, sizeof(h));
+  if (memcmp(h.magic, NODELIST_INDEX_MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION) {
+    VLOG(1) << "Ignoring nodelist index with wrong version: " << index_path;
+    return nullptr;
+  }
+  const File nodelist(nodelist_path);
+  if (h.nodelist_size != static_cast<uint64_t>(nodelist.length()) ||
+      h.nodelist_time != static_cast<int64_t>(nodelist.last_write_time())) {
+    VLOG(1) << "Ignoring stale nodelist index: " << index_path;
+    return nullptr;
+  }
+  const auto expected_size = sizeof(h) + h.num_records * sizeof(nodelist_index_record_t) +
+                             static_cast<std::size_t>(h.strings_size);
+  if (index->data_size_ != expected_size) {
+    LOG(WARNING) << "Ignoring nodelist index with wrong size: " << index_path;
+    return nullptr;
+  }
+  index->records_ = reinterpret_cast<const nodelist_index_record_t*>(index->data_ + sizeof(h));
+  index->num_records_ = h.num_records;
+  index->strings_ = index->data_ + sizeof(h) + h.num_records * sizeof(nodelist_index_record_t);
+  return index;
+}
+
+std::pair<int, int> NodelistIndex::range(uint16_t zone) const {
+  const auto* b = records_;
+  const auto* e = records_ + num_records_;
+  const auto lo = std::lower_bound(b, e, zone, [](const auto& r, uint16_t z) { return r.zone < z; });
+  const auto hi = std::upper_bound(lo, e, zone, [](uint16_t z, const auto& r) { return z < r.zone; });
+  return {static_cast<int>(lo - b), static_cast<int>(hi - b)};
+}
+
+std::pair<int, int> NodelistIndex::range(uint16_t zone, uint16_t net) const {
+  const auto* b = records_;
+  const auto* e = records_ + num_records_;
+  const auto key = std::make_tuple(zone, net);
+  const auto lo = std::lower_bound(b, e, key, [](const auto& r, const auto& k) {
+    return std::tie(r.zone, r.net) < k;
+  });
+  const auto hi = std::upper_bound(lo, e, key, [](const auto& k, const auto& r) {
+    return k < std::tie(r.zone, r.net);
+  });
+  return {static_cast<int>(lo - b), static_cast<int>(hi - b)};
+}
+
+std::optional<NodelistIndexEntry> NodelistIndex::find(uint16_t zone, uint16_t net,
+                                                      uint16_t node) const {
+  const auto* b = records_;
+  const auto* e = records_ + num_records_;
+  const auto key = std::make_tuple(zone, net, node);
+  const auto it = std::lower_bound(b, e, key, [](const auto& r, const auto& k) {
+    return std::tie(r.zone, r.net, r.node) < k;
+  });
+  if (it == e || std::tie(it->zone, it->net, it->node) != key) {
+    return std::nullopt;
+  }
+  return NodelistIndexEntry(*it, strings_);
+}
+
+bool NodelistIndex::has_zone(uint16_t zone) const {
+  const auto [lo, hi] = range(zone);
+  return lo != hi;
+}
+
+std::vector<uint16_t> NodelistIndex::zones() const {
+  std::vector<uint16_t> zones;
+  for (uint32_t i = 0; i < num_records_; i++) {
+    if (zones.empty() || zones.back() != records_[i].zone) {
+      zones.push_back(records_[i].zone);
+    }
+  }
+  return zones;
+}
+
+std::vector<uint16_t> NodelistIndex::nets(uint16_t zone) const {
+  std::vector<uint16_t> nets;
+  const auto [lo, hi] = range(zone);
+  for (auto i = lo; i < hi; i++) {
+    if (nets.empty() || nets.back() != records_[i].net) {
+      nets.push_back(records_[i].net);
+    }
+  }
+  return nets;
+}
+
+std::vector<uint16_t> NodelistIndex::nodes(uint16_t zone, uint16_t net) const {
+  std::vector<uint16_t> nodes;
+  const auto [lo, hi] = range(zone, net);
+  for (auto i = lo; i < hi; i++) {
+    nodes.push_back(records_[i].node);
+  }
+  return nodes;
+}
+
+} // namespace wwiv::sdk::fido
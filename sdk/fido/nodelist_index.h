@@ -0,0 +1,216 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_FIDO_NODELIST_INDEX_H
+#define INCLUDED_SDK_FIDO_NODELIST_INDEX_H
+
+#include "sdk/fido/fido_address.h"
+#include "sdk/fido/nodelist.h"
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/**
+ * A compiled nodelist index.
+ *
+ * The index file is a header, followed by one fixed size record per node
+ * sorted by zone, net and node, followed by a pool of all of the strings
+ * referenced by the records.  The header records the size and time of the
+ * nodelist it was compiled from so that a stale index is never used.
+ */
+
+namespace wwiv::sdk::fido {
+
+#ifndef __MSDOS__
+#pragma pack(push, 1)
+#endif // __MSDOS__
+
+struct nodelist_index_header_t {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_records;
+  // Size and last write time of the nodelist this was compiled from.
+  uint64_t nodelist_size;
+  int64_t nodelist_time;
+  uint32_t strings_size;
+  uint32_t unused[3];
+};
+
+/** A string in the string pool */
+struct nodelist_index_string_t {
+  uint32_t offset;
+  uint32_t size;
+};
+
+enum nodelist_index_flags_t : uint32_t {
+  NODELIST_FLAG_CM = 0x0001,
+  NODELIST_FLAG_ICM = 0x0002,
+  NODELIST_FLAG_MO = 0x0004,
+  NODELIST_FLAG_LO = 0x0008,
+  NODELIST_FLAG_MN = 0x0010,
+  NODELIST_FLAG_BARK_FILE = 0x0020,
+  NODELIST_FLAG_BARK_UPDATE = 0x0040,
+  NODELIST_FLAG_WAZOO_FILE = 0x0080,
+  NODELIST_FLAG_WAZOO_UPDATE = 0x0100,
+  NODELIST_FLAG_BINKP = 0x0200,
+  NODELIST_FLAG_TELNET = 0x0400,
+  NODELIST_FLAG_VMODEM = 0x0800,
+};
+
+enum nodelist_index_string_field_t {
+  NODELIST_NAME,
+  NODELIST_LOCATION,
+  NODELIST_SYSOP_NAME,
+  NODELIST_PHONE_NUMBER,
+  NODELIST_HOSTNAME,
+  NODELIST_BINKP_HOSTNAME,
+  NODELIST_TELNET_HOSTNAME,
+  NODELIST_VMODEM_HOSTNAME,
+  NODELIST_NUM_STRINGS
+};
+
+struct nodelist_index_record_t {
+  uint16_t zone;
+  uint16_t net;
+  uint16_t node;
+  uint8_t keyword;
+  uint8_t unused;
+  uint32_t baud_rate;
+  uint32_t flags;
+  uint16_t binkp_port;
+  uint16_t telnet_port;
+  uint16_t vmodem_port;
+  uint16_t unused2;
+  nodelist_index_string_t strings[NODELIST_NUM_STRINGS];
+};
+
+#ifndef __MSDOS__
+#pragma pack(pop)
+#endif // __MSDOS__
+
+static_assert(sizeof(nodelist_index_header_t) == 48, "nodelist_index_header_t != 48 bytes");
+static_assert(sizeof(nodelist_index_record_t) == 88, "nodelist_index_record_t != 88 bytes");
+
+/**
+ * One node in a NodelistIndex.  The strings point into the index, so this
+ * must not outlive it.
+ */
+class NodelistIndexEntry final {
+public:
+  NodelistIndexEntry(const nodelist_index_record_t& r, const char* strings)
+      : r_(&r), strings_(strings) {}
+
+  [[nodiscard]] uint16_t zone() const noexcept { return r_->zone; }
+  [[nodiscard]] uint16_t net() const noexcept { return r_->net; }
+  [[nodiscard]] uint16_t node() const noexcept { return r_->node; }
+  [[nodiscard]] NodelistKeyword keyword() const noexcept {
+    return static_cast<NodelistKeyword>(r_->keyword);
+  }
+  [[nodiscard]] std::string_view name() const noexcept { return str(NODELIST_NAME); }
+  [[nodiscard]] std::string_view location() const noexcept { return str(NODELIST_LOCATION); }
+  [[nodiscard]] std::string_view sysop_name() const noexcept { return str(NODELIST_SYSOP_NAME); }
+  [[nodiscard]] std::string_view phone_number() const noexcept {
+    return str(NODELIST_PHONE_NUMBER);
+  }
+  [[nodiscard]] uint32_t baud_rate() const noexcept { return r_->baud_rate; }
+  [[nodiscard]] bool has_flag(nodelist_index_flags_t f) const noexcept {
+    return (r_->flags & f) != 0;
+  }
+  [[nodiscard]] std::string_view hostname() const noexcept { return str(NODELIST_HOSTNAME); }
+  [[nodiscard]] uint16_t binkp_port() const noexcept { return r_->binkp_port; }
+  [[nodiscard]] std::string_view binkp_hostname() const noexcept {
+    return str(NODELIST_BINKP_HOSTNAME);
+  }
+
+  /** Creates a NodelistEntry for this node, with the address in domain */
+  [[nodiscard]] NodelistEntry ToNodelistEntry(const std::string& domain) const;
+
+private:
+  [[nodiscard]] std::string_view str(nodelist_index_string_field_t f) const noexcept {
+    const auto& s = r_->strings[f];
+    return {strings_ + s.offset, s.size};
+  }
+
+  const nodelist_index_record_t* r_;
+  const char* strings_;
+};
+
+/**
+ * A compiled nodelist that is memory mapped instead of parsed, and can be
+ * queried by zone, net and node with a binary search.
+ */
+class NodelistIndex final {
+public:
+  static constexpr uint32_t VERSION = 1;
+
+  ~NodelistIndex();
+  NodelistIndex(const NodelistIndex&) = delete;
+  NodelistIndex& operator=(const NodelistIndex&) = delete;
+
+  /** Path of the compiled index for the nodelist at nodelist_path. */
+  static std::filesystem::path index_path(const std::filesystem::path& nodelist_path);
+
+  /**
+   * Writes the compiled index of entries to index_path, stamped with the size
+   * and time of nodelist_path.
+   */
+  static bool Compile(const std::map<FidoAddress, NodelistEntry>& entries,
+                      const std::filesystem::path& nodelist_path,
+                      const std::filesystem::path& index_path);
+
+  /**
+   * Opens index_path, returning nullptr if it does not exist, is invalid or
+   * was not compiled from the current contents of nodelist_path.
+   */
+  static std::unique_ptr<NodelistIndex> Open(const std::filesystem::path& nodelist_path,
+                                             const std::filesystem::path& index_path);
+
+  [[nodiscard]] int size() const noexcept { return static_cast<int>(num_records_); }
+  [[nodiscard]] NodelistIndexEntry at(int i) const { return {records_[i], strings_}; }
+  [[nodiscard]] std::optional<NodelistIndexEntry> find(uint16_t zone, uint16_t net,
+                                                       uint16_t node) const;
+  /** Returns the index of the first and one past the last records in zone (and net). */
+  [[nodiscard]] std::pair<int, int> range(uint16_t zone) const;
+  [[nodiscard]] std::pair<int, int> range(uint16_t zone, uint16_t net) const;
+  [[nodiscard]] bool has_zone(uint16_t zone) const;
+  [[nodiscard]] std::vector<uint16_t> zones() const;
+  [[nodiscard]] std::vector<uint16_t> nets(uint16_t zone) const;
+  [[nodiscard]] std::vector<uint16_t> nodes(uint16_t zone, uint16_t net) const;
+
+private:
+  NodelistIndex() = default;
+
+  // Start of the mapped (or read) index file.
+  const char* data_{nullptr};
+  std::size_t data_size_{0};
+#ifdef _WIN32
+  // Windows reads the index into memory instead of mapping it.
+  std::vector<char> buffer_;
+#endif
+  const nodelist_index_record_t* records_{nullptr};
+  uint32_t num_records_{0};
+  const char* strings_{nullptr};
+};
+
+} // namespace wwiv::sdk::fido
+
+#endif
@@ -19,9 +19,12 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include "core/file.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/test/file_helper.h"
 #include "sdk/fido/nodelist.h"
+#include "sdk/fido/nodelist_index.h"
 #include <type_traits>
 
 using namespace wwiv::sdk;
@@ -144,4 +147,60 @@ TEST(NodelistTest, Nodes) {
   const auto nets = nl.nodes(1, 261);
   const std::vector<uint16_t>expected{1, 1300};
   EXPECT_EQ(expected, nets);
-}
\ No newline at end of file
+}
+TEST(NodelistTest, CompiledIndex) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+
+  const Nodelist parsed(path, "fidonet");
+  ASSERT_TRUE(parsed);
+  EXPECT_FALSE(parsed.indexed());
+  ASSERT_TRUE(wwiv::core::File::Exists(NodelistIndex::index_path(path)));
+
+  Nodelist nl(path, "fidonet");
+  ASSERT_TRUE(nl);
+  ASSERT_TRUE(nl.indexed());
+
+  EXPECT_EQ(parsed.zones(), nl.zones());
+  EXPECT_EQ(parsed.nets(1), nl.nets(1));
+  EXPECT_EQ(parsed.nodes(1, 261), nl.nodes(1, 261));
+  EXPECT_TRUE(nl.has_zone(42));
+  EXPECT_FALSE(nl.has_zone(8));
+  EXPECT_TRUE(nl.contains(FidoAddress("1:261/1300")));
+  EXPECT_TRUE(nl.contains(FidoAddress("1:261/1300@fidonet")));
+  EXPECT_FALSE(nl.contains(FidoAddress("1:261/1300@fsxnet")));
+  EXPECT_FALSE(nl.contains(FidoAddress("1:261/2")));
+
+  const auto* e = nl.entry(1, 261, 1);
+  ASSERT_TRUE(e != nullptr);
+  EXPECT_EQ("Weather Station Hub", e->name());
+  EXPECT_EQ("Bel Air MD", e->location());
+  EXPECT_TRUE(e->binkp());
+  EXPECT_EQ("bbs.weather-station.org", e->binkp_hostname());
+  EXPECT_EQ(24555u, e->binkp_port());
+  EXPECT_EQ(FidoAddress("1:261/1@fidonet"), e->address());
+
+  ASSERT_EQ(parsed.entries().size(), nl.entries().size());
+  for (const auto& [a, pe] : parsed.entries()) {
+    const auto& ie = nl.entry(a);
+    EXPECT_EQ(pe.address(), ie.address());
+    EXPECT_EQ(pe.keyword(), ie.keyword());
+    EXPECT_EQ(pe.sysop_name(), ie.sysop_name());
+    EXPECT_EQ(pe.hostname(), ie.hostname());
+    EXPECT_EQ(pe.cm(), ie.cm());
+  }
+}
+
+TEST(NodelistTest, CompiledIndex_Stale) {
+  wwiv::core::test::FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+  ASSERT_TRUE(Nodelist(path, ""));
+  ASSERT_TRUE(Nodelist(path, "").indexed());
+
+  // Changing the nodelist must not use the old index.
+  helper.CreateTempFile("nodelist.123", StrCat(raw, ",2,New_Node,Mars,Sysop,-Unpublished-,300\n"));
+  const Nodelist nl(path, "");
+  EXPECT_FALSE(nl.indexed());
+  EXPECT_TRUE(nl.contains(FidoAddress("42:123/2")));
+  EXPECT_TRUE(Nodelist(path, "").indexed());
+}
@@ -100,6 +100,7 @@ constexpr auto CHAINS_JSON = "chains.json";
 
 #define INPUT_MSG "input.msg"
 #define INSTANCE_DAT "instance.dat"
+#define INSTANCE_SHM "instance.shm"
 
 #define LANGUAGE_DAT "language.dat"
 #define LASTON_TXT "laston.txt"
@@ -177,6 +178,7 @@ constexpr auto CHAINS_JSON = "chains.json";
 #define SUBS_NOEXT "subs"
 #define SUBS_XTR "subs.xtr"
 #define SWFC_NOEXT "swfc"
+#define SYSOPLOG_EVT "sysoplog.evt"
 #define SYSTEM_NOEXT "system"
 
 #define SY_EMAIL_NOEXT "sy-email"
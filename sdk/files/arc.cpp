@@ -17,11 +17,13 @@
 /**************************************************************************/
 #include "sdk/files/arc.h"
 
+#include "core/crc32.h"
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
 #include "sdk/filenames.h"
+#include "sdk/files/inflate.h"
 #include "sdk/vardec.h"
 
 #include <string>
@@ -109,10 +111,10 @@ struct zip_end_dir {
 
 archive_method_t zip_method(int z) {
   if (z == 0) {
-    return archive_method_t::ZIP_STORED;
+    return archive_method_t::STORED;
   }
   if (z == 8) {
-    return archive_method_t::ZIP_DEFLATED;
+    return archive_method_t::DEFLATED;
   }
   return archive_method_t::UNKNOWN;
 }
@@ -124,7 +126,9 @@ template <typename Z> archive_entry_t create_archive_entry(const Z& z, const cha
   a.dt = dos2time_t(z.mod_date, z.mod_time);
   a.compress_size = z.comp_size;
   a.uncompress_size = z.uncomp_size;
-  a.method = zip_method(z.comp_meth);
+  // Encrypted members can't be extracted.
+  a.method = (z.flags & 0x01) ? archive_method_t::UNKNOWN : zip_method(z.comp_meth);
+  a.offset = 0;
   return a;
 }
 
@@ -164,7 +168,15 @@ list_archive_zip(const std::filesystem::path& path) {
       file.Read(s, zc.filename_len);
       s[zc.filename_len] = '\0';
       VLOG(1) << "ZIP_CENT_START_SIG: " << s;
-      files.emplace_back(create_archive_entry(zc, s));
+      auto ae = create_archive_entry(zc, s);
+      // The data follows the local header, whose name and extra field
+      // lengths may differ from the ones here.
+      file.Seek(static_cast<long>(zc.rel_ofs_header), File::Whence::begin);
+      if (zip_local_header zl{}; file.Read(&zl, sizeof(zl)) == sizeof(zl) && zl.signature == ZIP_LOCAL_SIG) {
+        ae.offset = static_cast<int64_t>(zc.rel_ofs_header) + sizeof(zl) + zl.filename_len +
+                    zl.extra_length;
+      }
+      files.emplace_back(ae);
       l += sizeof(zc);
       l += zc.filename_len + zc.extra_len;
     } break;
@@ -232,6 +244,9 @@ static std::optional<std::vector<archive_entry_t>> list_archive_arc(const std::f
     ae.compress_size = a.len;
     ae.uncompress_size = a.size;
     ae.dt = dos2time_t(a.date, a.time);
+    // Types 1 and 2 are stored.
+    ae.method = a.type <= 2 ? archive_method_t::STORED : archive_method_t::UNKNOWN;
+    ae.offset = pos - a.len - 1;
     files.emplace_back(ae);
   }
   return files;
@@ -350,9 +365,12 @@ static std::optional<std::vector<archive_entry_t>> list_archive_lzh(const std::f
 
           uint8_t ext_type = ext[0];
           VLOG(1) << "ext_type: " << ext_type;
+          // The compressed size of a level 1 header includes the extensions.
+          a.comp_size -= ext_size;
           ext_size = ext[ext_size - 1] << 8 | ext[ext_size - 2];
         } while (ext_size != 0);
       }
+      ae.offset = static_cast<int64_t>(file.current_position());
     } else {
       LOG(ERROR) << "Unknown LZH level: " << a.level << " on file: " << path;
       return {files};
@@ -361,6 +379,9 @@ static std::optional<std::vector<archive_entry_t>> list_archive_lzh(const std::f
     ae.compress_size = a.comp_size;
     ae.uncompress_size = a.uncomp_size;
     ae.crc32 = a.checksum;
+    const std::string ctype(a.ctype, sizeof(a.ctype));
+    ae.method = ctype == "-lh0-" || ctype == "-lz4-" ? archive_method_t::STORED
+                                                     : archive_method_t::UNKNOWN;
     files.emplace_back(ae);
   }
   return {files};
@@ -462,9 +483,13 @@ static std::optional<std::vector<archive_entry_t>> list_archive_arj(const std::f
     // We can skip the ext header since arj never used it.
     pos += h.basic_header_size + 4 + 4 + 2;
     if (!file_header) {
-      pos += static_cast<long>(h.compressed_size);
       archive_entry_t ae{};
+      ae.offset = pos;
+      pos += static_cast<long>(h.compressed_size);
       ae.filename = filename;
+      // Method 0 is stored, but not if it's garbled.
+      ae.method = h.method == 0 && !(h.flags & 0x01) ? archive_method_t::STORED
+                                                     : archive_method_t::UNKNOWN;
       ae.compress_size = h.compressed_size;
       ae.uncompress_size = h.original_size;
       ae.crc32 = h.crc32;
@@ -484,7 +509,8 @@ static std::optional<std::vector<archive_entry_t>> list_archive_arj(const std::f
 // Generic Archive
 //
 
-std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::path& path) {
+static std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::path& path,
+                                                                 const std::string& arc_type) {
   struct arc_command {
     const std::string arc_name;
     std::function<std::optional<std::vector<archive_entry_t>>(const std::filesystem::path&)> func;
@@ -497,6 +523,15 @@ std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::
     {"ARJ", list_archive_arj},
   };
 
+  for (const auto& t : arc_t) {
+    if (iequals(arc_type, t.arc_name)) {
+      return t.func(path);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::path& path) {
   if (!path.has_extension()) {
     // no extension?
     return std::nullopt;
@@ -506,12 +541,62 @@ std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::
     // trim leading . for extension
     ext = ext.substr(1);
   }
-  for (const auto& t : arc_t) {
-    if (iequals(ext, t.arc_name)) {
-      return t.func(path);
+  return list_archive(path, ext);
+}
+
+std::optional<std::string> extract_file(const std::filesystem::path& path,
+                                        const std::string& filename, int max_size) {
+  const auto arc_type = determine_arc_extension(path);
+  if (!arc_type) {
+    return std::nullopt;
+  }
+  const auto files = list_archive(path, arc_type.value());
+  if (!files) {
+    return std::nullopt;
+  }
+  const auto it = std::find_if(files->begin(), files->end(),
+                               [&](const auto& f) { return iequals(f.filename, filename); });
+  if (it == files->end()) {
+    return std::nullopt;
+  }
+  const auto& ae = *it;
+  if (ae.method == archive_method_t::UNKNOWN || ae.offset <= 0 || ae.compress_size < 0 ||
+      ae.uncompress_size < 0 || ae.uncompress_size > max_size) {
+    VLOG(1) << "Can't extract " << ae.filename << " from " << path;
+    return std::nullopt;
+  }
+
+  File file(path);
+  if (!file.Open(File::modeBinary | File::modeReadOnly)) {
+    return std::nullopt;
+  }
+  if (ae.offset + ae.compress_size > static_cast<int64_t>(file.length())) {
+    LOG(ERROR) << "Truncated member " << ae.filename << " in " << path;
+    return std::nullopt;
+  }
+  std::string data(ae.compress_size, '\0');
+  file.Seek(static_cast<long>(ae.offset), File::Whence::begin);
+  if (file.Read(data.data(), data.size()) != static_cast<File::size_type>(data.size())) {
+    return std::nullopt;
+  }
+  if (ae.method == archive_method_t::DEFLATED) {
+    auto o = inflate_raw(data.data(), data.size(), ae.uncompress_size);
+    if (!o) {
+      LOG(ERROR) << "Invalid deflate data for " << ae.filename << " in " << path;
+      return std::nullopt;
     }
+    data = std::move(o.value());
   }
-  return std::nullopt;
+  if (data.size() != static_cast<std::string::size_type>(ae.uncompress_size)) {
+    LOG(ERROR) << "Wrong size for " << ae.filename << " in " << path;
+    return std::nullopt;
+  }
+  // ZIP and ARJ use CRC-32; ARC and LZH only have a CRC-16.
+  if ((arc_type == "ZIP" || arc_type == "ARJ") && crc32string(data) != ae.crc32) {
+    LOG(ERROR) << "CRC mismatch for " << ae.filename << " in " << path;
+    return std::nullopt;
+  }
+  return data;
 }
 
 // One thing to note, if an 'arc' is found, it uses pak, and returns that
@@ -31,8 +31,8 @@ namespace wwiv::sdk::files {
 
 enum class archive_method_t {
   UNKNOWN = -1,
-  ZIP_STORED = 0,
-  ZIP_DEFLATED = 1 // 8
+  STORED = 0,
+  DEFLATED = 1 // ZIP method 8
 };
 
 struct archive_entry_t {
@@ -42,6 +42,8 @@ struct archive_entry_t {
   int32_t compress_size;
   int32_t uncompress_size;
   uint32_t crc32;
+  // Offset of the member's (compressed) data within the archive.
+  int64_t offset;
 };
 
 /**
@@ -55,6 +57,18 @@ std::vector<arcrec> read_arcs(const std::string& datadir);
  */
 std::optional<std::vector<archive_entry_t>> list_archive(const std::filesystem::path& path);
 
+/**
+ * Returns the contents of the member named filename (ignoring case) of the
+ * archive at path, without running an external archiver.  Stored and
+ * deflated ZIP members are supported, as are stored members of ARC, LZH
+ * and ARJ files.
+ *
+ * Returns std::nullopt if there is no such member, it uses any other
+ * compression method, it is larger than max_size, or it fails its CRC.
+ */
+std::optional<std::string> extract_file(const std::filesystem::path& path,
+                                        const std::string& filename, int max_size);
+
 /**
  * Returns the arc extension for the file identified by filename or std::nullopt of none
  * could be determined.  The contents of the file are checked first and if there is no
@@ -0,0 +1,138 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/test/file_helper.h"
+#include "sdk/files/arc.h"
+#include <cstdio>
+#include <string>
+
+using namespace wwiv::core::test;
+using namespace wwiv::sdk::files;
+
+// README.TXT (stored) and file_id.diz (deflated), written by Python's zipfile.
+static const std::string kZip(
+    "\x50\x4b\x03\x04\x14\x00\x00\x00\x00\x00\x83\x18\x22\x54\xf3\x86\x35\x87\x06"
+    "\x00\x00\x00\x06\x00\x00\x00\x0a\x00\x00\x00\x52\x45\x41\x44\x4d\x45\x2e\x54"
+    "\x58\x54\x72\x65\x61\x64\x6d\x65\x50\x4b\x03\x04\x14\x00\x00\x00\x08\x00\x83"
+    "\x18\x22\x54\xf9\xb5\xa0\x39\x62\x00\x00\x00\x53\x01\x00\x00\x0b\x00\x00\x00"
+    "\x66\x69\x6c\x65\x5f\x69\x64\x2e\x64\x69\x7a\x0b\x0f\xf7\x0c\x53\x70\x72\x0a"
+    "\x56\x08\xce\x4f\x2b\x29\x4f\x2c\x4a\x55\x28\x33\xd5\xb3\xe0\xe5\xe2\xe5\x0a"
+    "\xc9\x48\x55\x48\x4a\x2d\x2e\x01\xcb\x16\x43\x65\xf5\x14\xc2\x41\x1a\xe0\x04"
+    "\x2f\x97\x4f\x66\x5e\xaa\x42\x49\x46\x51\x6a\xaa\x42\x7e\x1a\x90\x91\xaa\xe0"
+    "\xe2\x19\xa5\x90\x96\x99\x93\xaa\x50\x9e\x59\x92\x01\xd4\x99\x9b\xaa\x90\x9b"
+    "\x0f\x34\xb8\x24\xb5\xa2\x84\x97\x2b\x7c\xd8\x5b\x08\x00\x50\x4b\x01\x02\x14"
+    "\x03\x14\x00\x00\x00\x00\x00\x83\x18\x22\x54\xf3\x86\x35\x87\x06\x00\x00\x00"
+    "\x06\x00\x00\x00\x0a\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x80\x01\x00"
+    "\x00\x00\x00\x52\x45\x41\x44\x4d\x45\x2e\x54\x58\x54\x50\x4b\x01\x02\x14\x03"
+    "\x14\x00\x00\x00\x08\x00\x83\x18\x22\x54\xf9\xb5\xa0\x39\x62\x00\x00\x00\x53"
+    "\x01\x00\x00\x0b\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x80\x01\x2e\x00"
+    "\x00\x00\x66\x69\x6c\x65\x5f\x69\x64\x2e\x64\x69\x7a\x50\x4b\x05\x06\x00\x00"
+    "\x00\x00\x02\x00\x02\x00\x71\x00\x00\x00\xb9\x00\x00\x00\x00\x00",
+    320);
+
+static std::string diz_text() {
+  std::string s;
+  for (auto i = 0; i < 3; i++) {
+    s += "WWIV BBS Software v5.8\r\n\r\nThe best BBS software. WWIV WWIV WWIV\r\n"
+         "Line three of the DIZ file with some more text\r\n";
+  }
+  return s;
+}
+
+class ArcTest : public testing::Test {
+protected:
+  std::filesystem::path CreateBinaryFile(const std::string& name, const std::string& contents) {
+    auto [fp, path] = helper_.OpenTempFile(name);
+    fwrite(contents.data(), 1, contents.size(), fp);
+    fclose(fp);
+    return path;
+  }
+
+  FileHelper helper_;
+};
+
+TEST_F(ArcTest, Zip_Deflated) {
+  const auto path = CreateBinaryFile("test.zip", kZip);
+  EXPECT_EQ(diz_text(), extract_file(path, "FILE_ID.DIZ", 1024).value_or("error"));
+}
+
+TEST_F(ArcTest, Zip_Stored) {
+  const auto path = CreateBinaryFile("test.zip", kZip);
+  EXPECT_EQ("readme", extract_file(path, "readme.txt", 1024).value_or("error"));
+}
+
+TEST_F(ArcTest, Zip_Missing) {
+  const auto path = CreateBinaryFile("test.zip", kZip);
+  EXPECT_FALSE(extract_file(path, "DESC.SDI", 1024).has_value());
+}
+
+TEST_F(ArcTest, Zip_TooBig) {
+  const auto path = CreateBinaryFile("test.zip", kZip);
+  EXPECT_FALSE(extract_file(path, "FILE_ID.DIZ", 100).has_value());
+}
+
+TEST_F(ArcTest, Zip_BadCrc) {
+  auto zip = kZip;
+  // The first byte of README.TXT's data.
+  zip[40] = 'R';
+  const auto path = CreateBinaryFile("test.zip", zip);
+  EXPECT_FALSE(extract_file(path, "README.TXT", 1024).has_value());
+}
+
+TEST_F(ArcTest, Zip_WrongExtension) {
+  // The archive type comes from the contents, not the name.
+  const auto path = CreateBinaryFile("test.lzh", kZip);
+  EXPECT_EQ("readme", extract_file(path, "README.TXT", 1024).value_or("error"));
+}
+
+TEST_F(ArcTest, Arc_Stored) {
+  std::string arc("\x1a\x02" "FILE_ID.DIZ\0\0" "\x05\0\0\0" "\0\0\0\0\0\0" "\x05\0\0\0", 29);
+  arc += "hello";
+  arc += std::string("\x1a\x00", 2);
+  const auto path = CreateBinaryFile("test.arc", arc);
+  EXPECT_EQ("hello", extract_file(path, "file_id.diz", 1024).value_or("error"));
+}
+
+TEST_F(ArcTest, Lzh_Stored) {
+  // Level 0 header: size, checksum, method, sizes, time, date, attr, level.
+  std::string lzh("\x22\x55-lh0-\x05\0\0\0\x05\0\0\0\0\0\0\0\x20\x00", 21);
+  lzh += '\x0b';
+  lzh += "FILE_ID.DIZ";
+  lzh += std::string("\0\0", 2);
+  lzh += "hello";
+  lzh += '\0';
+  const auto path = CreateBinaryFile("test.lzh", lzh);
+  EXPECT_EQ("hello", extract_file(path, "FILE_ID.DIZ", 1024).value_or("error"));
+}
+
+TEST_F(ArcTest, Lzh_Compressed) {
+  std::string lzh("\x22\x55-lh5-\x05\0\0\0\x05\0\0\0\0\0\0\0\x20\x00", 21);
+  lzh += '\x0b';
+  lzh += "FILE_ID.DIZ";
+  lzh += std::string("\0\0", 2);
+  lzh += "hello";
+  lzh += '\0';
+  const auto path = CreateBinaryFile("test.lzh", lzh);
+  EXPECT_FALSE(extract_file(path, "FILE_ID.DIZ", 1024).has_value());
+}
+
+TEST_F(ArcTest, NotAnArchive) {
+  const auto path = CreateBinaryFile("test.txt", "This is not an archive at all");
+  EXPECT_FALSE(extract_file(path, "FILE_ID.DIZ", 1024).has_value());
+}
@@ -34,6 +34,7 @@
 #include "sdk/vardec.h"
 #include "sdk/acs/expr.h"
 #include "sdk/files/dirs_cereal.h"
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -53,17 +54,20 @@ std::ostream& operator<<(std::ostream& os, const sdk::files::directory_t& d) {
 bool Dirs::LoadFromJSON(const std::filesystem::path& dir, const std::string& filename, std::vector<directory_t>& entries) {
   entries.clear();
   JsonFile f(FilePath(dir, filename), "dirs", entries, 1);
+  f.set_use_snapshot(true);
   return f.Load();
 }
 
 //static 
 bool Dirs::SaveToJSON(const std::filesystem::path& dir, const std::string& filename, const std::vector<directory_t>& entries) {
   JsonFile f(FilePath(dir, filename), "dirs", entries, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
 bool Dirs::set_dirs(const std::vector<directory_t>& dirs) {
   dirs_ = dirs;
+  index_valid_ = false;
   return true;
 }
 
@@ -99,6 +103,7 @@ Dirs::Dirs(std::filesystem::path datadir, int max_backups) : datadir_(std::move(
 Dirs::~Dirs() = default;
 
 bool Dirs::Load() {
+  index_valid_ = false;
   if (!LoadFromJSON(datadir_.string(), DIRS_JSON, dirs_)) {
     return LoadLegacy();
   }
@@ -110,6 +115,7 @@ bool Dirs::LoadLegacy() {
   auto old_dirs = read_dirs(datadir_);
 
   dirs_.clear();
+  index_valid_ = false;
   for (auto i = 0; i < wwiv::stl::ssize(old_dirs); i++) {
     const auto& olds = stl::at(old_dirs, i);
     directory_t dir{};
@@ -153,39 +159,84 @@ bool Dirs::Save() {
 }
 
 bool Dirs::insert(int n, directory_t r) {
+  index_valid_ = false;
   return insert_at(dirs_, n, r);
 }
 
 bool Dirs::erase(int n) {
+  index_valid_ = false;
   return erase_at(dirs_, n);
 }
 
-const directory_t& Dirs::dir(const std::string& filename) const {
-  for (const auto& n : dirs_) {
-    if (iequals(filename, n.filename)) {
-      return n;
+static std::string area_tag_index_key(const std::string& area_tag, const core::uuid_t& net_uuid) {
+  return StrCat(net_uuid.to_string(), ":", area_tag);
+}
+
+void Dirs::Reindex() const {
+  filename_index_.clear();
+  area_tag_index_.clear();
+  for (auto i = 0; i < size_int(dirs_); i++) {
+    const auto& d = dirs_[i];
+    filename_index_.add(d.filename, i);
+    for (const auto& t : d.area_tags) {
+      area_tag_index_.add(area_tag_index_key(t.area_tag, t.net_uuid), i);
     }
   }
+  index_valid_ = true;
+}
+
+std::optional<int> Dirs::dir_number(const std::string& filename) const {
+  if (!index_valid_) {
+    Reindex();
+  }
+  auto o = filename_index_.find(filename);
+  if (o && !iequals(filename, dirs_[o.value()].filename)) {
+    // A directory was renamed through a reference since the index was built.
+    Reindex();
+    o = filename_index_.find(filename);
+  }
+  return o;
+}
+
+static bool carries_area(const directory_t& dir, const std::string& area_tag,
+                         const core::uuid_t& net_uuid) {
+  return std::any_of(dir.area_tags.begin(), dir.area_tags.end(), [&](const dir_area_t& t) {
+    return t.net_uuid == net_uuid && iequals(area_tag, t.area_tag);
+  });
+}
+
+std::optional<int> Dirs::dir_number(const std::string& area_tag,
+                                    const core::uuid_t& net_uuid) const {
+  if (!index_valid_) {
+    Reindex();
+  }
+  const auto key = area_tag_index_key(area_tag, net_uuid);
+  auto o = area_tag_index_.find(key);
+  if (o && !carries_area(dirs_[o.value()], area_tag, net_uuid)) {
+    Reindex();
+    o = area_tag_index_.find(key);
+  }
+  return o;
+}
+
+const directory_t& Dirs::dir(const std::string& filename) const {
+  if (const auto o = dir_number(filename)) {
+    return dirs_[o.value()];
+  }
   throw std::out_of_range(StrCat("Unable to find dir of filename: ", filename));
 }
 
 directory_t& Dirs::dir(const std::string& filename) {
-  for (auto& n : dirs_) {
-    if (iequals(filename, n.filename)) {
-      return n;
-    }
+  if (const auto o = dir_number(filename)) {
+    // The caller may rename the directory through the reference.
+    index_valid_ = false;
+    return dirs_[o.value()];
   }
   throw std::out_of_range(StrCat("Unable to find dir of filename: ", filename));
 }
 
 bool Dirs::exists(const std::string& filename) const {
-  for (const auto& n : dirs_) {
-    if (iequals(filename, n.filename)) {
-      return true;
-    }
-  }
-
-  return false;
+  return dir_number(filename).has_value();
 }
 
 }
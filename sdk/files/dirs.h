@@ -23,7 +23,9 @@
 #include "core/stl.h"
 #include "core/uuid.h"
 #include "sdk/conf/conf_set.h"
+#include "sdk/name_index.h"
 #include <filesystem>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -93,7 +95,11 @@ public:
 
   [[nodiscard]] const directory_t& dir(std::size_t n) const { return stl::at(dirs_, n); }
   [[nodiscard]] const directory_t& dir(const std::string& filename) const;
-  directory_t& dir(std::size_t n) { return dirs_[n]; }
+  directory_t& dir(std::size_t n) {
+    // The caller may rename the directory through the reference.
+    index_valid_ = false;
+    return dirs_[n];
+  }
   directory_t& dir(const std::string& filename);
 
   const directory_t& operator[](std::size_t n) const { return dir(n); }
@@ -103,7 +109,20 @@ public:
 
   [[nodiscard]] bool exists(const std::string& filename) const;
 
-  void set_dir(int n, directory_t s) { dirs_[n] = std::move(s); }
+  /** Returns the number of the directory with filename. */
+  [[nodiscard]] std::optional<int> dir_number(const std::string& filename) const;
+
+  /**
+   * Returns the number of the first directory carrying the FTN file echo
+   * area_tag on the network with net_uuid.
+   */
+  [[nodiscard]] std::optional<int> dir_number(const std::string& area_tag,
+                                              const core::uuid_t& net_uuid) const;
+
+  void set_dir(int n, directory_t s) {
+    dirs_[n] = std::move(s);
+    index_valid_ = false;
+  }
   [[nodiscard]] const std::vector<directory_t>& dirs() const { return dirs_; }
   bool insert(int n, directory_t r);
   bool erase(int n);
@@ -118,6 +137,12 @@ private:
   const std::filesystem::path datadir_;
   const int max_backups_;
   std::vector<directory_t> dirs_;
+
+  void Reindex() const;
+  // Lazily rebuilt by lookups after dirs_ has changed.
+  mutable NameIndex filename_index_;
+  mutable NameIndex area_tag_index_;
+  mutable bool index_valid_{false};
 };
 
 }
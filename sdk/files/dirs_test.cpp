@@ -90,4 +90,38 @@ TEST_F(DirsTest, Smoke) {
     EXPECT_STREQ(d1["filename"].GetString(), "SYSOP");
   }
 
-}
\ No newline at end of file
+}
+
+TEST_F(DirsTest, DirNumber) {
+  files::directory_t d1{};
+  d1.filename = "SYSOP";
+  files::directory_t d2{};
+  d2.filename = "UPLOADS";
+  files::Dirs dirs(helper.files_.TempDir(), 0);
+  ASSERT_TRUE(dirs.set_dirs({d1, d2}));
+
+  EXPECT_EQ(1, dirs.dir_number("uploads").value_or(-1));
+  EXPECT_TRUE(dirs.exists("Sysop"));
+  EXPECT_FALSE(dirs.exists("OTHER"));
+
+  dirs.dir(1).filename = "OTHER";
+  EXPECT_FALSE(dirs.exists("UPLOADS"));
+  EXPECT_EQ("OTHER", dirs.dir("other").filename);
+}
+
+TEST_F(DirsTest, DirNumber_AreaTag) {
+  const auto net1 = wwiv::core::uuid_t::from_string("8e8db44a-d8d4-4d79-9b2c-fb7f67f8d1ee").value();
+  const auto net2 = wwiv::core::uuid_t::from_string("1b4e28ba-2fa1-11d2-883f-0016d3cca427").value();
+  files::directory_t d1{};
+  d1.filename = "D1";
+  d1.area_tags.push_back({"NODELIST", net1});
+  files::directory_t d2{};
+  d2.filename = "D2";
+  d2.area_tags.push_back({"NODELIST", net2});
+  files::Dirs dirs(helper.files_.TempDir(), 0);
+  ASSERT_TRUE(dirs.set_dirs({d1, d2}));
+
+  EXPECT_EQ(0, dirs.dir_number("nodelist", net1).value_or(-1));
+  EXPECT_EQ(1, dirs.dir_number("NODELIST", net2).value_or(-1));
+  EXPECT_FALSE(dirs.dir_number("OTHER", net1).has_value());
+}
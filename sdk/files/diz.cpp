@@ -63,10 +63,34 @@ std::optional<wwiv::sdk::files::Diz> wwiv::sdk::files::DizParser::parse(
     return std::nullopt;
   }
 
+  TextFile file(path, "rt");
+  return parse_lines(file.ReadFileIntoVector());
+}
+
+std::optional<wwiv::sdk::files::Diz>
+wwiv::sdk::files::DizParser::parse_text(const std::string& text) const {
+  // Split the same way TextFile::ReadFileIntoVector does.
+  std::vector<std::string> lines;
+  std::string::size_type start = 0;
+  while (start < text.size()) {
+    auto end = text.find('\n', start);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    auto line = text.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    lines.emplace_back(std::move(line));
+    start = end + 1;
+  }
+  return parse_lines(lines);
+}
+
+std::optional<wwiv::sdk::files::Diz>
+wwiv::sdk::files::DizParser::parse_lines(const std::vector<std::string>& lines) const {
   std::string description;
 
-  TextFile file(path, "rt");
-  auto lines = file.ReadFileIntoVector();
   auto iter = std::begin(lines);
   const auto end = std::end(lines);
   while (iter != end && iter->empty()) {
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace wwiv::sdk::files {
 
@@ -39,12 +40,19 @@ private:
 
 class DizParser final {
 public:
+  // The largest DIZ that will be read out of an archive.
+  static constexpr int MAX_SIZE = 64 * 1024;
+
   explicit DizParser(bool firstline_as_desc);
   DizParser() = delete;
   ~DizParser() = default;
 
   [[nodiscard]] std::optional<Diz> parse(const std::filesystem::path& path) const;
+  /** Parses the contents of a DIZ, such as one extracted from an archive. */
+  [[nodiscard]] std::optional<Diz> parse_text(const std::string& text) const;
 private:
+  [[nodiscard]] std::optional<Diz> parse_lines(const std::vector<std::string>& lines) const;
+
   bool firstline_as_desc_;
 };
 
@@ -112,6 +112,16 @@ TEST_F(DizTest, EmptyLinesAtStart) {
   EXPECT_EQ(d.description(), "<<< null e-magazine x00A (exec edition) >>>");
 }
 
+TEST_F(DizTest, ParseText) {
+  wwiv::sdk::files::DizParser p(true);
+  auto o = p.parse_text("\r\nLine1\r\nLine2\r\n\r\nLine3\r\n");
+  ASSERT_TRUE(o);
+
+  auto d = o.value();
+  EXPECT_EQ(d.description(), "Line1");
+  EXPECT_EQ(d.extended_description(), "Line2\n\nLine3\n");
+}
+
 /**
 
 
@@ -236,6 +236,26 @@ bool FileArea::AddFile(const FileRecord& f) {
   return true;
 }
 
+bool FileArea::AddFiles(const std::vector<FileRecord>& files) {
+  if (files.empty()) {
+    return true;
+  }
+  // AddFile puts each new file first, so the last one added ends up on top.
+  std::vector<uploadsrec> u;
+  u.reserve(files.size());
+  auto daten = header_->daten();
+  for (auto it = files.rbegin(); it != files.rend(); ++it) {
+    u.push_back(it->u());
+    daten = std::max(daten, it->u().daten);
+  }
+  const auto pos = files_.empty() ? std::end(files_) : std::begin(files_) + 1;
+  files_.insert(pos, std::begin(u), std::end(u));
+  header_->set_num_files(stl::size_uint32(files_) - 1);
+  header_->set_daten(daten);
+  dirty_ = true;
+  return true;
+}
+
 bool FileArea::AddFile(FileRecord& f, const std::string& ext_desc) {
   f.set_extended_description(!ext_desc.empty());
   if (!AddFile(f)) {
@@ -130,6 +130,9 @@ public:
 
   FileRecord ReadFile(int num);
   bool AddFile(const FileRecord& f);
+  // Adds all of files with a single insert, leaving them in the same place
+  // and order as calling AddFile for each of them would.
+  bool AddFiles(const std::vector<FileRecord>& files);
   bool AddFile(FileRecord& f, const std::string& ext_desc);
   bool UpdateFile(FileRecord& f, int num);
   bool UpdateFile(FileRecord& f, int num, const std::string& ext_desc);
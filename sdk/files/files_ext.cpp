@@ -24,8 +24,10 @@
 #include "sdk/files/files.h"
 #include "sdk/vardec.h"
 #include <algorithm>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -95,11 +97,21 @@ bool FileAreaExtendedDesc::AddExtended(const FileRecord& f, const std::string& t
 }
 
 bool FileAreaExtendedDesc::AddExtended(const std::string& file_name, const std::string& text) {
+  return AddExtended(std::vector<std::pair<std::string, std::string>>{{file_name, text}});
+}
+
+bool FileAreaExtendedDesc::AddExtended(
+    const std::vector<std::pair<std::string, std::string>>& descs) {
   Close();
 
-  ext_desc_type ed{};
-  to_char_array(ed.name, file_name);
-  ed.len = static_cast<int16_t>(text.size());
+  std::string data;
+  for (const auto& [file_name, text] : descs) {
+    ext_desc_type ed{};
+    to_char_array(ed.name, file_name);
+    ed.len = static_cast<int16_t>(text.size());
+    data.append(reinterpret_cast<const char*>(&ed), sizeof(ext_desc_type));
+    data.append(text);
+  }
 
   {
     File file(path());
@@ -107,8 +119,7 @@ bool FileAreaExtendedDesc::AddExtended(const std::string& file_name, const std::
       return false;
     }
     file.Seek(0L, File::Whence::end);
-    file.Write(&ed, sizeof(ext_desc_type));
-    file.Write(text.c_str(), ed.len);
+    file.Write(data.data(), data.size());
     file.Close();
   }
   return Close();
@@ -120,6 +131,11 @@ bool FileAreaExtendedDesc::DeleteExtended(const FileRecord& f) {
 }
 
 bool FileAreaExtendedDesc::DeleteExtended(const std::string& file_name) {
+  return DeleteExtended(std::vector<std::string>{file_name});
+}
+
+bool FileAreaExtendedDesc::DeleteExtended(const std::vector<std::string>& file_names) {
+  const std::set<std::string> names(std::begin(file_names), std::end(file_names));
 
   ext_desc_type ed{};
 
@@ -136,7 +152,7 @@ bool FileAreaExtendedDesc::DeleteExtended(const std::string& file_name) {
       std::string ss;
       ss.resize(ed.len);
       file.Read(&ss[0], ed.len);
-      if (file_name != ed.name) {
+      if (!wwiv::stl::contains(names, ed.name)) {
         if (r != w) {
           file.Seek(w, File::Whence::begin);
           file.Write(&ed, sizeof(ext_desc_type));
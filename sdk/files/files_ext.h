@@ -23,6 +23,7 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace wwiv::sdk::files {
@@ -51,8 +52,12 @@ public:
   // File specific
   bool AddExtended(const FileRecord& f, const std::string& text);
   bool AddExtended(const std::string& file_name, const std::string& text);
+  // Appends all of descs ({file_name, text}) with a single write.
+  bool AddExtended(const std::vector<std::pair<std::string, std::string>>& descs);
   bool DeleteExtended(const FileRecord& f);
   bool DeleteExtended(const std::string& file_name);
+  // Removes the descriptions for all of file_names in one pass over the file.
+  bool DeleteExtended(const std::vector<std::string>& file_names);
   std::optional<std::string> ReadExtended(const FileRecord& f);
   std::optional<std::string> ReadExtended(const std::string& file_name);
   std::optional<std::vector<std::string>> ReadExtendedAsLines(const FileRecord& f);
@@ -138,6 +138,21 @@ TEST_F(FilesTest, Add_Order) {
   EXPECT_EQ(area->ReadFile(2).aligned_filename(), "FILE0001.ZIP");
 }
 
+TEST_F(FilesTest, AddFiles) {
+  const string name = test_info_->name();
+  FileRecord f1{ul("FILE0001.ZIP", "", 1234)};
+  FileRecord f2{ul("FILE0002.ZIP", "", 1234)};
+  FileRecord f3{ul("FILE0003.ZIP", "", 1234)};
+  auto area = api_helper_.CreateAndPopulate(name, {f1});
+  ASSERT_TRUE(area->AddFiles({f2, f3}));
+  ASSERT_EQ(3, area->number_of_files());
+
+  // Same order as adding them one at a time.
+  EXPECT_EQ(area->ReadFile(1).aligned_filename(), "FILE0003.ZIP");
+  EXPECT_EQ(area->ReadFile(2).aligned_filename(), "FILE0002.ZIP");
+  EXPECT_EQ(area->ReadFile(3).aligned_filename(), "FILE0001.ZIP");
+}
+
 
 TEST_F(FilesTest, Add_Sort_FileName_Asc) {
   const string name = test_info_->name();
@@ -275,6 +290,26 @@ TEST_F(FilesTest, DeleteExtendedDescription) {
   EXPECT_FALSE(area->ext_desc().value()->ReadExtended(f1).has_value());
 }
 
+TEST_F(FilesTest, ExtendedDescription_Batch) {
+  const string name = test_info_->name();
+  FileRecord f1{ul("FILE0001.ZIP", "", 1234)};
+  FileRecord f2{ul("FILE0002.ZIP", "", 1234)};
+  FileRecord f3{ul("FILE0003.ZIP", "", 1234)};
+  auto area = api_helper_.CreateAndPopulate(name, {f1, f2, f3});
+  auto* ext = area->ext_desc().value();
+
+  ASSERT_TRUE(ext->AddExtended(std::vector<std::pair<std::string, std::string>>{
+      {f1.aligned_filename(), "One"}, {f2.aligned_filename(), "Two"},
+      {f3.aligned_filename(), "Three"}}));
+  EXPECT_EQ("Two", ext->ReadExtended(f2).value());
+
+  ASSERT_TRUE(ext->DeleteExtended(std::vector<std::string>{f1.aligned_filename(),
+                                                           f3.aligned_filename()}));
+  EXPECT_FALSE(ext->ReadExtended(f1).has_value());
+  EXPECT_EQ("Two", ext->ReadExtended(f2).value());
+  EXPECT_FALSE(ext->ReadExtended(f3).has_value());
+}
+
 TEST_F(FilesTest, FindFile) {
   const string name = test_info_->name();
   const auto now = DateTime::now().to_daten_t();
@@ -0,0 +1,323 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/files/inflate.h"
+
+#include <cstdint>
+#include <utility>
+
+// A small canonical Huffman inflater, in the style of zlib's puff.c.  It
+// decodes one bit at a time, which is plenty for the descriptions and other
+// small members it is used to pull out of archives.
+
+namespace wwiv::sdk::files {
+
+static constexpr int MAX_BITS = 15;
+static constexpr int MAX_LITERAL_CODES = 286;
+static constexpr int MAX_DIST_CODES = 30;
+static constexpr int FIXED_LITERAL_CODES = 288;
+
+static constexpr uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                             15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                             67, 83, 99, 115, 131, 163, 195, 227, 258};
+static constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                             2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static constexpr uint16_t DIST_BASE[30] = {1,    2,    3,    4,    5,    7,     9,     13,
+                                           17,   25,   33,   49,   65,   97,    129,   193,
+                                           257,  385,  513,  769,  1025, 1537,  2049,  3073,
+                                           4097, 6145, 8193, 12289, 16385, 24577};
+static constexpr uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Order of the code length code lengths in a dynamic block header.
+static constexpr uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                                  11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+class BitReader {
+public:
+  BitReader(const uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+  /** Returns the next n bits, LSB first.  Sets error() if there aren't enough. */
+  int bits(int n) {
+    auto v = bitbuf_;
+    while (bitcnt_ < n) {
+      if (pos_ >= size_) {
+        error_ = true;
+        return 0;
+      }
+      v |= static_cast<uint32_t>(data_[pos_++]) << bitcnt_;
+      bitcnt_ += 8;
+    }
+    bitbuf_ = v >> n;
+    bitcnt_ -= n;
+    return static_cast<int>(v & ((1u << n) - 1));
+  }
+
+  /** Discards the bits left in the current byte. */
+  void align() {
+    bitbuf_ = 0;
+    bitcnt_ = 0;
+  }
+
+  [[nodiscard]] const uint8_t* current() const noexcept { return data_ + pos_; }
+  [[nodiscard]] std::size_t remaining() const noexcept { return size_ - pos_; }
+  void skip(std::size_t n) noexcept { pos_ += n; }
+  [[nodiscard]] bool error() const noexcept { return error_; }
+
+private:
+  const uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_{0};
+  uint32_t bitbuf_{0};
+  int bitcnt_{0};
+  bool error_{false};
+};
+
+struct huffman_t {
+  // Number of codes of each length.
+  uint16_t count[MAX_BITS + 1];
+  // Symbols ordered by their code.
+  uint16_t symbol[FIXED_LITERAL_CODES];
+};
+
+/**
+ * Builds h from the code lengths.  Returns false if the lengths are
+ * over-subscribed.  Incomplete codes are allowed, since a block with a single
+ * distance code has one.
+ */
+static bool build(huffman_t& h, const uint8_t* length, int n) {
+  for (auto& c : h.count) {
+    c = 0;
+  }
+  for (auto i = 0; i < n; i++) {
+    h.count[length[i]]++;
+  }
+  if (h.count[0] == n) {
+    return true;
+  }
+  auto left = 1;
+  for (auto len = 1; len <= MAX_BITS; len++) {
+    left <<= 1;
+    left -= h.count[len];
+    if (left < 0) {
+      return false;
+    }
+  }
+  uint16_t offs[MAX_BITS + 1];
+  offs[1] = 0;
+  for (auto len = 1; len < MAX_BITS; len++) {
+    offs[len + 1] = static_cast<uint16_t>(offs[len] + h.count[len]);
+  }
+  for (auto i = 0; i < n; i++) {
+    if (length[i] != 0) {
+      h.symbol[offs[length[i]]++] = static_cast<uint16_t>(i);
+    }
+  }
+  return true;
+}
+
+/** Decodes one symbol, or returns -1 on invalid input. */
+static int decode(BitReader& in, const huffman_t& h) {
+  auto code = 0;
+  auto first = 0;
+  auto index = 0;
+  for (auto len = 1; len <= MAX_BITS; len++) {
+    code |= in.bits(1);
+    if (in.error()) {
+      return -1;
+    }
+    const auto count = h.count[len];
+    if (code - count < first) {
+      return h.symbol[index + (code - first)];
+    }
+    index += count;
+    first += count;
+    first <<= 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+static bool codes(BitReader& in, std::string& out, std::size_t max_size, const huffman_t& lencode,
+                  const huffman_t& distcode) {
+  for (;;) {
+    auto symbol = decode(in, lencode);
+    if (symbol < 0) {
+      return false;
+    }
+    if (symbol < 256) {
+      if (out.size() >= max_size) {
+        return false;
+      }
+      out.push_back(static_cast<char>(symbol));
+      continue;
+    }
+    if (symbol == 256) {
+      return true;
+    }
+    symbol -= 257;
+    if (symbol >= 29) {
+      return false;
+    }
+    const auto len = LENGTH_BASE[symbol] + in.bits(LENGTH_EXTRA[symbol]);
+    symbol = decode(in, distcode);
+    if (symbol < 0 || symbol >= MAX_DIST_CODES) {
+      return false;
+    }
+    const auto dist = static_cast<std::size_t>(DIST_BASE[symbol] + in.bits(DIST_EXTRA[symbol]));
+    if (in.error() || dist > out.size() || out.size() + len > max_size) {
+      return false;
+    }
+    // The copy may overlap what it is writing, so go a byte at a time.
+    auto from = out.size() - dist;
+    for (auto i = 0; i < len; i++) {
+      out.push_back(out[from++]);
+    }
+  }
+}
+
+static bool stored(BitReader& in, std::string& out, std::size_t max_size) {
+  in.align();
+  if (in.remaining() < 4) {
+    return false;
+  }
+  const auto* p = in.current();
+  const auto len = static_cast<std::size_t>(p[0] | (p[1] << 8));
+  const auto nlen = static_cast<std::size_t>(p[2] | (p[3] << 8));
+  in.skip(4);
+  if (len != (~nlen & 0xffff) || len > in.remaining() || out.size() + len > max_size) {
+    return false;
+  }
+  out.append(reinterpret_cast<const char*>(in.current()), len);
+  in.skip(len);
+  return true;
+}
+
+static bool fixed(BitReader& in, std::string& out, std::size_t max_size) {
+  static const auto tables = [] {
+    std::pair<huffman_t, huffman_t> t{};
+    uint8_t lengths[FIXED_LITERAL_CODES];
+    auto i = 0;
+    for (; i < 144; i++) {
+      lengths[i] = 8;
+    }
+    for (; i < 256; i++) {
+      lengths[i] = 9;
+    }
+    for (; i < 280; i++) {
+      lengths[i] = 7;
+    }
+    for (; i < FIXED_LITERAL_CODES; i++) {
+      lengths[i] = 8;
+    }
+    build(t.first, lengths, FIXED_LITERAL_CODES);
+    for (i = 0; i < MAX_DIST_CODES; i++) {
+      lengths[i] = 5;
+    }
+    build(t.second, lengths, MAX_DIST_CODES);
+    return t;
+  }();
+  return codes(in, out, max_size, tables.first, tables.second);
+}
+
+static bool dynamic(BitReader& in, std::string& out, std::size_t max_size) {
+  const auto nlen = in.bits(5) + 257;
+  const auto ndist = in.bits(5) + 1;
+  const auto ncode = in.bits(4) + 4;
+  if (in.error() || nlen > MAX_LITERAL_CODES || ndist > MAX_DIST_CODES) {
+    return false;
+  }
+  uint8_t lengths[MAX_LITERAL_CODES + MAX_DIST_CODES]{};
+  for (auto i = 0; i < ncode; i++) {
+    lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(in.bits(3));
+  }
+  huffman_t lencode{};
+  if (in.error() || !build(lencode, lengths, 19)) {
+    return false;
+  }
+
+  for (auto i = 0; i < nlen + ndist;) {
+    const auto symbol = decode(in, lencode);
+    if (symbol < 0) {
+      return false;
+    }
+    if (symbol < 16) {
+      lengths[i++] = static_cast<uint8_t>(symbol);
+      continue;
+    }
+    uint8_t len = 0;
+    int repeat;
+    if (symbol == 16) {
+      if (i == 0) {
+        return false;
+      }
+      len = lengths[i - 1];
+      repeat = 3 + in.bits(2);
+    } else if (symbol == 17) {
+      repeat = 3 + in.bits(3);
+    } else {
+      repeat = 11 + in.bits(7);
+    }
+    if (in.error() || i + repeat > nlen + ndist) {
+      return false;
+    }
+    while (repeat--) {
+      lengths[i++] = len;
+    }
+  }
+  if (lengths[256] == 0) {
+    // No end of block code.
+    return false;
+  }
+  huffman_t distcode{};
+  if (!build(lencode, lengths, nlen) || !build(distcode, lengths + nlen, ndist)) {
+    return false;
+  }
+  return codes(in, out, max_size, lencode, distcode);
+}
+
+std::optional<std::string> inflate_raw(const void* data, std::size_t size, std::size_t max_size) {
+  BitReader in(static_cast<const uint8_t*>(data), size);
+  std::string out;
+  for (auto last = 0; !last;) {
+    last = in.bits(1);
+    const auto type = in.bits(2);
+    if (in.error()) {
+      return std::nullopt;
+    }
+    bool ok;
+    switch (type) {
+    case 0:
+      ok = stored(in, out, max_size);
+      break;
+    case 1:
+      ok = fixed(in, out, max_size);
+      break;
+    case 2:
+      ok = dynamic(in, out, max_size);
+      break;
+    default:
+      ok = false;
+      break;
+    }
+    if (!ok) {
+      return std::nullopt;
+    }
+  }
+  return out;
+}
+
+} // namespace wwiv::sdk::files
@@ -0,0 +1,37 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_FILES_INFLATE_H
+#define INCLUDED_SDK_FILES_INFLATE_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace wwiv::sdk::files {
+
+/**
+ * Decompresses raw deflate data (RFC 1951), which is how ZIP files store
+ * deflated members.  Returns std::nullopt if the data is invalid, or if it
+ * would inflate to more than max_size bytes.
+ */
+[[nodiscard]] std::optional<std::string> inflate_raw(const void* data, std::size_t size,
+                                                     std::size_t max_size);
+
+} // namespace wwiv::sdk::files
+
+#endif
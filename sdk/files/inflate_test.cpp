@@ -0,0 +1,65 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "sdk/files/inflate.h"
+#include <string>
+
+using namespace wwiv::sdk::files;
+
+static std::optional<std::string> inflate_str(const std::string& data, std::size_t max_size = 1024) {
+  return inflate_raw(data.data(), data.size(), max_size);
+}
+
+TEST(InflateTest, Stored) {
+  const std::string data("\x01\x03\x00\xfc\xff\x61\x62\x63", 8);
+  EXPECT_EQ("abc", inflate_str(data).value_or("error"));
+}
+
+TEST(InflateTest, Fixed) {
+  // Includes a copy that overlaps itself.
+  const std::string data("\xcb\x48\xcd\xc9\xc9\x57\xc8\xc0\x20\xcb\xf3\x8b\x72\x52\xb8\x00", 16);
+  EXPECT_EQ("hello hello hello hello world\n", inflate_str(data).value_or("error"));
+}
+
+TEST(InflateTest, Dynamic) {
+  const std::string data("\x1d\x8a\xb1\x11\x00\x30\x10\x82\x7a\xb7\x44\xdd\x7f\x86\xf8\x91\x4a"
+                         "\x0e\x30\xaa\x02\x22\xa1\x66\x62\xcb\xa0\xba\x33\x97\xb3\x0e\xf6\xca"
+                         "\x1f\xda\xf4\x01",
+                         38);
+  EXPECT_EQ("aaba\nd\ncaa\naccadbaabaaaacacaad\nabaadbacaababcabb\nca\naccabbad",
+            inflate_str(data).value_or("error"));
+}
+
+TEST(InflateTest, TooBig) {
+  const std::string data("\xcb\x48\xcd\xc9\xc9\x57\xc8\xc0\x20\xcb\xf3\x8b\x72\x52\xb8\x00", 16);
+  EXPECT_FALSE(inflate_str(data, 10).has_value());
+}
+
+TEST(InflateTest, Truncated) {
+  const std::string data("\xcb\x48\xcd\xc9\xc9\x57\xc8\xc0", 8);
+  EXPECT_FALSE(inflate_str(data).has_value());
+}
+
+TEST(InflateTest, InvalidBlockType) {
+  EXPECT_FALSE(inflate_str("\x07").has_value());
+}
+
+TEST(InflateTest, Empty) {
+  EXPECT_FALSE(inflate_str("").has_value());
+}
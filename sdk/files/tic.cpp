@@ -19,14 +19,23 @@
 
 #include "core/crc32.h"
 #include "core/log.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "core/textfile.h"
 #include "fmt/printf.h"
+#include "sdk/filenames.h"
+#include "sdk/files/arc.h"
 #include "sdk/files/dirs.h"
+#include "sdk/files/diz.h"
+#include "sdk/files/files.h"
 #include "sdk/net/net.h"
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,7 +96,7 @@ core::DateTime Tic::date() const {
 }
 
 std::filesystem::path Tic::fpath() const {
-  auto fp = FilePath(path_.parent_path(), file);
+  auto fp = ::FilePath(path_.parent_path(), file);
   return fp;
 }
 
@@ -105,7 +114,7 @@ static std::tuple<std::string, std::string, bool> split_tic_line(const std::stri
 }
 
 std::optional<Tic> TicParser::parse(const std::string& filename) const {
-  TextFile f(FilePath(dir_, filename), "rt");
+  TextFile f(::FilePath(dir_, filename), "rt");
   if (!f) {
     return std::nullopt;
   }
@@ -114,7 +123,7 @@ std::optional<Tic> TicParser::parse(const std::string& filename) const {
 }
 
 std::optional<Tic> TicParser::parse(const std::string& filename, const std::vector<std::string>& lines) const {
-  const auto p = FilePath(dir_, filename);
+  const auto p = ::FilePath(dir_, filename);
   Tic t(p);
 
   for (const auto& l : lines) {
@@ -181,20 +190,156 @@ std::optional<Tic> TicParser::parse(const std::string& filename, const std::vect
 
 std::optional<directory_t> FindFileAreaForTic(const files::Dirs& dirs, const Tic& tic,
                                               const Network& net) {
-  const auto area_tag = tic.area;
-  for (const auto& d : dirs.dirs()) {
-    for (const auto& dt : d.area_tags) {
-      VLOG(3) << "Checking area: '" << dt.area_tag << "'";
-      if (iequals(area_tag, dt.area_tag)) {
-        VLOG(3) << "Found matching area, checking UUID for area: '" << dt.net_uuid << "'";
-        if (dt.net_uuid == net.uuid) {
-          return {d};
-        }
-        VLOG(1) << "UUID didn't match: [dir] " << dt.net_uuid << " != [net]:  " << net.uuid;
+  if (const auto o = dirs.dir_number(tic.area, net.uuid)) {
+    return {dirs.dir(o.value())};
+  }
+  VLOG(1) << "No area with tag: '" << tic.area << "' on network: " << net.name;
+  return std::nullopt;
+}
+
+// Uses the FILE_ID.DIZ in the file, if it has one, for the long description.
+static void add_diz_description(Tic& tic) {
+  const auto text = extract_file(tic.fpath(), FILE_ID_DIZ, DizParser::MAX_SIZE);
+  if (!text) {
+    return;
+  }
+  const DizParser parser(tic.desc.empty());
+  const auto diz = parser.parse_text(text.value());
+  if (!diz) {
+    return;
+  }
+  if (tic.desc.empty()) {
+    tic.desc = diz->description();
+  }
+  tic.ldesc = SplitString(diz->extended_description(), "\n", false);
+  while (!tic.ldesc.empty() && StringTrim(tic.ldesc.back()).empty()) {
+    tic.ldesc.pop_back();
+  }
+}
+
+std::vector<parsed_tic_t> ParseTics(const TicParser& parser,
+                                    const std::vector<std::string>& tic_filenames, int jobs) {
+  std::vector<parsed_tic_t> tics;
+  tics.reserve(tic_filenames.size());
+  for (const auto& name : tic_filenames) {
+    if (auto o = parser.parse(name)) {
+      tics.push_back(parsed_tic_t{name, std::move(o.value()), false});
+    }
+  }
+
+  std::atomic<std::size_t> next{0};
+  auto validate = [&] {
+    for (auto i = next++; i < tics.size(); i = next++) {
+      tics[i].valid = tics[i].tic.IsValid();
+      if (tics[i].valid && tics[i].tic.ldesc.empty()) {
+        add_diz_description(tics[i].tic);
       }
     }
+  };
+  const auto num_jobs = std::max(1, std::min(jobs, wwiv::stl::size_int(tics)));
+  if (num_jobs == 1) {
+    validate();
+    return tics;
   }
-  return std::nullopt;
+  std::vector<std::thread> validators;
+  for (auto i = 0; i < num_jobs; i++) {
+    validators.emplace_back(validate);
+  }
+  for (auto& t : validators) {
+    t.join();
+  }
+  return tics;
+}
+
+std::map<int, std::vector<parsed_tic_t>>
+GroupTicsByArea(const std::vector<parsed_tic_t>& tics, const files::Dirs& dirs,
+                const Network& net) {
+  std::map<int, std::vector<parsed_tic_t>> areas;
+  for (const auto& t : tics) {
+    if (!t.valid) {
+      continue;
+    }
+    const auto o = dirs.dir_number(t.tic.area, net.uuid);
+    if (!o) {
+      LOG(ERROR) << "Unable to find AREA_TAG for tic file: TAG: " << t.tic.area
+                 << "; file; " << t.tic_filename;
+      continue;
+    }
+    areas[o.value()].push_back(t);
+  }
+  return areas;
+}
+
+FileRecord ToFileRecord(const Tic& tic) {
+  const FileName fn(tic.file);
+  FileRecord r;
+  r.set_filename(fn);
+  r.set_description(tic.desc);
+  r.set_extended_description(!tic.ldesc.empty());
+  r.set_numbytes(tic.size());
+  r.set_date(tic.date());
+  r.set_uploaded_by("WWIV Tic Processor");
+  r.set_actual_date(DateTime::from_time_t(File::last_write_time(tic.fpath())));
+  return r;
+}
+
+std::optional<tic_import_result_t> ImportTics(FileArea& area,
+                                              const std::vector<parsed_tic_t>& tics) {
+  // Index the files already in the area once rather than scanning it per file.
+  std::unordered_map<std::string, int> existing;
+  const auto& raw = area.raw_files();
+  for (auto i = 1; i < wwiv::stl::ssize(raw); i++) {
+    existing.emplace(raw[i].filename, i);
+  }
+
+  tic_import_result_t result{};
+  std::vector<FileRecord> added;
+  std::unordered_map<std::string, std::size_t> added_index;
+  // Keyed by aligned file name, so a file in more than one tic gets the last one.
+  std::map<std::string, std::string> ext_descs;
+  for (const auto& t : tics) {
+    auto r = ToFileRecord(t.tic);
+    const auto name = r.aligned_filename();
+    if (const auto it = existing.find(name); it != std::end(existing)) {
+      LOG(INFO) << "** Updating: " << r;
+      area.UpdateFile(r, it->second);
+      ++result.updated;
+    } else if (const auto ait = added_index.find(name); ait != std::end(added_index)) {
+      LOG(INFO) << "** Replacing: " << r;
+      added.at(ait->second) = r;
+    } else {
+      LOG(INFO) << "** Adding  : " << r;
+      added_index.emplace(name, added.size());
+      added.push_back(r);
+      ++result.added;
+    }
+    if (!t.tic.ldesc.empty()) {
+      ext_descs[name] = JoinStrings(t.tic.ldesc, "\r\n");
+    }
+  }
+  area.AddFiles(added);
+
+  if (!ext_descs.empty()) {
+    auto o = area.ext_desc();
+    if (!o) {
+      return std::nullopt;
+    }
+    std::vector<std::string> names;
+    std::vector<std::pair<std::string, std::string>> descs;
+    for (const auto& [name, text] : ext_descs) {
+      names.push_back(name);
+      descs.emplace_back(name, text);
+    }
+    // Any old descriptions are replaced by the new ones.
+    o.value()->DeleteExtended(names);
+    if (!o.value()->AddExtended(descs)) {
+      return std::nullopt;
+    }
+  }
+  if (!area.Save()) {
+    return std::nullopt;
+  }
+  return result;
 }
 
 } // namespace wwiv::sdk::files
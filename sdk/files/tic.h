@@ -21,7 +21,9 @@
 #include "core/datetime.h"
 #include "sdk/fido/fido_address.h"
 #include "sdk/files/dirs.h"
+#include "sdk/files/file_record.h"
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <string>
 #include <vector>
@@ -32,6 +34,8 @@ class Network;
 
 namespace wwiv::sdk::files {
 
+class FileArea;
+
 class Tic {
 public:
   explicit Tic(std::filesystem::path path);
@@ -87,6 +91,47 @@ private:
 std::optional<directory_t> FindFileAreaForTic(const files::Dirs& dirs, const Tic& tic,
                                               const sdk::net::Network& net);
 
+/** A parsed TIC file and the result of validating the file it describes. */
+struct parsed_tic_t {
+  // Name of the .tic file itself.
+  std::string tic_filename;
+  Tic tic;
+  // True if the file exists and matches the size and CRC in the TIC.
+  bool valid{false};
+};
+
+/**
+ * Parses all of tic_filenames and then validates the files they describe.
+ * Since that reads every file to compute the CRC, the validation is spread
+ * over up to jobs threads.  TIC files that can not be parsed are skipped.
+ * Valid files with no LDESC get one from their FILE_ID.DIZ, if they have one.
+ */
+std::vector<parsed_tic_t> ParseTics(const TicParser& parser,
+                                    const std::vector<std::string>& tic_filenames, int jobs);
+
+/**
+ * Groups the valid tics by the number of the file area that each belongs in,
+ * keeping them in order.  Invalid tics and ones for unknown areas are dropped.
+ */
+std::map<int, std::vector<parsed_tic_t>>
+GroupTicsByArea(const std::vector<parsed_tic_t>& tics, const files::Dirs& dirs,
+                const sdk::net::Network& net);
+
+/** Creates the file record for the file described by tic. */
+FileRecord ToFileRecord(const Tic& tic);
+
+struct tic_import_result_t {
+  int added{0};
+  int updated{0};
+};
+
+/**
+ * Adds the files for all of tics to area, or updates them if they are already
+ * there, and then saves the area once.  The area must already be loaded.
+ */
+std::optional<tic_import_result_t> ImportTics(FileArea& area,
+                                              const std::vector<parsed_tic_t>& tics);
+
 } 
 
 #endif
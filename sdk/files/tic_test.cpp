@@ -20,12 +20,15 @@
 
 #include "core/datafile.h"
 #include "core/file.h"
+#include "core/strings.h"
 #include "core/test/file_helper.h"
 #include "sdk/net/net.h"
+#include "sdk/files/files.h"
 #include "sdk/files/tic.h"
 
 using namespace wwiv::core;
 using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
 
 TEST(TicTest, Smoke) {
   wwiv::core::test::FileHelper helper;
@@ -214,3 +217,102 @@ File sample.zip
   auto o = wwiv::sdk::files::FindFileAreaForTic(dirs, tic, net);
   ASSERT_FALSE(o.has_value());
 }
+
+class TicBatchTest : public testing::Test {
+public:
+  void SetUp() override {
+    ASSERT_TRUE(helper.Mkdir("data"));
+    std::random_device rd{};
+    wwiv::core::uuid_generator generator(rd);
+    net.name = "foo";
+    net.uuid = generator.generate();
+
+    wwiv::sdk::files::dir_area_t dt;
+    dt.net_uuid = net.uuid;
+    dt.area_tag = "AREANAME";
+    wwiv::sdk::files::directory_t dir;
+    dir.area_tags.emplace_back(dt);
+    dir.name = "d1";
+    dir.filename = "d1";
+    dirs.set_dirs({dir});
+  }
+
+  // Creates a 12 byte file and a TIC for it in area_tag.
+  void CreateTic(const std::string& name, const std::string& area_tag,
+                 const std::string& crc = "AF083B2D") {
+    helper.CreateTempFile(StrCat(name, ".tic"),
+                          StrCat("Area ", area_tag, "\nSize 12\nCrc ", crc, "\nFile ", name,
+                                 ".zip\nDesc ", name, "\nLDesc Long ", name, "\n"));
+    helper.CreateTempFile(StrCat(name, ".zip"), "hello world\n");
+  }
+
+  wwiv::core::test::FileHelper helper;
+  Network net{};
+  const std::filesystem::path datadir{helper.Dir("data")};
+  wwiv::sdk::files::Dirs dirs{datadir, 0};
+};
+
+TEST_F(TicBatchTest, ParseTics) {
+  CreateTic("good", "AREANAME");
+  CreateTic("badcrc", "AREANAME", "00000000");
+
+  const wwiv::sdk::files::TicParser parser(helper.TempDir());
+  const auto tics = wwiv::sdk::files::ParseTics(parser, {"good.tic", "badcrc.tic", "none.tic"}, 2);
+  ASSERT_EQ(2u, tics.size());
+  EXPECT_EQ("good.tic", tics[0].tic_filename);
+  EXPECT_TRUE(tics[0].valid);
+  EXPECT_EQ("badcrc.tic", tics[1].tic_filename);
+  EXPECT_FALSE(tics[1].valid);
+}
+
+TEST_F(TicBatchTest, GroupTicsByArea) {
+  CreateTic("one", "AREANAME");
+  CreateTic("two", "OTHER");
+  CreateTic("three", "areaname");
+
+  const wwiv::sdk::files::TicParser parser(helper.TempDir());
+  const auto tics =
+      wwiv::sdk::files::ParseTics(parser, {"one.tic", "two.tic", "three.tic"}, 1);
+  const auto areas = wwiv::sdk::files::GroupTicsByArea(tics, dirs, net);
+  ASSERT_EQ(1u, areas.size());
+  const auto& a = areas.at(0);
+  ASSERT_EQ(2u, a.size());
+  EXPECT_EQ("one.tic", a[0].tic_filename);
+  EXPECT_EQ("three.tic", a[1].tic_filename);
+}
+
+TEST_F(TicBatchTest, ImportTics) {
+  CreateTic("one", "AREANAME");
+  CreateTic("two", "AREANAME");
+  CreateTic("three", "AREANAME");
+
+  wwiv::sdk::files::FileApi api(datadir.string());
+  {
+    auto area = api.CreateOrOpen(dirs.dir(0));
+    ASSERT_TRUE(area);
+    uploadsrec u{};
+    to_char_array(u.filename, wwiv::sdk::files::align("two.zip"));
+    ASSERT_TRUE(area->AddFile(wwiv::sdk::files::FileRecord(u)));
+    ASSERT_TRUE(area->Save());
+  }
+
+  const wwiv::sdk::files::TicParser parser(helper.TempDir());
+  const auto tics =
+      wwiv::sdk::files::ParseTics(parser, {"one.tic", "two.tic", "three.tic"}, 1);
+  auto area = api.CreateOrOpen(dirs.dir(0));
+  ASSERT_TRUE(area);
+  const auto r = wwiv::sdk::files::ImportTics(*area, tics);
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(2, r->added);
+  EXPECT_EQ(1, r->updated);
+
+  auto saved = api.Open(dirs.dir(0));
+  ASSERT_TRUE(saved);
+  ASSERT_EQ(3, saved->number_of_files());
+  EXPECT_EQ("THREE   .ZIP", saved->ReadFile(1).aligned_filename());
+  EXPECT_EQ("ONE     .ZIP", saved->ReadFile(2).aligned_filename());
+  EXPECT_EQ("TWO     .ZIP", saved->ReadFile(3).aligned_filename());
+  EXPECT_EQ("two", saved->ReadFile(3).description());
+  EXPECT_EQ(12u, saved->ReadFile(3).numbytes());
+  EXPECT_EQ("Long two", saved->ext_desc().value()->ReadExtended("TWO     .ZIP").value());
+}
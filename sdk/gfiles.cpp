@@ -73,6 +73,7 @@ bool GFiles::LoadFromJSON(const std::filesystem::path& dir, const std::string& f
                           std::vector<gfile_dir_t>& entries) {
   entries.clear();
   JsonFile f(FilePath(dir, filename), "gfiles", entries, 1);
+  f.set_use_snapshot(true);
   return f.Load();
 }
 
@@ -81,6 +82,7 @@ bool GFiles::SaveToJSON(const std::filesystem::path& dir, const std::string& fil
   const auto path = FilePath(dir, filename);
   backup_file(path, max_backups_);
   JsonFile f(path, "gfiles", entries, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
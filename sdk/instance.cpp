@@ -25,6 +25,7 @@
 #include "fmt/format.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
+#include "sdk/instance_board.h"
 #include "sdk/vardec.h"
 
 #include <algorithm>
@@ -113,12 +114,18 @@ DateTime Instance::updated() const {
 }
 
 Instances::Instances(const Config& config)
-    : datadir_(config.datadir()), path_(FilePath(datadir_, INSTANCE_DAT)) {
+    : datadir_(config.datadir()), path_(FilePath(datadir_, INSTANCE_DAT)),
+      board_(InstanceBoard::Open(FilePath(datadir_, INSTANCE_SHM), path_)) {
   initialized_ = File::Exists(path_);
   instances_ = all();
 }
 
+Instances::~Instances() = default;
+
 Instances::size_type Instances::size() const {
+  if (board_) {
+    return std::max<int>(0, board_->size() - 1);
+  }
   if (const auto file = DataFile<instancerec>(path_, File::modeBinary | File::modeReadOnly)) {
     return std::max<int>(0, file.number_of_records() - 1);
   }
@@ -127,6 +134,14 @@ Instances::size_type Instances::size() const {
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 Instance Instances::at(size_type pos) {
+  if (board_) {
+    if (static_cast<int>(pos) >= board_->size()) {
+      return Instance(pos);
+    }
+    if (const auto ir = board_->read(static_cast<int>(pos))) {
+      return Instance(ir.value());
+    }
+  }
   if (auto file = DataFile<instancerec>(path_, File::modeBinary | File::modeReadOnly)) {
     instancerec ir{};
     if (file.Read(pos, &ir)) {
@@ -138,6 +153,14 @@ Instance Instances::at(size_type pos) {
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 std::vector<Instance> Instances::all() {
+  if (board_) {
+    std::vector<Instance> r;
+    const auto num = board_->size();
+    for (auto i = 0; i < num; i++) {
+      r.emplace_back(at(i));
+    }
+    return r;
+  }
   if (auto file = DataFile<instancerec>(path_, File::modeBinary | File::modeReadOnly)) {
     std::vector<instancerec> ir;
     if (file.ReadVector(ir)) {
@@ -153,6 +176,10 @@ std::vector<Instance> Instances::all() {
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 bool Instances::upsert(size_type pos, const instancerec& ir) {
+  if (board_) {
+    board_->write(static_cast<int>(pos), ir);
+  }
+  // Always keep instance.dat up to date too.
   if (auto file = DataFile<instancerec>(path_, File::modeBinary | File::modeReadWrite |
                                                    File::modeCreateFile)) {
     return file.Write(pos, &ir);
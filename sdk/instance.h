@@ -21,6 +21,7 @@
 #include "core/datetime.h"
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 #include "sdk/config.h"
@@ -28,6 +29,8 @@
 
 namespace wwiv::sdk {
 
+class InstanceBoard;
+
 class Instance final {
 public:
   explicit Instance(instancerec ir);
@@ -130,7 +133,7 @@ public:
   explicit Instances(const Config& config);
   Instances& operator=(const Instances&) = delete;
   Instances& operator=(Instances&&) = delete;
-  ~Instances() = default;
+  ~Instances();
 
   [[nodiscard]] bool IsInitialized() const { return initialized_; }
 
@@ -150,6 +153,8 @@ private:
   bool initialized_;
   std::string datadir_;
   const std::filesystem::path path_;
+  // The shared node status board, or null to use instance.dat directly.
+  std::unique_ptr<InstanceBoard> board_;
   std::vector<Instance> instances_;
 };
 
@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/instance_board.h"
+
+#include "core/datafile.h"
+#include "core/log.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::core;
+
+namespace wwiv::sdk {
+
+static constexpr char BOARD_MAGIC[8] = {'W', 'W', 'I', 'V', 'I', 'N', 'S', 'T'};
+// How long to wait on a slot that is being written before deciding that the
+// writer died part way through.
+static constexpr int MAX_SPINS = 10000;
+
+static constexpr std::size_t board_size() {
+  return sizeof(instance_board_header_t) +
+         sizeof(instance_board_slot_t) * InstanceBoard::MAX_SLOTS;
+}
+
+InstanceBoard::~InstanceBoard() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(data_, data_size_);
+  }
+#endif
+}
+
+// static
+std::unique_ptr<InstanceBoard> InstanceBoard::Open(const std::filesystem::path& path,
+                                                   const std::filesystem::path& instance_dat) {
+#ifdef _WIN32
+  // Windows keeps using instance.dat directly.
+  return nullptr;
+#else
+  const auto fd = open(path.string().c_str(), O_RDWR | O_CREAT, 0664);
+  if (fd < 0) {
+    LOG(WARNING) << "Unable to open node status board: " << path.string();
+    return nullptr;
+  }
+  // Hold the lock while checking (and maybe creating) the board so that only
+  // one process ever initializes it.
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      (st.st_size < static_cast<off_t>(board_size()) &&
+       ftruncate(fd, static_cast<off_t>(board_size())) != 0)) {
+    LOG(WARNING) << "Unable to size node status board: " << path.string();
+    close(fd);
+    return nullptr;
+  }
+  auto* p = mmap(nullptr, board_size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  std::unique_ptr<InstanceBoard> board(new InstanceBoard());
+  board->data_ = p;
+  board->data_size_ = board_size();
+  board->header_ = static_cast<instance_board_header_t*>(p);
+  board->slots_ = reinterpret_cast<instance_board_slot_t*>(static_cast<char*>(p) +
+                                                           sizeof(instance_board_header_t));
+
+  auto* h = board->header_;
+  if (memcmp(h->magic, BOARD_MAGIC, sizeof(BOARD_MAGIC)) != 0 || h->version != VERSION ||
+      h->num_slots != MAX_SLOTS || h->slot_size != sizeof(instance_board_slot_t)) {
+    VLOG(1) << "Creating node status board from: " << instance_dat.string();
+    memset(p, 0, board_size());
+    std::vector<instancerec> records;
+    if (auto file = DataFile<instancerec>(instance_dat, File::modeBinary | File::modeReadOnly)) {
+      file.ReadVector(records);
+    }
+    const auto num = std::min<int>(static_cast<int>(records.size()), MAX_SLOTS);
+    for (auto i = 0; i < num; i++) {
+      board->write(i, records[i]);
+    }
+    h->version = VERSION;
+    h->num_slots = MAX_SLOTS;
+    h->slot_size = sizeof(instance_board_slot_t);
+    // Mark it valid last, in case this process dies before it's done.
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(h->magic, BOARD_MAGIC, sizeof(BOARD_MAGIC));
+  }
+  flock(fd, LOCK_UN);
+  close(fd);
+  return board;
+#endif
+}
+
+int InstanceBoard::size() const noexcept {
+  return static_cast<int>(header_->size.load(std::memory_order_acquire));
+}
+
+uint32_t InstanceBoard::generation() const noexcept {
+  return header_->generation.load(std::memory_order_acquire);
+}
+
+std::optional<instancerec> InstanceBoard::read(int pos) const {
+  if (pos < 0 || pos >= size()) {
+    return std::nullopt;
+  }
+  const auto& slot = slots_[pos];
+  uint32_t words[INSTANCE_BOARD_WORDS];
+  for (auto tries = 0; tries < MAX_SPINS; tries++) {
+    const auto before = slot.seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (auto i = 0; i < INSTANCE_BOARD_WORDS; i++) {
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == before) {
+      instancerec ir{};
+      memcpy(&ir, words, sizeof(ir));
+      return ir;
+    }
+  }
+  LOG(WARNING) << "Timed out reading node status for node: " << pos;
+  return std::nullopt;
+}
+
+bool InstanceBoard::write(int pos, const instancerec& ir) {
+  if (pos < 0 || pos >= MAX_SLOTS) {
+    return false;
+  }
+  auto& slot = slots_[pos];
+  // Normally a node only writes its own slot, but take the slot anyway so
+  // that two writers can never interleave.
+  auto seq = slot.seq.load(std::memory_order_relaxed);
+  for (auto tries = 0;; tries++) {
+    if (!(seq & 1)) {
+      if (slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        ++seq;
+        break;
+      }
+      continue;
+    }
+    if (tries >= MAX_SPINS) {
+      // Whoever was writing it died part way through, so finish for them.
+      LOG(WARNING) << "Taking over node status slot: " << pos;
+      break;
+    }
+    std::this_thread::yield();
+    seq = slot.seq.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  uint32_t words[INSTANCE_BOARD_WORDS]{};
+  memcpy(words, &ir, sizeof(ir));
+  for (auto i = 0; i < INSTANCE_BOARD_WORDS; i++) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.seq.store(seq + 1, std::memory_order_release);
+
+  const auto new_size = static_cast<uint32_t>(pos + 1);
+  auto size = header_->size.load(std::memory_order_relaxed);
+  while (size < new_size &&
+         !header_->size.compare_exchange_weak(size, new_size, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+  }
+  header_->generation.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+} // namespace wwiv::sdk
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_INSTANCE_BOARD_H
+#define INCLUDED_SDK_INSTANCE_BOARD_H
+
+#include "sdk/vardec.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+/**
+ * The node status board.
+ *
+ * A table of the instancerec of every node, kept in a file that each
+ * process maps shared, so that every node, wwivd and wwivutil see the same
+ * memory.  Each node gets its own cache line aligned slot, written with
+ * atomic stores under a sequence lock, so that readers never take a lock
+ * or touch the disk.  instance.dat is still written as well, for
+ * compatibility, and the board is loaded from it when first created.
+ */
+
+namespace wwiv::sdk {
+
+struct instance_board_header_t {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  // Number of records, including the unused record 0, like instance.dat.
+  std::atomic<uint32_t> size;
+  // Incremented by every write, so readers can tell if anything changed.
+  std::atomic<uint32_t> generation;
+  uint8_t unused[36];
+};
+
+static constexpr int INSTANCE_BOARD_WORDS = (sizeof(instancerec) + 3) / 4;
+
+struct alignas(64) instance_board_slot_t {
+  // Odd while the record is being written.
+  std::atomic<uint32_t> seq;
+  // The instancerec, stored a word at a time.
+  std::atomic<uint32_t> words[INSTANCE_BOARD_WORDS];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the node status board needs lock free atomics");
+static_assert(sizeof(instance_board_header_t) == 64, "instance_board_header_t != 64 bytes");
+static_assert(sizeof(instance_board_slot_t) == 128, "instance_board_slot_t != 128 bytes");
+
+class InstanceBoard final {
+public:
+  static constexpr uint32_t VERSION = 1;
+  static constexpr int MAX_SLOTS = 1000;
+
+  ~InstanceBoard();
+  InstanceBoard(const InstanceBoard&) = delete;
+  InstanceBoard& operator=(const InstanceBoard&) = delete;
+
+  /**
+   * Maps the board at path, creating it from the records in instance_dat
+   * if it does not exist yet.  Returns nullptr if the board can not be
+   * used, including on Windows, in which case callers should read and
+   * write instance.dat directly.
+   */
+  static std::unique_ptr<InstanceBoard> Open(const std::filesystem::path& path,
+                                             const std::filesystem::path& instance_dat);
+
+  /** The number of records, including the unused record 0. */
+  [[nodiscard]] int size() const noexcept;
+
+  /** The number of writes made to the board so far. */
+  [[nodiscard]] uint32_t generation() const noexcept;
+
+  /**
+   * Returns the record at pos.  Returns std::nullopt if pos is past the end
+   * of the board, or if the record could not be read because a writer
+   * appears to have died in the middle of updating it.
+   */
+  [[nodiscard]] std::optional<instancerec> read(int pos) const;
+
+  /** Writes ir as the record at pos. */
+  bool write(int pos, const instancerec& ir);
+
+private:
+  InstanceBoard() = default;
+
+  void* data_{nullptr};
+  std::size_t data_size_{0};
+  instance_board_header_t* header_{nullptr};
+  instance_board_slot_t* slots_{nullptr};
+};
+
+} // namespace wwiv::sdk
+
+#endif
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/test/file_helper.h"
+#include "sdk/instance_board.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace wwiv::core::test;
+using namespace wwiv::sdk;
+
+class InstanceBoardTest : public testing::Test {
+protected:
+  InstanceBoardTest()
+      : board_path_(helper_.TempDir() / "instance.shm"),
+        dat_path_(helper_.TempDir() / "instance.dat") {}
+
+  static instancerec make_ir(int num, int user) {
+    instancerec ir{};
+    ir.number = static_cast<int16_t>(num);
+    ir.user = static_cast<int16_t>(user);
+    return ir;
+  }
+
+  void WriteInstanceDat(const std::vector<instancerec>& records) {
+    auto [fp, path] = helper_.OpenTempFile("instance.dat");
+    fwrite(records.data(), sizeof(instancerec), records.size(), fp);
+    fclose(fp);
+  }
+
+  FileHelper helper_;
+  const std::filesystem::path board_path_;
+  const std::filesystem::path dat_path_;
+};
+
+#ifndef _WIN32
+
+TEST_F(InstanceBoardTest, CreatedFromInstanceDat) {
+  WriteInstanceDat({make_ir(0, 0), make_ir(1, 10), make_ir(2, 20)});
+  const auto board = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(board);
+  EXPECT_EQ(3, board->size());
+  EXPECT_EQ(20, board->read(2)->user);
+  EXPECT_FALSE(board->read(3).has_value());
+}
+
+TEST_F(InstanceBoardTest, NoInstanceDat) {
+  const auto board = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(board);
+  EXPECT_EQ(0, board->size());
+  EXPECT_FALSE(board->read(1).has_value());
+}
+
+TEST_F(InstanceBoardTest, Write) {
+  const auto board = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(board);
+  const auto gen = board->generation();
+  ASSERT_TRUE(board->write(3, make_ir(3, 30)));
+  EXPECT_EQ(4, board->size());
+  EXPECT_EQ(30, board->read(3)->user);
+  EXPECT_EQ(0, board->read(1)->user);
+  EXPECT_EQ(gen + 1, board->generation());
+
+  EXPECT_FALSE(board->write(InstanceBoard::MAX_SLOTS, make_ir(1, 1)));
+}
+
+TEST_F(InstanceBoardTest, Shared) {
+  const auto writer = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(writer);
+  const auto reader = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(reader);
+
+  writer->write(1, make_ir(1, 10));
+  EXPECT_EQ(10, reader->read(1)->user);
+  writer->write(1, make_ir(1, 11));
+  EXPECT_EQ(11, reader->read(1)->user);
+}
+
+TEST_F(InstanceBoardTest, KeptWhenReopened) {
+  WriteInstanceDat({make_ir(0, 0), make_ir(1, 10)});
+  {
+    const auto board = InstanceBoard::Open(board_path_, dat_path_);
+    ASSERT_TRUE(board);
+    board->write(1, make_ir(1, 11));
+  }
+  const auto board = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(board);
+  EXPECT_EQ(11, board->read(1)->user);
+}
+
+TEST_F(InstanceBoardTest, RebuiltIfInvalid) {
+  WriteInstanceDat({make_ir(0, 0), make_ir(1, 10)});
+  {
+    const auto board = InstanceBoard::Open(board_path_, dat_path_);
+    ASSERT_TRUE(board);
+    board->write(1, make_ir(1, 11));
+  }
+  auto* fp = fopen(board_path_.string().c_str(), "r+b");
+  ASSERT_NE(nullptr, fp);
+  fputs("JUNK", fp);
+  fclose(fp);
+
+  const auto board = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(board);
+  EXPECT_EQ(10, board->read(1)->user);
+}
+
+TEST_F(InstanceBoardTest, NeverTorn) {
+  const auto writer = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(writer);
+  const auto reader = InstanceBoard::Open(board_path_, dat_path_);
+  ASSERT_TRUE(reader);
+  writer->write(1, make_ir(1, 0));
+
+  std::atomic<bool> done{false};
+  std::thread t([&] {
+    for (auto i = 1; i <= 2000; i++) {
+      auto ir = make_ir(1, i);
+      memset(ir.extra, i & 0xff, sizeof(ir.extra));
+      writer->write(1, ir);
+      if (i % 16 == 0) {
+        std::this_thread::yield();
+      }
+    }
+    done = true;
+  });
+  auto reads = 0;
+  do {
+    const auto ir = reader->read(1);
+    ASSERT_TRUE(ir.has_value());
+    for (const auto b : ir->extra) {
+      ASSERT_EQ(ir->user & 0xff, b) << "user: " << ir->user;
+    }
+    ++reads;
+    std::this_thread::yield();
+  } while (!done);
+  t.join();
+  EXPECT_EQ(2000, reader->read(1)->user);
+  EXPECT_GT(reads, 0);
+}
+
+#endif
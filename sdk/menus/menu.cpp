@@ -105,6 +105,7 @@ bool Menu56::Load() {
   const auto dir = FilePath(menu_dir_, menu_set_);
   const auto name = StrCat(menu_name_, ".mnu.json");
   JsonFile f(FilePath(dir, name), "menu", menu, 1);
+  f.set_use_snapshot(true);
   return f.Load();
 }
 
@@ -112,6 +113,7 @@ bool Menu56::Save() {
   const auto dir = FilePath(menu_dir_, menu_set_);
   const auto name = StrCat(menu_name_, ".mnu.json");
   JsonFile f(FilePath(dir, name), "menu", menu, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
@@ -229,6 +231,7 @@ std::vector<menu_command_help_t> LoadCommandHelpJSON(const std::string& datadir)
   std::vector<menu_command_help_t> cmds;
   const auto path = FilePath(datadir, "menu_commands.json");
   JsonFile f(path, "commands", cmds, 1);
+  f.set_use_snapshot(true);
   if (!f.Load()) {
     return {};
   }
@@ -240,6 +243,7 @@ bool SaveCommandHelpJSON(const std::string& datadir, const std::vector<menu_comm
   VLOG(1) << "SaveCommandHelpJSON";
   const auto path = FilePath(datadir, "menu_commands.json");
   JsonFile f(path, "commands", cmds, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
@@ -71,12 +71,14 @@ MenuSet56::~MenuSet56() = default;
 bool MenuSet56::Load() {
   const auto dir = FilePath(menuset_dir_, "menuset.json");
   JsonFile f(dir, "menuset", menu_set, 1);
+  f.set_use_snapshot(true);
   return f.Load();
 }
 
 bool MenuSet56::Save() {
   const auto dir = FilePath(menuset_dir_, "menuset.json");
   JsonFile f(dir, "menuset", menu_set, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
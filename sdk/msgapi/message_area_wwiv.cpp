@@ -34,6 +34,7 @@
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/net/packets.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -123,7 +124,8 @@ WWIVMessageArea::WWIVMessageArea(WWIVMessageApi* api, const subboard_t& sub,
                                  std::filesystem::path text_filename, int subnum,
                                  std::vector<Network> net_networks)
     : MessageArea(api), Type2Text(std::move(text_filename)), wwiv_api_(api), sub_(sub),
-      sub_filename_(std::move(sub_filename)), header_{}, net_networks_(std::move(net_networks)) {
+      sub_filename_(std::move(sub_filename)), thread_index_(ThreadIndex::index_path(sub_filename_)),
+      header_{}, net_networks_(std::move(net_networks)) {
   DataFile<postrec> subfile(sub_filename_, File::modeBinary | File::modeReadOnly);
   if (!subfile) {
     // TODO: throw exception
@@ -493,6 +495,7 @@ bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOption
   p.msg = msg.value();
   auto result = add_post(p);
   if (result) {
+    thread_index_.Add(p.qscan, p.daten, header.title(), message.text().text());
     DeleteExcess();
   }
   return result;
@@ -692,6 +695,31 @@ message_anonymous_t WWIVMessageArea::anonymous_type() const noexcept {
   }
 }
 
+ThreadIndex& WWIVMessageArea::thread_index() {
+  thread_index_.Refresh();
+  return thread_index_;
+}
+
+std::optional<int> WWIVMessageArea::FindMessageNumber(uint32_t qscan) {
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadOnly);
+  if (!sub) {
+    return std::nullopt;
+  }
+  const auto num = number_of_messages();
+  std::vector<postrec> posts;
+  // Record 0 is the subfile header, so the message number is the index.
+  if (!sub.ReadVector(posts, num + 1)) {
+    return std::nullopt;
+  }
+  // Newer messages are more likely to be wanted, so search backwards.
+  for (auto i = std::min<int>(num, stl::ssize(posts) - 1); i >= 1; i--) {
+    if (posts[i].qscan == qscan) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
 // Implementation Details
 
 bool WWIVMessageArea::add_post(const postrec& post) {
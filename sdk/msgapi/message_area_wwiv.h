@@ -21,10 +21,12 @@
 #include "sdk/msgapi/message.h"
 #include "sdk/msgapi/message_api.h"
 #include "sdk/msgapi/message_wwiv.h"
+#include "sdk/msgapi/thread_index.h"
 #include "sdk/msgapi/type2_text.h"
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace wwiv::sdk::msgapi {
@@ -108,6 +110,17 @@ public:
   [[nodiscard]] MessageAreaLastRead& last_read() const noexcept override;
   [[nodiscard]] message_anonymous_t anonymous_type() const noexcept override;
 
+  /**
+   * The thread index of this area, including any messages added to it
+   * since it was last used.
+   */
+  [[nodiscard]] ThreadIndex& thread_index();
+  /**
+   * Returns the message number of the message with qscan, reading only the
+   * message headers.
+   */
+  [[nodiscard]] std::optional<int> FindMessageNumber(uint32_t qscan);
+
 private:
   int DeleteExcess();
   [[nodiscard]] bool add_post(const postrec& post);
@@ -124,6 +137,7 @@ private:
   const subboard_t sub_;
   // Full path to the *.sub filename.
   const std::filesystem::path sub_filename_;
+  ThreadIndex thread_index_;
   bool open_{false};
   subfile_header_t header_;
   const std::vector<net::Network> net_networks_;
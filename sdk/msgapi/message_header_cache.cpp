@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/msgapi/message_header_cache.h"
+
+#include "core/strings.h"
+#include <algorithm>
+#include <string>
+
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::msgapi {
+
+message_header_summary_t to_header_summary(const MessageHeader& h) {
+  message_header_summary_t s{};
+  // Some editors add a \r to the title, so trim it off here once.
+  s.title = StringTrim(h.title());
+  s.from = h.from();
+  s.to = h.to();
+  s.in_reply_to = h.in_reply_to();
+  s.daten = h.daten();
+  s.last_read = h.last_read();
+  s.from_usernum = h.from_usernum();
+  s.from_system = h.from_system();
+  s.anony = h.anony();
+  s.storage_type = h.storage_type();
+  s.local = h.local();
+  s.unvalidated = h.unvalidated();
+  s.deleted = h.deleted();
+  s.pending_network = h.pending_network();
+  return s;
+}
+
+std::optional<message_header_summary_t> AreaHeaderCache::get(MessageArea& area,
+                                                             int message_number) {
+  if (message_number < 1 || message_number > num_msgs_) {
+    return std::nullopt;
+  }
+  const auto block_num = (message_number - 1) / BLOCK_SIZE;
+  auto it = blocks_.find(block_num);
+  if (it == blocks_.end()) {
+    const auto first = block_num * BLOCK_SIZE + 1;
+    const auto last = std::min(first + BLOCK_SIZE - 1, num_msgs_);
+    std::vector<std::optional<message_header_summary_t>> block;
+    block.reserve(last - first + 1);
+    for (auto i = first; i <= last; i++) {
+      if (auto h = area.ReadMessageHeader(i)) {
+        block.emplace_back(to_header_summary(*h));
+      } else {
+        block.emplace_back(std::nullopt);
+      }
+    }
+    it = blocks_.emplace(block_num, std::move(block)).first;
+  }
+  return it->second.at((message_number - 1) % BLOCK_SIZE);
+}
+
+AreaHeaderCache& MessageHeaderCache::area(const std::string& filename, int num_msgs,
+                                          uint32_t qscanptr) {
+  const auto key = ToStringLowerCase(filename);
+  if (auto it = areas_.find(key); it != areas_.end()) {
+    if (it->second.num_msgs_ == num_msgs && it->second.qscanptr_ == qscanptr) {
+      it->second.last_used_ = ++clock_;
+      return it->second;
+    }
+    areas_.erase(it);
+  }
+  if (areas_.size() >= MAX_AREAS) {
+    const auto lru = std::min_element(areas_.begin(), areas_.end(), [](const auto& l, const auto& r) {
+      return l.second.last_used_ < r.second.last_used_;
+    });
+    areas_.erase(lru);
+  }
+  auto& a = areas_.emplace(key, AreaHeaderCache(num_msgs, qscanptr)).first->second;
+  a.last_used_ = ++clock_;
+  return a;
+}
+
+void MessageHeaderCache::invalidate(const std::string& filename) {
+  areas_.erase(ToStringLowerCase(filename));
+}
+
+void MessageHeaderCache::clear() { areas_.clear(); }
+
+} // namespace wwiv::sdk::msgapi
@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_MESSAGE_HEADER_CACHE_H
+#define INCLUDED_SDK_MSGAPI_MESSAGE_HEADER_CACHE_H
+
+#include "sdk/msgapi/message_area.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wwiv::sdk::msgapi {
+
+/** The parts of a message header needed to list it with other messages. */
+struct message_header_summary_t {
+  std::string title;
+  std::string from;
+  std::string to;
+  std::string in_reply_to;
+  uint32_t daten{0};
+  uint32_t last_read{0};
+  uint16_t from_usernum{0};
+  uint16_t from_system{0};
+  uint8_t anony{0};
+  uint8_t storage_type{0};
+  bool local{false};
+  bool unvalidated{false};
+  bool deleted{false};
+  bool pending_network{false};
+};
+
+[[nodiscard]] message_header_summary_t to_header_summary(const MessageHeader& h);
+
+/**
+ * The cached message headers of one message area.  Headers are read from
+ * the area in blocks of BLOCK_SIZE messages the first time any message in
+ * the block is needed.
+ */
+class AreaHeaderCache final {
+public:
+  static constexpr int BLOCK_SIZE = 32;
+
+  AreaHeaderCache(int num_msgs, uint32_t qscanptr) : num_msgs_(num_msgs), qscanptr_(qscanptr) {}
+
+  /** Returns the header of message_number, reading it from area if not cached. */
+  [[nodiscard]] std::optional<message_header_summary_t> get(MessageArea& area, int message_number);
+  [[nodiscard]] int num_msgs() const noexcept { return num_msgs_; }
+  [[nodiscard]] uint32_t qscanptr() const noexcept { return qscanptr_; }
+  /** The number of blocks read so far. */
+  [[nodiscard]] int num_blocks() const noexcept { return static_cast<int>(blocks_.size()); }
+
+private:
+  friend class MessageHeaderCache;
+
+  int num_msgs_;
+  uint32_t qscanptr_;
+  uint64_t last_used_{0};
+  std::map<int, std::vector<std::optional<message_header_summary_t>>> blocks_;
+};
+
+/**
+ * Caches the headers of the most recently used message areas, so that
+ * listing the titles of the messages in a sub doesn't read every message
+ * again each time the list is scrolled.
+ *
+ * An area is identified by the filename of the sub, and its cached headers
+ * are dropped whenever the number of messages in it or the qscan pointer
+ * from status (which changes whenever anything is posted) has changed.
+ */
+class MessageHeaderCache final {
+public:
+  static constexpr int MAX_AREAS = 8;
+
+  /** Returns the cache for the area of the sub with filename. */
+  AreaHeaderCache& area(const std::string& filename, int num_msgs, uint32_t qscanptr);
+  /** Drops anything cached for the sub with filename. */
+  void invalidate(const std::string& filename);
+  void clear();
+
+private:
+  std::map<std::string, AreaHeaderCache> areas_;
+  uint64_t clock_{0};
+};
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
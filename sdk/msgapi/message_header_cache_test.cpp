@@ -0,0 +1,133 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_header_cache.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/sdk_helper.h"
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+
+class MessageHeaderCacheTest : public testing::Test {
+public:
+  void SetUp() override {
+    MessageApiOptions options;
+    options.overflow_strategy = OverflowStrategy::delete_none;
+    api.reset(new WWIVMessageApi(options, helper.config(), {}, new NullLastReadImpl()));
+    sub.filename = "a1";
+    ASSERT_TRUE(api->Create(sub, -1));
+    area.reset(api->Open(sub, -1));
+  }
+
+  void AddMessages(int num) {
+    auto msg(area->CreateMessage());
+    auto& h = msg->header();
+    h.set_to("To");
+    h.set_in_reply_to("IRT");
+    msg->text().set_text("Line1\r\n");
+    for (auto i = 1; i <= num; i++) {
+      h.set_from_usernum(static_cast<uint16_t>(i));
+      h.set_from(std::to_string(i));
+      h.set_title(std::to_string(i) + " Title\r");
+      h.set_daten(915192000 + i);
+      ASSERT_TRUE(area->AddMessage(*msg, {}));
+    }
+  }
+
+  SdkHelper helper;
+  subboard_t sub{};
+  unique_ptr<MessageApi> api;
+  unique_ptr<MessageArea> area;
+  MessageHeaderCache cache;
+};
+
+TEST_F(MessageHeaderCacheTest, Get) {
+  AddMessages(3);
+  auto& c = cache.area("a1", area->number_of_messages(), 1);
+  const auto h = c.get(*area, 2);
+  ASSERT_TRUE(h.has_value());
+  EXPECT_EQ("2", h->from);
+  EXPECT_EQ("2 Title", h->title);
+  EXPECT_EQ("To", h->to);
+  EXPECT_EQ("IRT", h->in_reply_to);
+  EXPECT_EQ(2, h->from_usernum);
+  EXPECT_EQ(915192002u, h->daten);
+}
+
+TEST_F(MessageHeaderCacheTest, Get_OutOfRange) {
+  AddMessages(2);
+  auto& c = cache.area("a1", area->number_of_messages(), 1);
+  EXPECT_FALSE(c.get(*area, 0).has_value());
+  EXPECT_FALSE(c.get(*area, 3).has_value());
+  EXPECT_EQ(0, c.num_blocks());
+}
+
+TEST_F(MessageHeaderCacheTest, ReadsBlocksLazily) {
+  AddMessages(AreaHeaderCache::BLOCK_SIZE + 2);
+  auto& c = cache.area("a1", area->number_of_messages(), 1);
+  EXPECT_EQ(0, c.num_blocks());
+  ASSERT_TRUE(c.get(*area, 1).has_value());
+  ASSERT_TRUE(c.get(*area, AreaHeaderCache::BLOCK_SIZE).has_value());
+  EXPECT_EQ(1, c.num_blocks());
+  const auto h = c.get(*area, AreaHeaderCache::BLOCK_SIZE + 2);
+  ASSERT_TRUE(h.has_value());
+  EXPECT_EQ(std::to_string(AreaHeaderCache::BLOCK_SIZE + 2), h->from);
+  EXPECT_EQ(2, c.num_blocks());
+}
+
+TEST_F(MessageHeaderCacheTest, SameKey_KeepsHeaders) {
+  AddMessages(2);
+  ASSERT_TRUE(cache.area("a1", 2, 1).get(*area, 1).has_value());
+  EXPECT_EQ(1, cache.area("A1", 2, 1).num_blocks());
+}
+
+TEST_F(MessageHeaderCacheTest, Changed_DropsHeaders) {
+  AddMessages(2);
+  ASSERT_TRUE(cache.area("a1", 2, 1).get(*area, 1).has_value());
+  EXPECT_EQ(0, cache.area("a1", 2, 2).num_blocks());
+
+  ASSERT_TRUE(cache.area("a1", 2, 2).get(*area, 1).has_value());
+  AddMessages(1);
+  auto& c = cache.area("a1", area->number_of_messages(), 2);
+  EXPECT_EQ(0, c.num_blocks());
+  EXPECT_EQ("1", c.get(*area, 3)->from);
+}
+
+TEST_F(MessageHeaderCacheTest, Invalidate) {
+  AddMessages(2);
+  ASSERT_TRUE(cache.area("a1", 2, 1).get(*area, 1).has_value());
+  cache.invalidate("A1");
+  EXPECT_EQ(0, cache.area("a1", 2, 1).num_blocks());
+}
+
+TEST_F(MessageHeaderCacheTest, DropsLeastRecentlyUsed) {
+  AddMessages(1);
+  for (auto i = 0; i < MessageHeaderCache::MAX_AREAS; i++) {
+    ASSERT_TRUE(cache.area(std::to_string(i), 1, 1).get(*area, 1).has_value());
+  }
+  // Use area 0 so that area 1 is now the least recently used.
+  EXPECT_EQ(1, cache.area("0", 1, 1).num_blocks());
+  ASSERT_TRUE(cache.area("new", 1, 1).get(*area, 1).has_value());
+  EXPECT_EQ(1, cache.area("0", 1, 1).num_blocks());
+  EXPECT_EQ(0, cache.area("1", 1, 1).num_blocks());
+}
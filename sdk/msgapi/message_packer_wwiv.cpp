@@ -0,0 +1,437 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/msgapi/message_packer_wwiv.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/vardec.h"
+#include "sdk/msgapi/thread_index.h"
+#include "sdk/msgapi/type2_text.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::msgapi {
+
+static constexpr gati_t GAT_END = static_cast<gati_t>(-1);
+
+static File::size_type msg_starting(int section) {
+  return static_cast<File::size_type>(section) * GATSECLEN + GAT_SECTION_SIZE;
+}
+
+static std::optional<std::string> read_whole_file(const std::filesystem::path& path) {
+  File f(path);
+  if (!f.Open(File::modeBinary | File::modeReadOnly, File::shareDenyNone)) {
+    return std::nullopt;
+  }
+  std::string s(static_cast<std::string::size_type>(f.length()), '\0');
+  if (f.Read(s.data(), static_cast<File::size_type>(s.size())) !=
+      static_cast<File::size_type>(s.size())) {
+    return std::nullopt;
+  }
+  return s;
+}
+
+namespace {
+
+/** Reads the blocks of messages from an existing .dat file. */
+class Type2Reader {
+public:
+  explicit Type2Reader(const std::filesystem::path& path) : file_(path) {
+    file_.Open(File::modeBinary | File::modeReadOnly, File::shareDenyNone);
+  }
+
+  [[nodiscard]] bool ok() const { return file_.IsOpen(); }
+
+  /** Closes the file, which has to happen before the area is locked. */
+  void close() { file_.Close(); }
+
+  /** Appends the blocks of msg to out, returning the number of blocks. */
+  int read(const messagerec& msg, std::vector<char>& out) {
+    const auto section = static_cast<int>(msg.stored_as / GAT_NUMBER_ELEMENTS);
+    const auto& gat = load_gat(section);
+    auto num = 0;
+    for (auto cur = static_cast<int>(msg.stored_as % GAT_NUMBER_ELEMENTS);
+         cur > 0 && cur < GAT_NUMBER_ELEMENTS; cur = gat[cur]) {
+      if (++num >= GAT_NUMBER_ELEMENTS) {
+        // The chain has a loop in it.
+        return 0;
+      }
+      const auto pos = out.size();
+      out.resize(pos + MSG_BLOCK_SIZE);
+      file_.Seek(msg_starting(section) + MSG_BLOCK_SIZE * static_cast<File::size_type>(cur),
+                 File::Whence::begin);
+      if (file_.Read(&out[pos], MSG_BLOCK_SIZE) != MSG_BLOCK_SIZE) {
+        return 0;
+      }
+    }
+    return num;
+  }
+
+private:
+  const std::vector<gati_t>& load_gat(int section) {
+    if (auto it = gats_.find(section); it != gats_.end()) {
+      return it->second;
+    }
+    std::vector<gati_t> gat(GAT_NUMBER_ELEMENTS);
+    file_.Seek(static_cast<File::size_type>(section) * GATSECLEN, File::Whence::begin);
+    if (file_.Read(gat.data(), GAT_SECTION_SIZE) != GAT_SECTION_SIZE) {
+      std::fill(gat.begin(), gat.end(), gati_t{0});
+    }
+    return gats_.emplace(section, std::move(gat)).first->second;
+  }
+
+  File file_;
+  std::map<int, std::vector<gati_t>> gats_;
+};
+
+/** Writes a new .dat file one section at a time. */
+class Type2Writer {
+public:
+  explicit Type2Writer(const std::filesystem::path& path)
+      : file_(path), gat_(GAT_NUMBER_ELEMENTS),
+        blocks_(static_cast<std::size_t>(GAT_NUMBER_ELEMENTS) * MSG_BLOCK_SIZE) {
+    ok_ = file_.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                     File::modeTruncate);
+  }
+
+  /** Returns false if opening or writing to the file failed. */
+  [[nodiscard]] bool ok() const { return ok_; }
+
+  /** Adds a message with num blocks of data, returning where it was stored. */
+  messagerec add(const char* data, int num) {
+    if (next_ + num > GAT_NUMBER_ELEMENTS) {
+      flush(true);
+    }
+    std::memcpy(&blocks_[static_cast<std::size_t>(next_) * MSG_BLOCK_SIZE], data,
+                static_cast<std::size_t>(num) * MSG_BLOCK_SIZE);
+    for (auto i = next_; i < next_ + num; i++) {
+      gat_[i] = static_cast<gati_t>(i + 1 < next_ + num ? i + 1 : GAT_END);
+    }
+    messagerec m{};
+    m.storage_type = STORAGE_TYPE;
+    m.stored_as = static_cast<uint32_t>(section_) * GAT_NUMBER_ELEMENTS + next_;
+    next_ += num;
+    return m;
+  }
+
+  /** Writes the last section, returning the size of the file. */
+  int64_t close() {
+    flush(false);
+    const auto size = static_cast<int64_t>(file_.length());
+    file_.Close();
+    return size;
+  }
+
+private:
+  // Writes the current section.  Only a full section needs all of its
+  // blocks written, so that the next one starts in the right place.
+  void flush(bool full) {
+    const auto num_blocks = full ? GAT_NUMBER_ELEMENTS : next_;
+    ok_ = ok_ && file_.Write(gat_.data(), GAT_SECTION_SIZE) == GAT_SECTION_SIZE;
+    const auto len = static_cast<File::size_type>(num_blocks) * MSG_BLOCK_SIZE;
+    ok_ = ok_ && file_.Write(blocks_.data(), len) == len;
+    std::fill(gat_.begin(), gat_.end(), gati_t{0});
+    std::fill(blocks_.begin(), blocks_.end(), '\0');
+    ++section_;
+    next_ = 1;
+  }
+
+  File file_;
+  std::vector<gati_t> gat_;
+  std::vector<char> blocks_;
+  int section_{0};
+  // Block 0 is never used since 0 marks a free block in the GAT.
+  int next_{1};
+  bool ok_{true};
+};
+
+struct dat_state_t {
+  int64_t size{0};
+  std::filesystem::file_time_type time{};
+  bool operator==(const dat_state_t& o) const { return size == o.size && time == o.time; }
+};
+
+/** The files used while packing a message area. */
+struct pack_paths_t {
+  pack_paths_t(const std::filesystem::path& sub_path, const std::filesystem::path& dat_path)
+      : sub(sub_path), dat(dat_path), thr(ThreadIndex::index_path(sub_path)),
+        new_sub(StrCat(sub_path.string(), ".pck")), new_dat(StrCat(dat_path.string(), ".pck")),
+        new_thr(StrCat(thr.string(), ".pck")), marker(StrCat(sub_path.string(), ".pack")) {}
+
+  std::filesystem::path sub;
+  std::filesystem::path dat;
+  std::filesystem::path thr;
+  std::filesystem::path new_sub;
+  std::filesystem::path new_dat;
+  std::filesystem::path new_thr;
+  // Exists from when the packed files are complete until all of them have
+  // replaced the old ones.
+  std::filesystem::path marker;
+};
+
+} // namespace
+
+// Uses std::filesystem rather than File since this is called while the
+// area is locked, and File::Open would block on that lock.
+static dat_state_t dat_state(const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return {};
+  }
+  const auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return {};
+  }
+  return {static_cast<int64_t>(size), time};
+}
+
+// The text of a message runs up to the first NUL or ^Z in its blocks.
+static std::string message_text(const std::vector<char>& data) {
+  const auto end =
+      std::find_if(data.begin(), data.end(), [](char c) { return c == '\0' || c == '\x1a'; });
+  return std::string(data.begin(), end);
+}
+
+static void remove_packed_files(const pack_paths_t& paths) {
+  File::Remove(paths.new_dat);
+  File::Remove(paths.new_sub);
+  File::Remove(paths.new_thr);
+}
+
+// Opens f so that no other node can read or write it until it is closed.
+static bool open_locked(File& f) {
+  return f.Open(File::modeBinary | File::modeReadWrite, File::shareDenyReadWrite);
+}
+
+/** Replaces the contents of the open file to with those of the file from. */
+static bool copy_over(const std::filesystem::path& from, File& to) {
+  File in(from);
+  if (!in.Open(File::modeBinary | File::modeReadOnly)) {
+    return false;
+  }
+  std::vector<char> buf(64 * 1024);
+  File::size_type total = 0;
+  to.Seek(0, File::Whence::begin);
+  for (;;) {
+    const auto num = in.Read(buf.data(), static_cast<File::size_type>(buf.size()));
+    if (num < 0) {
+      return false;
+    }
+    if (num == 0) {
+      break;
+    }
+    if (to.Write(buf.data(), num) != num) {
+      return false;
+    }
+    total += num;
+  }
+  return to.set_length(total);
+}
+
+/**
+ * Copies the packed files over the locked .dat and .sub files and then moves
+ * the new thread index into place.  The files are copied over rather than
+ * renamed so that nodes waiting on the lock read the packed area once they
+ * get it, and so that this works on Windows.  The marker is only removed
+ * once everything has been replaced, so a swap that is interrupted is
+ * finished by the next pack.
+ */
+static bool swap_packed(const pack_paths_t& paths, File& sub_file, File& dat_file) {
+  if (!copy_over(paths.new_dat, dat_file) || !copy_over(paths.new_sub, sub_file)) {
+    LOG(ERROR) << "Unable to replace: " << paths.sub.string();
+    return false;
+  }
+  if (File::Exists(paths.new_thr) && !File::Rename(paths.new_thr, paths.thr)) {
+    // The qscan pointers didn't change, so the old index is still usable.
+    LOG(WARNING) << "Unable to replace: " << paths.thr.string();
+  }
+  File::Remove(paths.marker);
+  remove_packed_files(paths);
+  return true;
+}
+
+/**
+ * Finishes the swap of a pack that was interrupted after it started, or
+ * removes the files left by one that was interrupted before then.
+ */
+static bool finish_interrupted_pack(const pack_paths_t& paths) {
+  if (!File::Exists(paths.marker)) {
+    remove_packed_files(paths);
+    return true;
+  }
+  LOG(INFO) << "Finishing the interrupted pack of: " << paths.sub.string();
+  File sub_file(paths.sub);
+  File dat_file(paths.dat);
+  if (!open_locked(sub_file) || !open_locked(dat_file)) {
+    LOG(ERROR) << "Unable to lock: " << paths.sub.string();
+    return false;
+  }
+  return swap_packed(paths, sub_file, dat_file);
+}
+
+static pack_result_t pack_once(const pack_paths_t& paths, const pack_options_t& options) {
+  pack_result_t result{};
+  const auto before_dat = dat_state(paths.dat);
+  const auto before_sub = read_whole_file(paths.sub);
+  if (!before_sub || before_sub->size() < sizeof(postrec)) {
+    LOG(ERROR) << "Unable to read: " << paths.sub.string();
+    return result;
+  }
+  const auto num_records = static_cast<int>(before_sub->size() / sizeof(postrec));
+  std::vector<postrec> posts(num_records);
+  std::memcpy(posts.data(), before_sub->data(), posts.size() * sizeof(postrec));
+  // Record 0 is the header; active_message_count is at the same place as
+  // owneruser in the legacy header, so this works for both.
+  subfile_header_t header{};
+  std::memcpy(&header, &posts[0], sizeof(subfile_header_t));
+  const auto num_msgs = std::min<int>(header.active_message_count, num_records - 1);
+
+  // Like WWIVMessageArea::DeleteExcess, the oldest messages are deleted
+  // first and locked ones are never deleted.
+  std::vector<bool> excess(num_msgs + 1, false);
+  if (options.overflow_strategy != OverflowStrategy::delete_none && options.max_messages > 0) {
+    auto num_excess = num_msgs - options.max_messages;
+    if (options.overflow_strategy == OverflowStrategy::delete_one) {
+      num_excess = std::min(num_excess, 1);
+    }
+    for (auto i = 1; i <= num_msgs && num_excess > 0; i++) {
+      if (!(posts[i].status & status_no_delete)) {
+        excess[i] = true;
+        --num_excess;
+      }
+    }
+  }
+
+  Type2Reader reader(paths.dat);
+  if (!reader.ok()) {
+    LOG(ERROR) << "Unable to open: " << paths.dat.string();
+    return result;
+  }
+  Type2Writer writer(paths.new_dat);
+  File::Remove(paths.new_thr);
+  ThreadIndex thread_index(paths.new_thr);
+
+  std::vector<postrec> packed;
+  packed.reserve(num_msgs + 1);
+  packed.push_back(posts[0]);
+  std::vector<char> data;
+  for (auto i = 1; i <= num_msgs; i++) {
+    auto p = posts[i];
+    if (excess[i]) {
+      VLOG(1) << "Deleting message #" << i << " from " << paths.sub.string();
+      ++result.num_deleted;
+      continue;
+    }
+    data.clear();
+    const auto num = p.msg.storage_type == STORAGE_TYPE ? reader.read(p.msg, data) : 0;
+    if (num == 0) {
+      VLOG(1) << "Dropping message #" << i << " from " << paths.sub.string();
+      ++result.num_dropped;
+      continue;
+    }
+    p.msg = writer.add(data.data(), num);
+    packed.push_back(p);
+    thread_index.Add(p.qscan, p.daten, std::string(p.title, strnlen(p.title, sizeof(p.title))),
+                     message_text(data));
+  }
+  // The reader's shared lock would keep this process from locking the area.
+  reader.close();
+  result.num_messages = static_cast<int>(packed.size()) - 1;
+  result.old_size = before_dat.size;
+  result.new_size = writer.close();
+  if (!writer.ok()) {
+    LOG(ERROR) << "Error writing: " << paths.new_dat.string();
+    remove_packed_files(paths);
+    return result;
+  }
+
+  std::memcpy(&header, &packed[0], sizeof(subfile_header_t));
+  header.active_message_count = static_cast<uint16_t>(result.num_messages);
+  if (strncmp(header.signature, "WWIV\x1A", 5) == 0) {
+    header.mod_count++;
+  }
+  std::memcpy(&packed[0], &header, sizeof(subfile_header_t));
+  {
+    File f(paths.new_sub);
+    const auto len = static_cast<File::size_type>(packed.size() * sizeof(postrec));
+    if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                File::modeTruncate) ||
+        f.Write(packed.data(), len) != len) {
+      LOG(ERROR) << "Error writing: " << paths.new_sub.string();
+      remove_packed_files(paths);
+      return result;
+    }
+  }
+
+  // Lock the area so that nobody can post, delete or edit anything in it
+  // between checking that it hasn't changed while it was being packed and
+  // replacing it.
+  File sub_file(paths.sub);
+  File dat_file(paths.dat);
+  if (!open_locked(sub_file) || !open_locked(dat_file)) {
+    LOG(ERROR) << "Unable to lock: " << paths.sub.string();
+    remove_packed_files(paths);
+    return result;
+  }
+  std::string current_sub(static_cast<std::string::size_type>(sub_file.length()), '\0');
+  if (sub_file.Read(current_sub.data(), static_cast<File::size_type>(current_sub.size())) !=
+          static_cast<File::size_type>(current_sub.size()) ||
+      current_sub != *before_sub || !(dat_state(paths.dat) == before_dat)) {
+    remove_packed_files(paths);
+    result.changed = true;
+    return result;
+  }
+  if (File marker(paths.marker);
+      !marker.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite)) {
+    LOG(ERROR) << "Unable to create: " << paths.marker.string();
+    remove_packed_files(paths);
+    return result;
+  }
+  result.ok = swap_packed(paths, sub_file, dat_file);
+  return result;
+}
+
+pack_result_t pack_wwiv_message_area(const std::filesystem::path& sub_path,
+                                     const std::filesystem::path& dat_path,
+                                     const pack_options_t& options) {
+  const pack_paths_t paths(sub_path, dat_path);
+  if (!finish_interrupted_pack(paths)) {
+    return {};
+  }
+  pack_result_t result{};
+  for (auto attempt = 1; attempt <= options.max_attempts; attempt++) {
+    result = pack_once(paths, options);
+    if (!result.changed) {
+      return result;
+    }
+    LOG(INFO) << "Message area changed while packing, trying again: " << sub_path.string();
+  }
+  return result;
+}
+
+} // namespace wwiv::sdk::msgapi
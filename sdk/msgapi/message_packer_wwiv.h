@@ -0,0 +1,68 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_MESSAGE_PACKER_WWIV_H
+#define INCLUDED_SDK_MSGAPI_MESSAGE_PACKER_WWIV_H
+
+#include "sdk/msgapi/message_api.h"
+#include <cstdint>
+#include <filesystem>
+
+namespace wwiv::sdk::msgapi {
+
+struct pack_result_t {
+  bool ok{false};
+  // The area was changed by someone else on every attempt to pack it.
+  bool changed{false};
+  int num_messages{0};
+  // Messages that were not type-2 or whose text could not be found.
+  int num_dropped{0};
+  // Messages deleted because the area held more than max_messages.
+  int num_deleted{0};
+  int64_t old_size{0};
+  int64_t new_size{0};
+};
+
+struct pack_options_t {
+  // How to delete messages when the area holds more than max_messages.
+  OverflowStrategy overflow_strategy{OverflowStrategy::delete_none};
+  int max_messages{0};
+  int max_attempts{3};
+};
+
+/**
+ * Packs the WWIV type-2 message area stored in sub_path (the .sub file)
+ * and dat_path (the .dat file).
+ *
+ * The message blocks are copied in a single pass through both files into
+ * new files, with each message stored in consecutive blocks and the GAT of
+ * each section built in memory, so the message text isn't parsed or
+ * re-saved.  The thread index is rebuilt from the messages that are kept.
+ *
+ * The area can be packed while the BBS is running: once the new files are
+ * written, the .sub and .dat files are locked, and the new files only
+ * replace the old ones if neither old file changed while they were being
+ * written, otherwise the pack is retried up to max_attempts times.  A pack
+ * that is interrupted while replacing the files is finished by the next one.
+ */
+[[nodiscard]] pack_result_t pack_wwiv_message_area(const std::filesystem::path& sub_path,
+                                                   const std::filesystem::path& dat_path,
+                                                   const pack_options_t& options = {});
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
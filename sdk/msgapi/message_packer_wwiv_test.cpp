@@ -0,0 +1,242 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core/test/file_helper.h"
+#include "sdk/vardec.h"
+#include "sdk/msgapi/message_packer_wwiv.h"
+#include "sdk/msgapi/thread_index.h"
+#include "sdk/msgapi/type2_text.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+class MessagePackerWWIVTest : public testing::Test {
+public:
+  void SetUp() override {
+    sub_path = helper.CreateTempFilePath("a1.sub");
+    dat_path = helper.CreateTempFilePath("a1.dat");
+    File(dat_path).Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+  }
+
+  static std::string text(int i) {
+    // Make some messages span more than one block.
+    return StrCat("Message ", i, "\r\n", std::string(i * 300, 'x'), "\r\n");
+  }
+
+  // Creates num messages, then removes the text of the ones in deleted.
+  void Create(int num, const std::vector<int>& deleted = {}) {
+    Type2Text t(dat_path);
+    std::vector<postrec> posts(1);
+    for (auto i = 1; i <= num; i++) {
+      postrec p{};
+      to_char_array(p.title, StrCat("Title ", i));
+      p.qscan = 100 + i;
+      p.msg = t.savefile(text(i)).value();
+      posts.push_back(p);
+    }
+    for (const auto d : deleted) {
+      ASSERT_TRUE(t.remove_link(posts.at(d).msg));
+      posts.erase(posts.begin() + d);
+    }
+    posts[0].owneruser = static_cast<uint16_t>(posts.size() - 1);
+    DataFile<postrec> f(sub_path, File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    ASSERT_TRUE(f.WriteVector(posts));
+  }
+
+  std::vector<postrec> ReadPosts() {
+    std::vector<postrec> posts;
+    DataFile<postrec> f(sub_path, File::modeBinary | File::modeReadOnly);
+    EXPECT_TRUE(f.ReadVector(posts));
+    return posts;
+  }
+
+  FileHelper helper;
+  std::filesystem::path sub_path;
+  std::filesystem::path dat_path;
+};
+
+TEST_F(MessagePackerWWIVTest, Pack) {
+  Create(6, {4, 2});
+  const auto r = pack_wwiv_message_area(sub_path, dat_path);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(4, r.num_messages);
+  EXPECT_EQ(0, r.num_dropped);
+  EXPECT_LT(r.new_size, r.old_size);
+  EXPECT_EQ(r.new_size, static_cast<int64_t>(File(dat_path).length()));
+
+  const auto posts = ReadPosts();
+  ASSERT_EQ(5u, posts.size());
+  EXPECT_EQ(4, posts[0].owneruser);
+  Type2Text t(dat_path);
+  const std::vector<int> expected{1, 3, 5, 6};
+  for (auto i = 0; i < 4; i++) {
+    const auto& p = posts.at(i + 1);
+    EXPECT_EQ(100u + expected[i], p.qscan);
+    EXPECT_EQ(StrCat("Title ", expected[i]), std::string(p.title));
+    EXPECT_EQ(text(expected[i]), t.readfile(p.msg).value_or(""));
+  }
+  EXPECT_FALSE(File::Exists(StrCat(sub_path.string(), ".pck")));
+  EXPECT_FALSE(File::Exists(StrCat(dat_path.string(), ".pck")));
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_AddAfter) {
+  Create(3, {1});
+  ASSERT_TRUE(pack_wwiv_message_area(sub_path, dat_path).ok);
+
+  // New messages can still be saved into the packed file.
+  Type2Text t(dat_path);
+  const auto m = t.savefile(text(7));
+  ASSERT_TRUE(m.has_value());
+  EXPECT_EQ(text(7), t.readfile(m.value()).value_or(""));
+  for (const auto& p : ReadPosts()) {
+    if (p.qscan) {
+      EXPECT_EQ(text(p.qscan - 100), t.readfile(p.msg).value_or(""));
+    }
+  }
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_DropsMissingText) {
+  Create(2);
+  {
+    DataFile<postrec> f(sub_path, File::modeBinary | File::modeReadWrite);
+    postrec p{};
+    ASSERT_TRUE(f.Read(1, &p));
+    p.msg.storage_type = 1;
+    ASSERT_TRUE(f.Write(1, &p));
+  }
+  const auto r = pack_wwiv_message_area(sub_path, dat_path);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(1, r.num_messages);
+  EXPECT_EQ(1, r.num_dropped);
+  EXPECT_EQ(102u, ReadPosts().at(1).qscan);
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_ManySections) {
+  // Each message takes 1 block, so this needs more than one GAT section.
+  Type2Text t(dat_path);
+  std::vector<postrec> posts(1);
+  for (auto i = 1; i <= 2100; i++) {
+    postrec p{};
+    p.qscan = i;
+    p.msg = t.savefile(StrCat("Message ", i)).value();
+    posts.push_back(p);
+  }
+  posts[0].owneruser = 2100;
+  {
+    DataFile<postrec> f(sub_path, File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    ASSERT_TRUE(f.WriteVector(posts));
+  }
+  const auto r = pack_wwiv_message_area(sub_path, dat_path);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(2100, r.num_messages);
+  const auto packed = ReadPosts();
+  EXPECT_EQ("Message 2100", t.readfile(packed.at(2100).msg).value_or(""));
+  EXPECT_EQ(1u, packed.at(2100).msg.stored_as / GAT_NUMBER_ELEMENTS);
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_DeleteOverflow_All) {
+  Create(5);
+  {
+    DataFile<postrec> f(sub_path, File::modeBinary | File::modeReadWrite);
+    postrec p{};
+    ASSERT_TRUE(f.Read(1, &p));
+    p.status |= status_no_delete;
+    ASSERT_TRUE(f.Write(1, &p));
+  }
+  pack_options_t options{};
+  options.overflow_strategy = OverflowStrategy::delete_all;
+  options.max_messages = 2;
+  const auto r = pack_wwiv_message_area(sub_path, dat_path, options);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(2, r.num_messages);
+  EXPECT_EQ(3, r.num_deleted);
+  const auto posts = ReadPosts();
+  ASSERT_EQ(3u, posts.size());
+  // The locked message is kept even though it is the oldest.
+  EXPECT_EQ(101u, posts.at(1).qscan);
+  EXPECT_EQ(105u, posts.at(2).qscan);
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_DeleteOverflow_One) {
+  Create(5);
+  pack_options_t options{};
+  options.overflow_strategy = OverflowStrategy::delete_one;
+  options.max_messages = 2;
+  const auto r = pack_wwiv_message_area(sub_path, dat_path, options);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(4, r.num_messages);
+  EXPECT_EQ(1, r.num_deleted);
+  EXPECT_EQ(102u, ReadPosts().at(1).qscan);
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_RebuildsThreadIndex) {
+  Create(4, {2});
+  const auto thr_path = ThreadIndex::index_path(sub_path);
+  ThreadIndex old_index(thr_path);
+  for (auto i = 1; i <= 4; i++) {
+    old_index.Add(100 + i, 0, StrCat("Title ", i), text(i));
+  }
+  ASSERT_TRUE(pack_wwiv_message_area(sub_path, dat_path).ok);
+
+  ThreadIndex index(thr_path);
+  ASSERT_TRUE(index.Refresh());
+  EXPECT_EQ(3, index.size());
+  EXPECT_TRUE(index.find(101).has_value());
+  EXPECT_FALSE(index.find(102).has_value());
+  EXPECT_TRUE(index.find(104).has_value());
+  EXPECT_FALSE(File::Exists(StrCat(thr_path.string(), ".pck")));
+}
+
+TEST_F(MessagePackerWWIVTest, Pack_FinishesInterruptedSwap) {
+  Create(3, {1});
+  const auto old_sub = StrCat(sub_path.string(), ".old");
+  const auto old_dat = StrCat(dat_path.string(), ".old");
+  const auto new_sub = StrCat(sub_path.string(), ".pck");
+  const auto new_dat = StrCat(dat_path.string(), ".pck");
+  const auto marker = StrCat(sub_path.string(), ".pack");
+  std::filesystem::copy_file(sub_path, old_sub);
+  std::filesystem::copy_file(dat_path, old_dat);
+  const auto packed = pack_wwiv_message_area(sub_path, dat_path);
+  ASSERT_TRUE(packed.ok);
+
+  // Leave the area as it would be if the last pack stopped right after
+  // creating the marker.
+  ASSERT_TRUE(File::Rename(sub_path, new_sub));
+  ASSERT_TRUE(File::Rename(dat_path, new_dat));
+  ASSERT_TRUE(File::Rename(old_sub, sub_path));
+  ASSERT_TRUE(File::Rename(old_dat, dat_path));
+  File(marker).Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+
+  const auto r = pack_wwiv_message_area(sub_path, dat_path);
+  ASSERT_TRUE(r.ok);
+  EXPECT_EQ(2, r.num_messages);
+  EXPECT_EQ(packed.new_size, r.old_size);
+  EXPECT_EQ(packed.new_size, r.new_size);
+  EXPECT_FALSE(File::Exists(marker));
+  EXPECT_FALSE(File::Exists(new_sub));
+  EXPECT_FALSE(File::Exists(new_dat));
+}
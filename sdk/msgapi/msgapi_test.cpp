@@ -22,10 +22,12 @@
 #include "core/strings.h"
 #include "sdk/config.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_area_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/sdk_helper.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace wwiv::core;
@@ -172,3 +174,30 @@ TEST_F(MsgApiTest, Resynch_MessageNumber) {
   a2->ResyncMessage(msgnum);
   EXPECT_EQ(1, msgnum);
 }
+
+TEST_F(MsgApiTest, ThreadIndex) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  auto m(CreateMessage(*area, 1, "From1", "Hello", "\x04" "0MSGID: 1:2/3 1\r\nLine1\r\n"));
+  EXPECT_TRUE(area->AddMessage(*m, {}));
+  m->header().set_title("Something else");
+  m->text().set_text("\x04" "0MSGID: 1:2/3 2\r\nLine1\r\n");
+  EXPECT_TRUE(area->AddMessage(*m, {}));
+  m->header().set_title("Re: Hello");
+  m->text().set_text("\x04" "0MSGID: 1:2/3 3\r\n\x04" "0REPLY: 1:2/3 1\r\nLine1\r\n");
+  EXPECT_TRUE(area->AddMessage(*m, {}));
+
+  auto& wa = dynamic_cast<WWIVMessageArea&>(*area);
+  const auto first = wa.ReadMessageHeader(1)->last_read();
+  const auto reply = wa.ReadMessageHeader(3)->last_read();
+  const std::vector<uint32_t> expected{first, reply};
+  EXPECT_EQ(expected, wa.thread_index().thread(reply));
+  EXPECT_EQ(3, wa.FindMessageNumber(reply).value_or(0));
+
+  // Deleting a message shifts the message numbers but not the thread.
+  EXPECT_TRUE(area->DeleteMessage(2));
+  EXPECT_EQ(expected, wa.thread_index().thread(first));
+  EXPECT_EQ(2, wa.FindMessageNumber(reply).value_or(0));
+}
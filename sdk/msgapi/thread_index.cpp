@@ -0,0 +1,240 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/msgapi/thread_index.h"
+
+#include "core/crc32.h"
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::msgapi {
+
+std::string wwiv_control_line(std::string_view text, std::string_view name) {
+  while (!text.empty()) {
+    const auto nl = text.find('\n');
+    auto line = text.substr(0, nl);
+    text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+    if (line.size() < name.size() + 3 || line[0] != '\x04' || line[1] != '0') {
+      continue;
+    }
+    line.remove_prefix(2);
+    if (line.substr(0, name.size()) != name || line[name.size()] != ':') {
+      continue;
+    }
+    line.remove_prefix(name.size() + 1);
+    return StringTrim(std::string(line));
+  }
+  return {};
+}
+
+// Returns the length of the "Re:" or "Re^N:" prefix at the start of title, or 0.
+static std::string_view::size_type reply_prefix_size(std::string_view title) {
+  if (title.size() < 3 || std::tolower(static_cast<unsigned char>(title[0])) != 'r' ||
+      std::tolower(static_cast<unsigned char>(title[1])) != 'e') {
+    return 0;
+  }
+  std::string_view::size_type i = 2;
+  if (title[i] == '^') {
+    ++i;
+    while (i < title.size() && std::isdigit(static_cast<unsigned char>(title[i]))) {
+      ++i;
+    }
+  }
+  return i < title.size() && title[i] == ':' ? i + 1 : 0;
+}
+
+std::string normalize_thread_title(std::string_view title) {
+  auto t = StringTrim(std::string(title));
+  for (auto n = reply_prefix_size(t); n != 0; n = reply_prefix_size(t)) {
+    t = StringTrim(t.substr(n));
+  }
+  return ToStringLowerCase(t);
+}
+
+std::filesystem::path ThreadIndex::index_path(const std::filesystem::path& sub_filename) {
+  auto p = sub_filename;
+  return p.replace_extension(".thr");
+}
+
+void ThreadIndex::reset() {
+  num_read_ = 0;
+  records_.clear();
+  by_qscan_.clear();
+  by_msgid_.clear();
+  by_title_.clear();
+  replies_.clear();
+}
+
+void ThreadIndex::index(const thread_index_record_t& r) {
+  // Keep the first record of a message added by two nodes at once, so
+  // that the replies always form a tree.
+  if (!by_qscan_.emplace(r.qscan, records_.size()).second) {
+    return;
+  }
+  records_.push_back(r);
+  if (r.msgid_crc != 0) {
+    by_msgid_[r.msgid_crc] = r.qscan;
+  }
+  by_title_[r.title_crc] = r.qscan;
+  if (r.parent != 0) {
+    replies_[r.parent].push_back(r.qscan);
+  }
+}
+
+bool ThreadIndex::Refresh() {
+  DataFile<thread_index_record_t> file(path_, File::modeBinary | File::modeReadOnly);
+  if (!file) {
+    // No messages have been indexed yet.
+    reset();
+    return true;
+  }
+  return ReadAdded(file);
+}
+
+bool ThreadIndex::ReadAdded(DataFile<thread_index_record_t>& file) {
+  const auto num = static_cast<std::size_t>(file.number_of_records());
+  if (num < num_read_) {
+    VLOG(1) << "Thread index shrank, reading it again: " << path_.string();
+    reset();
+  }
+  if (num == num_read_) {
+    return true;
+  }
+  std::vector<thread_index_record_t> added(num - num_read_);
+  if (!file.Seek(static_cast<int>(num_read_)) ||
+      !file.Read(added.data(), static_cast<int>(added.size()))) {
+    LOG(ERROR) << "Unable to read thread index: " << path_.string();
+    return false;
+  }
+  num_read_ = num;
+  for (const auto& r : added) {
+    index(r);
+  }
+  return true;
+}
+
+std::optional<thread_index_record_t> ThreadIndex::Add(uint32_t qscan, uint32_t daten,
+                                                      const std::string& title,
+                                                      const std::string& text) {
+  // Hold an exclusive lock until our record is written, so nobody else can
+  // append between reading the records added by other nodes and our write.
+  DataFile<thread_index_record_t> file(path_,
+                                       File::modeBinary | File::modeReadWrite |
+                                           File::modeCreateFile,
+                                       File::shareDenyReadWrite);
+  if (!file || !ReadAdded(file)) {
+    LOG(ERROR) << "Unable to open thread index: " << path_.string();
+    return std::nullopt;
+  }
+  if (auto existing = find(qscan)) {
+    return existing;
+  }
+
+  thread_index_record_t r{};
+  r.qscan = qscan;
+  r.daten = daten;
+  if (const auto msgid = wwiv_control_line(text, "MSGID"); !msgid.empty()) {
+    r.msgid_crc = crc32string(msgid);
+  }
+  if (const auto reply = wwiv_control_line(text, "REPLY"); !reply.empty()) {
+    r.reply_crc = crc32string(reply);
+  }
+  r.title_crc = crc32string(normalize_thread_title(title));
+
+  if (auto it = by_msgid_.find(r.reply_crc); r.reply_crc != 0 && it != by_msgid_.end()) {
+    r.parent = it->second;
+  } else if (reply_prefix_size(StringTrim(title)) != 0) {
+    if (auto t = by_title_.find(r.title_crc); t != by_title_.end()) {
+      r.parent = t->second;
+    }
+  }
+  r.root = r.qscan;
+  if (r.parent != 0) {
+    if (const auto p = find(r.parent)) {
+      r.root = p->root;
+    }
+  }
+
+  if (!file.Seek(static_cast<int>(num_read_)) || !file.Write(&r)) {
+    LOG(ERROR) << "Unable to write thread index: " << path_.string();
+    return std::nullopt;
+  }
+  ++num_read_;
+  index(r);
+  return r;
+}
+
+std::optional<thread_index_record_t> ThreadIndex::find(uint32_t qscan) const {
+  if (const auto it = by_qscan_.find(qscan); it != by_qscan_.end()) {
+    return records_.at(it->second);
+  }
+  return std::nullopt;
+}
+
+std::vector<uint32_t> ThreadIndex::replies(uint32_t qscan) const {
+  if (const auto it = replies_.find(qscan); it != replies_.end()) {
+    return it->second;
+  }
+  return {};
+}
+
+std::vector<uint32_t> ThreadIndex::thread(uint32_t qscan) const {
+  const auto r = find(qscan);
+  if (!r) {
+    return {};
+  }
+  std::vector<uint32_t> result;
+  std::vector<uint32_t> stack{r->root};
+  while (!stack.empty()) {
+    const auto q = stack.back();
+    stack.pop_back();
+    result.push_back(q);
+    if (const auto it = replies_.find(q); it != replies_.end()) {
+      // Push in reverse so the oldest reply is visited first.
+      stack.insert(stack.end(), it->second.rbegin(), it->second.rend());
+    }
+  }
+  return result;
+}
+
+std::optional<uint32_t> ThreadIndex::next_in_thread(uint32_t qscan) const {
+  const auto t = thread(qscan);
+  const auto it = std::find(t.begin(), t.end(), qscan);
+  if (it == t.end() || it + 1 == t.end()) {
+    return std::nullopt;
+  }
+  return *(it + 1);
+}
+
+std::optional<uint32_t> ThreadIndex::previous_in_thread(uint32_t qscan) const {
+  const auto t = thread(qscan);
+  const auto it = std::find(t.begin(), t.end(), qscan);
+  if (it == t.end() || it == t.begin()) {
+    return std::nullopt;
+  }
+  return *(it - 1);
+}
+
+} // namespace wwiv::sdk::msgapi
@@ -0,0 +1,144 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_THREAD_INDEX_H
+#define INCLUDED_SDK_MSGAPI_THREAD_INDEX_H
+
+#include "core/datafile.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * The thread index of a message area.
+ *
+ * Each message area has a <filename>.thr file next to the .sub file
+ * holding one fixed size record per message, in the order the messages
+ * were added.  Messages are identified by their qscan pointer, since that
+ * is unique and (unlike the message number) doesn't change when earlier
+ * messages are deleted.
+ *
+ * A message is a reply to the message whose MSGID matches its REPLY
+ * control line, or failing that, if the title starts with "Re:", to the
+ * most recent message with the same title once any "Re:" is removed.
+ */
+
+namespace wwiv::sdk::msgapi {
+
+#ifndef __MSDOS__
+#pragma pack(push, 1)
+#endif // __MSDOS__
+
+struct thread_index_record_t {
+  // qscan pointer of the message.
+  uint32_t qscan;
+  // qscan pointer of the message this replies to, or 0 if none.
+  uint32_t parent;
+  // qscan pointer of the first message in the thread.
+  uint32_t root;
+  uint32_t daten;
+  // CRC32 of the MSGID and REPLY control lines, 0 if not present.
+  uint32_t msgid_crc;
+  uint32_t reply_crc;
+  // CRC32 of the normalized title.
+  uint32_t title_crc;
+  uint32_t unused;
+};
+
+#ifndef __MSDOS__
+#pragma pack(pop)
+#endif // __MSDOS__
+
+static_assert(sizeof(thread_index_record_t) == 32, "thread_index_record_t != 32 bytes");
+
+/**
+ * Returns the value of the WWIV control line (^D0NAME: value) in text,
+ * or an empty string.
+ */
+[[nodiscard]] std::string wwiv_control_line(std::string_view text, std::string_view name);
+
+/**
+ * Returns the title lowercased, trimmed and without any leading "Re:" or
+ * "Re^2:" prefixes.
+ */
+[[nodiscard]] std::string normalize_thread_title(std::string_view title);
+
+class ThreadIndex final {
+public:
+  explicit ThreadIndex(std::filesystem::path path) : path_(std::move(path)) {}
+
+  /** Path of the thread index for the message area with sub_filename. */
+  [[nodiscard]] static std::filesystem::path index_path(const std::filesystem::path& sub_filename);
+
+  /**
+   * Reads any records added to the index file since the last call, or all
+   * of them if the file has been replaced by a shorter one (i.e. packed).
+   */
+  bool Refresh();
+
+  /**
+   * Adds the message with qscan to the index, linking it to the message it
+   * replies to.  text is the message text, including any control lines.
+   * Adding a message that is already in the index does nothing.  The index
+   * file is locked while new records are read and this one is appended, so
+   * messages added by several nodes at once are linked and stored in order.
+   */
+  std::optional<thread_index_record_t> Add(uint32_t qscan, uint32_t daten,
+                                           const std::string& title, const std::string& text);
+
+  [[nodiscard]] std::optional<thread_index_record_t> find(uint32_t qscan) const;
+  /** Returns the qscan pointers of the direct replies to qscan, oldest first. */
+  [[nodiscard]] std::vector<uint32_t> replies(uint32_t qscan) const;
+  /**
+   * Returns the qscan pointers of every message in the thread containing
+   * qscan, starting with the first message and then each reply followed by
+   * its own replies.
+   */
+  [[nodiscard]] std::vector<uint32_t> thread(uint32_t qscan) const;
+  /** Returns the message after qscan in thread(qscan). */
+  [[nodiscard]] std::optional<uint32_t> next_in_thread(uint32_t qscan) const;
+  /** Returns the message before qscan in thread(qscan). */
+  [[nodiscard]] std::optional<uint32_t> previous_in_thread(uint32_t qscan) const;
+
+  [[nodiscard]] int size() const noexcept { return static_cast<int>(records_.size()); }
+  [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+  bool ReadAdded(core::DataFile<thread_index_record_t>& file);
+  void index(const thread_index_record_t& r);
+  void reset();
+
+  const std::filesystem::path path_;
+  // Number of records read from (or written to) the index file.
+  std::size_t num_read_{0};
+  std::vector<thread_index_record_t> records_;
+  // qscan to position in records_.
+  std::unordered_map<uint32_t, std::size_t> by_qscan_;
+  // MSGID and normalized title CRCs to the qscan of the latest message with it.
+  std::unordered_map<uint32_t, uint32_t> by_msgid_;
+  std::unordered_map<uint32_t, uint32_t> by_title_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> replies_;
+};
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
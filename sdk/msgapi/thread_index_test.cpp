@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/test/file_helper.h"
+#include "sdk/msgapi/thread_index.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wwiv::core::test;
+using namespace wwiv::sdk::msgapi;
+
+class ThreadIndexTest : public testing::Test {
+public:
+  static std::string text(const std::string& msgid, const std::string& reply = "") {
+    std::string s = "\x04" "0MSGID: " + msgid + "\r\n";
+    if (!reply.empty()) {
+      s += "\x04" "0REPLY: " + reply + "\r\n";
+    }
+    return s + "Hello\r\n";
+  }
+
+  FileHelper helper;
+  const std::filesystem::path path{ThreadIndex::index_path(helper.CreateTempFilePath("a1.sub"))};
+};
+
+TEST(ThreadIndexFunctionsTest, ControlLine) {
+  const std::string t = "\x04" "0MSGID: 1:2/3 1234\r\n\x04" "0REPLY: 1:2/4 5678\r\nText\r\n";
+  EXPECT_EQ("1:2/3 1234", wwiv_control_line(t, "MSGID"));
+  EXPECT_EQ("1:2/4 5678", wwiv_control_line(t, "REPLY"));
+  EXPECT_EQ("", wwiv_control_line(t, "PID"));
+  EXPECT_EQ("", wwiv_control_line("MSGID: 1234\r\n", "MSGID"));
+}
+
+TEST(ThreadIndexFunctionsTest, NormalizeTitle) {
+  EXPECT_EQ("hello", normalize_thread_title("Hello"));
+  EXPECT_EQ("hello", normalize_thread_title(" Re: Hello "));
+  EXPECT_EQ("hello", normalize_thread_title("RE: re^2: Hello"));
+  EXPECT_EQ("reply", normalize_thread_title("Reply"));
+}
+
+TEST_F(ThreadIndexTest, IndexPath) {
+  EXPECT_EQ("a1.thr", path.filename().string());
+}
+
+TEST_F(ThreadIndexTest, ByReply) {
+  ThreadIndex t(path);
+  ASSERT_TRUE(t.Add(1, 100, "Hello", text("a 1")));
+  ASSERT_TRUE(t.Add(2, 101, "Other", text("a 2")));
+  const auto r = t.Add(3, 102, "Different title", text("a 3", "a 1"));
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(1u, r->parent);
+  EXPECT_EQ(1u, r->root);
+  EXPECT_EQ(std::vector<uint32_t>{3}, t.replies(1));
+  EXPECT_TRUE(t.replies(2).empty());
+}
+
+TEST_F(ThreadIndexTest, ByTitle) {
+  ThreadIndex t(path);
+  ASSERT_TRUE(t.Add(1, 100, "Hello", ""));
+  ASSERT_TRUE(t.Add(2, 101, "Hello", ""));
+  const auto r = t.Add(3, 102, "Re: HELLO", "");
+  ASSERT_TRUE(r.has_value());
+  // Replies by title go to the latest message with the same title.
+  EXPECT_EQ(2u, r->parent);
+  EXPECT_EQ(2u, r->root);
+  // Without a "Re:" it's a new thread, even with the same title.
+  EXPECT_EQ(0u, t.Add(4, 103, "Hello", "")->parent);
+}
+
+TEST_F(ThreadIndexTest, Thread) {
+  ThreadIndex t(path);
+  ASSERT_TRUE(t.Add(1, 100, "Hello", text("a 1")));
+  ASSERT_TRUE(t.Add(2, 101, "Re: Hello", text("a 2", "a 1")));
+  ASSERT_TRUE(t.Add(3, 102, "Unrelated", text("a 3")));
+  ASSERT_TRUE(t.Add(4, 103, "Re: Hello", text("a 4", "a 1")));
+  ASSERT_TRUE(t.Add(5, 104, "Re: Hello", text("a 5", "a 2")));
+
+  const std::vector<uint32_t> expected{1, 2, 5, 4};
+  EXPECT_EQ(expected, t.thread(5));
+  EXPECT_EQ(expected, t.thread(1));
+  EXPECT_EQ(std::vector<uint32_t>{3}, t.thread(3));
+  EXPECT_EQ(5u, t.next_in_thread(2).value());
+  EXPECT_EQ(4u, t.next_in_thread(5).value());
+  EXPECT_FALSE(t.next_in_thread(4).has_value());
+  EXPECT_EQ(2u, t.previous_in_thread(5).value());
+  EXPECT_FALSE(t.previous_in_thread(1).has_value());
+  EXPECT_TRUE(t.thread(99).empty());
+}
+
+TEST_F(ThreadIndexTest, AddTwice) {
+  ThreadIndex t(path);
+  ASSERT_TRUE(t.Add(1, 100, "Hello", ""));
+  ASSERT_TRUE(t.Add(1, 100, "Hello", ""));
+  EXPECT_EQ(1, t.size());
+}
+
+TEST_F(ThreadIndexTest, Refresh) {
+  ThreadIndex t1(path);
+  ThreadIndex t2(path);
+  ASSERT_TRUE(t1.Add(1, 100, "Hello", text("a 1")));
+  ASSERT_TRUE(t2.Refresh());
+  EXPECT_EQ(1, t2.size());
+
+  // t1 sees the reply added through t2.
+  ASSERT_TRUE(t2.Add(2, 101, "Re: Hello", text("a 2", "a 1")));
+  const auto r = t1.Add(3, 102, "Re: Hello", text("a 3", "a 2"));
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(2u, r->parent);
+  EXPECT_EQ(1u, r->root);
+
+  ThreadIndex t3(path);
+  ASSERT_TRUE(t3.Refresh());
+  EXPECT_EQ(3, t3.size());
+  EXPECT_EQ(3u, t3.thread(1).size());
+}
+
+TEST_F(ThreadIndexTest, AddFromSeveralNodes) {
+  static constexpr int NUM_NODES = 4;
+  static constexpr int NUM_POSTS = 50;
+  ThreadIndex first(path);
+  ASSERT_TRUE(first.Add(1, 100, "Hello", text("a 1")));
+
+  std::vector<std::thread> nodes;
+  for (auto n = 0; n < NUM_NODES; n++) {
+    nodes.emplace_back([this, n] {
+      ThreadIndex t(path);
+      for (auto i = 0; i < NUM_POSTS; i++) {
+        const auto qscan = static_cast<uint32_t>(2 + n * NUM_POSTS + i);
+        t.Add(qscan, 100, "Re: Hello", text("a " + std::to_string(qscan), "a 1"));
+      }
+    });
+  }
+  for (auto& t : nodes) {
+    t.join();
+  }
+
+  // Every record made it into the file, and all are replies to the first.
+  EXPECT_EQ((1 + NUM_NODES * NUM_POSTS) * sizeof(thread_index_record_t),
+            std::filesystem::file_size(path));
+  ThreadIndex t(path);
+  ASSERT_TRUE(t.Refresh());
+  EXPECT_EQ(1 + NUM_NODES * NUM_POSTS, t.size());
+  EXPECT_EQ(static_cast<std::size_t>(NUM_NODES * NUM_POSTS), t.replies(1).size());
+}
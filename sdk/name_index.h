@@ -0,0 +1,60 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_NAME_INDEX_H
+#define INCLUDED_SDK_NAME_INDEX_H
+
+#include "core/strings.h"
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace wwiv::sdk {
+
+/**
+ * A case insensitive index from names to positions in a container, so that
+ * looking up an entry by name does not need to scan every entry.
+ *
+ * The containers using this keep their entries in a vector that can also be
+ * modified through references, so they rebuild the index whenever it may be
+ * stale and check every hit against the entry it points to.
+ */
+class NameIndex final {
+public:
+  void clear() { index_.clear(); }
+
+  /** Adds name at pos. When a name is added more than once, the first one wins. */
+  void add(const std::string& name, int pos) {
+    index_.try_emplace(strings::ToStringLowerCase(name), pos);
+  }
+
+  [[nodiscard]] std::optional<int> find(const std::string& name) const {
+    if (const auto it = index_.find(strings::ToStringLowerCase(name)); it != index_.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return index_.empty(); }
+
+private:
+  std::unordered_map<std::string, int> index_;
+};
+
+} // namespace wwiv::sdk
+
+#endif
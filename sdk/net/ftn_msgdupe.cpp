@@ -132,19 +132,7 @@ std::string FtnMessageDupe::CreateMessageID(const wwiv::sdk::fido::FidoAddress&
 
 // static
 std::string FtnMessageDupe::GetMessageIDFromText(const std::string& text) {
-  static const std::string kMSGID = "MSGID: ";
-  auto lines = wwiv::sdk::fido::split_message(text);
-  for (const auto& line : lines) {
-    if (line.empty() || line.front() != '\001' || line.size() < 2) {
-      continue;
-    }
-    auto s = line.substr(1);
-    if (starts_with(s, kMSGID)) {
-      // Found the message ID, mail here.
-      return StringTrim(s.substr(kMSGID.size()));
-    }
-  }
-  return "";
+  return std::string(wwiv::sdk::fido::find_kludge_line(text, "MSGID"));
 }
 
 // static
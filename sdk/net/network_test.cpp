@@ -112,3 +112,31 @@ TEST_F(NetworkTest, Networks_Contains) {
   EXPECT_TRUE(n.contains("one"));
   EXPECT_FALSE(n.contains("foo"));
 }
+
+TEST_F(NetworkTest, Networks_NetworkNumber_CaseInsensitive) {
+  const auto& n = test_networks();
+
+  EXPECT_EQ(1, n.network_number("TWO"));
+  EXPECT_TRUE(n.contains("One"));
+}
+
+TEST_F(NetworkTest, Networks_NetworkNumber_AfterRename) {
+  auto& n = test_networks();
+  ASSERT_EQ(1, n.network_number("two"));
+
+  n.at(1).name = "three";
+  EXPECT_EQ(Networks::npos, n.network_number("two"));
+  EXPECT_EQ(1, n.network_number("three"));
+
+  n.at("three").name = "four";
+  EXPECT_FALSE(n.contains("three"));
+  EXPECT_EQ("four", n.at("FOUR").name);
+}
+
+TEST_F(NetworkTest, Networks_NetworkNumber_AfterErase) {
+  auto& n = test_networks();
+  ASSERT_TRUE(n.erase(0));
+
+  EXPECT_EQ(Networks::npos, n.network_number("one"));
+  EXPECT_EQ(0, n.network_number("two"));
+}
@@ -64,10 +64,8 @@ Networks::Networks(const Config& config)
 }
 
 const Network& Networks::at(const std::string& name) const {
-  for (const auto& n : networks_) {
-    if (iequals(name, n.name)) {
-      return n;
-    }
+  if (const auto num = network_number(name); num != npos) {
+    return networks_[num];
   }
   const auto msg = fmt::format("Unable to find network named: {}", name);
   LOG(ERROR) << msg;
@@ -105,6 +103,8 @@ const Network& Networks::at(size_type num) const {
 }
 
 Network& Networks::at(size_type num) {
+  // The caller may rename the network through the reference.
+  index_valid_ = false;
   if (networks_.empty()) {
     return *network_255;
   }
@@ -124,10 +124,9 @@ Network& Networks::at(size_type num) {
 }
 
 Network& Networks::at(const std::string& name) {
-  for (auto& n : networks_) {
-    if (iequals(name, n.name)) {
-      return n;
-    }
+  if (const auto num = network_number(name); num != npos) {
+    index_valid_ = false;
+    return networks_[num];
   }
   const auto msg = fmt::format("Unable to find network named: {}", name);
   LOG(ERROR) << msg;
@@ -157,24 +156,29 @@ std::optional<const Network> Networks::by_uuid(const std::string& uuid_text) {
 
 Networks::~Networks() = default;
 
+void Networks::Reindex() const {
+  name_index_.clear();
+  for (auto i = 0; i < size_int(networks_); i++) {
+    name_index_.add(networks_[i].name, i);
+  }
+  index_valid_ = true;
+}
+
 auto Networks::network_number(const std::string& network_name) const -> size_type {
-  auto i = 0;
-  for (const auto& n : networks_) {
-    if (iequals(network_name, n.name)) {
-      return i;
-    }
-    ++i;
+  if (!index_valid_) {
+    Reindex();
+  }
+  auto o = name_index_.find(network_name);
+  if (o && !iequals(network_name, networks_[o.value()].name)) {
+    // A network was renamed through a reference since the index was built.
+    Reindex();
+    o = name_index_.find(network_name);
   }
-  return npos;
+  return o.value_or(npos);
 }
 
 bool Networks::contains(const std::string& network_name) const {
-  for (const auto& n : networks_) {
-    if (iequals(network_name, n.name)) {
-      return true;
-    }
-  }
-  return false;
+  return network_number(network_name) != npos;
 }
 
 std::size_t Networks::size() const noexcept { return networks_.size(); }
@@ -198,6 +202,7 @@ bool Networks::erase(int n) {
 }
 
 bool Networks::Load() {
+  index_valid_ = false;
   if (LoadFromJSON()) {
     return true;
   }
@@ -207,6 +212,7 @@ bool Networks::Load() {
 bool Networks::LoadFromJSON() {
   networks_.clear();
   JsonFile json(FilePath(datadir_, NETWORKS_JSON), "networks", networks_);
+  json.set_use_snapshot(true);
   if (!json.Load()) {
     return false;
   }
@@ -281,6 +287,7 @@ void Networks::EnsureNetDirAbsolute() {
 
 // Set network_number on each network.
 void Networks::SetNetworkNumbers() {
+  index_valid_ = false;
   auto nn = 0;
   for (auto& n : networks_) {
     n.network_number_ = nn++;
@@ -289,6 +296,7 @@ void Networks::SetNetworkNumbers() {
 
 bool Networks::SaveToJSON() {
   JsonFile json(FilePath(datadir_, NETWORKS_JSON), "networks", networks_);
+  json.set_use_snapshot(true);
   return json.Save();
 }
 
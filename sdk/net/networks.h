@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include "sdk/config.h"
+#include "sdk/name_index.h"
 #include "sdk/net/net.h"
 
 namespace wwiv::sdk {
@@ -52,6 +53,7 @@ public:
   const net::Network& operator[](int num) const { return at(num); }
   const net::Network& operator[](const std::string& name) const { return at(name); }
 
+  /** Returns the number of the network named network_name, or npos. */
   [[nodiscard]] size_type network_number(const std::string& network_name) const;
   [[nodiscard]] bool contains(const std::string& network_name) const;
   [[nodiscard]] std::size_t size() const noexcept;
@@ -70,11 +72,15 @@ private:
   bool LoadFromDat();
   bool SaveToJSON();
   bool SaveToDat();
+  void Reindex() const;
 
   bool initialized_{false};
   std::filesystem::path root_directory_;
   std::filesystem::path datadir_;
   std::vector<net::Network> networks_;
+  // Lazily rebuilt by lookups after networks_ has changed.
+  mutable NameIndex name_index_;
+  mutable bool index_valid_{false};
 };
 
 
@@ -31,6 +31,7 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include "sdk/subs_cereal.h"
 #include "sdk/vardec.h"
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -59,6 +60,7 @@ bool Subs::LoadFromJSON(const std::filesystem::path& dir, const std::string& fil
   entries.clear();
   const auto path = FilePath(dir, filename);
   JsonFile f(path, "subs", entries, 1);
+  f.set_use_snapshot(true);
   return f.Load();
 }
 
@@ -68,6 +70,7 @@ bool Subs::SaveToJSON(const std::filesystem::path& dir, const std::string& filen
                       const std::vector<subboard_t>& entries) {
   const auto path = FilePath(dir, filename);
   JsonFile f(path, "subs", entries, 1);
+  f.set_use_snapshot(true);
   return f.Save();
 }
 
@@ -227,6 +230,7 @@ Subs::Subs(std::string datadir, const std::vector<Network>& net_networks, int ma
 Subs::~Subs() = default;
 
 bool Subs::Load() {
+  index_valid_ = false;
   if (!LoadFromJSON(datadir_, SUBS_JSON, subs_)) {
     return LoadLegacy();
   }
@@ -241,6 +245,7 @@ bool Subs::LoadLegacy() {
   }
 
   subs_.clear();
+  index_valid_ = false;
   for (decltype(old_subs)::size_type i = 0; i < old_subs.size(); i++) {
     const auto& olds = at(old_subs, i);
     auto& oldx = xsubs[i];
@@ -341,44 +346,88 @@ bool Subs::Save() {
 }
 
 bool Subs::insert(int n, subboard_t r) {
+  index_valid_ = false;
   return insert_at(subs_, n, r);
 }
 
 bool Subs::add(subboard_t r) {
   subs_.emplace_back(r);
+  index_valid_ = false;
   return true;
 }
 
 bool Subs::erase(int n) {
+  index_valid_ = false;
   return erase_at(subs_, n);
 }
 
-const subboard_t& Subs::sub(const std::string& filename) const {
-  for (const auto& n : subs_) {
-    if (iequals(filename, n.filename)) {
-      return n;
+static std::string net_index_key(int net_num, const std::string& stype) {
+  return StrCat(net_num, ":", stype);
+}
+
+void Subs::Reindex() const {
+  filename_index_.clear();
+  net_index_.clear();
+  for (auto i = 0; i < size_int(subs_); i++) {
+    const auto& s = subs_[i];
+    filename_index_.add(s.filename, i);
+    for (const auto& n : s.nets) {
+      net_index_.add(net_index_key(n.net_num, n.stype), i);
     }
   }
+  index_valid_ = true;
+}
+
+std::optional<int> Subs::sub_number(const std::string& filename) const {
+  if (!index_valid_) {
+    Reindex();
+  }
+  auto o = filename_index_.find(filename);
+  if (o && !iequals(filename, subs_[o.value()].filename)) {
+    // A sub was renamed through a reference since the index was built.
+    Reindex();
+    o = filename_index_.find(filename);
+  }
+  return o;
+}
+
+static bool carried_on(const subboard_t& sub, int net_num, const std::string& stype) {
+  return std::any_of(sub.nets.begin(), sub.nets.end(), [&](const subboard_network_data_t& n) {
+    return n.net_num == net_num && iequals(stype, n.stype);
+  });
+}
+
+std::optional<int> Subs::sub_number(int net_num, const std::string& stype) const {
+  if (!index_valid_) {
+    Reindex();
+  }
+  const auto key = net_index_key(net_num, stype);
+  auto o = net_index_.find(key);
+  if (o && !carried_on(subs_[o.value()], net_num, stype)) {
+    Reindex();
+    o = net_index_.find(key);
+  }
+  return o;
+}
+
+const subboard_t& Subs::sub(const std::string& filename) const {
+  if (const auto o = sub_number(filename)) {
+    return subs_[o.value()];
+  }
   throw std::out_of_range(StrCat("Unable to find sub of filename: ", filename));
 }
 
 subboard_t& Subs::sub(const std::string& filename) {
-  for (auto& n : subs_) {
-    if (iequals(filename, n.filename)) {
-      return n;
-    }
+  if (const auto o = sub_number(filename)) {
+    // The caller may rename the sub through the reference.
+    index_valid_ = false;
+    return subs_[o.value()];
   }
   throw std::out_of_range(StrCat("Unable to find sub of filename: ", filename));
 }
 
 bool Subs::exists(const std::string& filename) const {
-  for (const auto& n : subs_) {
-    if (iequals(filename, n.filename)) {
-      return true;
-    }
-  }
-
-  return false;
+  return sub_number(filename).has_value();
 }
 
 }
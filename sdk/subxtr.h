@@ -24,7 +24,9 @@
 #include "fido/fido_address.h"
 #include "sdk/net/net.h"
 #include "sdk/conf/conf_set.h"
+#include "sdk/name_index.h"
 #include <filesystem>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -113,7 +115,11 @@ public:
 
   [[nodiscard]] const subboard_t& sub(std::size_t n) const { return stl::at(subs_, n); }
   [[nodiscard]] const subboard_t& sub(const std::string& filename) const;
-  subboard_t& sub(std::size_t n) { return subs_[n]; }
+  subboard_t& sub(std::size_t n) {
+    // The caller may rename the sub through the reference.
+    index_valid_ = false;
+    return subs_[n];
+  }
   subboard_t& sub(const std::string& filename);
 
   const subboard_t& operator[](std::size_t n) const { return sub(n); }
@@ -123,7 +129,19 @@ public:
 
   [[nodiscard]] bool exists(const std::string& filename) const;
 
-  void set_sub(int n, subboard_t s) { subs_[n] = std::move(s); }
+  /** Returns the number of the sub with filename. */
+  [[nodiscard]] std::optional<int> sub_number(const std::string& filename) const;
+
+  /**
+   * Returns the number of the first sub carried on network net_num with the
+   * network sub type (or echo tag for FTN networks) stype.
+   */
+  [[nodiscard]] std::optional<int> sub_number(int net_num, const std::string& stype) const;
+
+  void set_sub(int n, subboard_t s) {
+    subs_[n] = std::move(s);
+    index_valid_ = false;
+  }
   [[nodiscard]] const std::vector<subboard_t>& subs() const { return subs_; }
   bool insert(int n, subboard_t r);
   bool add(subboard_t r);
@@ -139,6 +157,12 @@ private:
   const std::vector<net::Network> net_networks_;
   const int max_backups_;
   std::vector<subboard_t> subs_;
+
+  void Reindex() const;
+  // Lazily rebuilt by lookups after subs_ has changed.
+  mutable NameIndex filename_index_;
+  mutable NameIndex net_index_;
+  mutable bool index_valid_{false};
 };
 
 // Not serialized as binary on disk.
@@ -153,4 +153,61 @@ TEST_F(SubXtrTest, JsonSmoke) {
   EXPECT_EQ("n1", subs[0].name);
   EXPECT_EQ(2, subs[0].storage_type);
 
-}
\ No newline at end of file
+}
+
+TEST_F(SubXtrTest, SubNumber) {
+  Subs subs(helper.datadir(), net_networks_);
+  subboard_t s1{};
+  s1.filename = "S1";
+  subboard_t s2{};
+  s2.filename = "S2";
+  ASSERT_TRUE(subs.add(s1));
+  ASSERT_TRUE(subs.add(s2));
+
+  EXPECT_EQ(1, subs.sub_number("s2").value_or(-1));
+  EXPECT_TRUE(subs.exists("S1"));
+  EXPECT_FALSE(subs.exists("S3"));
+
+  ASSERT_TRUE(subs.erase(0));
+  EXPECT_EQ(0, subs.sub_number("S2").value_or(-1));
+  EXPECT_FALSE(subs.exists("S1"));
+
+  subs.sub(0).filename = "S3";
+  EXPECT_FALSE(subs.exists("S2"));
+  EXPECT_EQ("S3", subs.sub("s3").filename);
+}
+
+static subboard_network_data_t sub_net(const std::string& stype, int16_t net_num) {
+  subboard_network_data_t n{};
+  n.stype = stype;
+  n.net_num = net_num;
+  return n;
+}
+
+TEST_F(SubXtrTest, SubNumber_NetType) {
+  Subs subs(helper.datadir(), net_networks_);
+  subboard_t s1{};
+  s1.filename = "S1";
+  s1.nets.push_back(sub_net("GENERAL", 0));
+  subboard_t s2{};
+  s2.filename = "S2";
+  s2.nets.push_back(sub_net("OTHER", 1));
+  s2.nets.push_back(sub_net("GENERAL", 1));
+  ASSERT_TRUE(subs.add(s1));
+  ASSERT_TRUE(subs.add(s2));
+
+  EXPECT_EQ(0, subs.sub_number(0, "general").value_or(-1));
+  EXPECT_EQ(1, subs.sub_number(1, "General").value_or(-1));
+  EXPECT_EQ(1, subs.sub_number(1, "OTHER").value_or(-1));
+  EXPECT_FALSE(subs.sub_number(0, "OTHER").has_value());
+
+  subboard_t s3{};
+  s3.filename = "S3";
+  s3.nets.push_back(sub_net("OTHER", 0));
+  ASSERT_TRUE(subs.insert(0, s3));
+  EXPECT_EQ(0, subs.sub_number(0, "OTHER").value_or(-1));
+  EXPECT_EQ(1, subs.sub_number(0, "GENERAL").value_or(-1));
+
+  subs.sub(1).nets.clear();
+  EXPECT_FALSE(subs.sub_number(0, "GENERAL").has_value());
+}
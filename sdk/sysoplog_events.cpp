@@ -0,0 +1,244 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/sysoplog_events.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk {
+
+static std::string clean_field(std::string s) {
+  std::replace_if(
+      s.begin(), s.end(), [](char c) { return c == '\t' || c == '\r' || c == '\n'; }, ' ');
+  return s;
+}
+
+std::string to_sysoplog_event_line(const sysoplog_event_t& e) {
+  return fmt::format("{}\t{}\t{}\t{}\n", static_cast<int64_t>(e.time), e.node,
+                     clean_field(e.user), clean_field(e.text));
+}
+
+std::optional<sysoplog_event_t> parse_sysoplog_event_line(std::string_view line) {
+  while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+    line.remove_suffix(1);
+  }
+  std::string_view fields[3];
+  for (auto& f : fields) {
+    const auto idx = line.find('\t');
+    if (idx == std::string_view::npos) {
+      return std::nullopt;
+    }
+    f = line.substr(0, idx);
+    line.remove_prefix(idx + 1);
+  }
+  sysoplog_event_t e{};
+  e.time = static_cast<time_t>(to_number<int64_t>(std::string(fields[0])));
+  e.node = to_number<int>(std::string(fields[1]));
+  e.user = std::string(fields[2]);
+  e.text = std::string(line);
+  return e;
+}
+
+bool append_atomically(const std::filesystem::path& path, const std::vector<std::string>& chunks) {
+  if (chunks.empty()) {
+    return true;
+  }
+#ifdef _WIN32
+  std::string data;
+  for (const auto& c : chunks) {
+    data.append(c);
+  }
+  File f(path);
+  if (!f.Open(File::modeWriteOnly | File::modeAppend | File::modeBinary | File::modeCreateFile)) {
+    return false;
+  }
+  return f.Write(data) == static_cast<File::size_type>(data.size());
+#else
+  const auto fd = ::open(path.string().c_str(), O_WRONLY | O_APPEND | O_CREAT, 0664);
+  if (fd < 0) {
+    LOG(ERROR) << "Unable to open: " << path.string();
+    return false;
+  }
+  std::vector<iovec> iov;
+  std::string joined;
+  if (chunks.size() > IOV_MAX) {
+    for (const auto& c : chunks) {
+      joined.append(c);
+    }
+    iov.push_back({joined.data(), joined.size()});
+  } else {
+    iov.reserve(chunks.size());
+    for (const auto& c : chunks) {
+      iov.push_back({const_cast<char*>(c.data()), c.size()});
+    }
+  }
+  // A regular file opened with O_APPEND is written in one go; the loop only
+  // exists to finish the job if the kernel ever returns a short write.
+  auto* v = iov.data();
+  auto remaining = static_cast<int>(iov.size());
+  auto ok = true;
+  while (remaining > 0) {
+    auto written = ::writev(fd, v, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ok = false;
+      break;
+    }
+    while (remaining > 0 && static_cast<size_t>(written) >= v->iov_len) {
+      written -= static_cast<ssize_t>(v->iov_len);
+      ++v;
+      --remaining;
+    }
+    if (remaining > 0) {
+      v->iov_base = static_cast<char*>(v->iov_base) + written;
+      v->iov_len -= written;
+    }
+  }
+  ::close(fd);
+  return ok;
+#endif
+}
+
+bool rotate_sysoplog_events(const std::filesystem::path& path, int backups) {
+  if (!File::Exists(path)) {
+    return true;
+  }
+  auto backup = [&path](int n) {
+    auto p = path;
+    p += fmt::format(".{}", n);
+    return p;
+  };
+  std::error_code ec;
+  std::filesystem::remove(backup(backups), ec);
+  for (auto i = backups - 1; i >= 1; i--) {
+    std::filesystem::rename(backup(i), backup(i + 1), ec);
+  }
+  std::filesystem::rename(path, backup(1), ec);
+  if (ec) {
+    LOG(ERROR) << "Unable to rotate: " << path.string() << "; " << ec.message();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Returns a value identifying the file at path, which changes when the file
+ * is rotated, or 0 when that can't be told.
+ */
+static uint64_t file_id(const std::filesystem::path& path) {
+#ifdef _WIN32
+  // Windows won't rename the file while it's open for appending, and a
+  // rotated file is found by it being shorter than the read offset.
+  return 0;
+#else
+  struct stat st{};
+  if (stat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(st.st_ino);
+#endif
+}
+
+void SysopLogEventReader::seek_last(int num) {
+  static constexpr int BLOCK_SIZE = 4096;
+  file_id_ = file_id(path_);
+  File f(path_);
+  if (!f.Open(File::modeReadOnly | File::modeBinary)) {
+    offset_ = 0;
+    return;
+  }
+  const auto size = static_cast<int64_t>(f.length());
+  // The last byte is the newline ending the final record, so skip one more
+  // newline than the number of records wanted.
+  auto newlines = 0;
+  auto pos = size;
+  char buf[BLOCK_SIZE];
+  while (pos > 0) {
+    const auto len = std::min<int64_t>(BLOCK_SIZE, pos);
+    pos -= len;
+    f.Seek(pos, File::Whence::begin);
+    if (f.Read(buf, len) != len) {
+      break;
+    }
+    for (auto i = len - 1; i >= 0; i--) {
+      if (buf[i] == '\n' && ++newlines > num) {
+        offset_ = pos + i + 1;
+        return;
+      }
+    }
+  }
+  offset_ = 0;
+}
+
+std::vector<sysoplog_event_t> SysopLogEventReader::read() {
+  const auto id = file_id(path_);
+  if (id != 0 && file_id_ != 0 && id != file_id_) {
+    VLOG(1) << "Sysop log event stream rotated, starting over: " << path_.string();
+    offset_ = 0;
+  }
+  file_id_ = id;
+  File f(path_);
+  if (!f.Open(File::modeReadOnly | File::modeBinary)) {
+    return {};
+  }
+  const auto size = static_cast<int64_t>(f.length());
+  if (size < offset_) {
+    VLOG(1) << "Sysop log event stream truncated, starting over: " << path_.string();
+    offset_ = 0;
+  }
+  if (size == offset_) {
+    return {};
+  }
+  std::string data(static_cast<std::string::size_type>(size - offset_), '\0');
+  f.Seek(offset_, File::Whence::begin);
+  data.resize(f.Read(data.data(), data.size()));
+
+  std::vector<sysoplog_event_t> events;
+  std::string_view v(data);
+  std::string_view::size_type start = 0;
+  for (auto nl = v.find('\n'); nl != std::string_view::npos; nl = v.find('\n', start)) {
+    if (auto e = parse_sysoplog_event_line(v.substr(start, nl - start))) {
+      events.emplace_back(std::move(e.value()));
+    }
+    start = nl + 1;
+  }
+  // Anything after the last newline is a record still being written.
+  offset_ += static_cast<int64_t>(start);
+  return events;
+}
+
+} // namespace wwiv::sdk
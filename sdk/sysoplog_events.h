@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_SYSOPLOG_EVENTS_H
+#define INCLUDED_SDK_SYSOPLOG_EVENTS_H
+
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The sysop log event stream.
+ *
+ * Every line written to the sysop log by any node is also appended to
+ * SYSOPLOG_EVT in gfiles as one record per line of tab separated fields:
+ * time (seconds since the epoch), node number, user name and the event text.
+ */
+
+namespace wwiv::sdk {
+
+struct sysoplog_event_t {
+  time_t time{0};
+  int node{0};
+  std::string user;
+  std::string text;
+};
+
+/** Formats e as a single record line, including the trailing newline. */
+[[nodiscard]] std::string to_sysoplog_event_line(const sysoplog_event_t& e);
+
+/** Parses a record line (with or without the trailing newline). */
+[[nodiscard]] std::optional<sysoplog_event_t> parse_sysoplog_event_line(std::string_view line);
+
+/**
+ * Appends all of chunks to path using a single write on a file opened with
+ * O_APPEND, so that lines written by multiple nodes are never interleaved.
+ */
+bool append_atomically(const std::filesystem::path& path, const std::vector<std::string>& chunks);
+
+/** Number of rotated copies of the sysop log event stream that are kept. */
+static constexpr int SYSOPLOG_EVT_BACKUPS = 7;
+
+/**
+ * Renames the event stream at path to path.1, path.1 to path.2 and so on,
+ * keeping at most backups old copies.  Nodes open the stream for every
+ * append, so new records go to a new file at path.  Called once a day from
+ * the daily maintenance so the stream doesn't grow forever.
+ */
+bool rotate_sysoplog_events(const std::filesystem::path& path,
+                            int backups = SYSOPLOG_EVT_BACKUPS);
+
+/**
+ * Reads records from the sysop log event stream starting at a byte offset,
+ * so that the stream can be followed by polling read().
+ */
+class SysopLogEventReader final {
+public:
+  explicit SysopLogEventReader(std::filesystem::path path, int64_t offset = 0)
+      : path_(std::move(path)), offset_(offset) {}
+
+  /** Moves the read position to the start of the last num records. */
+  void seek_last(int num);
+
+  /**
+   * Returns all complete records written since the last call. If the file
+   * has been truncated or rotated since then, reading starts over from the
+   * beginning of the new file.
+   */
+  [[nodiscard]] std::vector<sysoplog_event_t> read();
+
+  [[nodiscard]] int64_t offset() const noexcept { return offset_; }
+
+private:
+  const std::filesystem::path path_;
+  int64_t offset_;
+  // Identity of the file offset_ refers to, or 0 if not known.
+  uint64_t file_id_{0};
+};
+
+} // namespace wwiv::sdk
+
+#endif
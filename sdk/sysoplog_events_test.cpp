@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core/test/file_helper.h"
+#include "fmt/format.h"
+#include "sdk/sysoplog_events.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+using namespace wwiv::sdk;
+
+TEST(SysopLogEventsTest, RoundTrip) {
+  sysoplog_event_t e{};
+  e.time = 1666000000;
+  e.node = 3;
+  e.user = "Rushfan";
+  e.text = "Read\tmail\r\n";
+  const auto line = to_sysoplog_event_line(e);
+  EXPECT_EQ("1666000000\t3\tRushfan\tRead mail  \n", line);
+
+  const auto p = parse_sysoplog_event_line(line);
+  ASSERT_TRUE(p.has_value());
+  EXPECT_EQ(e.time, p->time);
+  EXPECT_EQ(3, p->node);
+  EXPECT_EQ("Rushfan", p->user);
+  EXPECT_EQ("Read mail  ", p->text);
+}
+
+TEST(SysopLogEventsTest, Parse_Invalid) {
+  EXPECT_FALSE(parse_sysoplog_event_line("").has_value());
+  EXPECT_FALSE(parse_sysoplog_event_line("1\t2").has_value());
+}
+
+TEST(SysopLogEventsTest, AppendAndRead) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("sysoplog.evt");
+  SysopLogEventReader reader(path);
+  EXPECT_TRUE(reader.read().empty());
+
+  ASSERT_TRUE(append_atomically(path, {"1\t1\tA\tone\n", "2\t2\tB\ttwo\n"}));
+  auto events = reader.read();
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ("one", events.front().text);
+  EXPECT_EQ(2, events.back().node);
+  EXPECT_TRUE(reader.read().empty());
+
+  // A partial record is not returned until it is complete.
+  ASSERT_TRUE(append_atomically(path, {"3\t1\tA\tthr"}));
+  EXPECT_TRUE(reader.read().empty());
+  ASSERT_TRUE(append_atomically(path, {"ee\n"}));
+  events = reader.read();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ("three", events.front().text);
+}
+
+TEST(SysopLogEventsTest, SeekLast) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("sysoplog.evt");
+  std::vector<std::string> lines;
+  for (auto i = 0; i < 1000; i++) {
+    sysoplog_event_t e{};
+    e.time = i;
+    e.node = 1;
+    e.user = "User";
+    e.text = std::string(20, 'x');
+    lines.push_back(to_sysoplog_event_line(e));
+  }
+  ASSERT_TRUE(append_atomically(path, lines));
+
+  SysopLogEventReader reader(path);
+  reader.seek_last(2);
+  const auto events = reader.read();
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(998, events.front().time);
+  EXPECT_EQ(999, events.back().time);
+
+  SysopLogEventReader all(path);
+  all.seek_last(5000);
+  EXPECT_EQ(1000u, all.read().size());
+}
+
+TEST(SysopLogEventsTest, Rotate) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("sysoplog.evt");
+  SysopLogEventReader reader(path);
+  for (auto i = 1; i <= 3; i++) {
+    ASSERT_TRUE(append_atomically(path, {fmt::format("{}\t1\tA\tday {}\n", i, i)}));
+    ASSERT_EQ(1u, reader.read().size());
+    ASSERT_TRUE(rotate_sysoplog_events(path, 2));
+    EXPECT_FALSE(File::Exists(path));
+  }
+  EXPECT_EQ("3\t1\tA\tday 3\n", helper.ReadFile(FilePath(helper.TempDir(), "sysoplog.evt.1")));
+  EXPECT_EQ("2\t1\tA\tday 2\n", helper.ReadFile(FilePath(helper.TempDir(), "sysoplog.evt.2")));
+  EXPECT_FALSE(File::Exists(FilePath(helper.TempDir(), "sysoplog.evt.3")));
+
+  // Readers following the stream start over on the new file.
+  ASSERT_TRUE(append_atomically(path, {"4\t1\tA\tday 4\n"}));
+  const auto events = reader.read();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ("day 4", events.front().text);
+
+  // Nothing to rotate.
+  EXPECT_TRUE(rotate_sysoplog_events(FilePath(helper.TempDir(), "missing.evt"), 2));
+}
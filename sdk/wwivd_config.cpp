@@ -83,6 +83,7 @@ void serialize(Archive& ar, wwivd_matrix_entry_t &a) {
   SERIALIZE(a, telnet_cmd);
   SERIALIZE(a, data_mode);
   SERIALIZE(a, working_directory);
+  SERIALIZE(a, warm_workers);
 }
 
 template <class Archive>
@@ -93,6 +94,7 @@ void serialize(Archive & ar, wwivd_config_t &a) {
   SERIALIZE(a, binkp_cmd);
   SERIALIZE(a, do_network_callouts);
   SERIALIZE(a, network_callout_cmd);
+  SERIALIZE(a, network_callout_max_sessions);
   SERIALIZE(a, do_beginday_event);
   SERIALIZE(a, beginday_cmd);
   SERIALIZE(a, http_address);
@@ -74,6 +74,11 @@ struct wwivd_matrix_entry_t {
   int local_node;
   /** Mode for passing data to the BBS: Socket or Named Pipe */
   wwivd_data_mode_t data_mode{wwivd_data_mode_t::socket};
+  /**
+   * Number of idle nodes to keep a fully initialized BBS waiting on, so that
+   * telnet callers don't have to wait for the BBS to start.  0 disables this.
+   */
+  int warm_workers{0};
 };
 
 class wwivd_config_t {
@@ -84,6 +89,8 @@ public:
   std::string binkp_cmd;
   bool do_network_callouts{false};
   std::string network_callout_cmd;
+  /** Maximum number of network callouts to run at the same time. */
+  int network_callout_max_sessions{4};
   bool do_beginday_event{true};
   std::string beginday_cmd;
 
@@ -194,6 +194,10 @@ static void edit_matrix_entry(const Config& config, wwivd_matrix_entry_t& b) {
     items.add(new Label("Data Mode:"),
               new ToggleEditItem<wwiv::sdk::wwivd_data_mode_t>(data_modes, &b.data_mode),
               "The way to communicate from wwivd to bbs (default is socket handle)", 1, y);
+    y++;
+    items.add(new Label("Warm Workers:"), new NumberEditItem<int>(&b.warm_workers),
+              "Number of idle nodes to keep a BBS started and waiting on for telnet (0=none)",
+              1, y);
   }
 
   items.relayout_items_and_labels();
@@ -359,6 +363,9 @@ void wwivd_ui(const Config& config) {
   items.add(new Label("Net Callouts:"),
             new BooleanEditItem(&c.do_network_callouts),
             "Command to execute to perform a network callout.", 1, y);
+  items.add(new Label("Max Sessions:"),
+            new NumberEditItem<int>(&c.network_callout_max_sessions),
+            "Maximum number of network callouts to run at the same time.", 3, y);
 
   y++;
   items.add(new Label("Net Callout Cmd:"),
@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV BBS Software                             */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/callout_scheduler.h"
+
+#include "core/log.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace wwiv::wwivd {
+
+using namespace std::chrono;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+std::string callout_request_t::key() const {
+  return StrCat(ToStringLowerCase(network_name), ":", node);
+}
+
+minutes callout_backoff(int consecutive_failures) {
+  if (consecutive_failures <= 0) {
+    return minutes(0);
+  }
+  // 1, 2, 4, 8, 16, 32, then capped at 60 minutes.
+  const auto shift = std::min(consecutive_failures - 1, 6);
+  return std::min(minutes(1 << shift), minutes(60));
+}
+
+CalloutScheduler::CalloutScheduler(int max_sessions, executor_t executor,
+                                   std::filesystem::path log_path, Clock& clock)
+    : max_sessions_(std::max(1, max_sessions)), executor_(std::move(executor)),
+      log_path_(std::move(log_path)), clock_(clock) {
+  for (auto i = 0; i < max_sessions_; i++) {
+    threads_.emplace_back([this] { Worker(); });
+  }
+}
+
+CalloutScheduler::~CalloutScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stopping_ = true;
+    if (!queue_.empty()) {
+      LOG(INFO) << "Dropping " << queue_.size() << " queued callouts.";
+    }
+    for (const auto& r : queue_) {
+      active_.erase(r.key());
+    }
+    queue_.clear();
+  }
+  cv_.notify_all();
+  idle_cv_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+bool CalloutScheduler::can_call_locked(const std::string& key) const {
+  if (active_.find(key) != std::end(active_)) {
+    return false;
+  }
+  if (const auto it = backoff_.find(key); it != std::end(backoff_)) {
+    return it->second.next_allowed <= clock_.Now();
+  }
+  return true;
+}
+
+bool CalloutScheduler::can_call(const callout_request_t& r) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return can_call_locked(r.key());
+}
+
+bool CalloutScheduler::Schedule(const callout_request_t& r) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto key = r.key();
+    if (!can_call_locked(key)) {
+      VLOG(2) << "Not scheduling callout to: " << key << "; running or backing off.";
+      return false;
+    }
+    active_.insert(key);
+    queue_.push_back(r);
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void CalloutScheduler::Wait() {
+  std::unique_lock<std::mutex> lock(mu_);
+  idle_cv_.wait(lock, [this] { return active_.empty(); });
+}
+
+std::map<std::string, callout_backoff_t> CalloutScheduler::backoff() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return backoff_;
+}
+
+void CalloutScheduler::Worker() {
+  for (;;) {
+    callout_request_t r;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) {
+        return;
+      }
+      r = queue_.front();
+      queue_.pop_front();
+    }
+
+    const auto start = clock_.Now();
+    auto ok = false;
+    try {
+      ok = executor_(r);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception calling: " << r.key() << ": " << e.what();
+    }
+    Log(r, start, ok);
+
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      const auto key = r.key();
+      if (ok) {
+        backoff_.erase(key);
+      } else {
+        auto& b = backoff_[key];
+        ++b.consecutive_failures;
+        b.next_allowed = clock_.Now() + callout_backoff(b.consecutive_failures);
+        LOG(INFO) << "Callout to " << key << " failed " << b.consecutive_failures
+                  << " times in a row; not calling again until: " << b.next_allowed.to_string();
+      }
+      active_.erase(key);
+      if (active_.empty()) {
+        idle_cv_.notify_all();
+      }
+    }
+  }
+}
+
+void CalloutScheduler::Log(const callout_request_t& r, const DateTime& start, bool ok) {
+  if (log_path_.empty()) {
+    return;
+  }
+  const auto elapsed = duration_cast<seconds>(clock_.Now().to_system_clock() - start.to_system_clock());
+  const auto line = fmt::format("{} {:<12} {:<24} {:>5}s {}", start.to_string("%FT%T"),
+                                r.network_name, r.node, elapsed.count(), ok ? "OK" : "FAILED");
+  std::lock_guard<std::mutex> lock(log_mu_);
+  TextFile f(log_path_, "at");
+  f.WriteLine(line);
+}
+
+} // namespace
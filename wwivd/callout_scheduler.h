@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV BBS Software                             */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_CALLOUT_SCHEDULER_H
+#define INCLUDED_WWIVD_CALLOUT_SCHEDULER_H
+
+#include "core/clock.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/** A single outbound network session. */
+struct callout_request_t {
+  /** Network number, passed as @T to the callout command. */
+  int network_number{0};
+  std::string network_name;
+  /** WWIVnet node number or FTN address, passed as @N to the callout command. */
+  std::string node;
+
+  /** Key used to limit sessions and track failures per node. */
+  [[nodiscard]] std::string key() const;
+};
+
+struct callout_backoff_t {
+  int consecutive_failures{0};
+  core::DateTime next_allowed;
+};
+
+/**
+ * Returns how long to wait before calling a node again after it has
+ * failed consecutive_failures times in a row: 1 minute doubling up to 1 hour.
+ */
+std::chrono::minutes callout_backoff(int consecutive_failures);
+
+/**
+ * Runs network callouts on up to max_sessions threads at once, while never
+ * running more than one session to the same node.  Nodes whose sessions
+ * fail are not called again until their backoff has expired.  One line per
+ * session is appended to log_path.
+ */
+class CalloutScheduler final {
+public:
+  /** Runs the session, returning true if it succeeded. */
+  typedef std::function<bool(const callout_request_t&)> executor_t;
+
+  CalloutScheduler(int max_sessions, executor_t executor, std::filesystem::path log_path,
+                   core::Clock& clock);
+  /**
+   * Drops any queued sessions and waits for the running ones to finish, so
+   * shutting down isn't held up by calls that haven't started yet.
+   */
+  ~CalloutScheduler();
+
+  /**
+   * Queues r to run, returns false if a session to that node is already
+   * queued or running, or the node is backing off after failures.
+   */
+  bool Schedule(const callout_request_t& r);
+  /** True if r is not queued, running or backing off. */
+  [[nodiscard]] bool can_call(const callout_request_t& r) const;
+  /** Waits until nothing is queued or running. */
+  void Wait();
+
+  [[nodiscard]] int max_sessions() const { return max_sessions_; }
+  // Used for testing
+  [[nodiscard]] std::map<std::string, callout_backoff_t> backoff() const;
+
+private:
+  [[nodiscard]] bool can_call_locked(const std::string& key) const;
+  void Worker();
+  void Log(const callout_request_t& r, const core::DateTime& start, bool ok);
+
+  const int max_sessions_;
+  executor_t executor_;
+  const std::filesystem::path log_path_;
+  core::Clock& clock_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::condition_variable idle_cv_;
+  // GUARDED_BY(mu_)
+  std::deque<callout_request_t> queue_;
+  // Keys of queued or running sessions. GUARDED_BY(mu_)
+  std::set<std::string> active_;
+  // GUARDED_BY(mu_)
+  std::map<std::string, callout_backoff_t> backoff_;
+  // GUARDED_BY(mu_)
+  bool stopping_{false};
+  std::mutex log_mu_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace
+
+#endif
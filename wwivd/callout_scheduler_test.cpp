@@ -0,0 +1,134 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "core/fake_clock.h"
+#include "core/file.h"
+#include "core/textfile.h"
+#include "core/test/file_helper.h"
+#include "wwivd/callout_scheduler.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::wwivd;
+
+TEST(CalloutBackoff, Smoke) {
+  EXPECT_EQ(0min, callout_backoff(0));
+  EXPECT_EQ(1min, callout_backoff(1));
+  EXPECT_EQ(2min, callout_backoff(2));
+  EXPECT_EQ(32min, callout_backoff(6));
+  EXPECT_EQ(60min, callout_backoff(7));
+  EXPECT_EQ(60min, callout_backoff(100));
+}
+
+TEST(CalloutScheduler, RunsConcurrently) {
+  FakeClock clock(DateTime::now());
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::atomic<int> calls{0};
+  auto exec = [&](const callout_request_t&) {
+    const auto r = ++running;
+    auto m = max_running.load();
+    while (r > m && !max_running.compare_exchange_weak(m, r)) {}
+    std::this_thread::sleep_for(50ms);
+    --running;
+    ++calls;
+    return true;
+  };
+  CalloutScheduler scheduler(3, exec, "", clock);
+  for (auto i = 1; i <= 6; i++) {
+    EXPECT_TRUE(scheduler.Schedule({0, "wwivnet", std::to_string(i)}));
+  }
+  scheduler.Wait();
+  EXPECT_EQ(6, calls.load());
+  EXPECT_LE(max_running.load(), 3);
+  EXPECT_GT(max_running.load(), 1);
+}
+
+TEST(CalloutScheduler, OneSessionPerNode) {
+  FakeClock clock(DateTime::now());
+  std::mutex mu;
+  mu.lock();
+  auto exec = [&](const callout_request_t&) {
+    std::lock_guard<std::mutex> lock(mu);
+    return true;
+  };
+  CalloutScheduler scheduler(4, exec, "", clock);
+  const callout_request_t r{0, "wwivnet", "1"};
+  EXPECT_TRUE(scheduler.Schedule(r));
+  EXPECT_FALSE(scheduler.can_call(r));
+  EXPECT_FALSE(scheduler.Schedule(r));
+  EXPECT_TRUE(scheduler.Schedule({0, "wwivnet", "2"}));
+  EXPECT_TRUE(scheduler.Schedule({1, "fidonet", "1"}));
+  mu.unlock();
+  scheduler.Wait();
+  EXPECT_TRUE(scheduler.can_call(r));
+}
+
+TEST(CalloutScheduler, BacksOffFailedNodes) {
+  wwiv::core::test::FileHelper helper;
+  const auto log = FilePath(helper.TempDir(), "callout.log");
+  FakeClock clock(DateTime::now());
+  CalloutScheduler scheduler(2, [](const callout_request_t&) { return false; }, log, clock);
+  const callout_request_t r{0, "wwivnet", "1"};
+  EXPECT_TRUE(scheduler.Schedule(r));
+  scheduler.Wait();
+  EXPECT_EQ(1, scheduler.backoff().at(r.key()).consecutive_failures);
+  EXPECT_FALSE(scheduler.Schedule(r));
+
+  clock.tick(61s);
+  EXPECT_TRUE(scheduler.Schedule(r));
+  scheduler.Wait();
+  EXPECT_EQ(2, scheduler.backoff().at(r.key()).consecutive_failures);
+  clock.tick(61s);
+  EXPECT_FALSE(scheduler.can_call(r));
+  clock.tick(60s);
+  EXPECT_TRUE(scheduler.can_call(r));
+
+  TextFile f(log, "rt");
+  const auto lines = f.ReadFileIntoVector();
+  ASSERT_EQ(2u, lines.size());
+  EXPECT_NE(std::string::npos, lines.front().find("FAILED"));
+}
+
+TEST(CalloutScheduler, DropsQueuedOnDestruction) {
+  FakeClock clock(DateTime::now());
+  std::atomic<int> calls{0};
+  auto exec = [&](const callout_request_t&) {
+    ++calls;
+    std::this_thread::sleep_for(200ms);
+    return true;
+  };
+  auto scheduler = std::make_unique<CalloutScheduler>(1, exec, "", clock);
+  for (auto i = 1; i <= 3; i++) {
+    EXPECT_TRUE(scheduler->Schedule({0, "wwivnet", std::to_string(i)}));
+  }
+  while (calls.load() == 0) {
+    std::this_thread::yield();
+  }
+  // Waits for the running callout, but not the two still queued.
+  scheduler.reset();
+  EXPECT_EQ(1, calls.load());
+}
@@ -20,9 +20,12 @@
 
 #include "core/net.h"
 #include "sdk/config.h"
+#include "sdk/instance.h"
 #include "sdk/wwivd_config.h"
 #include "wwivd/ips.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/status_snapshot.h"
+#include "wwivd/warm_pool.h"
 #include <map>
 #include <memory>
 
@@ -38,9 +41,17 @@ struct ConnectionData {
   const wwiv::sdk::wwivd_config_t* c;
   std::map<const std::string, std::shared_ptr<NodeManager>>* nodes;
   std::shared_ptr<ConcurrentConnections> concurrent_connections_;
+  // HTTP connections being served, counted apart from the BBS ones.
+  std::shared_ptr<ConcurrentConnections> http_connections_;
   std::shared_ptr<GoodIp> good_ips_;
   std::shared_ptr<BadIp> bad_ips_;
   std::shared_ptr<AutoBlocker> auto_blocker_;
+  // The node status board, shared by all connections.
+  std::shared_ptr<wwiv::sdk::Instances> instances_;
+  // The status served over HTTP, refreshed in the background.
+  std::shared_ptr<StatusSnapshot> status_;
+  // Warm BBS workers by BBS name, only for BBSes that use them.
+  std::map<std::string, std::shared_ptr<WarmPool>> warm_pools_;
 };
 
 }  // namespace wwivd
@@ -17,6 +17,7 @@
 /**************************************************************************/
 
 #include "core/datetime.h"
+#include "core/file.h"
 #include "core/log.h"
 #include "core/os.h"
 #include "core/stl.h"
@@ -29,6 +30,7 @@
 #include "sdk/net/callouts.h"
 #include "sdk/net/contact.h"
 #include "sdk/net/networks.h"
+#include "wwivd/callout_scheduler.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/wwivd.h"
 #include "wwivd/wwivd_non_http.h"
@@ -52,6 +54,7 @@ using namespace wwiv::os;
 
 std::atomic<bool> need_to_exit;
 std::atomic<bool> need_to_reload_config;
+std::atomic<bool> need_to_reload_warm_pools;
 
 // TODO(rushfan): Add tests for new stuff in here.
 
@@ -65,8 +68,45 @@ static NetworkContact network_contact_from_last_time(const fido::FidoAddress& ad
   return NetworkContact{ncr};
 }
 
+// Returns the number of failed sessions recorded in contact.net for the node
+// in r, networkb adds one each time it is unable to connect.
+static int callout_failures(const Config& config, const callout_request_t& r) {
+  const Networks networks(config);
+  if (!networks.contains(r.network_name)) {
+    return 0;
+  }
+  const auto& net = networks[r.network_name];
+  Contact contact(net);
+  const auto* ncn = net.type == network_type_t::wwivnet
+                        ? contact.contact_rec_for(to_number<int>(r.node))
+                        : contact.contact_rec_for(r.node);
+  return ncn == nullptr ? 0 : ncn->numfails();
+}
+
+// Executes the network callout command for r, this is run on one of the
+// CalloutScheduler threads.
+static bool execute_callout(const Config& config, const wwivd_config_t& c,
+                            const callout_request_t& r) {
+  const auto failures = callout_failures(config, r);
+  const std::map<char, std::string> params = {{'N', r.node},
+                                              {'T', std::to_string(r.network_number)}};
+  const auto cmd = CreateCommandLine(c.network_callout_cmd, params);
+  auto exit_code = -1;
+  if (!ExecCommandAndWait(c, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET, &exit_code)) {
+    LOG(ERROR) << "Error executing command: '" << cmd << "'";
+    return false;
+  }
+  if (exit_code != 0) {
+    LOG(WARNING) << "Callout to " << r.key() << " failed; '" << cmd
+                 << "' exited with code: " << exit_code;
+    return false;
+  }
+  // networkb may exit cleanly after a failed session, contact.net knows better.
+  return callout_failures(config, r) <= failures;
+}
+
 static void one_net_ftn_callout(const Config& config, const Network& net,
-                                const wwivd_config_t& c, int network_number) {
+                                CalloutScheduler& scheduler, int network_number) {
   const fido::FidoCallout callout(config.root_directory(), config.max_backups(), net);
 
   // TODO(rushfan): 1. Right now we just keep the map of last call-out
@@ -86,6 +126,11 @@ static void one_net_ftn_callout(const Config& config, const Network& net,
       // Is the call out bit set.
       continue;
     }
+    const callout_request_t r{network_number, net.name, address.as_string()};
+    if (!scheduler.can_call(r)) {
+      // Already calling it, or it is backing off after failures.
+      continue;
+    }
     auto ncn = network_contact_from_last_time(address,
                                               DateTime::from_time_t(current_last_contact[address]),
                                               ftn_bytes_waiting(net, address));
@@ -97,16 +142,11 @@ static void one_net_ftn_callout(const Config& config, const Network& net,
     current_last_contact[address] = DateTime::now().to_time_t();
     // 2: Call it.
     LOG(INFO) << "ftn: should call out to: " << address.as_string() << "." << net.name;
-    const std::map<char, std::string> params = {{'N', address.as_string()},
-                                           {'T', std::to_string(network_number)}};
-    const auto cmd = CreateCommandLine(c.network_callout_cmd, params);
-    if (!ExecCommandAndWait(c, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
-      LOG(ERROR) << "Error executing command: '" << cmd << "'";
-    }
+    scheduler.Schedule(r);
   }
 }
 
-static void one_net_wwivnet_callout(const Network& net, const wwivd_config_t& c,
+static void one_net_wwivnet_callout(const Network& net, CalloutScheduler& scheduler,
                                     int network_number) {
   VLOG(2) << "one_net_wwivnet_callout: @" << net.sysnum << "; name: " << net.name;
   Contact contact(net);
@@ -126,27 +166,27 @@ static void one_net_wwivnet_callout(const Network& net, const wwivd_config_t& c,
       VLOG(2) << "!should_call: #" << kv.second.sysnum;
       continue;
     }
+    const callout_request_t r{network_number, net.name, std::to_string(kv.first)};
+    if (!scheduler.can_call(r)) {
+      VLOG(2) << "!can_call: #" << kv.second.sysnum << "; running or backing off.";
+      continue;
+    }
     // Call it.
     LOG(INFO) << "should call out to: " << kv.first << "." << net.name;
-    const std::map<char, std::string> params = {{'N', std::to_string(kv.first)},
-                                           {'T', std::to_string(network_number)}};
-    const auto cmd = CreateCommandLine(c.network_callout_cmd, params);
-    if (!ExecCommandAndWait(c, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
-      LOG(ERROR) << "Error executing command: " << cmd;
-    }
+    scheduler.Schedule(r);
   }
 }
 
-static void one_callout_loop(const Config& config, const wwivd_config_t& c) {
+static void one_callout_loop(const Config& config, CalloutScheduler& scheduler) {
   VLOG(1) << "do_wwivd_callouts: one_callout_loop: ";
   const Networks networks(config);
   const auto& nets = networks.networks();
   auto network_number = 0;
   for (const auto& net : nets) {
     if (net.type == network_type_t::wwivnet) {
-      one_net_wwivnet_callout(net, c, network_number++);
+      one_net_wwivnet_callout(net, scheduler, network_number++);
     } else if (net.type == network_type_t::ftn) {
-      one_net_ftn_callout(config, net, c, network_number++);
+      one_net_ftn_callout(config, net, scheduler, network_number++);
     }
   }
 }
@@ -156,6 +196,11 @@ static void do_wwivd_callout_loop(const Config& config, const wwivd_config_t& or
   auto c{original_config};
 
   StatusMgr sm(config.datadir(), [](int) {});
+  SystemClock clock;
+  CalloutScheduler scheduler(
+      c.network_callout_max_sessions,
+      [&](const callout_request_t& r) { return execute_callout(config, c, r); },
+      FilePath(config.logdir(), "callout.log"), clock);
   auto e = need_to_exit.load();
   auto last_callout = DateTime::now().to_system_clock();
   while (!e) {
@@ -163,12 +208,14 @@ static void do_wwivd_callout_loop(const Config& config, const wwivd_config_t& or
     if (need_to_reload_config.load()) {
       LOG(INFO) << "Received HUP: Reloading Configuration for Callouts.";
       need_to_reload_config.store(false);
+      // The running callouts are using c, so let them finish first.
+      scheduler.Wait();
       c.Load(config);
     }
     if (c.do_network_callouts) {
       if (auto now = DateTime::now().to_system_clock(); now - last_callout > 60s) {
         last_callout = DateTime::now().to_system_clock();
-        one_callout_loop(config, c);
+        one_callout_loop(config, scheduler);
       }
     }
     if (need_to_exit.load()) {
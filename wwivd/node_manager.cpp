@@ -147,16 +147,23 @@ bool NodeManager::ReleaseNode(int node) {
   return true;
 }
 
-ConcurrentConnections::ConcurrentConnections(int max_num) : max_num_(max_num) {}
+ConcurrentConnections::ConcurrentConnections(int max_num, int max_total)
+    : max_num_(max_num), max_total_(max_total) {}
 ConcurrentConnections::~ConcurrentConnections() = default;
 
 bool ConcurrentConnections::aquire(const std::string& peer) {
   VLOG(1) << "ConcurrentConnections::aquire: " << peer;
   std::lock_guard<std::mutex> lock(connection_mu_);
-  const auto cur = map_[peer];
+  const auto it = map_.find(peer);
+  const auto cur = it == map_.end() ? 0 : it->second;
   VLOG(2) << "ConcurrentConnections: cur: " << cur << "; max_num_: " << max_num_;
+  if (max_total_ > 0 && total_ >= max_total_) {
+    VLOG(2) << "ConcurrentConnections: total: " << total_ << "; max_total_: " << max_total_;
+    return false;
+  }
   if (cur < max_num_) {
     map_[peer] = cur + 1;
+    ++total_;
     VLOG(2) << "ConcurrentConnections: (post increment) cur: " << cur << "; max_num_: " << max_num_;
     return true;
   }
@@ -165,7 +172,12 @@ bool ConcurrentConnections::aquire(const std::string& peer) {
 
 bool ConcurrentConnections::release(const std::string& peer) {
   std::lock_guard<std::mutex> lock(connection_mu_);
-  const auto cur = map_[peer] - 1;
+  const auto it = map_.find(peer);
+  if (it == map_.end()) {
+    return false;
+  }
+  --total_;
+  const auto cur = it->second - 1;
   if (cur > 0) {
     map_[peer] = cur;
   } else {
@@ -91,7 +91,11 @@ private:
 
 class ConcurrentConnections final {
 public:
-  explicit ConcurrentConnections(int max_num);
+  /**
+   * Allows up to max_num connections from each peer and, when max_total is
+   * more than 0, up to max_total from all of them.
+   */
+  explicit ConcurrentConnections(int max_num, int max_total = 0);
   ~ConcurrentConnections();
 
   ConcurrentConnections() = delete;
@@ -105,6 +109,8 @@ public:
 
 private:
   int max_num_{1};
+  int max_total_{0};
+  int total_{0};
   std::mutex connection_mu_;
   std::unordered_map<std::string, int> map_;
 };
@@ -0,0 +1,145 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/status_snapshot.h"
+
+#include "core/crc32.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "fmt/format.h"
+#include <string>
+#include <utility>
+
+using namespace wwiv::strings;
+
+namespace wwiv::wwivd {
+
+std::string http_etag(std::string_view body) {
+  return fmt::format("\"{:08x}-{:x}\"", wwiv::core::crc32string(body), body.size());
+}
+
+bool etag_matches(const std::vector<std::string>& headers, std::string_view etag) {
+  static const std::string name = "if-none-match:";
+  for (const auto& h : headers) {
+    if (h.size() < name.size() || !iequals(h.substr(0, name.size()), name)) {
+      continue;
+    }
+    for (auto tag : SplitString(h.substr(name.size()), ",")) {
+      StringTrim(&tag);
+      if (tag == "*") {
+        return true;
+      }
+      // If-None-Match uses the weak comparison.
+      if (starts_with(tag, "W/")) {
+        tag = tag.substr(2);
+      }
+      if (tag == etag) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::string sse_event(std::string_view event, uint64_t id, std::string_view data) {
+  auto s = fmt::format("event: {}\nid: {}\n", event, id);
+  while (!data.empty()) {
+    const auto nl = data.find('\n');
+    auto line = data.substr(0, nl);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    s.append("data: ").append(line).push_back('\n');
+    if (nl == std::string_view::npos) {
+      break;
+    }
+    data.remove_prefix(nl + 1);
+  }
+  s.push_back('\n');
+  return s;
+}
+
+StatusSnapshot::StatusSnapshot(builder_t builder) : builder_(std::move(builder)) {
+  Refresh();
+}
+
+StatusSnapshot::~StatusSnapshot() {
+  Stop();
+}
+
+bool StatusSnapshot::Refresh() {
+  auto json = builder_();
+  std::lock_guard<std::mutex> lock(mu_);
+  if (current_ && current_->json == json) {
+    return false;
+  }
+  auto s = std::make_shared<snapshot_t>();
+  s->version = current_ ? current_->version + 1 : 1;
+  s->etag = http_etag(json);
+  s->event = sse_event("status", s->version, json);
+  s->json = std::move(json);
+  current_ = std::move(s);
+  cv_.notify_all();
+  return true;
+}
+
+void StatusSnapshot::Start(std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (thread_.joinable() || stopped_) {
+    return;
+  }
+  thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!cv_.wait_for(lock, interval, [this] { return stopped_; })) {
+      lock.unlock();
+      try {
+        Refresh();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Error refreshing the status: " << e.what();
+      }
+      lock.lock();
+    }
+  });
+}
+
+void StatusSnapshot::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::shared_ptr<const StatusSnapshot::snapshot_t> StatusSnapshot::current() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return current_;
+}
+
+std::shared_ptr<const StatusSnapshot::snapshot_t>
+StatusSnapshot::WaitForChange(uint64_t version, std::chrono::milliseconds timeout) const {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait_for(lock, timeout, [&] { return stopped_ || current_->version > version; });
+  if (stopped_) {
+    return nullptr;
+  }
+  return current_;
+}
+
+}  // namespace wwiv::wwivd
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_STATUS_SNAPSHOT_H
+#define INCLUDED_WWIVD_STATUS_SNAPSHOT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+/**
+ * Returns the quoted entity tag for body, suitable for the ETag header.
+ */
+[[nodiscard]] std::string http_etag(std::string_view body);
+
+/**
+ * True if any If-None-Match header in headers (raw "Name: value" lines)
+ * matches etag, so the client's copy is current.
+ */
+[[nodiscard]] bool etag_matches(const std::vector<std::string>& headers, std::string_view etag);
+
+/**
+ * Formats data as a single server-sent event named event with id id,
+ * prefixing every line of data with "data: ".
+ */
+[[nodiscard]] std::string sse_event(std::string_view event, uint64_t id, std::string_view data);
+
+/**
+ * A pre-serialized copy of the wwivd status.  The status is rebuilt on a
+ * background thread every interval, and the serialized text, entity tag and
+ * server-sent event are only regenerated when the status has changed, so
+ * requests never touch the disk or the serializer.
+ */
+class StatusSnapshot final {
+public:
+  /** Builds the current status as JSON. */
+  typedef std::function<std::string()> builder_t;
+
+  static constexpr auto REFRESH_INTERVAL = std::chrono::seconds(2);
+
+  struct snapshot_t {
+    /** Starts at 1 and is incremented every time the status changes. */
+    uint64_t version{0};
+    std::string json;
+    std::string etag;
+    std::string event;
+  };
+
+  /** Builds the initial snapshot using builder. */
+  explicit StatusSnapshot(builder_t builder);
+  /** Stops the refresh thread. */
+  ~StatusSnapshot();
+  StatusSnapshot(const StatusSnapshot&) = delete;
+  StatusSnapshot& operator=(const StatusSnapshot&) = delete;
+
+  /** Rebuilds the status now, returning true if it changed. */
+  bool Refresh();
+  /** Starts a thread to Refresh every interval until Stop is called. */
+  void Start(std::chrono::milliseconds interval = REFRESH_INTERVAL);
+  /** Stops the refresh thread and wakes everyone in WaitForChange. */
+  void Stop();
+
+  [[nodiscard]] std::shared_ptr<const snapshot_t> current() const;
+
+  /**
+   * Waits up to timeout for a snapshot newer than version, returning the
+   * current snapshot (which is not newer on timeout) or nullptr once stopped.
+   */
+  [[nodiscard]] std::shared_ptr<const snapshot_t> WaitForChange(uint64_t version,
+                                                                std::chrono::milliseconds timeout) const;
+
+private:
+  const builder_t builder_;
+  mutable std::mutex mu_;
+  mutable std::condition_variable cv_;
+  std::shared_ptr<const snapshot_t> current_;
+  bool stopped_{false};
+  std::thread thread_;
+};
+
+}  // namespace wwiv::wwivd
+
+#endif
@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2022, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/status_snapshot.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace wwiv::wwivd;
+
+TEST(HttpEtag, Smoke) {
+  const auto etag = http_etag("{}");
+  EXPECT_EQ('"', etag.front());
+  EXPECT_EQ('"', etag.back());
+  EXPECT_EQ(etag, http_etag("{}"));
+  EXPECT_NE(etag, http_etag("{ }"));
+}
+
+TEST(EtagMatches, Smoke) {
+  const std::string etag = "\"1234abcd-2\"";
+  EXPECT_TRUE(etag_matches({"If-None-Match: \"1234abcd-2\""}, etag));
+  EXPECT_TRUE(etag_matches({"Accept: */*", "if-none-match: \"1234abcd-2\""}, etag));
+  EXPECT_TRUE(etag_matches({"If-None-Match: \"x\", W/\"1234abcd-2\""}, etag));
+  EXPECT_TRUE(etag_matches({"If-None-Match: *"}, etag));
+  EXPECT_FALSE(etag_matches({"If-None-Match: \"1234abcd-3\""}, etag));
+  EXPECT_FALSE(etag_matches({"ETag: \"1234abcd-2\""}, etag));
+  EXPECT_FALSE(etag_matches({}, etag));
+}
+
+TEST(SseEvent, SingleLine) {
+  EXPECT_EQ("event: status\nid: 3\ndata: {}\n\n", sse_event("status", 3, "{}"));
+}
+
+TEST(SseEvent, MultiLine) {
+  EXPECT_EQ("event: status\nid: 1\ndata: {\ndata:   \"a\": 1\ndata: }\n\n",
+            sse_event("status", 1, "{\r\n  \"a\": 1\n}"));
+}
+
+TEST(StatusSnapshotTest, RefreshOnlyChangesWhenStatusDoes) {
+  std::string json = "{\"a\": 1}";
+  StatusSnapshot s([&] { return json; });
+  const auto first = s.current();
+  ASSERT_TRUE(first);
+  EXPECT_EQ(1u, first->version);
+  EXPECT_EQ(json, first->json);
+  EXPECT_EQ(http_etag(json), first->etag);
+  EXPECT_EQ(sse_event("status", 1, json), first->event);
+
+  EXPECT_FALSE(s.Refresh());
+  EXPECT_EQ(first, s.current());
+
+  json = "{\"a\": 2}";
+  EXPECT_TRUE(s.Refresh());
+  const auto second = s.current();
+  EXPECT_EQ(2u, second->version);
+  EXPECT_EQ(json, second->json);
+  EXPECT_NE(first->etag, second->etag);
+  // Anyone still holding the first snapshot sees it unchanged.
+  EXPECT_EQ("{\"a\": 1}", first->json);
+}
+
+TEST(StatusSnapshotTest, WaitForChange_Timeout) {
+  StatusSnapshot s([] { return std::string("{}"); });
+  const auto w = s.WaitForChange(1, 10ms);
+  ASSERT_TRUE(w);
+  EXPECT_EQ(1u, w->version);
+}
+
+TEST(StatusSnapshotTest, WaitForChange_AlreadyNewer) {
+  StatusSnapshot s([] { return std::string("{}"); });
+  const auto w = s.WaitForChange(0, 10s);
+  ASSERT_TRUE(w);
+  EXPECT_EQ(1u, w->version);
+}
+
+TEST(StatusSnapshotTest, WaitForChange_WokenByRefresh) {
+  std::atomic<int> n{0};
+  StatusSnapshot s([&] { return std::to_string(n.load()); });
+  std::thread t([&] {
+    n.store(1);
+    s.Refresh();
+  });
+  const auto w = s.WaitForChange(1, 10s);
+  t.join();
+  ASSERT_TRUE(w);
+  EXPECT_EQ(2u, w->version);
+  EXPECT_EQ("1", w->json);
+}
+
+TEST(StatusSnapshotTest, Stop_WakesWaiters) {
+  StatusSnapshot s([] { return std::string("{}"); });
+  std::thread t([&] { s.Stop(); });
+  EXPECT_FALSE(s.WaitForChange(1, 10s));
+  t.join();
+}
+
+TEST(StatusSnapshotTest, Start_Refreshes) {
+  std::atomic<int> n{0};
+  StatusSnapshot s([&] { return std::to_string(n.load()); });
+  s.Start(1ms);
+  n.store(1);
+  const auto w = s.WaitForChange(1, 10s);
+  ASSERT_TRUE(w);
+  EXPECT_EQ("1", w->json);
+  s.Stop();
+}
@@ -0,0 +1,229 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV BBS Software                             */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/warm_pool.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/os.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "wwivd/wwivd.h"
+#include "wwivd/wwivd_non_http.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+namespace wwiv::wwivd {
+
+time_t bbs_config_stamp(const Config& config) {
+  std::vector<std::filesystem::path> files{
+      FilePath(config.root_directory(), CONFIG_JSON), FilePath(config.root_directory(), CONFIG_DAT),
+      FilePath(config.root_directory(), WWIV_INI)};
+  for (const auto* f : {SUBS_JSON, DIRS_JSON, NETWORKS_JSON, CHAINS_JSON, "gfiles.json",
+                        "conference.json", "sl.json", "autoval.json", ARCHIVER_DAT, EDITORS_DAT}) {
+    files.emplace_back(FilePath(config.datadir(), f));
+  }
+  for (const auto* f : {NEXTERN_DAT, NINTERN_DAT}) {
+    files.emplace_back(FilePath(config.datadir(), f));
+  }
+  // The menus are read as they're used, so any change to one of them (or a
+  // menu set being added or removed) makes the workers stale.
+  std::error_code ec;
+  for (std::filesystem::recursive_directory_iterator it(config.menudir(), ec), end;
+       !ec && it != end; it.increment(ec)) {
+    files.emplace_back(it->path());
+  }
+  files.emplace_back(config.menudir());
+
+  time_t stamp = 0;
+  for (const auto& f : files) {
+    if (File::Exists(f)) {
+      stamp = std::max(stamp, File::last_write_time(f));
+    }
+  }
+  return stamp;
+}
+
+WarmPool::WarmPool(const Config& config, wwivd_matrix_entry_t bbs,
+                   std::shared_ptr<NodeManager> nodes, Clock& clock, warm_worker_fns_t fns)
+    : config_(config), nodes_(std::move(nodes)), clock_(clock), fns_(std::move(fns)),
+      bbs_(std::move(bbs)) {
+  if (!fns_.spawn) {
+    fns_.spawn = SpawnWarmWorker;
+  }
+  if (!fns_.running) {
+    fns_.running = IsWarmWorkerRunning;
+  }
+  if (!fns_.wait) {
+    fns_.wait = WaitForWarmWorker;
+  }
+}
+
+WarmPool::~WarmPool() {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto& [node, w] : workers_) {
+    StopWorker(w);
+  }
+  workers_.clear();
+}
+
+bool WarmPool::usable(const worker_t& w, time_t stamp) const {
+  return fns_.running(w.pid) && w.config_stamp == stamp && clock_.Now() < w.started + MAX_IDLE;
+}
+
+void WarmPool::StopWorker(const worker_t& w) const {
+  // Closing our end of the channel tells the worker to exit.
+  closesocket(w.channel);
+  fns_.wait(w.pid, "[warm] ", 0);
+}
+
+static bool uses_warm_workers(const wwivd_matrix_entry_t& bbs) {
+  return bbs.warm_workers > 0 && !bbs.telnet_cmd.empty() &&
+         !starts_with(bbs.telnet_cmd, "@telnet:") && bbs.data_mode == wwivd_data_mode_t::socket;
+}
+
+void WarmPool::Refill() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!uses_warm_workers(bbs_)) {
+      return;
+    }
+  }
+  const auto stamp = bbs_config_stamp(config_);
+  std::vector<worker_t> stale;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (auto it = workers_.begin(); it != workers_.end();) {
+      if (usable(it->second, stamp)) {
+        ++it;
+        continue;
+      }
+      VLOG(1) << "Recycling warm worker for node #" << it->first;
+      stale.push_back(it->second);
+      it = workers_.erase(it);
+    }
+  }
+  for (const auto& w : stale) {
+    StopWorker(w);
+  }
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (!uses_warm_workers(bbs_)) {
+    // Reloaded while we were stopping the stale workers.
+    return;
+  }
+  const auto working_dir = bbs_.working_directory.empty()
+                               ? std::filesystem::path(config_.root_directory())
+                               : FilePath(config_.root_directory(), bbs_.working_directory);
+  // Nodes are handed out lowest first, so keep the lowest idle nodes warm.
+  auto num_idle = 0;
+  for (auto node = nodes_->start_node();
+       node <= nodes_->end_node() && num_idle < bbs_.warm_workers; node++) {
+    if (nodes_->status_for_copy(node).connected) {
+      continue;
+    }
+    ++num_idle;
+    if (workers_.find(node) != workers_.end()) {
+      continue;
+    }
+    worker_t w{};
+    auto cmd_fn = [&](SOCKET channel) {
+      const std::map<char, std::string> params = {
+          {'N', std::to_string(node)},
+          {'H', std::to_string(channel)},
+          {'P', std::to_string(os::get_pid())},
+      };
+      return StrCat("cd \"", working_dir.string(), "\" && ",
+                    CreateCommandLine(bbs_.telnet_cmd, params));
+    };
+    if (!fns_.spawn(cmd_fn, w.pid, w.channel)) {
+      // Not supported or not working, don't keep trying on every node.
+      return;
+    }
+    w.config_stamp = stamp;
+    w.started = clock_.Now();
+    VLOG(1) << "Started warm worker for node #" << node << "; pid: " << w.pid;
+    workers_.emplace(node, w);
+  }
+}
+
+void WarmPool::Reload(wwivd_matrix_entry_t bbs) {
+  std::map<int, worker_t> workers;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    bbs_ = std::move(bbs);
+    std::swap(workers, workers_);
+  }
+  for (const auto& [node, w] : workers) {
+    VLOG(1) << "Stopping warm worker for node #" << node << " to reload.";
+    StopWorker(w);
+  }
+}
+
+bool WarmPool::Handoff(int node, SOCKET& sock, const std::string& pid) {
+  worker_t w{};
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto it = workers_.find(node);
+    if (it == workers_.end()) {
+      return false;
+    }
+    w = it->second;
+    workers_.erase(it);
+  }
+  if (!usable(w, bbs_config_stamp(config_)) || !SendSocketHandle(w.channel, sock, "T")) {
+    LOG(INFO) << pid << "Warm worker for node #" << node << " is not usable.";
+    StopWorker(w);
+    return false;
+  }
+  VLOG(1) << pid << "Handed connection to warm worker for node #" << node;
+  // The worker has its own copy of the socket now.  Don't keep ours open for
+  // the whole session, or the caller won't be disconnected when it closes it.
+  closesocket(sock);
+  sock = INVALID_SOCKET;
+  closesocket(w.channel);
+  fns_.wait(w.pid, pid, node);
+  return true;
+}
+
+void WarmPool::Stop(int node) {
+  worker_t w{};
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto it = workers_.find(node);
+    if (it == workers_.end()) {
+      return;
+    }
+    w = it->second;
+    workers_.erase(it);
+  }
+  StopWorker(w);
+}
+
+int WarmPool::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return static_cast<int>(workers_.size());
+}
+
+} // namespace wwiv::wwivd
@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV BBS Software                             */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_WARM_POOL_H
+#define INCLUDED_WWIVD_WARM_POOL_H
+
+#include "core/clock.h"
+#include "core/net.h"
+#include "sdk/config.h"
+#include "sdk/wwivd_config.h"
+#include "wwivd/node_manager.h"
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace wwiv::wwivd {
+
+/**
+ * Returns the newest last write time of the configuration files a BBS loads
+ * at startup, including the menus.
+ */
+time_t bbs_config_stamp(const sdk::Config& config);
+
+/**
+ * How a WarmPool starts, checks on and waits for its worker processes.  Any
+ * function left empty uses SpawnWarmWorker, IsWarmWorkerRunning and
+ * WaitForWarmWorker.
+ */
+struct warm_worker_fns_t {
+  std::function<bool(const std::function<std::string(SOCKET)>& cmd_fn, int& pid,
+                     SOCKET& channel)>
+      spawn;
+  std::function<bool(int pid)> running;
+  std::function<void(int worker_pid, const std::string& pid, int node_number)> wait;
+};
+
+/**
+ * Keeps a BBS started and fully initialized on each of the first
+ * warm_workers idle nodes of a matrix BBS, waiting for wwivd to hand it an
+ * accepted telnet socket.
+ *
+ * Workers are recycled when any of the configuration files the BBS reads at
+ * startup change, or once they have been idle for MAX_IDLE.
+ */
+class WarmPool final {
+public:
+  static constexpr auto MAX_IDLE = std::chrono::minutes(30);
+
+  WarmPool(const sdk::Config& config, sdk::wwivd_matrix_entry_t bbs,
+           std::shared_ptr<NodeManager> nodes, core::Clock& clock,
+           warm_worker_fns_t fns = {});
+  ~WarmPool();
+
+  WarmPool() = delete;
+  WarmPool(const WarmPool&) = delete;
+  WarmPool& operator=(const WarmPool&) = delete;
+
+  /** Stops stale or exited workers and starts workers on idle nodes. */
+  void Refill();
+
+  /**
+   * Stops all of the workers and replaces the BBS settings with bbs, so that
+   * the next Refill starts workers using them.  Used when wwivd gets a HUP.
+   */
+  void Reload(sdk::wwivd_matrix_entry_t bbs);
+
+  /**
+   * Hands sock to the worker waiting on node, closes our copy of it and sets
+   * sock to INVALID_SOCKET, and then waits for the session to end.  Returns
+   * false if there is no usable worker for node, in which case sock is left
+   * alone and the caller must launch the BBS itself.
+   */
+  bool Handoff(int node, SOCKET& sock, const std::string& pid);
+
+  /** Stops the worker waiting on node, if any. */
+  void Stop(int node);
+
+  /** Number of workers currently waiting for a connection. */
+  [[nodiscard]] int size() const;
+
+private:
+  struct worker_t {
+    int pid{0};
+    SOCKET channel{INVALID_SOCKET};
+    time_t config_stamp{0};
+    core::DateTime started;
+  };
+
+  [[nodiscard]] bool usable(const worker_t& w, time_t stamp) const;
+  void StopWorker(const worker_t& w) const;
+
+  const sdk::Config& config_;
+  std::shared_ptr<NodeManager> nodes_;
+  core::Clock& clock_;
+  warm_worker_fns_t fns_;
+  mutable std::mutex mu_;
+  sdk::wwivd_matrix_entry_t bbs_; // GUARDED_BY(mu_)
+  // Workers by node number.
+  std::map<int, worker_t> workers_; // GUARDED_BY(mu_)
+};
+
+} // namespace wwiv::wwivd
+
+#endif
@@ -0,0 +1,273 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV BBS Software                             */
+/*                 Copyright (C)2022, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/warm_pool.h"
+
+#include "core/fake_clock.h"
+#include "core/file.h"
+#include "core/net.h"
+#include "core/strings.h"
+#include "core/test/file_helper.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/wwivd_config.h"
+#include "wwivd/node_manager.h"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+using namespace wwiv::wwivd;
+
+static config_t test_config() {
+  config_t c{};
+  c.datadir = "data";
+  c.menudir = "menus";
+  return c;
+}
+
+static void set_time(const std::filesystem::path& path, time_t t) {
+  File f(path);
+  ASSERT_TRUE(f.set_last_write_time(t)) << path.string();
+}
+
+class BbsConfigStampTest : public testing::Test {
+protected:
+  BbsConfigStampTest() : config_(helper_.TempDir(), test_config()) {
+    File::mkdirs(FilePath(config_.menudir(), "wwiv"));
+    File::mkdirs(config_.datadir());
+  }
+
+  FileHelper helper_;
+  Config config_;
+};
+
+TEST_F(BbsConfigStampTest, ExternsAndMenus) {
+  const time_t t0 = 1000000000;
+  set_time(FilePath(config_.menudir(), "wwiv"), t0);
+  set_time(config_.menudir(), t0);
+  EXPECT_EQ(t0, bbs_config_stamp(config_));
+
+  const auto nextern = helper_.CreateTempFile(FilePath("data", NEXTERN_DAT).string(), "x");
+  set_time(nextern, t0 + 10);
+  EXPECT_EQ(t0 + 10, bbs_config_stamp(config_));
+
+  const auto nintern = helper_.CreateTempFile(FilePath("data", NINTERN_DAT).string(), "x");
+  set_time(nintern, t0 + 20);
+  EXPECT_EQ(t0 + 20, bbs_config_stamp(config_));
+
+  const auto menu = helper_.CreateTempFile(FilePath("menus/wwiv", "main.mnu").string(), "x");
+  set_time(menu, t0 + 30);
+  set_time(FilePath(config_.menudir(), "wwiv"), t0);
+  EXPECT_EQ(t0 + 30, bbs_config_stamp(config_));
+
+  // Removing a menu changes the directory it was in.
+  ASSERT_TRUE(File::Remove(menu));
+  EXPECT_LT(t0 + 30, bbs_config_stamp(config_));
+}
+
+class WarmPoolTest : public testing::Test {
+protected:
+  struct fake_worker_t {
+    int pid{0};
+    // The worker's end of the channel.
+    SOCKET channel{INVALID_SOCKET};
+    std::string cmd;
+  };
+
+  WarmPoolTest()
+      : config_(helper_.TempDir(), test_config()), clock_(DateTime::now()),
+        nodes_(std::make_shared<NodeManager>("BBS", ConnectionType::TELNET, 1, 4)) {
+    File::mkdirs(config_.menudir());
+    File::mkdirs(config_.datadir());
+    bbs_.name = "BBS";
+    bbs_.telnet_cmd = "bbs -N@N -H@H";
+    bbs_.start_node = 1;
+    bbs_.end_node = 4;
+    bbs_.warm_workers = 2;
+
+    fns_.spawn = [this](const std::function<std::string(SOCKET)>& cmd_fn, int& pid,
+                        SOCKET& channel) {
+      int sv[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+        return false;
+      }
+      pid = next_pid_++;
+      channel = sv[0];
+      spawned_.push_back(fake_worker_t{pid, sv[1], cmd_fn(sv[1])});
+      running_.insert(pid);
+      return true;
+    };
+    fns_.running = [this](int pid) { return running_.count(pid) > 0; };
+    fns_.wait = [this](int pid, const std::string&, int) { running_.erase(pid); };
+  }
+
+  void TearDown() override {
+    pool_.reset();
+    for (const auto& w : spawned_) {
+      close(w.channel);
+    }
+  }
+
+  WarmPool& pool() {
+    if (!pool_) {
+      pool_ = std::make_unique<WarmPool>(config_, bbs_, nodes_, clock_, fns_);
+    }
+    return *pool_;
+  }
+
+  /** Returns true once wwivd has closed its end of the channel to worker i. */
+  bool stopped(int i) const {
+    char c;
+    return recv(spawned_.at(i).channel, &c, 1, MSG_DONTWAIT) == 0;
+  }
+
+  FileHelper helper_;
+  Config config_;
+  FakeClock clock_;
+  std::shared_ptr<NodeManager> nodes_;
+  wwivd_matrix_entry_t bbs_{};
+  warm_worker_fns_t fns_;
+  int next_pid_{100};
+  std::vector<fake_worker_t> spawned_;
+  std::set<int> running_;
+  std::unique_ptr<WarmPool> pool_;
+};
+
+TEST_F(WarmPoolTest, Refill_LowestIdleNodes) {
+  nodes_->set_node(1, ConnectionType::TELNET, "Connected");
+  pool().Refill();
+  ASSERT_EQ(2u, spawned_.size());
+  EXPECT_EQ(2, pool().size());
+  EXPECT_TRUE(ends_with(spawned_[0].cmd, StrCat("bbs -N2 -H", spawned_[0].channel)))
+      << spawned_[0].cmd;
+  EXPECT_TRUE(ends_with(spawned_[1].cmd, StrCat("bbs -N3 -H", spawned_[1].channel)))
+      << spawned_[1].cmd;
+
+  // Nothing to do while they're still usable.
+  pool().Refill();
+  EXPECT_EQ(2u, spawned_.size());
+}
+
+TEST_F(WarmPoolTest, Refill_Disabled) {
+  bbs_.warm_workers = 0;
+  pool().Refill();
+  EXPECT_TRUE(spawned_.empty());
+}
+
+TEST_F(WarmPoolTest, Handoff) {
+  pool().Refill();
+  int conn[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, conn));
+  SOCKET sock = conn[0];
+  ASSERT_TRUE(pool().Handoff(1, sock, "[test] "));
+  // Our copy of the connection is closed as soon as the worker has it.
+  EXPECT_EQ(INVALID_SOCKET, sock);
+  EXPECT_EQ(0u, running_.count(spawned_[0].pid));
+  EXPECT_EQ(1, pool().size());
+
+  SOCKET received = INVALID_SOCKET;
+  std::string data;
+  ASSERT_TRUE(ReceiveSocketHandle(spawned_[0].channel, received, data));
+  EXPECT_EQ("T", data);
+  ASSERT_EQ(2, write(received, "hi", 2));
+  char buf[10]{};
+  ASSERT_EQ(2, read(conn[1], buf, sizeof(buf)));
+  EXPECT_EQ("hi", std::string(buf, 2));
+
+  // When the worker hangs up, the caller is disconnected.
+  close(received);
+  EXPECT_EQ(0, read(conn[1], buf, sizeof(buf)));
+  close(conn[1]);
+}
+
+TEST_F(WarmPoolTest, Handoff_NoWorker) {
+  SOCKET sock = 42;
+  EXPECT_FALSE(pool().Handoff(1, sock, "[test] "));
+  EXPECT_EQ(42, sock);
+}
+
+TEST_F(WarmPoolTest, Handoff_WorkerExited) {
+  pool().Refill();
+  running_.erase(spawned_[0].pid);
+  SOCKET sock = 42;
+  EXPECT_FALSE(pool().Handoff(1, sock, "[test] "));
+  EXPECT_EQ(42, sock);
+  EXPECT_TRUE(stopped(0));
+  EXPECT_EQ(1, pool().size());
+}
+
+TEST_F(WarmPoolTest, Refill_RecyclesWhenConfigChanges) {
+  pool().Refill();
+  ASSERT_EQ(2u, spawned_.size());
+
+  const auto nextern = helper_.CreateTempFile(FilePath("data", NEXTERN_DAT).string(), "x");
+  set_time(nextern, time(nullptr) + 100);
+  pool().Refill();
+  ASSERT_EQ(4u, spawned_.size());
+  EXPECT_TRUE(stopped(0));
+  EXPECT_TRUE(stopped(1));
+  EXPECT_FALSE(stopped(2));
+  EXPECT_EQ(2, pool().size());
+}
+
+TEST_F(WarmPoolTest, Refill_RecyclesIdleWorkers) {
+  pool().Refill();
+  clock_.tick(WarmPool::MAX_IDLE - 1min);
+  pool().Refill();
+  EXPECT_EQ(2u, spawned_.size());
+
+  clock_.tick(2min);
+  pool().Refill();
+  EXPECT_EQ(4u, spawned_.size());
+  EXPECT_TRUE(stopped(0));
+  EXPECT_TRUE(stopped(1));
+}
+
+TEST_F(WarmPoolTest, Reload) {
+  pool().Refill();
+  auto bbs = bbs_;
+  bbs.warm_workers = 1;
+  pool().Reload(bbs);
+  EXPECT_EQ(0, pool().size());
+  EXPECT_TRUE(stopped(0));
+  EXPECT_TRUE(stopped(1));
+
+  pool().Refill();
+  EXPECT_EQ(3u, spawned_.size());
+  EXPECT_EQ(1, pool().size());
+
+  // Removed from the matrix.
+  pool().Reload(wwivd_matrix_entry_t{});
+  pool().Refill();
+  EXPECT_EQ(3u, spawned_.size());
+  EXPECT_EQ(0, pool().size());
+}
+
+#endif
@@ -29,11 +29,14 @@
 #include "core/strings.h"
 #include "core/version.h"
 #include "sdk/config.h"
+#include "sdk/instance.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/nets.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/warm_pool.h"
 #include "wwivd/wwivd_http.h"
 #include "wwivd/wwivd_non_http.h"
+#include <algorithm>
 #include <atomic>
 #include <csignal>
 #include <iostream>
@@ -69,6 +72,7 @@ namespace wwiv::wwivd {
 
 extern std::atomic<bool> need_to_exit;
 extern std::atomic<bool> need_to_reload_config;
+extern std::atomic<bool> need_to_reload_warm_pools;
 
 static bool DeleteAllSemaphores(const Config& config, int start_node, int end_node) {
   // Delete telnet/SSH node semaphore files.
@@ -126,6 +130,13 @@ int Main(CommandLine& cmdline) {
       std::make_shared<ConcurrentConnections>(c.blocking.max_concurrent_sessions);
 
   ConnectionData data(&config, &c, &nodes, concurrent_connections);
+  data.http_connections_ =
+      std::make_shared<ConcurrentConnections>(MAX_HTTP_CONNECTIONS_PER_PEER, MAX_HTTP_CONNECTIONS);
+  data.instances_ = std::make_shared<Instances>(config);
+  if (c.http_port > 0) {
+    data.status_ = CreateStatusSnapshot(data);
+    data.status_->Start();
+  }
   if (c.blocking.use_goodip_txt) {
     data.good_ips_ = std::make_shared<GoodIp>(FilePath(config.datadir(), "goodip.txt"));
   }
@@ -140,6 +151,11 @@ int Main(CommandLine& cmdline) {
     }
     data.auto_blocker_ = std::make_shared<AutoBlocker>(data.bad_ips_, c.blocking, config.datadir(), clock);
   }
+  // Every BBS gets a pool so that a HUP can turn warm workers on or off. Pools
+  // for BBSes without warm workers never start any.
+  for (const auto& b : c.bbses) {
+    data.warm_pools_[b.name] = std::make_shared<WarmPool>(config, b, nodes.at(b.name), clock);
+  }
 
   auto telnet_or_ssh_fn = [&](accepted_socket_t r) {
     std::thread client(HandleConnection, std::make_unique<ConnectionHandler>(data, r));
@@ -150,8 +166,10 @@ int Main(CommandLine& cmdline) {
     client.detach();
   };
   auto http_fn = [&](accepted_socket_t r) {
-    std::thread client(HandleHttpConnection, data, r);
-    client.detach();
+    if (auto peer = AcquireHttpConnection(data, r)) {
+      std::thread client(HandleHttpConnection, data, r, std::move(peer.value()));
+      client.detach();
+    }
   };
 
   SocketSet sockets(10);
@@ -173,10 +191,42 @@ int Main(CommandLine& cmdline) {
   SwitchToNonRootUser(wwiv_user);
   need_to_exit.store(false);
   need_to_reload_config.store(false);
+  need_to_reload_warm_pools.store(false);
 
   // Do network callouts if enabled.
   do_wwivd_callouts(config, c);
 
+  // Keep the warm BBS workers started, and recycle them when the config changes.
+  std::thread warm_pool_thread;
+  if (!data.warm_pools_.empty()) {
+    std::thread t([&] {
+      while (!need_to_exit.load()) {
+        if (need_to_reload_warm_pools.exchange(false)) {
+          LOG(INFO) << "Received HUP: Restarting warm BBS workers.";
+          wwivd_config_t reloaded{};
+          if (reloaded.Load(config)) {
+            for (const auto& [name, pool] : data.warm_pools_) {
+              const auto it = std::find_if(reloaded.bbses.begin(), reloaded.bbses.end(),
+                                           [&](const auto& b) { return b.name == name; });
+              // A BBS removed from the matrix keeps its nodes, but no warm workers.
+              pool->Reload(it != reloaded.bbses.end() ? *it : wwivd_matrix_entry_t{});
+            }
+          }
+        }
+        for (const auto& [name, pool] : data.warm_pools_) {
+          pool->Refill();
+        }
+        sleep_for(std::chrono::seconds(2));
+      }
+    });
+    std::swap(t, warm_pool_thread);
+  }
+  ScopeExit join_warm_pool_thread([&] {
+    if (warm_pool_thread.joinable()) {
+      warm_pool_thread.join();
+    }
+  });
+
   if (!sockets.Run(need_to_exit)) {
     LOG(INFO) << "Error accepting client socket. " << errno;
     return 2;
@@ -19,6 +19,7 @@
 #ifndef INCLUDED_WWIV_WWIV_WWIVD_H
 #define INCLUDED_WWIV_WWIV_WWIVD_H
 
+#include <functional>
 #include <string>
 #include <core/net.h>
 #include "sdk/config.h"
@@ -36,8 +37,30 @@ void SwitchToNonRootUser(const std::string& wwiv_user);
  * If sock is > -1 then we'll close the socket after executing the command 
  * since this is the child socket.
  * pid and node_number is just used for logging.
+ * If exit_code is not null, it's set to the exit code of the command, or -1
+ * if the command did not exit normally.
  */
 bool ExecCommandAndWait(const wwiv::sdk::wwivd_config_t& wc, const std::string& cmd,
-                        const std::string& pid, int node_number, SOCKET sock);
+                        const std::string& pid, int node_number, SOCKET sock,
+                        int* exit_code = nullptr);
+
+/**
+ * Spawns a warm BBS worker that initializes itself and then waits to be
+ * handed a connection over channel.  cmd_fn is given the worker's end of the
+ * channel and returns the command line to run.  The worker finds its end of
+ * the channel in the WWIV_HANDOFF environment variable.
+ * Returns false if this isn't supported on this platform.
+ */
+bool SpawnWarmWorker(const std::function<std::string(SOCKET)>& cmd_fn, int& pid,
+                     SOCKET& channel);
+
+/** Returns true if the warm worker pid has not exited. */
+bool IsWarmWorkerRunning(int pid);
+
+/**
+ * Waits for a warm worker that has been handed a connection to exit.
+ * pid and node_number is just used for logging.
+ */
+void WaitForWarmWorker(int worker_pid, const std::string& pid, int node_number);
 
 #endif
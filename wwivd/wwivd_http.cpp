@@ -32,13 +32,19 @@
 #include "core/log.h"
 #include "core/net.h"
 #include "core/os.h"
+#include "core/scope_exit.h"
 #include "core/socket_connection.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "sdk/config.h"
+#include "sdk/instance.h"
+#include "sdk/net/contact.h"
+#include "sdk/net/networks.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/node_manager.h"
+#include "wwivd/status_snapshot.h"
 
+#include <chrono>
 #include <string>
 
 namespace wwiv::wwivd {
@@ -49,14 +55,56 @@ using namespace wwiv::stl;
 using namespace wwiv::strings;
 using namespace wwiv::os;
 
+/** A node with a caller on it, from the node status board. */
+struct node_status_t {
+  int node;
+  int user_number;
+  std::string location;
+  std::string updated;
+
+  template <class Archive> void serialize(Archive& ar) {
+    ar(cereal::make_nvp("node", node), cereal::make_nvp("user_number", user_number),
+       cereal::make_nvp("location", location), cereal::make_nvp("updated", updated));
+  }
+};
+
+/** Queue size and last callouts for one node in a network, from contact.net. */
+struct contact_status_t {
+  std::string address;
+  uint32_t bytes_waiting;
+  uint32_t last_contact;
+  uint32_t last_try;
+  int failures;
+
+  template <class Archive> void serialize(Archive& ar) {
+    ar(cereal::make_nvp("address", address), cereal::make_nvp("bytes_waiting", bytes_waiting),
+       cereal::make_nvp("last_contact", last_contact), cereal::make_nvp("last_try", last_try),
+       cereal::make_nvp("failures", failures));
+  }
+};
+
+struct network_status_t {
+  std::string name;
+  uint32_t bytes_waiting;
+  std::vector<contact_status_t> contacts;
+
+  template <class Archive> void serialize(Archive& ar) {
+    ar(cereal::make_nvp("name", name), cereal::make_nvp("bytes_waiting", bytes_waiting),
+       cereal::make_nvp("contacts", contacts));
+  }
+};
+
 struct status_reponse_t {
   int num_instances;
   int used_instances;
   std::vector<std::string> lines;
+  std::vector<node_status_t> online;
+  std::vector<network_status_t> networks;
 
   template <class Archive> void serialize(Archive& ar) {
     ar(cereal::make_nvp("num_instances", num_instances),
-      cereal::make_nvp("used_instances", used_instances), cereal::make_nvp("lines", lines));
+      cereal::make_nvp("used_instances", used_instances), cereal::make_nvp("lines", lines),
+      cereal::make_nvp("online", online), cereal::make_nvp("networks", networks));
   }
 };
 
@@ -72,17 +120,39 @@ std::string ToJson(status_reponse_t r) {
   return ss.str();
 }
 
-class StatusHandler : public HttpHandler {
-public:
-  StatusHandler(std::map<const std::string, std::shared_ptr<NodeManager>>* nodes) : nodes_(nodes) {}
+static std::vector<network_status_t> network_status(const Config& config) {
+  std::vector<network_status_t> result;
+  const Networks networks(config);
+  for (const auto& net : networks.networks()) {
+    const Contact contact(net);
+    if (contact.contacts().empty()) {
+      continue;
+    }
+    network_status_t n{net.name, 0, {}};
+    for (const auto& [address, c] : contact.contacts()) {
+      n.bytes_waiting += c.bytes_waiting();
+      n.contacts.push_back(
+          {address, c.bytes_waiting(), c.lastcontact(), c.lasttry(), c.numfails()});
+    }
+    result.emplace_back(std::move(n));
+  }
+  return result;
+}
 
-  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string> headers) override {
-    // We only handle status
-    HttpResponse response(200);
-    response.headers.emplace("Content-Type: ", "text/json");
+std::shared_ptr<StatusSnapshot> CreateStatusSnapshot(const ConnectionData& data) {
+  // contact.net only changes after a network session, so it's read far less
+  // often than the node status, which is all in memory.
+  static constexpr auto NETWORK_REFRESH = std::chrono::seconds(30);
+  auto last_network_refresh = std::chrono::steady_clock::time_point::min();
+  std::vector<network_status_t> networks;
 
+  const auto* config = data.config;
+  auto* nodes = data.nodes;
+  auto instances = data.instances_;
+
+  return std::make_shared<StatusSnapshot>([=]() mutable {
     status_reponse_t r{};
-    for (const auto& n : *nodes_) {
+    for (const auto& n : *nodes) {
       const auto v = n.second->status_lines();
       r.num_instances += n.second->total_nodes();
       r.used_instances += n.second->nodes_used();
@@ -90,30 +160,116 @@ public:
         r.lines.push_back(l);
       }
     }
-    response.text = ToJson(r);
+    if (instances) {
+      for (const auto& inst : instances->all()) {
+        // Invisible callers stay that way here too.
+        if (inst.online() && !inst.invisible()) {
+          r.online.push_back({inst.node_number(), inst.user_number(),
+                              inst.location_description(), inst.updated().to_string()});
+        }
+      }
+    }
+    if (const auto now = std::chrono::steady_clock::now();
+        now - last_network_refresh >= NETWORK_REFRESH) {
+      networks = network_status(*config);
+      last_network_refresh = now;
+    }
+    r.networks = networks;
+    return ToJson(r);
+  });
+}
+
+/** Serves the status snapshot, or 304 if the client already has it. */
+class StatusHandler : public HttpHandler {
+public:
+  explicit StatusHandler(StatusSnapshot* status) : status_(status) {}
+
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string> headers) override {
+    const auto s = status_->current();
+    HttpResponse response(200);
+    response.headers.emplace("ETag", s->etag);
+    response.headers.emplace("Cache-Control", "no-cache");
+    if (etag_matches(headers, s->etag)) {
+      response.status = 304;
+      return response;
+    }
+    response.headers.emplace("Content-Type", "application/json");
+    response.text = s->json;
+    return response;
+  }
+
+private:
+  StatusSnapshot* status_;
+};
+
+/**
+ * Streams the status as server-sent events: the current snapshot right away,
+ * and then every new one as it's made.
+ */
+class StatusEventsHandler : public HttpHandler {
+public:
+  // Sent when nothing has changed so proxies don't time out the stream.
+  static constexpr auto KEEPALIVE_INTERVAL = std::chrono::seconds(15);
+
+  explicit StatusEventsHandler(StatusSnapshot* status) : status_(status) {}
+
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string>) override {
+    HttpResponse response(200);
+    response.headers.emplace("Content-Type", "text/event-stream");
+    response.headers.emplace("Cache-Control", "no-cache");
+    response.stream = [this](HttpResponseWriter& writer) {
+      static const std::string keepalive = ": keep-alive\n\n";
+      auto s = status_->current();
+      uint64_t sent = 0;
+      while (s) {
+        if (!writer.write(s->version > sent ? s->event : keepalive)) {
+          break;
+        }
+        sent = s->version;
+        s = status_->WaitForChange(sent, KEEPALIVE_INTERVAL);
+      }
+    };
     return response;
   }
 
 private:
-  std::map<const std::string, std::shared_ptr<NodeManager>>* nodes_;
+  StatusSnapshot* status_;
 };
 
-void HandleHttpConnection(ConnectionData data, accepted_socket_t r) {
-  const auto sock = r.client_socket;
+std::optional<std::string> AcquireHttpConnection(const ConnectionData& data,
+                                                 const accepted_socket_t& r) {
+  std::string peer;
+  GetRemotePeerAddress(r.client_socket, peer);
+  if (data.http_connections_->aquire(peer)) {
+    return peer;
+  }
+  LOG(INFO) << "HTTP BUSY (Concurrent Limit Reached): " << peer;
+  try {
+    HttpServer h(std::make_unique<SocketConnection>(r.client_socket));
+    h.SendResponse(HttpResponse(503));
+  } catch (const std::exception& e) {
+    VLOG(1) << "AcquireHttpConnection: " << e.what();
+  }
+  return std::nullopt;
+}
+
+void HandleHttpConnection(ConnectionData data, accepted_socket_t r, std::string peer) {
   const auto& b = data.c->blocking;
+  ScopeExit at_exit([&] { data.http_connections_->release(peer); });
 
   try {
-    std::string remote_peer;
-    if (GetRemotePeerAddress(sock, remote_peer)) {
-      const auto cc = get_dns_cc(remote_peer, b.dns_cc_server);
-      LOG(INFO) << "Accepted HTTP connection on port: " << r.port << "; from: " << remote_peer
+    if (!peer.empty()) {
+      const auto cc = get_dns_cc(peer, b.dns_cc_server);
+      LOG(INFO) << "Accepted HTTP connection on port: " << r.port << "; from: " << peer
         << "; country code: " << cc;
     }
 
-    // HTTP Request
+    // Serves every request on this connection until the client is done.
     HttpServer h(std::make_unique<SocketConnection>(r.client_socket));
-    StatusHandler status(data.nodes);
+    StatusHandler status(data.status_.get());
+    StatusEventsHandler events(data.status_.get());
     h.add(HttpMethod::GET, "/status", &status);
+    h.add(HttpMethod::GET, "/status/events", &events);
     h.Run();
 
   }
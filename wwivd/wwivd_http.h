@@ -19,10 +19,37 @@
 #define INCLUDED_WWIVD_WWIVD_HTTP_H
 
 #include "wwivd/connection_data.h"
+#include "wwivd/status_snapshot.h"
+#include <memory>
+#include <optional>
+#include <string>
 
 namespace wwiv::wwivd {
 
-void HandleHttpConnection(ConnectionData data, wwiv::core::accepted_socket_t r);
+/**
+ * Creates the status snapshot for nodes, callers and network queues in
+ * data.  It isn't refreshed until it's started.
+ */
+std::shared_ptr<StatusSnapshot> CreateStatusSnapshot(const ConnectionData& data);
+
+/**
+ * Most HTTP connections, including status event streams, served at once.
+ * Each one has its own thread.
+ */
+static constexpr int MAX_HTTP_CONNECTIONS = 32;
+/** Most HTTP connections served at once to one address. */
+static constexpr int MAX_HTTP_CONNECTIONS_PER_PEER = 4;
+
+/**
+ * Counts the HTTP connection r against data.http_connections_, returning the
+ * address of the client.  If there are already too many, the client is sent
+ * a 503, the connection is closed and nothing is returned.
+ */
+std::optional<std::string> AcquireHttpConnection(const ConnectionData& data,
+                                                 const wwiv::core::accepted_socket_t& r);
+
+/** Serves the HTTP connection r from peer, releasing it when done. */
+void HandleHttpConnection(ConnectionData data, wwiv::core::accepted_socket_t r, std::string peer);
 
 }  // namespace
 
@@ -283,8 +283,8 @@ static void socket_pipe_loop(SOCKET sock, Pipe& data_pipe, Pipe& control_pipe) {
 
 static bool launch_cmd(const wwivd_config_t& wc, const std::string& raw_cmd,
                        const std::string& working_dir, const std::shared_ptr<NodeManager>& nodes,
-                       int node_number, SOCKET sock, ConnectionType connection_type,
-                       const std::string& remote_peer) {
+                       const std::shared_ptr<WarmPool>& warm_pool, int node_number, SOCKET& sock,
+                       ConnectionType connection_type, const std::string& remote_peer) {
   const auto pid = fmt::format("[{}] ", get_pid());
   nodes->set_node(node_number, connection_type, StrCat("Connected: ", remote_peer));
 
@@ -307,6 +307,14 @@ static bool launch_cmd(const wwivd_config_t& wc, const std::string& raw_cmd,
   if (starts_with(raw_cmd, "@telnet:")) {
     return telnet_to(raw_cmd.substr(8), node_number, sock);
   }
+  if (warm_pool) {
+    if (connection_type == ConnectionType::TELNET && sock != INVALID_SOCKET &&
+        warm_pool->Handoff(node_number, sock, pid)) {
+      return true;
+    }
+    // Never leave a warm worker waiting on the node we're about to launch.
+    warm_pool->Stop(node_number);
+  }
   const auto cmd = CreateCommandLine(raw_cmd, params);
   File::set_current_directory(working_dir);
   return ExecCommandAndWait(wc, cmd, pid, node_number, sock);
@@ -315,16 +323,20 @@ static bool launch_cmd(const wwivd_config_t& wc, const std::string& raw_cmd,
 static bool launch_node(const Config& config, const wwivd_config_t& wc, 
                         wwivd_matrix_entry_t& bbs,
                         const std::shared_ptr<NodeManager>& nodes,
-                        int node_number, SOCKET sock, ConnectionType connection_type,
+                        const std::shared_ptr<WarmPool>& warm_pool, int node_number, SOCKET sock, ConnectionType connection_type,
                         const std::string& remote_peer) {
   const auto& raw_cmd = connection_type == ConnectionType::SSH ? bbs.ssh_cmd : bbs.telnet_cmd;
   const auto root = config.root_directory();
   const auto working_dir =
       bbs.working_directory.empty() ? "" : FilePath(root, bbs.working_directory).string();
 
-  ScopeExit at_exit([=] {
-    closesocket(sock);
-    VLOG(2) << "closed socket: " << sock;
+  // Cleared if launch_cmd hands the socket to a warm worker, which closes it.
+  auto close_sock = true;
+  ScopeExit at_exit([=, &close_sock] {
+    if (close_sock) {
+      closesocket(sock);
+      VLOG(2) << "closed socket: " << sock;
+    }
   });
 
   const auto pid = fmt::format("[{}] ", get_pid());
@@ -349,7 +361,10 @@ static bool launch_node(const Config& config, const wwivd_config_t& wc,
 #endif
       sock = INVALID_SOCKET;
     }
-    bool result = launch_cmd(wc, raw_cmd, working_dir, nodes, node_number, sock, connection_type, remote_peer);
+    auto launch_sock = sock;
+    bool result = launch_cmd(wc, raw_cmd, working_dir, nodes, warm_pool, node_number, launch_sock,
+                             connection_type, remote_peer);
+    close_sock = sock == INVALID_SOCKET || launch_sock != INVALID_SOCKET;
     VLOG(1) << "after launch_cmd";
 #if defined(WWIV_USE_PIPES)
 #if defined(__OS2__)
@@ -543,7 +558,7 @@ ConnectionHandler::BlockedConnectionResult ConnectionHandler::CheckForBlockedCon
 }
 
 void ConnectionHandler::HandleBinkPConnection() {
-  const auto sock = r.client_socket;
+  auto sock = r.client_socket;
   try {
     const auto result = CheckForBlockedConnection();
     if (result.action == BlockedConnectionAction::DENY) {
@@ -569,7 +584,8 @@ void ConnectionHandler::HandleBinkPConnection() {
         closesocket(sock);
         VLOG(2) << "closed socket: " << sock;
       });
-      launch_cmd(*data.c, data.c->binkp_cmd, "", nodemgr, 0, sock, ConnectionType::BINKP, result.remote_peer);
+      launch_cmd(*data.c, data.c->binkp_cmd, "", nodemgr, nullptr, 0, sock, ConnectionType::BINKP,
+                 result.remote_peer);
     }
 
   } catch (const std::exception& e) {
@@ -666,7 +682,10 @@ void ConnectionHandler::HandleConnection() {
     auto node = -1;
     if (nodemgr->AcquireNode(node)) {
       auto current_dir = File::current_directory();
-      launch_node(*data.config, *data.c, bbs, nodemgr, node, sock, connection_type, result.remote_peer);
+      const auto warm_pool = contains(data.warm_pools_, bbs.name) ? data.warm_pools_.at(bbs.name)
+                                                                   : nullptr;
+      launch_node(*data.config, *data.c, bbs, nodemgr, warm_pool, node, sock, connection_type,
+                  result.remote_peer);
       File::set_current_directory(current_dir);
       VLOG(1) << "Exiting HandleConnection (launch_node)";
     } else {
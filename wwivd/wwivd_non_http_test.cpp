@@ -175,3 +175,25 @@ TEST(AutoBlock, ShouldNotBlock) {
   EXPECT_FALSE(bip->IsBlocked("1.1.1.1"));
 }
 
+TEST(ConcurrentConnections, PerPeer) {
+  ConcurrentConnections c(2);
+  EXPECT_TRUE(c.aquire("10.0.0.1"));
+  EXPECT_TRUE(c.aquire("10.0.0.1"));
+  EXPECT_FALSE(c.aquire("10.0.0.1"));
+  EXPECT_TRUE(c.aquire("10.0.0.2"));
+  c.release("10.0.0.1");
+  EXPECT_TRUE(c.aquire("10.0.0.1"));
+}
+
+TEST(ConcurrentConnections, MaxTotal) {
+  ConcurrentConnections c(2, 3);
+  EXPECT_TRUE(c.aquire("10.0.0.1"));
+  EXPECT_TRUE(c.aquire("10.0.0.1"));
+  EXPECT_TRUE(c.aquire("10.0.0.2"));
+  EXPECT_FALSE(c.aquire("10.0.0.3"));
+  // Releasing a peer that was never acquired doesn't free anything.
+  EXPECT_FALSE(c.release("10.0.0.3"));
+  EXPECT_FALSE(c.aquire("10.0.0.3"));
+  c.release("10.0.0.1");
+  EXPECT_TRUE(c.aquire("10.0.0.3"));
+}
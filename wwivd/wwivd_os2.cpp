@@ -82,7 +82,7 @@ void SwitchToNonRootUser(const std::string&) {
 
 
 bool ExecCommandAndWait(const wwivd_config_t& wc, const std::string& cmd, const std::string& pid,
-                        int node_number, SOCKET sock) {
+                        int node_number, SOCKET sock, int* exit_code) {
 
   LOG(INFO) << pid << "Invoking Command Line (Win32):" << cmd;
 
@@ -148,6 +148,18 @@ bool ExecCommandAndWait(const wwivd_config_t& wc, const std::string& cmd, const
   } else {
     LOG(INFO) << "Command: '" << cmd << "' exited with error code: " << code.codeResult;
   }
+  if (exit_code != nullptr) {
+    *exit_code = static_cast<int>(code.codeResult);
+  }
   return true;
 }
 
+
+bool SpawnWarmWorker(const std::function<std::string(SOCKET)>&, int&, SOCKET&) {
+  // Passing sockets to an already running process isn't supported here.
+  return false;
+}
+
+bool IsWarmWorkerRunning(int) { return false; }
+
+void WaitForWarmWorker(int, const std::string&, int) {}
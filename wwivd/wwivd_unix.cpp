@@ -22,11 +22,14 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <vector>
 
+#include <fcntl.h>
 #include <pwd.h>
 #include <signal.h>
 #include <spawn.h>
 #include <string>
+#include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -65,6 +68,7 @@ namespace wwivd {
 
 extern std::atomic<bool> need_to_exit;
 extern std::atomic<bool> need_to_reload_config;
+extern std::atomic<bool> need_to_reload_warm_pools;
 
 } // namespace wwivd
 } // namespace wwiv
@@ -76,6 +80,7 @@ void signal_handler(int mysignal) {
   case SIGHUP: {
     cerr << "Received SIGHUP" << endl;
     need_to_reload_config.store(true);
+    need_to_reload_warm_pools.store(true);
     break;
   }
   case SIGINT: {
@@ -157,8 +162,42 @@ void SwitchToNonRootUser(const std::string& wwiv_user) {
   }
 }
 
+// Returns the exit code of the child, or -1 if it didn't exit normally.
+static int WaitForChild(pid_t child_pid, const std::string& pid, int node_number,
+                        const std::string& cmd) {
+  int status = 0;
+  VLOG(2) << pid << "before waitpid";
+  while (waitpid(child_pid, &status, 0) == -1) {
+    if (errno != EINTR) {
+      break;
+    }
+  }
+  VLOG(2) << pid << "after waitpid";
+
+  std::ostringstream errs;
+  errs << pid;
+  if (node_number > 0) {
+    errs << "Node #" << node_number;
+  } else {
+    errs << "cmd: " << cmd;
+  }
+  const auto err = errs.str();
+  if (WIFEXITED(status)) {
+    // Process exited.
+    LOG(INFO) << err << " exited with error code: " << WEXITSTATUS(status);
+    return WEXITSTATUS(status);
+  }
+  else if (WIFSIGNALED(status)) {
+    LOG(INFO) << err << " killed by signal: " << WTERMSIG(status);
+  }
+  else if (WIFSTOPPED(status)) {
+    LOG(INFO) << err << " stopped by signal: " << WSTOPSIG(status);
+  }
+  return -1;
+}
+
 bool ExecCommandAndWait(const wwivd_config_t& wc, const std::string& cmd, const std::string& pid,
-                        int node_number, SOCKET sock) {
+                        int node_number, SOCKET sock, int* exit_code) {
   char sh[21];
   char dc[21];
   char cmdstr[4000];
@@ -181,34 +220,63 @@ bool ExecCommandAndWait(const wwivd_config_t& wc, const std::string& cmd, const
     return false;
   }
   bbs_pid = child_pid;
-  int status = 0;
-  VLOG(2) << pid << "before waitpid";
-  while (waitpid(child_pid, &status, 0) == -1) {
-    if (errno != EINTR) {
-      break;
-    }
+  const auto code = WaitForChild(child_pid, pid, node_number, cmd);
+  if (exit_code != nullptr) {
+    *exit_code = code;
   }
-  VLOG(2) << pid << "after waitpid";
+  return true;
+}
 
-  std::ostringstream errs;
-  errs << pid;
-  if (node_number > 0) {
-    errs << "Node #" << node_number;
-  } else {
-    errs << "cmd: " << cmd;
-  }
-  const auto err = errs.str();
-  if (WIFEXITED(status)) {
-    // Process exited.
-    LOG(INFO) << err << " exited with error code: " << WEXITSTATUS(status);
+bool SpawnWarmWorker(const std::function<std::string(SOCKET)>& cmd_fn, int& pid,
+                     SOCKET& channel) {
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+    LOG(ERROR) << "Unable to create socketpair for warm worker; errno: " << errno;
+    return false;
   }
-  else if (WIFSIGNALED(status)) {
-    LOG(INFO) << err << " killed by signal: " << WTERMSIG(status);
+  // Only the worker's end of the channel should be inherited.
+  fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+
+  const auto cmd = cmd_fn(sv[1]);
+  char sh[21];
+  char dc[21];
+  char cmdstr[4000];
+  to_char_array(sh, "sh");
+  to_char_array(dc, "-c");
+  to_char_array(cmdstr, cmd);
+  char* argv[] = { sh, dc, cmdstr, NULL };
+
+  std::vector<std::string> env;
+  for (auto** e = environ; *e != nullptr; ++e) {
+    if (!starts_with(*e, "WWIV_HANDOFF=")) {
+      env.emplace_back(*e);
+    }
   }
-  else if (WIFSTOPPED(status)) {
-    LOG(INFO) << err << " stopped by signal: " << WSTOPSIG(status);
+  env.emplace_back(StrCat("WWIV_HANDOFF=", sv[1]));
+  std::vector<char*> envp;
+  for (auto& e : env) {
+    envp.push_back(e.data());
   }
+  envp.push_back(nullptr);
 
+  VLOG(2) << "Invoking warm worker (posix_spawn):" << cmd;
+  pid_t child_pid = 0;
+  const auto ret = posix_spawn(&child_pid, "/bin/sh", NULL, NULL, argv, envp.data());
+  closesocket(sv[1]);
+  if (ret != 0) {
+    LOG(ERROR) << "Error forking warm worker.";
+    closesocket(sv[0]);
+    return false;
+  }
+  pid = child_pid;
+  channel = sv[0];
   return true;
 }
 
+bool IsWarmWorkerRunning(int pid) {
+  return pid > 0 && kill(pid, 0) == 0;
+}
+
+void WaitForWarmWorker(int worker_pid, const std::string& pid, int node_number) {
+  WaitForChild(worker_pid, pid, node_number, "warm worker");
+}
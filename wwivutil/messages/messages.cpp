@@ -28,15 +28,18 @@
 #include "sdk/names.h"
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
+#include "sdk/msgapi/message_packer_wwiv.h"
 #include "sdk/net/networks.h"
 #include "wwivutil/util.h"
 
+#include <atomic>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace wwiv::core;
@@ -58,10 +61,8 @@ static subboard_t default_sub(const std::string& fn) {
 // N.B(rushfan): This is similar to the one in post.cpp.  But that one uses
 // network number and network name as key and not filename for sub file.
 static std::optional<subboard_t> find_sub(const wwiv::sdk::Subs& subs, const std::string& filename) {
-  for (const auto& x : subs.subs()) {
-    if (iequals(filename, x.filename)) {
-      return {x};
-    }
+  if (const auto o = subs.sub_number(filename)) {
+    return {subs.sub(o.value())};
   }
   return std::nullopt;
 }
@@ -248,12 +249,14 @@ public:
 
 class PackMessageCommand final : public BaseMessagesSubCommand {
 public:
-  PackMessageCommand() : BaseMessagesSubCommand("pack", "Packs a WWIV type-2 message area.") {}
+  PackMessageCommand() : BaseMessagesSubCommand("pack", "Packs WWIV type-2 message areas.") {}
 
   bool AddSubCommands() override {
     add_argument(BooleanCommandLineArgument{"backup", "make a backup of the subs", true});
+    add_argument(BooleanCommandLineArgument{"all", "Pack all type-2 message areas", false});
+    add_argument({"jobs", "Number of message areas to pack at once (0 for one per CPU)", "0"});
     add_argument({"delete_overflow",
-                  "Strategy for deleting excess messages when adding new ones. (none|one|all)",
+                  "Strategy for deleting messages over the area's maximum. (none|one|all)",
                   "none"});
     return true;
   }
@@ -261,7 +264,8 @@ public:
   [[nodiscard]] std::string GetUsage() const override {
     std::ostringstream ss;
     ss << "Usage:   pack <base sub filename>" << std::endl;
-    ss << "Example: post general" << std::endl;
+    ss << "         pack --all [--jobs=N] [--delete_overflow=none|one|all]" << std::endl;
+    ss << "Example: pack general" << std::endl;
     return ss.str();
   }
 
@@ -272,7 +276,82 @@ public:
     return sb && db;
   }
 
-   int Execute() override {
+  [[nodiscard]] pack_options_t pack_options(const subboard_t& area) const {
+    pack_options_t options{};
+    options.max_messages = area.maxmsgs;
+    if (const auto d = sarg("delete_overflow"); d == "one") {
+      options.overflow_strategy = OverflowStrategy::delete_one;
+    } else if (d == "all") {
+      options.overflow_strategy = OverflowStrategy::delete_all;
+    }
+    return options;
+  }
+
+  [[nodiscard]] bool pack(const subboard_t& area) const {
+    const auto& name = area.filename;
+    const auto& config = *this->config()->config();
+    const auto sub_fn = FilePath(config.datadir(), StrCat(name, ".sub"));
+    const auto dat_fn = FilePath(config.msgsdir(), StrCat(name, ".dat"));
+    if (!File::Exists(sub_fn) || !File::Exists(dat_fn)) {
+      LOG(INFO) << "Skipping message area without any messages: " << name;
+      return true;
+    }
+    if (barg("backup")) {
+      backup(config, name);
+    }
+    const auto r = pack_wwiv_message_area(sub_fn, dat_fn, pack_options(area));
+    if (!r.ok) {
+      LOG(ERROR) << "Unable to pack message area: '" << name << "'"
+                 << (r.changed ? " (it kept changing while being packed)" : "");
+      return false;
+    }
+    LOG(INFO) << "Packed " << name << ": " << r.num_messages << " messages, dropped "
+              << r.num_dropped << ", deleted " << r.num_deleted << ", " << r.old_size << " -> " << r.new_size << " bytes.";
+    return true;
+  }
+
+  int PackAll() {
+    const auto& config = *this->config()->config();
+    Subs subs(config.datadir(), this->config()->networks().networks(), config.max_backups());
+    if (!subs.Load()) {
+      std::clog << "Unable to load subs." << std::endl;
+      return 1;
+    }
+    std::vector<subboard_t> areas;
+    for (const auto& s : subs.subs()) {
+      if (s.storage_type == 2) {
+        areas.push_back(s);
+      }
+    }
+    auto jobs = iarg("jobs");
+    if (jobs <= 0) {
+      jobs = std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    jobs = std::max(1, std::min(jobs, stl::size_int(areas)));
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<int> failed{0};
+    auto packer = [&] {
+      for (auto i = next++; i < areas.size(); i = next++) {
+        if (!pack(areas[i])) {
+          ++failed;
+        }
+      }
+    };
+    std::vector<std::thread> packers;
+    for (auto i = 0; i < jobs; i++) {
+      packers.emplace_back(packer);
+    }
+    for (auto& t : packers) {
+      t.join();
+    }
+    return failed > 0 ? 1 : 0;
+  }
+
+  int Execute() override {
+    if (barg("all")) {
+      return PackAll();
+    }
     if (remaining().empty()) {
       std::clog << "Missing sub basename." << std::endl;
       std::cout << GetUsage() << GetHelp();
@@ -294,53 +373,7 @@ public:
         return 1;
       }
     }
-
-    if (barg("backup")) {
-      backup(*config()->config(), basename);
-    }
-
-    auto newsub = sub();
-    newsub.filename = StrCat(basename, ".new");
-    {
-      std::unique_ptr<MessageArea> area(api().Open(sub(), -1));
-      if (!api().Create(newsub, -1)) {
-        std::clog << "Unable to create new area: " << newsub.filename;
-        return 1;
-      }
-      std::unique_ptr<MessageArea> newarea(api().Open(newsub, -1));
-      const auto total = area->number_of_messages();
-      for (auto i = 1; i <= total; i++) {
-        auto message(area->ReadMessage(i));
-        if (!message) {
-          LOG(ERROR) << "Unable to load message #" << i;
-          continue;
-        }
-        if (!newarea->AddMessage(*message, {})) {
-          LOG(ERROR) << "Error adding message: " << message->header().title();
-        } else {
-          std::cout << "[" << i << "]";
-        }
-      }
-    }
-
-    // Copy "new" versions back to sub and dat
-    const auto orig_sub_fn = FilePath(config()->config()->datadir(), StrCat(basename, ".sub"));
-    const auto new_sub_fn =
-        FilePath(config()->config()->datadir(), StrCat(newsub.filename, ".sub"));
-    File::Remove(orig_sub_fn);
-    if (!File::Rename(new_sub_fn, orig_sub_fn)) {
-      std::clog << "Unable to move sub";
-    }
-    const auto orig_dat_fn =
-        FilePath(config()->config()->msgsdir(), StrCat(newsub.filename, ".dat"));
-    const auto new_dat_fn =
-        FilePath(config()->config()->msgsdir(), StrCat(newsub.filename, ".dat"));
-    File::Remove(orig_dat_fn);
-    if (!File::Rename(new_dat_fn, orig_dat_fn)) {
-      std::clog << "Unable to move dat";
-    }
-
-    return 0;
+    return pack(sub()) ? 0 : 1;
   }
 };
 
@@ -40,23 +40,11 @@ namespace wwiv::wwivutil::net {
 
 // Based off one from post.cpp
 static std::optional<subboard_t> find_sub(const Subs& subs, int network_number, const std::string& netname) {
-  auto current = 0;
   VLOG(3) << "find_sub: subs.subs().size(): " << subs.subs().size()
           << "; net_num: " << network_number;
-  for (const auto& x : subs.subs()) {
-    for (const auto& n : x.nets) {
-      if (n.net_num == network_number) {
-        VLOG(4) << "netname: " << netname << "; n.stype: " << n.stype;
-        if (iequals(netname, n.stype)) {
-          VLOG(2) << "MATCH: netname: " << netname << "; n.stype: " << n.stype;
-          // Since the subtype matches, we need to find the sub-board base filename.
-          // and return that.
-          auto sub = subs.sub(current);
-          return { sub };
-        }
-      }
-    }
-    ++current;
+  if (const auto o = subs.sub_number(network_number, netname)) {
+    VLOG(2) << "MATCH: netname: " << netname << "; sub: " << subs.sub(o.value()).filename;
+    return {subs.sub(o.value())};
   }
   return std::nullopt;
 }
@@ -19,16 +19,22 @@
 
 #include "sdk/status.h"
 #include "core/command_line.h"
+#include "core/datetime.h"
 #include "core/file.h"
+#include "core/os.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/sysoplog_events.h"
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
 using wwiv::core::BooleanCommandLineArgument;
+using namespace wwiv::core;
 using namespace wwiv::sdk;
 using namespace wwiv::strings;
 
@@ -121,9 +127,51 @@ public:
 
 };
 
+class StatusSysopLogCommand final : public UtilCommand {
+public:
+  StatusSysopLogCommand()
+      : UtilCommand("sysoplog", "Displays the sysop log events from all nodes.") {}
+
+  [[nodiscard]] std::string GetUsage() const override {
+    std::ostringstream ss;
+    ss << "Usage: " << std::endl << std::endl;
+    ss << "  sysoplog : Displays the most recent sysop log events." << std::endl << std::endl;
+    return ss.str();
+  }
+
+  bool AddSubCommands() override {
+    add_argument({"lines", 'n', "Number of events to display.", "20"});
+    add_argument({"node", "Only display events from this node (0 for all).", "0"});
+    add_argument(BooleanCommandLineArgument{"follow", 'f', "Keep displaying new events.", false});
+    return true;
+  }
+
+  int Execute() override {
+    const auto node = iarg("node");
+    SysopLogEventReader reader(FilePath(config()->config()->gfilesdir(), SYSOPLOG_EVT));
+    reader.seek_last(iarg("lines"));
+    for (;;) {
+      for (const auto& e : reader.read()) {
+        if (node != 0 && e.node != node) {
+          continue;
+        }
+        std::cout << DateTime::from_time_t(e.time).to_string("%Y-%m-%d %H:%M:%S") << " ["
+                  << e.node << "] " << (e.user.empty() ? "-" : e.user) << ": " << e.text
+                  << std::endl;
+      }
+      if (!barg("follow")) {
+        break;
+      }
+      os::sleep_for(std::chrono::seconds(1));
+    }
+    return 0;
+  }
+};
+
 bool StatusCommand::AddSubCommands() {
   add(std::make_unique<StatusQScanCommand>());
   add(std::make_unique<StatusDumpCommand>());
+  add(std::make_unique<StatusSysopLogCommand>());
   return true;
 }
 